@@ -8,6 +8,7 @@
 #include <list>
 #include <deque>
 #include <vector>
+#include <string>
 
 #include "Types.h"
 
@@ -35,11 +36,17 @@ struct TimeoutHandler {
 
 //! This is the thread functor that actually waits out a timeout
 struct FunctorTimeout {
+  //! Reference to the clock the timeout is kept by
+  Clock &clock;
   //! Reference to when the timeout is
-  boost::xtime &timeout;
-  //! Reference to the mutex for timeout
+  TimeInterval &timeout;
+  //! Reference to whether the timeout is set
+  bool &armed;
+  //! Reference to whether the thread should quit
+  bool &quitting;
+  //! Reference to the mutex for timeout, armed and quitting
   boost::mutex &mutex_timeout;
-  //! Reference to the condition variable for timeout
+  //! Reference to the condition variable for timeout, armed and quitting
   boost::condition &cond_timeout;
 
   //! Reference to the timeout handler pointer
@@ -48,12 +55,16 @@ struct FunctorTimeout {
   boost::mutex &mutex_handler;
  
   //! Constructor---fill in references
-  inline FunctorTimeout(boost::xtime &my_timeout,
+  inline FunctorTimeout(Clock &my_clock,
+			TimeInterval &my_timeout,
+			bool &my_armed,
+			bool &my_quitting,
 			boost::mutex &my_mutex_timeout,
 			boost::condition &my_cond_timeout,
 			TimeoutHandler* &my_handler,
 			boost::mutex &my_mutex_handler)
-  : timeout(my_timeout), mutex_timeout(my_mutex_timeout),
+  : clock(my_clock), timeout(my_timeout), armed(my_armed),
+    quitting(my_quitting), mutex_timeout(my_mutex_timeout),
     cond_timeout(my_cond_timeout), handler(my_handler),
     mutex_handler(my_mutex_handler) { }
 
@@ -64,25 +75,20 @@ struct FunctorTimeout {
     // spending most of our time waiting on a condition variable, though.
     boost::mutex::scoped_lock lock_t(mutex_timeout);
 
-    // Loop forever
+    // Loop until told to quit
     for(;;) {
-      // First make a copy of the timeout variable. Dunno if this is
-      // necessary, but why risk it?
-      boost::xtime timeout_copy = timeout;
+      if(quitting) return;
 
-      // If the timeout seconds field is 0, abort the thread.
-      if((timeout_copy.sec == 0) && (timeout_copy.nsec == 0)) return;
+      // No timeout set? Wait for one.
+      if(!armed) { cond_timeout.wait(lock_t); continue; }
 
-      // Wait for the timeout to time out. If the wait returns true, we
-      // were interrupted and there's a new timeout value waiting for
-      // us. Otherwise, we've hit the end of the timeout and we need to
-      // call the handler.
-//std::cerr << "starting wait at " << TimeInterval::now() << std::endl;
-      if(cond_timeout.timed_wait(lock_t, timeout_copy)) continue;
-//std::cerr << "left wait at " << TimeInterval::now() << std::endl;
-
-      // Now set a timeout waaaay off in the distant future
-      timeout = muchLater();
+      // Wait for the timeout to time out. If we're woken first, there may
+      // be a new timeout value waiting for us, so look again. Otherwise,
+      // we've hit the end of the timeout and we need to call the handler.
+      const TimeInterval timeout_copy = timeout;
+      if(clock.waitUntil(cond_timeout, lock_t, timeout_copy)) continue;
+      if(quitting || !armed || (timeout.nsecs != timeout_copy.nsecs)) continue;
+      armed = false;
 
       // Unlock the timeout variable while we call the handler,
       // then lock it back after that's done.
@@ -96,32 +102,26 @@ struct FunctorTimeout {
       // And that's it. Loop 'round and get set for the next timeout.
     }
   }
-
-  //! Returns a time that's way off from now.
-  inline static boost::xtime muchLater()
-  {
-    // First get the time right now
-    boost::xtime later;
-    boost::xtime_get(&later, boost::TIME_UTC_);	// Gary: TIME_UTC to TIME_UTC_
-    // Then add an interval. NB: This is exactly three weeks! Don't
-    // let a program using this run for more than three weeks!
-    later.sec += 1814400;
-    return later;
-  }
 };
 
 //! Calls a designated method when a specified timeout expires
 
 //! Register a TimeoutHandler with a Timeout object and specify an interval
-//! to wait. When this interval passes, the TimeoutHandler's handleTimeout()
-//! method is called.
+//! to wait. When this interval passes, by the Timeout's clock, the
+//! TimeoutHandler's handleTimeout() method is called.
 class Timeout : public boost::noncopyable {
 private:
+  //! The clock the timeout is kept by
+  Clock &clock;
   //! When the timeout is
-  boost::xtime timeout;
-  //! Mutex for timeout
+  TimeInterval timeout;
+  //! Whether the timeout is set
+  bool armed;
+  //! Whether the thread should quit
+  bool quitting;
+  //! Mutex for timeout, armed and quitting
   boost::mutex mutex_timeout;
-  //! Condition variable for timeout
+  //! Condition variable for timeout, armed and quitting
   boost::condition cond_timeout;
 
   //! The timeout handler
@@ -134,18 +134,18 @@ private:
 
 public:
   //! Constructor: start thread
-  inline Timeout()
-  : timeout(FunctorTimeout::muchLater()), handler(NULL),
+  inline Timeout(Clock &my_clock=Clock::real())
+  : clock(my_clock), armed(false), quitting(false), handler(NULL),
     t_ft(new boost::thread(
-      FunctorTimeout(timeout, mutex_timeout, cond_timeout,
-		     handler, mutex_handler))) { }
+      FunctorTimeout(clock, timeout, armed, quitting, mutex_timeout,
+		     cond_timeout, handler, mutex_handler))) { }
 
   //! Constructor: start thread and set TimeoutHandler
-  inline Timeout(TimeoutHandler &my_handler)
-  : timeout(FunctorTimeout::muchLater()), handler(&my_handler),
+  inline Timeout(TimeoutHandler &my_handler, Clock &my_clock=Clock::real())
+  : clock(my_clock), armed(false), quitting(false), handler(&my_handler),
     t_ft(new boost::thread(
-      FunctorTimeout(timeout, mutex_timeout, cond_timeout,
-		     handler, mutex_handler))) { }
+      FunctorTimeout(clock, timeout, armed, quitting, mutex_timeout,
+		     cond_timeout, handler, mutex_handler))) { }
 
   //! Set the timeout handler. (Does not copy---sets a reference)
   inline void setTimeoutHandler(TimeoutHandler &my_handler)
@@ -166,33 +166,24 @@ public:
   //! Set timeout---arg is how far in the future timeout happens
   inline void setTimeout(const TimeInterval &my_timeout)
   {
-//std::cerr << "called to wait for " << my_timeout << std::endl;
-    // First get the time right now
-    boost::xtime time_now;
-    boost::xtime_get(&time_now, boost::TIME_UTC_);
-
     // Grab timeout mutex
     boost::mutex::scoped_lock lock_t(mutex_timeout);
 
     // Figure out the future timeout time
-    timeout = time_now;
-    timeout.sec += my_timeout.secs;
-    const unsigned int nsecs = my_timeout.msecs * 1000000;
-    timeout.nsec += nsecs % 1000000000;
-    timeout.sec  += nsecs / 1000000000;
+    timeout = clock.now() + my_timeout;
+    armed = true;
 
     // Notify the waiting thread
     cond_timeout.notify_one();
   }
 
-  //! Clear timeout---or set it to sometime in the distant future
+  //! Clear timeout
   inline void clearTimeout()
   {
     // Grab timeout mutex
     boost::mutex::scoped_lock lock_t(mutex_timeout);
 
-    // Set to the future
-    timeout = FunctorTimeout::muchLater();
+    armed = false;
 
     // Notify the waiting thread
     cond_timeout.notify_one();
@@ -204,8 +195,8 @@ public:
     { // ENCLOSING BLOCK: For grabbing timeout mutex
     boost::mutex::scoped_lock lock_t(mutex_timeout);
 
-    // Set timeout to 0 and notify the wait thread
-    timeout.sec = 0; timeout.nsec = 0;
+    // Tell the wait thread to quit
+    quitting = true;
     cond_timeout.notify_one();
     } // END ENCLOSING BLOCK
 
@@ -279,85 +270,111 @@ struct FunctorNewEventsSSSC {
 
 
 //! The actual guts of a ShortStylusSuppressor
+
+//! Runs a ShortStylusFilter either with threads of its own (a Timeout to
+//! wait out the threshold and a FunctorNewEventsSSSC to pass events on) or
+//! inline, with a shared TimerService doing the waiting and events passed
+//! on directly from whichever thread made them reportable.
 class ShortStylusSuppressorCore
-: public boost::noncopyable, public TimeoutHandler {
+: public boost::noncopyable, public TimeoutHandler, public TimerClient {
 private:
   //! ShortStylusSuppressor object whose guts we manipulate
   ShortStylusSuppressor &sss;
 
-  //! Freshly filtered BaseIOEvents
+  //! The clock we keep time by
+  Clock &clock;
+
+  //! Shared timer service when running inline, otherwise NULL
+  TimerService *timers;
+
+  //! Freshly filtered BaseIOEvents (threaded only)
   std::deque<BaseIOEvent> new_bevents;
   //! Mutex for new_bevents
   boost::mutex mutex_new_bevents;
   //! Condition variable for new_bevents
   boost::condition cond_new_bevents;
 
-  //! Minimum insertion/extraction time threshold for debouncing
-  TimeInterval threshold;
-  //! Mutex for the time threshold
-  boost::mutex mutex_threshold;
+  //! The debouncing logic proper
+  ShortStylusFilter filter;
+  //! Mutex for the filter
+  boost::mutex mutex_filter;
 
-  //! Timeout that we use to measure the debouncing interval.
-  Timeout timeout;
+  //! Timeout that we use to measure the debouncing interval (threaded only)
+  boost::scoped_ptr<Timeout> timeout;
 
-  //! The queue of stylus BaseIOEvents that we filter when debouncing
+  //! Thread for dispatching new BaseIOEvents to the interface (threaded only)
+  boost::scoped_ptr<boost::thread> t_new_bevents;
 
-  //! A list so that iterators can still be valid after erasure.
-  std::list<BaseIOEvent> stylus_bevents;
+  //! Arrange to be called back when the filter next has events to release.
+  //! Call with the filter mutex held.
+  inline void reschedule(const TimeInterval &now)
+  {
+    TimeInterval deadline;
+    if(!filter.nextDeadline(deadline)) return;
+    if(timers) timers->schedule(*this, deadline);
+    else timeout->setTimeout(deadline > now ? deadline - now : TimeInterval());
+  }
 
-  //! Mutex for stylus events
-  boost::mutex mutex_stylus_bevents;
+  //! Pass filtered events on. Call with the filter mutex held in lock_f;
+  //! it's released once the events' order relative to any others is fixed.
+  inline void pass(std::deque<BaseIOEvent> &events,
+		   boost::mutex::scoped_lock &lock_f)
+  {
+    if(events.empty()) return;
 
-  //! Thread for dispatching new BaseIOEvents to the interface
-  boost::scoped_ptr<boost::thread> t_new_bevents;
+    // Inline: straight to the handler
+    if(timers) {
+      boost::mutex::scoped_lock lock_b(sss.out_events_mutex);
+      lock_f.unlock();
+      sss.out_events.insert(sss.out_events.end(), events.begin(), events.end());
+      if(sss.handler) (*sss.handler)(sss.out_events);
+    }
+    // Threaded: via the event reporter
+    else {
+      boost::mutex::scoped_lock lock_n(mutex_new_bevents);
+      lock_f.unlock();
+      new_bevents.insert(new_bevents.end(), events.begin(), events.end());
+      cond_new_bevents.notify_one();
+    }
+  }
 
-  //! Pops "debounced" events off the list and adds them to the filtered
-  //! BaseIOEvents queue.
-  inline void findAndReportDebounced()
+  //! Release events held back long enough, and pass them on
+  inline void release()
   {
-    // Debounced events are those in the stylus_bevents queue that are older
-    // than now minus the debouncing threshold
-    TimeInterval survival_time = TimeInterval::now() - threshold;
-
-    // Grab stylus events mutex
-    boost::mutex::scoped_lock lock_s(mutex_stylus_bevents);
-
-    // Some checks to keep us from wasting our time
-    if(stylus_bevents.empty()) return;
-    if(stylus_bevents.front().timestamp > survival_time) return;
-
-    // Grab new BaseIOEvent queue mutex and stuff in new events
-    unsigned int new_bevents_enqueued = 0;
-    boost::mutex::scoped_lock lock_n(mutex_new_bevents);
-    while((!stylus_bevents.empty()) &&
-	  (stylus_bevents.front().timestamp <= survival_time)) {
-/*
-std::cerr << "<<popping out event " << stylus_bevents.front().type
-	  << ", cell " << stylus_bevents.front().cell
-	  << ", dot " << stylus_bevents.front().dot << ">>" << std::endl;
-*/
-      new_bevents.push_back(stylus_bevents.front());
-      stylus_bevents.pop_front();
-      ++new_bevents_enqueued;
-    }
+    const TimeInterval now = clock.now();
+    std::deque<BaseIOEvent> released;
 
-    // If new events are waiting, Notify event reporter
-    if(new_bevents_enqueued > 0) cond_new_bevents.notify_one();
+    boost::mutex::scoped_lock lock_f(mutex_filter);
+    filter.expire(released, now);
+    reschedule(now);
+    pass(released, lock_f);
   }
 
 public:
-  //! Constructor---start thread
+  //! Constructor---start threads
   inline ShortStylusSuppressorCore(ShortStylusSuppressor &my_sss,
+				   Clock &my_clock,
 				   const TimeInterval &my_threshold)
-  : sss(my_sss), threshold(my_threshold), timeout(*this),
+  : sss(my_sss), clock(my_clock), timers(NULL), filter(my_threshold),
+    timeout(new Timeout(*this, clock)),
     t_new_bevents(
       new boost::thread(
 	FunctorNewEventsSSSC(
 	  new_bevents, mutex_new_bevents, cond_new_bevents, sss))) { }
 
+  //! Constructor---run inline, with no threads
+  inline ShortStylusSuppressorCore(ShortStylusSuppressor &my_sss,
+				   TimerService &my_timers,
+				   const TimeInterval &my_threshold)
+  : sss(my_sss), clock(my_timers.getClock()), timers(&my_timers),
+    filter(my_threshold) { }
+
   //! Destructor---call for death
   inline ~ShortStylusSuppressorCore()
   {
+    // Inline: just make sure the timer service forgets us
+    if(timers) { timers->cancel(*this); return; }
+
     { // Grab new events mutex and insert a DONE BaseIOEvent.
       // Note that by the time this happens, the functor may already be
       // dead from the BrailleTutor object's own DONE BaseIOEvent.
@@ -371,120 +388,184 @@ public:
 
     // Wait for the event reporter thread to die
     if(t_new_bevents) t_new_bevents->join();
+
+    // Stop the timeout before the filter it looks at goes away
+    timeout.reset();
   }
 
   //! Set the minimum insertion/withdrawal-time threshold for stylus events
   inline void setThreshold(const TimeInterval &my_threshold)
   {
-    { // Grab threshold mutex and change threshold
-    boost::mutex::scoped_lock lock_t(mutex_threshold);
-    threshold = my_threshold;
+    { // Grab filter mutex and change threshold
+    boost::mutex::scoped_lock lock_f(mutex_filter);
+    filter.setThreshold(my_threshold);
     }
 
     // See if that's made any events reportable now
-    findAndReportDebounced();
+    release();
   }
 
-  //! IOEventHandler functor method definition
-  inline virtual void operator()(std::deque<BaseIOEvent> &events)
+  //! Learn a threshold for each hole
+  inline void setAdaptiveThreshold(const TimeInterval &min_threshold,
+				   const TimeInterval &max_threshold)
   {
-    unsigned int new_bevents_enqueued = 0;
-
-    { // ENCLOSING BLOCK: new and stylus bevent queue mutexes
-    boost::mutex::scoped_lock lock_n(mutex_new_bevents);
-    boost::mutex::scoped_lock lock_s(mutex_stylus_bevents);
-
-    // Store stylus events in stylus_bevents for processing. The rest
-    // get passed straight to the listener.
-    std::deque<BaseIOEvent>::const_iterator e_iter;
-    for(e_iter=events.begin(); e_iter!=events.end(); ++e_iter)
-      if((e_iter->type == BaseIOEvent::STYLUS_DOWN) ||
-	 (e_iter->type == BaseIOEvent::STYLUS_UP))
-	stylus_bevents.push_back(*e_iter);
-	else {
-	  new_bevents.push_back(*e_iter);
-	  ++new_bevents_enqueued;
-	}
+    { // Grab filter mutex and start learning
+    boost::mutex::scoped_lock lock_f(mutex_filter);
+    filter.setAdaptiveThreshold(min_threshold, max_threshold);
+    }
 
-    // Clear out stored events
-    events.clear();
-    } // END ENCLOSING BLOCK
+    release();
+  }
 
-    // If we have new events, notify the event reporter about them
-    if(new_bevents_enqueued > 0) cond_new_bevents.notify_one();
+  //! Load a saved noise profile
+  inline void loadNoiseProfile(const std::string &filename)
+  {
+    { // Grab filter mutex and load the profile
+    boost::mutex::scoped_lock lock_f(mutex_filter);
+    if(!filter.profile())
+      throw BTException(BTException::BT_EINVAL,
+			"stylus suppressor threshold isn't adaptive");
+    filter.profile()->read(filename);
+    }
 
-    // See if there are events to debounce or register
-    handleTimeout();
+    release();
   }
 
-  //! Timeout handler---scans stylus_bevents and performs debouncing.
+  //! Save the noise profile learned so far
+  inline void saveNoiseProfile(const std::string &filename)
+  {
+    boost::mutex::scoped_lock lock_f(mutex_filter);
+    if(!filter.profile())
+      throw BTException(BTException::BT_EINVAL,
+			"stylus suppressor threshold isn't adaptive");
+    filter.profile()->write(filename);
+  }
 
-  //! Scans through events, from most recent to least, and eliminates event
-  //! pairs that come from the same key/cell. If they appear together in the
-  //! queue, it's assumed that they cover an interval too short to belong to
-  //! a real event, so both events in the pair are deleted.
-  inline virtual void handleTimeout()
+  //! BaseIOEventHandler functor method definition
+  inline virtual void operator()(std::deque<BaseIOEvent> &events)
   {
-    // Pop "debounced" stylus events off the queue.
-    findAndReportDebounced();
-
-    // Acquire lock for the stylus events queue
-    boost::mutex::scoped_lock lock_s(mutex_stylus_bevents);
-//std::cerr << "bevents size: " << stylus_bevents.size() << std::endl;
-
-    // Avoid unnecessary work---can't find an annihilating event pair if
-    // there's only 0 or 1 events.
-    // If there's one event, we move the timeout back though.
-    if(stylus_bevents.empty()) return;
-    if(stylus_bevents.size() == 1) { timeout.setTimeout(threshold); return; }
-
-    // A binary vector indicating which events are to be deleted
-    std::vector<bool> is_dead(stylus_bevents.size(), false);
-    // A collection of iterators to delete
-    std::vector<std::list<BaseIOEvent>::iterator> dead_iters;
-
-    // This is a bit nasty. We go through the stylus event list from front
-    // (latest) to back (earliest), looking for pairs of events occurring
-    // in the same braille cell/dot. We mark these as dead and place
-    // iterators pointing to them into an array so we can eliminate them.
-    std::list<BaseIOEvent>::iterator sb_iter1 = stylus_bevents.begin();
-    for(unsigned int i=0; i<stylus_bevents.size()-1; ++i) {
-      if(is_dead[i]) { ++sb_iter1; continue; }
-      std::list<BaseIOEvent>::iterator sb_iter2 = sb_iter1; ++sb_iter2;
-
-      for(unsigned int j=0; j<stylus_bevents.size(); ++j) {
-	if(is_dead[j]) { ++sb_iter2; continue; }
-	if((sb_iter1->cell==sb_iter2->cell) && (sb_iter1->dot==sb_iter2->dot)) {
-	  is_dead[i] = is_dead[j] = true;
-	  dead_iters.push_back(sb_iter1);
-	  dead_iters.push_back(sb_iter2);
-	  j = stylus_bevents.size(); // abort iteration
-	  continue;
-	}
-	++sb_iter2;
-      }
+    const TimeInterval now = clock.now();
+    std::deque<BaseIOEvent> filtered;
+    filtered.swap(events);
+
+    boost::mutex::scoped_lock lock_f(mutex_filter);
+    filter.filter(filtered, now);
+    reschedule(now);
+    pass(filtered, lock_f);
+  }
 
-      ++sb_iter1;
+  //! Timeout handler for the threaded suppressor
+  inline virtual void handleTimeout() { release(); }
+
+  //! Timer handler for the inline suppressor
+  inline virtual void handleTimer(const TimeInterval &) { release(); }
+};
+
+///////////////////////////////////
+//// ShortStylusFilter METHODS ////
+///////////////////////////////////
+
+// Constructor
+ShortStylusFilter::ShortStylusFilter(const TimeInterval &my_threshold)
+: threshold(my_threshold) { }
+
+// Destructor
+ShortStylusFilter::~ShortStylusFilter() { }
+
+// Set a fixed threshold
+void ShortStylusFilter::setThreshold(const TimeInterval &my_threshold)
+{
+  noise.reset();
+  threshold = my_threshold;
+}
+
+// Learn a threshold for each hole
+void ShortStylusFilter::setAdaptiveThreshold(const TimeInterval &min_threshold,
+					     const TimeInterval &max_threshold)
+{
+  // Build the profile first; it checks its arguments
+  noise.reset(new StylusNoiseProfile(min_threshold, max_threshold));
+  threshold = max_threshold;
+}
+
+// Filter events arriving at time now
+void ShortStylusFilter::filter(std::deque<BaseIOEvent> &events,
+			       const TimeInterval &now)
+{
+  // Hold stylus events back for processing, letting an adaptive threshold
+  // learn from each, spurious or not. The rest stay put.
+  std::deque<BaseIOEvent>::iterator e_iter, kept = events.begin();
+  for(e_iter=events.begin(); e_iter!=events.end(); ++e_iter)
+    if((e_iter->type == BaseIOEvent::STYLUS_DOWN) ||
+       (e_iter->type == BaseIOEvent::STYLUS_UP)) {
+      if(noise) noise->observe(*e_iter);
+      held.push_back(*e_iter);
     }
+    else *kept++ = *e_iter;
+  events.erase(kept, events.end());
 
-    // Eliminate events that we marked for deletion
-    std::vector<std::list<BaseIOEvent>::iterator>::iterator di_iter;
-    for(di_iter=dead_iters.begin(); di_iter!=dead_iters.end(); ++di_iter)
-/*
+  // See if there are events to debounce or release
+  expire(events, now);
+}
+
+// Release events held back long enough
+void ShortStylusFilter::expire(std::deque<BaseIOEvent> &events,
+			       const TimeInterval &now)
 {
-std::cerr << "[[ eliminating bevent type " << (*di_iter)->type
-	  << ", cell " << (*di_iter)->cell
-	  << ", dot " << (int) (*di_iter)->dot
-	  << ", time " << (*di_iter)->timestamp << " ]]" << std::endl;
-*/
-      stylus_bevents.erase(*di_iter);
-//}
-
-    // Indicate a new scanning timeout. (Need threshold mutex first).
-    boost::mutex::scoped_lock lock_t(mutex_threshold);
-    timeout.setTimeout(threshold);
+  // Drop pairs of events held in the same hole that span too short a time
+  // to be real
+  annihilate();
+
+  // Debounced events are those held back since before now minus their
+  // debouncing threshold. Events in the same hole share a threshold, so
+  // they're released in timestamp order.
+  std::list<BaseIOEvent>::iterator h_iter = held.begin();
+  while(h_iter != held.end())
+    if(h_iter->timestamp + holdTime(*h_iter) <= now) {
+      events.push_back(*h_iter);
+      h_iter = held.erase(h_iter);
+    }
+    else ++h_iter;
+}
+
+// Find when expire() next has events to release
+bool ShortStylusFilter::nextDeadline(TimeInterval &deadline) const
+{
+  if(held.empty()) return false;
+
+  // With a fixed threshold, the oldest event is always next
+  std::list<BaseIOEvent>::const_iterator h_iter = held.begin();
+  deadline = h_iter->timestamp + holdTime(*h_iter);
+  if(!noise) return true;
+
+  for(++h_iter; h_iter != held.end(); ++h_iter) {
+    const TimeInterval due = h_iter->timestamp + holdTime(*h_iter);
+    if(due < deadline) deadline = due;
   }
-};
+  return true;
+}
+
+// Scans through held-back events, from earliest to latest, and eliminates
+// event pairs that come from the same cell and dot and cover an interval
+// too short to belong to a real event (shorter than the first event's hold
+// time). Events that arrive late can be held together however far apart
+// their timestamps are, so a pair further apart than that is left alone:
+// it's a genuine contact (or gap), and expire() releases it in order.
+void ShortStylusFilter::annihilate()
+{
+  std::list<BaseIOEvent>::iterator sb_iter1 = held.begin();
+  while(sb_iter1 != held.end()) {
+    std::list<BaseIOEvent>::iterator sb_iter2 = sb_iter1;
+    for(++sb_iter2; sb_iter2 != held.end(); ++sb_iter2)
+      if((sb_iter1->cell==sb_iter2->cell) && (sb_iter1->dot==sb_iter2->dot))
+	break;
+
+    if((sb_iter2 == held.end()) ||
+       (sb_iter2->timestamp - sb_iter1->timestamp >= holdTime(*sb_iter1)))
+      ++sb_iter1;
+    else { held.erase(sb_iter2); sb_iter1 = held.erase(sb_iter1); }
+  }
+}
 
 ///////////////////////////////////////
 //// ShortStylusSuppressor METHODS ////
@@ -492,7 +573,20 @@ std::cerr << "[[ eliminating bevent type " << (*di_iter)->type
 
 // ShortStylusSuppressor constructor
 ShortStylusSuppressor::ShortStylusSuppressor(const TimeInterval &threshold)
-: handler(NULL), sssc(new ShortStylusSuppressorCore(*this, threshold)) { }
+: handler(NULL),
+  sssc(new ShortStylusSuppressorCore(*this, Clock::real(), threshold)) { }
+
+// ShortStylusSuppressor constructor for keeping time by another clock
+ShortStylusSuppressor::ShortStylusSuppressor(Clock &clock,
+					     const TimeInterval &threshold)
+: handler(NULL),
+  sssc(new ShortStylusSuppressorCore(*this, clock, threshold)) { }
+
+// ShortStylusSuppressor constructor for running inline
+ShortStylusSuppressor::ShortStylusSuppressor(TimerService &timers,
+					     const TimeInterval &threshold)
+: handler(NULL),
+  sssc(new ShortStylusSuppressorCore(*this, timers, threshold)) { }
 
 // Register a BaseIOEventHandler with this ShortStylusSuppressor.
 void ShortStylusSuppressor::setBaseIOEventHandler(BaseIOEventHandler &bioeh)
@@ -509,6 +603,31 @@ void ShortStylusSuppressor::pollBaseIOEvents(BaseIOEventHandler &bioeh)
   bioeh(out_events);
 }
 
+// Set the minimum insertion/withdrawal-time threshold for stylus events
+void ShortStylusSuppressor::setThreshold(const TimeInterval &threshold)
+{
+  if(sssc != NULL) sssc->setThreshold(threshold);
+}
+
+// Learn a threshold for each hole
+void ShortStylusSuppressor::setAdaptiveThreshold(
+  const TimeInterval &min_threshold, const TimeInterval &max_threshold)
+{
+  if(sssc != NULL) sssc->setAdaptiveThreshold(min_threshold, max_threshold);
+}
+
+// Load a saved noise profile
+void ShortStylusSuppressor::loadNoiseProfile(const std::string &filename)
+{
+  if(sssc != NULL) sssc->loadNoiseProfile(filename);
+}
+
+// Save the noise profile learned so far
+void ShortStylusSuppressor::saveNoiseProfile(const std::string &filename)
+{
+  if(sssc != NULL) sssc->saveNoiseProfile(filename);
+}
+
 // BaseIOEvent handler callback
 void ShortStylusSuppressor::operator()(std::deque<BaseIOEvent> &events)
 {
@@ -17,14 +17,92 @@
  */
 
 #include "Types.h"
+#include "TimerService.h"
+#include "StylusNoiseProfile.h"
+
+#include <list>
+#include <deque>
+#include <string>
 
 #include <boost/thread.hpp>
+#include <boost/scoped_ptr.hpp>
 
 namespace BrailleTutorNS {
 
 // Predefinition
 class ShortStylusSuppressorCore;
 
+//! The debouncing logic of a ShortStylusSuppressor, without any threads
+
+//! Holds stylus BaseIOEvents back for a threshold time after their
+//! timestamps; if a stylus event for the same hole comes along in the
+//! meantime, both are dropped. All other BaseIOEvents pass straight
+//! through. The caller supplies the time and calls expire() once
+//! nextDeadline() is reached. The threshold is either fixed or, with
+//! setAdaptiveThreshold(), learned hole by hole by a StylusNoiseProfile.
+//! Not thread safe.
+class ShortStylusFilter {
+public:
+  //! Constructor
+  ShortStylusFilter(const TimeInterval &my_threshold=0.75);
+
+  //! Destructor
+  ~ShortStylusFilter();
+
+  //! Filter events arriving at time now, in place
+
+  //! Stylus events are taken out of events to be held back; anything held
+  //! back that has now been held long enough is appended to events.
+  void filter(std::deque<BaseIOEvent> &events, const TimeInterval &now);
+
+  //! Append held-back events that have been held long enough as of now
+  void expire(std::deque<BaseIOEvent> &events, const TimeInterval &now);
+
+  //! Find when expire() next has events to release
+
+  //! Returns false if no events are held back.
+  bool nextDeadline(TimeInterval &deadline) const;
+
+  //! Set a fixed insertion/withdrawal-time threshold for stylus events
+
+  //! Stops any adaptation begun by setAdaptiveThreshold().
+  void setThreshold(const TimeInterval &my_threshold);
+
+  //! Retrieve the fixed threshold (the upper bound when adaptive)
+  inline const TimeInterval &getThreshold() const { return threshold; }
+
+  //! Learn a threshold for each hole from the noise it makes
+
+  //! Each hole's threshold starts at max_threshold and falls as low as
+  //! min_threshold as the hole proves clean; see StylusNoiseProfile. Calling
+  //! this again starts learning afresh. Will throw a BT_EDOM BTException
+  //! unless 0 < min_threshold <= max_threshold.
+  void setAdaptiveThreshold(const TimeInterval &min_threshold,
+			    const TimeInterval &max_threshold);
+
+  //! The noise profile being learned, or NULL if the threshold is fixed
+  inline StylusNoiseProfile *profile() { return noise.get(); }
+  //! The noise profile being learned, or NULL if the threshold is fixed
+  inline const StylusNoiseProfile *profile() const { return noise.get(); }
+
+private:
+  //! Fixed insertion/extraction time threshold for debouncing
+  TimeInterval threshold;
+
+  //! Per-hole noise statistics when the threshold is adaptive
+  boost::scoped_ptr<StylusNoiseProfile> noise;
+
+  //! Stylus events being held back, oldest first
+  std::list<BaseIOEvent> held;
+
+  //! How long a stylus event should be held back
+  inline TimeInterval holdTime(const BaseIOEvent &event) const
+  { return noise ? noise->threshold(event.cell, event.dot) : threshold; }
+
+  //! Drop pairs of held-back events for the same hole
+  void annihilate();
+};
+
 //! Filters out spurious stylus-related BaseIOEvents
 
 //! Some BrailleTutors generate spurious stylus events---when hands are
@@ -38,8 +116,27 @@ class ShortStylusSuppressor
 : public BaseIOEventHandler, public boost::noncopyable {
 public:
   //! Constructor
+
+  //! Events are passed on from a thread of this object's own, and another
+  //! thread waits out the threshold.
   ShortStylusSuppressor(const TimeInterval &threshold=0.75);
 
+  //! Constructor for a threaded suppressor keeping time by clock
+
+  //! Don't destroy clock before this object.
+  ShortStylusSuppressor(Clock &clock, const TimeInterval &threshold=0.75);
+
+  //! Constructor for a suppressor that runs inline, with no threads
+
+  //! Events are filtered and passed on to the BaseIOEventHandler on the
+  //! thread that supplies them, and held-back events are passed on from the
+  //! timers thread, which may be shared with other inline event handlers
+  //! (e.g. an IOEventParser further down the chain). The handler therefore
+  //! shouldn't dawdle. Time is kept by the timers' clock. Don't destroy
+  //! timers before this object.
+  ShortStylusSuppressor(TimerService &timers,
+			const TimeInterval &threshold=0.75);
+
   //! Register a BaseIOEventHandler with this ShortStylusSuppressor.
   void setBaseIOEventHandler(BaseIOEventHandler &bioeh);
 
@@ -47,8 +144,33 @@ public:
   void pollBaseIOEvents(BaseIOEventHandler &bioeh);
 
   //! Set the minimum insertion/withdrawal-time threshold for stylus events
+
+  //! Stops any adaptation begun by setAdaptiveThreshold().
   void setThreshold(const TimeInterval &threshold);
 
+  //! Learn a threshold for each hole from the noise it makes
+
+  //! Events from clean holes are held back for as little as min_threshold;
+  //! those from noisy holes for up to max_threshold, which is also where
+  //! every hole starts out. See StylusNoiseProfile for how it's learned.
+  //! Calling this again starts learning afresh. Will throw a BT_EDOM
+  //! BTException unless 0 < min_threshold <= max_threshold.
+  void setAdaptiveThreshold(const TimeInterval &min_threshold,
+			    const TimeInterval &max_threshold);
+
+  //! Load a noise profile saved by saveNoiseProfile()
+
+  //! Lets a board pick up where it left off, rather than relearning from
+  //! max_threshold. Will throw a BT_EINVAL BTException if the threshold
+  //! isn't adaptive, or any exception StylusNoiseProfile::read() throws.
+  void loadNoiseProfile(const std::string &filename);
+
+  //! Save the noise profile learned so far
+
+  //! Will throw a BT_EINVAL BTException if the threshold isn't adaptive, or
+  //! any exception StylusNoiseProfile::write() throws.
+  void saveNoiseProfile(const std::string &filename);
+
   //! BaseIOEvent handler callback
   virtual void operator()(std::deque<BaseIOEvent> &events);
 
@@ -56,8 +178,9 @@ public:
   virtual ~ShortStylusSuppressor();
 
 private:
-  // Allow one of the thread classes to access our innards
+  // Allow one of the thread classes and the core to access our innards
   friend class FunctorNewEventsSSSC;
+  friend class ShortStylusSuppressorCore;
 
   //! Pointer to the current BaseIOEventHandler object
   BaseIOEventHandler *handler;
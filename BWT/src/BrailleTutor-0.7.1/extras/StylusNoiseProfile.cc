@@ -0,0 +1,194 @@
+/*
+ * Braille Tutor interface library
+ * StylusNoiseProfile.cc, started 19 October 2026
+ *
+ * Implements the per-hole stylus noise statistics behind the adaptive
+ * ShortStylusSuppressor, and their persistence.
+ */
+
+#include <string>
+#include <fstream>
+#include <sstream>
+#include <iostream>
+#include <algorithm>
+
+#include "Types.h"
+#include "StylusNoiseProfile.h"
+
+namespace BrailleTutorNS {
+
+//! Header line of a saved profile
+static const char *profile_header = "!STYLUS NOISE PROFILE 1";
+//! Footer line of a saved profile
+static const char *profile_footer = "!END";
+
+// Constructor
+StylusNoiseProfile::StylusNoiseProfile(const TimeInterval &my_min_threshold,
+				       const TimeInterval &my_max_threshold,
+				       const double &my_margin,
+				       const double &my_decay)
+: min_threshold(my_min_threshold), max_threshold(my_max_threshold),
+  margin(my_margin), decay(my_decay)
+{
+  if((min_threshold <= 0.0) || (max_threshold < min_threshold))
+    throw BTException(BTException::BT_EDOM,
+		      "stylus noise thresholds must satisfy 0 < min <= max");
+  if(margin < 1.0)
+    throw BTException(BTException::BT_EDOM,
+		      "stylus noise margin must be at least 1");
+  if((decay <= 0.0) || (decay > 1.0))
+    throw BTException(BTException::BT_EDOM,
+		      "stylus noise decay must be in (0, 1]");
+  reset();
+}
+
+// Learn from a raw stylus event
+void StylusNoiseProfile::observe(const BaseIOEvent &event)
+{
+  if((event.type != BaseIOEvent::STYLUS_DOWN) &&
+     (event.type != BaseIOEvent::STYLUS_UP)) return;
+  const unsigned int s = slot(event.cell, event.dot);
+  if(s == NUM_CELLS*DOTS_PER_CELL) return;
+
+  // Time the interval since the hole's last event. Repeated insertions or
+  // withdrawals come only from corrupt input, and teach us nothing.
+  const BaseIOEvent::Type prev_type = last_type[s];
+  const double interval = (double) (event.timestamp - last_edge[s]);
+  last_type[s] = event.type;
+  last_edge[s] = event.timestamp;
+  if((prev_type == BaseIOEvent::DONE) || (prev_type == event.type)) return;
+
+  HoleStats &hole = holes[s];
+  const bool noise = interval < max_threshold;
+
+  // A withdrawal completes a contact; old noise fades a little with each
+  if(event.type == BaseIOEvent::STYLUS_UP) {
+    ++hole.contacts;
+    hole.ceiling *= decay;
+    if(noise) ++hole.shorts;
+  }
+  // An insertion ends a gap
+  else if(noise) ++hole.bounces;
+
+  if(noise) hole.ceiling = std::max(hole.ceiling, interval);
+}
+
+// How long a stylus event in a hole should be held back
+TimeInterval StylusNoiseProfile::threshold(const unsigned short int &cell,
+					   const unsigned char &dot) const
+{
+  const unsigned int s = slot(cell, dot);
+  if(s == NUM_CELLS*DOTS_PER_CELL) return TimeInterval(max_threshold);
+
+  const HoleStats &hole = holes[s];
+  if(hole.contacts < MIN_SAMPLES) return TimeInterval(max_threshold);
+  return TimeInterval(std::min(max_threshold,
+			       std::max(min_threshold, hole.ceiling * margin)));
+}
+
+// Statistics for a hole
+const StylusNoiseProfile::HoleStats &
+StylusNoiseProfile::stats(const unsigned short int &cell,
+			  const unsigned char &dot) const
+{
+  const unsigned int s = slot(cell, dot);
+  if(s == NUM_CELLS*DOTS_PER_CELL)
+    throw BTException(BTException::BT_EINVAL,
+		      "hole is outside the stylus noise profile");
+  return holes[s];
+}
+
+// Forget everything learned so far
+void StylusNoiseProfile::reset()
+{
+  for(unsigned int s=0; s<NUM_CELLS*DOTS_PER_CELL; ++s) {
+    holes[s].contacts = holes[s].shorts = holes[s].bounces = 0;
+    holes[s].ceiling = 0.0;
+    last_type[s] = BaseIOEvent::DONE;
+  }
+}
+
+// Load statistics saved by write()
+void StylusNoiseProfile::read(std::istream &in)
+{
+  // Read into a scratch copy, so malformed input changes nothing
+  HoleStats loaded[NUM_CELLS*DOTS_PER_CELL];
+  for(unsigned int s=0; s<NUM_CELLS*DOTS_PER_CELL; ++s) {
+    loaded[s].contacts = loaded[s].shorts = loaded[s].bounces = 0;
+    loaded[s].ceiling = 0.0;
+  }
+
+  std::string line;
+  if(!std::getline(in, line) || (line != profile_header))
+    throw BTException(BTException::BT_EINVAL,
+		      "stylus noise profile has a bad header");
+
+  for(;;) {
+    if(!std::getline(in, line))
+      throw BTException(BTException::BT_EINVAL,
+			"stylus noise profile is truncated");
+    if(line == profile_footer) break;
+
+    // Each line: cell dot contacts shorts bounces ceiling
+    std::istringstream fields(line);
+    unsigned int cell, dot;
+    HoleStats hole;
+    if(!(fields >> cell >> dot >> hole.contacts >> hole.shorts
+		>> hole.bounces >> hole.ceiling) ||
+       (slot(cell, dot) == NUM_CELLS*DOTS_PER_CELL) || (hole.ceiling < 0.0))
+      throw BTException(BTException::BT_EINVAL,
+			"stylus noise profile has a bad line: " + line);
+    loaded[slot(cell, dot)] = hole;
+  }
+
+  // All good; take the statistics. The transient state is left alone.
+  std::copy(loaded, loaded + NUM_CELLS*DOTS_PER_CELL, holes);
+}
+
+// Load statistics from a file
+void StylusNoiseProfile::read(const std::string &filename)
+{
+  std::ifstream in(filename.c_str());
+
+  if(!in.good())
+    throw BTException(BTException::BT_EIO,
+		      std::string("failed to open file ") + filename +
+		      " for reading");
+
+  read(in);
+}
+
+// Save the statistics learned so far
+void StylusNoiseProfile::write(std::ostream &out) const
+{
+  // Enough digits that read() gets back exactly the ceilings written
+  const std::streamsize old_precision = out.precision(17);
+  out << profile_header << std::endl;
+
+  // Only holes that have seen something
+  for(unsigned int s=0; s<NUM_CELLS*DOTS_PER_CELL; ++s) {
+    const HoleStats &hole = holes[s];
+    if((hole.contacts == 0) && (hole.bounces == 0)) continue;
+    out << s / DOTS_PER_CELL << ' ' << s % DOTS_PER_CELL << ' '
+	<< hole.contacts << ' ' << hole.shorts << ' ' << hole.bounces << ' '
+	<< hole.ceiling << std::endl;
+  }
+
+  out << profile_footer << std::endl;
+  out.precision(old_precision);
+}
+
+// Save the statistics to a file
+void StylusNoiseProfile::write(const std::string &filename) const
+{
+  std::ofstream out(filename.c_str());
+
+  if(!out.good())
+    throw BTException(BTException::BT_EIO,
+		      std::string("failed to open file ") + filename +
+		      " for writing");
+
+  write(out);
+}
+
+} // namespace BrailleTutorNS
@@ -0,0 +1,122 @@
+#ifndef _STYLUS_NOISE_PROFILE_H_
+#define _STYLUS_NOISE_PROFILE_H_
+/*
+ * Braille Tutor interface library
+ * StylusNoiseProfile.h, started 19 October 2026
+ *
+ * Per-hole statistics on the spurious contacts a Tutor board makes, learned
+ * online from its raw stylus events. Most of a board's noise usually comes
+ * from a few worn holes; a StylusNoiseProfile lets a ShortStylusSuppressor
+ * hold back events from those holes for as long as their noise lasts, while
+ * letting events from clean holes through almost at once. Profiles can be
+ * saved and reloaded, so a board needn't be relearned every session.
+ */
+
+#include <string>
+#include <iostream>
+
+#include "Types.h"
+
+namespace BrailleTutorNS {
+
+//! Learns, hole by hole, how long a stylus event must last to be trusted
+
+//! Feed observe() every raw stylus event, in timestamp order. For each
+//! hole, it times each contact (insertion to withdrawal) and each gap
+//! (withdrawal to reinsertion). Intervals shorter than the maximum threshold
+//! are counted as noise: short contacts and bounces respectively. The
+//! hole's noise ceiling tracks the longest such interval, decaying by a
+//! constant factor with each contact, so a hole that bounces often stays
+//! high and one that has a rare glitch soon falls back. A hole's threshold
+//! is its ceiling times a margin, kept between the minimum and maximum
+//! thresholds; until a hole has seen MIN_SAMPLES contacts, it's the maximum.
+//! Holes outside the Tutor's geometry always get the maximum. Not thread
+//! safe.
+class StylusNoiseProfile {
+public:
+  //! Number of cells the profile has room for
+  static const unsigned int NUM_CELLS = 32;
+  //! Number of dots per cell the profile has room for
+  static const unsigned int DOTS_PER_CELL = 8;
+  //! Number of contacts a hole must see before its threshold adapts
+  static const unsigned int MIN_SAMPLES = 4;
+
+  //! What the profile knows about one hole
+  struct HoleStats {
+    unsigned long contacts;	//!< Contacts (insertion+withdrawal) seen
+    unsigned long shorts;	//!< Contacts shorter than the max threshold
+    unsigned long bounces;	//!< Gaps shorter than the max threshold
+    double ceiling;		//!< Decaying longest noise interval, in secs
+  };
+
+  //! Constructor
+
+  //! Will throw a BT_EDOM BTException unless 0 < min_threshold <=
+  //! max_threshold, margin >= 1, and 0 < decay <= 1.
+  StylusNoiseProfile(const TimeInterval &my_min_threshold=TimeInterval(0, 30),
+		     const TimeInterval &my_max_threshold=TimeInterval(0, 300),
+		     const double &my_margin=1.5,
+		     const double &my_decay=0.95);
+
+  //! Learn from a raw STYLUS_DOWN or STYLUS_UP event; others are ignored
+  void observe(const BaseIOEvent &event);
+
+  //! How long a stylus event in a hole should be held back
+  TimeInterval threshold(const unsigned short int &cell,
+			 const unsigned char &dot) const;
+
+  //! Statistics for a hole. Will throw a BT_EINVAL BTException if the hole
+  //! is outside the profile.
+  const HoleStats &stats(const unsigned short int &cell,
+			 const unsigned char &dot) const;
+
+  //! Lower bound on thresholds
+  inline TimeInterval getMinThreshold() const { return min_threshold; }
+  //! Upper bound on thresholds
+  inline TimeInterval getMaxThreshold() const { return max_threshold; }
+
+  //! Forget everything learned so far, e.g. when a new board is connected
+  void reset();
+
+  //! Load statistics saved by write(), replacing those learned so far
+
+  //! Will throw a BT_EINVAL BTException if the input is malformed, in which
+  //! case the profile is left alone.
+  void read(std::istream &in);
+  //! Load statistics from a file; will throw a BT_EIO BTException if the
+  //! file can't be opened, or BT_EINVAL as above
+  void read(const std::string &filename);
+
+  //! Save the statistics learned so far
+  void write(std::ostream &out) const;
+  //! Save the statistics to a file; will throw a BT_EIO BTException if the
+  //! file can't be opened
+  void write(const std::string &filename) const;
+
+private:
+  //! Lower bound on thresholds, in seconds
+  double min_threshold;
+  //! Upper bound on thresholds, in seconds
+  double max_threshold;
+  //! Factor applied to a hole's noise ceiling
+  double margin;
+  //! Factor the noise ceiling decays by with each contact
+  double decay;
+
+  //! Statistics for each hole
+  HoleStats holes[NUM_CELLS*DOTS_PER_CELL];
+  //! Time of the last event seen in each hole
+  TimeInterval last_edge[NUM_CELLS*DOTS_PER_CELL];
+  //! Type of the last event seen in each hole; DONE if none yet
+  BaseIOEvent::Type last_type[NUM_CELLS*DOTS_PER_CELL];
+
+  //! Index of a hole's slot, or NUM_CELLS*DOTS_PER_CELL if there's none
+  static inline unsigned int slot(const unsigned short int &cell,
+				  const unsigned char &dot)
+  { return ((cell < NUM_CELLS) && (dot < DOTS_PER_CELL)) ?
+	   cell*DOTS_PER_CELL + dot : NUM_CELLS*DOTS_PER_CELL; }
+};
+
+} // namespace BrailleTutorNS
+
+#endif
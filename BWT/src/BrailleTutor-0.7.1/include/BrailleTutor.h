@@ -16,9 +16,11 @@
  */
 
 #include "Types.h"
+#include "Clock.h"
 
 #include <deque>
 #include <string>
+#include <iosfwd>
 
 #include <boost/utility.hpp>
 #include <boost/thread/mutex.hpp>
@@ -45,6 +47,11 @@ public:
   //! behavior of our thread library (Boost::Thread).
   BrailleTutor();
 
+  //! Constructor for a Braille Tutor whose events are timed by clock
+
+  //! Don't destroy clock before this object.
+  BrailleTutor(Clock &clock);
+
   //! Initializes internal resources
 
   //! Initializes internal resources. This method must be called once before
@@ -139,6 +146,49 @@ public:
   //! the reset has succeeded and false otherwise.
   bool resetSoft();
 
+  //! Enable or disable recovery from corrupt bytes sent by the Tutor
+
+  //! With error recovery on (the default), a byte the internal model of the
+  //! Tutor can't make sense of causes the model to discard input up to the
+  //! next frame boundary in the Tutor protocol and carry on from there,
+  //! instead of killing the I/O threads with an exception. Noisy cables
+  //! then cost a few lost bytes (counted; see getResyncStats()) rather
+  //! than a crash or a reset.
+  void setErrorRecovery(const bool &recover);
+
+  //! Report how much corrupt input the Tutor model has recovered from
+
+  //! Fills resyncs with the number of times the internal model of the Tutor
+  //! has resynchronised after a parse error, and dropped with the total
+  //! number of bytes from the Tutor it discarded in doing so.
+  void getResyncStats(unsigned int &resyncs, unsigned long &dropped);
+
+  //! Report how many indications for nonexistent buttons or holes were seen
+
+  //! The Tutor's geometry is fixed; stylus or button activity reported
+  //! outside of it can only come from corrupt input, and is ignored rather
+  //! than passed on as BaseIOEvent events. This method says how often.
+  unsigned long getStrayContacts();
+
+  //! Write recent activity of the internal Tutor model to a stream
+
+  //! The BrailleTutor object keeps a record of the last few thousand
+  //! transitions of its internal model of the Tutor: states, bytes from
+  //! the Tutor, and indications of stylus and button activity, all with
+  //! timestamps. This method writes the whole record to out, oldest first.
+  void dumpTrace(std::ostream &out);
+
+  //! Choose where activity records are written when the Tutor model fails
+
+  //! Whenever the internal model of the Tutor chokes on its input, the
+  //! transitions recorded since the last such failure are written to out
+  //! (std::cerr by default), at most once a second; failures in between
+  //! are counted in the next dump. Pass NULL to turn off these automatic
+  //! dumps.
+  //! As with handlers, the BrailleTutor object does NOT keep its own copy
+  //! of out, so keep the stream around while it's in use.
+  void setTraceDump(std::ostream *out);
+
   //! Deconstructor and cleanup
   ~BrailleTutor();
 
@@ -158,6 +208,9 @@ private:
   //! Pointer to the current BaseIOEventHandler object
   BaseIOEventHandler *handler;
 
+  //! The clock events are timed by
+  Clock &clock;
+
   //! Checks whether init has been called; otherwise throws an exception.
   void checkReady();
 
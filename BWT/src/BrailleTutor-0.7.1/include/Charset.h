@@ -20,35 +20,46 @@
  * the portability buck, but a little bit.
  */
 
+#include <set>
 #include <map>
 #include <string>
 #include <vector>
 #include <iostream>
 #include <stdint.h>
 
-#include <boost/shared_array.hpp>
+#include <boost/shared_ptr.hpp>
 
 namespace BrailleTutorNS {
 
 //! Character/"wide char" structures to which Braille dot patterns are mapped.
 
-//! Dot patterns are mapped to GlyphMapping objects, which contain pointers
-//! to both a regular null-terminated char array and an array of 32-bit
-//! unsigned ints (also null-terminated). The unsigned ints are made by
-//! converting the char array bytes as if they are UTF-8. You may be able
-//! to cast the unsigned int string to a wchar_t string on your platform;
-//! otherwise you should be able to convert it to one without much trouble.
+//! Dot patterns are mapped to GlyphMapping objects, which contain both a
+//! regular null-terminated char array and an array of 32-bit unsigned ints
+//! (also null-terminated). The unsigned ints are made by converting the
+//! char array bytes as if they are UTF-8. You may be able to cast the
+//! unsigned int string to a wchar_t string on your platform; otherwise you
+//! should be able to convert it to one without much trouble.
 //!
-//! The smart pointers in a GlyphMapping object may point to the same strings
-//! as the pointers in other GlyphMapping objects. Change these strings with
-//! caution, or best not at all.
+//! Short glyphs (which is to say nearly all of them; every glyph in the
+//! stock language mapping files is one) are stored inside the GlyphMapping
+//! itself. Longer ones live in immutable storage shared by all copies of
+//! the GlyphMapping; Charset objects intern the long glyphs they hold so
+//! that equal glyphs share storage too. Either way, copying a GlyphMapping
+//! never allocates memory, and the strings it contains can't be changed.
 struct GlyphMapping {
+  //! Glyphs with fewer UTF-8 bytes than this are candidates to be inline
+  static const unsigned int INLINE_BYTES = 16;
+  //! Glyphs with fewer 32-bit characters than this are candidates too
+  static const unsigned int INLINE_CHARS = 8;
+
   //! Character string to which a Braille dot pattern is mapped
-  boost::shared_array<uint8_t> str; // NB: You may have to cast to char*.
+  inline const uint8_t *str() const // NB: You may have to cast to char*.
+  { return long_glyph ? &long_glyph->str[0] : in_str; }
 
   //! 32-bit unsigned null-terminated "string" to which a Braille dot pattern
   //! is mapped
-  boost::shared_array<uint32_t> str_w;
+  inline const uint32_t *str_w() const
+  { return long_glyph ? &long_glyph->str_w[0] : in_str_w; }
 
   //! Equality test for GlyphMapping objects (compares the str member)
   bool equals(const GlyphMapping &gm) const;
@@ -61,9 +72,26 @@ struct GlyphMapping {
   bool lt(const GlyphMapping &gm) const;
 
 private:
+  //! Shared storage for glyphs too long to keep inline
+  struct LongGlyph {
+    std::vector<uint8_t> str;	//!< Null-terminated UTF-8 string
+    std::vector<uint32_t> str_w;	//!< Null-terminated 32-bit string
+  };
+
+  //! Inline storage for the UTF-8 string of a short glyph
+  uint8_t in_str[INLINE_BYTES];
+  //! Inline storage for the 32-bit string of a short glyph
+  uint32_t in_str_w[INLINE_CHARS];
+  //! Storage for a long glyph; if NULL, the glyph is stored inline
+  boost::shared_ptr<const LongGlyph> long_glyph;
+
   //! Shared routine initializing a GlyphMapping from a character string
   void initFromStr(const uint8_t *my_str);
 
+  //! Store strings of the given lengths inline, or else in a new LongGlyph
+  void store(const uint8_t *my_str, const unsigned int &len,
+	     const uint32_t *my_str_w, const unsigned int &len_w);
+
 public:
 
   //! Constructor: converts an array of 32-bit ints to a GlyphMapping.
@@ -80,19 +108,24 @@ public:
   inline GlyphMapping(const char *my_str) {initFromStr((uint8_t *) my_str); }
 
   //! Constructor: creates an "empty mapping"
-  inline GlyphMapping()
-  : str(new uint8_t[1]), str_w(new uint32_t[1]) { str[0] = 0; str_w[0] = 0; }
+  inline GlyphMapping() { in_str[0] = 0; in_str_w[0] = 0; }
+
+  //! Returns a GlyphMapping that shares no storage with this GlyphMapping
 
-  //! Returns a GlyphMapping whose pointers point at new copies of this
-  //! GlyphMapping's information
+  //! Since GlyphMapping strings are immutable, this is seldom needed; it's
+  //! mainly of use for keeping long glyphs from pinning a Charset's intern
+  //! table in memory.
   GlyphMapping dup() const;
 
   //! Returns an approximate std::string version of this GlyphMapping.
   //! Useful only for ASCII strings.
-  inline operator std::string() const { return std::string((char*) str.get()); }
+  inline operator std::string() const { return std::string((char*) str()); }
 
   //! Returns true if this GlyphMapping is the empty mapping
-  inline bool isEmpty() const { return *(str.get()) == 0; }
+  inline bool isEmpty() const { return *str() == 0; }
+
+  //! Returns true if this GlyphMapping's strings are stored inline
+  inline bool isInline() const { return !long_glyph; }
 };
 
 //! GlyphMapping infix equality operator
@@ -117,10 +150,130 @@ private:
   //! Name of this character set. A GlyphMapping object works fine here too.
   GlyphMapping name;
 
+  //! Number of slots in the letter index: twice the most letters there can
+  //! be, so probe sequences stay short
+  static const unsigned int INDEX_SLOTS = 512;
+
+  //! A slot in the letter index
+  struct IndexSlot {
+    uint8_t tag;	//!< Top byte of the letter's hash (never 0); 0 if empty
+    uint8_t dots;	//!< Dot pattern mapped to the letter
+  };
+
   //! Mapping from cell dot pattern bitmaps to letters
   GlyphMapping dots_to_letters[256];
   //! Mapping from letters to cell dot pattern bitmaps
-  std::map<GlyphMapping, unsigned char> letters_to_dots;
+
+  //! An open-addressing hash table over the letters' UTF-8 bytes, probed
+  //! linearly. A slot stores only a dot pattern; the letter is the one
+  //! dots_to_letters has for it, and the tag lets most probes skip comparing
+  //! strings. Kept up to date by set(), so lookups never walk a tree.
+  IndexSlot letter_index[INDEX_SLOTS];
+  //! Number of letters in letter_index
+  unsigned int num_letters;
+  //! Long glyphs set in this character set, so that equal ones share storage
+  std::set<GlyphMapping> interned;
+  //! For each dot pattern, whether it's mapped and no added dots are
+  //! (see isSettled())
+  bool settled[256];
+  //! Dot pattern mapped to each one-byte (ASCII) letter, or INVALID_DOTS,
+  //! so transcode() can look ASCII text up without hashing it
+  unsigned char ascii_dots[128];
+
+public:
+  //! Most patterns nearest() reports for one written pattern
+  static const unsigned int MAX_NEAREST = 4;
+
+  //! The mapped dot patterns nearest to a written one (see nearest())
+  struct Nearest {
+    uint8_t count;		//!< Patterns in dots; 0 if nothing else is mapped
+    uint8_t distance;		//!< Their dotDistance() from the written pattern
+    uint8_t mirrored;		//!< Bit i is set if dots[i] is that near only
+				//!< to the written pattern's mirror image
+    uint8_t dots[MAX_NEAREST];	//!< The nearest patterns, lowest first
+
+    //! Dots to add or remove to turn written (its mirror image, if
+    //! dots[i] is mirrored) into dots[i]
+    unsigned char differences(const unsigned char &written,
+			      const unsigned int &i) const;
+  };
+
+private:
+  //! The nearest mapped patterns to each of the 256 dot patterns
+  Nearest nearest_table[256];
+
+  //! Recompute the settled table after the mapping changes
+  void updateSettled();
+
+  //! Recompute the ASCII table after the mapping changes
+  void updateAscii();
+
+  //! Recompute the nearest pattern table after the mapping changes
+  void updateNearest();
+
+  //! Recompute the settled, ASCII and nearest pattern tables at once
+  inline void updateTables()
+  { updateSettled(); updateAscii(); updateNearest(); }
+
+  //! Change the mapping and letter index as set() does, leaving the other
+  //! tables to the caller: bulk loads change many mappings, then call
+  //! updateTables() once
+  void assign(const unsigned char &dots, const GlyphMapping &letter);
+
+  //! Weight of each of the 256 dot patterns, for dotDistance()
+  static const unsigned char dot_weights[256];
+
+  //! Hash of a letter's UTF-8 bytes (FNV-1a)
+  static inline uint32_t hash(const GlyphMapping &letter)
+  { uint32_t h = 2166136261u;
+    for(const uint8_t *c = letter.str(); *c; ++c) h = (h ^ *c) * 16777619u;
+    return h ^ (h >> 16); }
+
+  //! Hash of length UTF-8 bytes; the same as hash() of a letter made of
+  //! them
+  static inline uint32_t hash(const uint8_t *bytes, const size_t &length)
+  { uint32_t h = 2166136261u;
+    for(size_t i=0; i<length; ++i) h = (h ^ bytes[i]) * 16777619u;
+    return h ^ (h >> 16); }
+
+  //! The letter index slot a hash starts probing at
+  static inline unsigned int homeSlot(const uint32_t &h)
+  { return h & (INDEX_SLOTS-1); }
+
+  //! The letter index tag for a hash
+  static inline uint8_t tagOf(const uint32_t &h)
+  { return (h >> 24) ? (h >> 24) : 1; }
+
+  //! The letter index slot holding letter, or the empty slot ending its
+  //! probe sequence if it isn't there
+  inline unsigned int probe(const GlyphMapping &letter) const
+  { const uint32_t h = hash(letter);
+    const uint8_t tag = tagOf(h);
+    for(unsigned int s=homeSlot(h);; s=(s+1) & (INDEX_SLOTS-1)) {
+      const IndexSlot &slot = letter_index[s];
+      if((slot.tag == 0) ||
+	 ((slot.tag == tag) && dots_to_letters[slot.dots].equals(letter)))
+	return s; } }
+
+  //! The letter index slot holding the letter made of length UTF-8 bytes,
+  //! or the empty slot ending its probe sequence if it isn't there
+  inline unsigned int probe(const uint8_t *bytes, const size_t &length) const
+  { const uint32_t h = hash(bytes, length);
+    const uint8_t tag = tagOf(h);
+    for(unsigned int s=homeSlot(h);; s=(s+1) & (INDEX_SLOTS-1)) {
+      const IndexSlot &slot = letter_index[s];
+      if(slot.tag == 0) return s;
+      if(slot.tag != tag) continue;
+      const uint8_t *str = dots_to_letters[slot.dots].str();
+      size_t i = 0;
+      while((i < length) && (str[i] != 0) && (str[i] == bytes[i])) ++i;
+      if((i == length) && (str[i] == 0)) return s; } }
+
+  //! Add letter, mapped from dots, to the letter index (or remap it)
+  void index(const GlyphMapping &letter, const unsigned char &dots);
+
+  //! Remove letter from the letter index if it's mapped from dots there
+  void unindex(const GlyphMapping &letter, const unsigned char &dots);
 
 public:
   //! Constructor. Creates a new empty mapping.
@@ -137,13 +290,32 @@ public:
   inline static Charset fromFile(const std::string &filename)
   { Charset c(""); c.read(filename); return c; }
 
+  //! Named constructor. Loads a character set compiled by writeCompiled().
+  //! Throws as readCompiled() does.
+  inline static Charset fromCompiledFile(const std::string &filename)
+  { Charset c(""); c.readCompiled(filename); return c; }
+
+  //! Named constructor. Loads a text mapping file, from its compiled image
+  //! if there is one that's up to date
+
+  //! The compiled image is the file named by compiledFilename(filename). It
+  //! is used if it's no older than the text file and loads without error;
+  //! otherwise the text file is parsed as fromFile() would. Errors in the
+  //! text file are silently ignored.
+  static Charset load(const std::string &filename);
+
+  //! Name of the compiled image of a text mapping file: the same name,
+  //! with a .btc extension in place of any .txt one
+  static std::string compiledFilename(const std::string &filename);
+
   //! Clear out the entire mapping
   inline void clear()
   { for(unsigned int i=0; i<256; ++i) dots_to_letters[i] = GlyphMapping();
-    letters_to_dots.clear(); }
+    for(unsigned int s=0; s<INDEX_SLOTS; ++s) letter_index[s].tag = 0;
+    num_letters = 0; interned.clear(); updateTables(); }
 
   //! The number of entries in this mapping
-  inline unsigned int size() { return letters_to_dots.size(); }
+  inline unsigned int size() const { return num_letters; }
 
   //! Retrieve the name of this character set
   inline const GlyphMapping &getName() const { return name; }
@@ -157,6 +329,11 @@ public:
   //! the empty GlyphMapping (e.g. GlyphMapping()).
   void set(const unsigned char &dots, const GlyphMapping &letter);
 
+  //! Returns a GlyphMapping equal to letter that shares storage with any
+  //! equal long glyph in this character set. Long glyphs not already in
+  //! the character set are added to its intern table.
+  GlyphMapping intern(const GlyphMapping &letter);
+
   //! Retrieve the letter onto which the dot pattern argument is mapped
 
   //! Retrieve the letter onto which the dot pattern argument is mapped. An
@@ -164,14 +341,93 @@ public:
   inline const GlyphMapping &operator[](const unsigned char &dots) const
   { return dots_to_letters[dots]; }
 
+  //! Returns true if no more dots can change the letter a pattern makes
+
+  //! Returns true if the dot pattern maps to a letter and no pattern made
+  //! by adding dots to it does. Once a glyph under construction is settled,
+  //! the user can't be on the way to some other letter, so the letter can
+  //! be reported before the glyph is complete. The table behind this is
+  //! kept for all 256 patterns, so it serves 6-dot and 8-dot sets alike.
+  inline bool isSettled(const unsigned char &dots) const
+  { return settled[dots]; }
+
+  //! Cost of writing a letter as its mirror image, in dotDistance() units:
+  //! as much as one dot wrong
+  static const unsigned int MIRROR_COST = 2;
+
+  //! Weighted Hamming distance between two dot patterns
+
+  //! Each of dots 1-6 that's in one pattern but not the other costs 2, and
+  //! each of dots 7 and 8 costs 1, so in a 6-dot set a stray dot 7 or 8
+  //! counts for less than a dot missed or added in the cell proper.
+  static inline unsigned int dotDistance(const unsigned char &a,
+					 const unsigned char &b)
+  { return dot_weights[a ^ b]; }
+
+  //! The mapped dot patterns nearest to a written one
+
+  //! Finds the letters a student most likely meant on writing dots: the
+  //! mapped patterns other than dots itself at the least distance from it,
+  //! up to MAX_NEAREST of them. The distance to a pattern is dotDistance()
+  //! from dots, or MIRROR_COST plus dotDistance() from dots' mirror image
+  //! if that's less, since writing a whole letter mirrored is one slip. The
+  //! answers for all 256 patterns are worked out whenever the mapping
+  //! changes, so this is a table lookup, cheap enough to give feedback with
+  //! on every wrong letter. Like operator[](const unsigned char&), this
+  //! takes dots as the character set has them; use DotsMirror::mir() to get
+  //! there from dots as written on the Braille Tutor.
+  inline const Nearest &nearest(const unsigned char &dots) const
+  { return nearest_table[dots]; }
+
   //! Retrieve the dot pattern onto which the letter argument is mapped
 
   //! Retrieve the dot pattern onto which the letter argument is mapped. The
   //! value INVALID_DOTS indicates that no such mapping exists.
   inline const unsigned char &operator[](const GlyphMapping &letter) const
-  { std::map<GlyphMapping, unsigned char>::const_iterator i;
-    i = letters_to_dots.find(letter);
-    if(i==letters_to_dots.end()) return INVALID_DOTS; else return i->second;}
+  { const IndexSlot &slot = letter_index[probe(letter)];
+    return slot.tag ? slot.dots : INVALID_DOTS; }
+
+  //! Retrieve the dot pattern onto which a UTF-8 letter is mapped, as
+  //! operator[](const GlyphMapping&) does, without making a GlyphMapping
+  //! of it first
+  inline unsigned char dotsFor(const std::string &letter) const
+  { if((letter.size() == 1) && ((uint8_t) letter[0] < 0x80))
+      return ascii_dots[(uint8_t) letter[0]];
+    const IndexSlot &slot =
+      letter_index[probe((const uint8_t*) letter.data(), letter.size())];
+    return slot.tag ? slot.dots : INVALID_DOTS; }
+
+  //! Transcode UTF-8 text into dot patterns, one per character
+
+  //! Looks up each character of the length bytes of text as a letter and
+  //! stores the dot patterns in dots, up to max_dots of them. Characters
+  //! with no mapping get INVALID_DOTS. Returns the number of characters in
+  //! text, which can be more than max_dots; like snprintf, call again with
+  //! a bigger buffer if it is. ASCII characters are looked up in a table,
+  //! others in the letter index straight from text's bytes, so no
+  //! GlyphMapping or string is made along the way. Letters of more than one
+  //! character (e.g. contractions) are never matched; to read those, see
+  //! TranslationTable.
+  size_t transcode(const char *text, const size_t &length,
+		   unsigned char *dots, const size_t &max_dots) const;
+
+  //! Transcode a UTF-8 string into dot patterns, one per character; as
+  //! transcode(const char*, const size_t&, unsigned char*, const size_t&)
+  inline size_t transcode(const std::string &text, unsigned char *dots,
+			  const size_t &max_dots) const
+  { return transcode(text.data(), text.size(), dots, max_dots); }
+
+  //! Transcode a list of UTF-8 words into one packed array of dot patterns
+
+  //! Replaces the contents of dots with the dot patterns of all the words,
+  //! one after another, and of starts with the index in dots where each
+  //! word's patterns begin, followed by one more entry: dots.size(). Word i
+  //! is then dots[starts[i]] to dots[starts[i+1]-1]. The vectors' storage
+  //! is reused, so a word list can be transcoded once when it's loaded and
+  //! again whenever the character set changes, without reallocating.
+  void transcode(const std::vector<std::string> &words,
+		 std::vector<unsigned char> &dots,
+		 std::vector<uint32_t> &starts) const;
 
   //! Facilitates lookup/retrieval of mirrored dot patterns
 
@@ -188,19 +444,50 @@ public:
   //! Load a mapping from a UTF-8 input stream. Returns line numbers where
   //! errors were encountered.
   std::vector<unsigned int> read(std::istream &in);
+  //! Load a mapping from a UTF-8 input stream. Returns line numbers where
+  //! errors were encountered, and puts in remapped_lines the numbers of
+  //! lines mapping a dot pattern that an earlier line mapped too (the
+  //! later line wins, which is almost always a typo in the file).
+  std::vector<unsigned int> read(std::istream &in,
+				 std::vector<unsigned int> &remapped_lines);
   //! Load a mapping from a file. Returns line numbers where errors were
   //! encountered. For portability, only throws BT_EIO BTExceptions.
   std::vector<unsigned int> read(const std::string &filename);
+  //! Load a mapping from a file, noting remapped dot patterns as the
+  //! stream version does. For portability, only throws BT_EIO BTExceptions.
+  std::vector<unsigned int> read(const std::string &filename,
+				 std::vector<unsigned int> &remapped_lines);
   //! Write a mapping to a UTF-8 output stream
   void write(std::ostream &out) const;
   //! Write a mapping to a file. For portability, only throws BT_EIO
   //! BTExceptions.
   void write(const std::string &filename) const;
 
+  //! Load a mapping compiled by writeCompiled()
+
+  //! The file is mapped into memory read-only and its tables are copied in
+  //! as they are: there's nothing to parse, the letter index isn't rebuilt,
+  //! and glyphs short enough to be stored inline (see GlyphMapping) need no
+  //! memory allocated. Throws a BT_EIO BTException if the file can't be
+  //! read, or BT_EINVAL if it isn't a compiled charset of this version
+  //! made on a machine with the same byte order; either way, this Charset
+  //! is left alone.
+  void readCompiled(const std::string &filename);
+  //! Write this mapping in the compiled binary format (see CharsetImage.cc).
+  //! Only throws BT_EIO BTExceptions.
+  void writeCompiled(const std::string &filename) const;
+
   //! Returns const reference to a default character set
   static const Charset &defaultCharset();
 };
 
+//! An immutable, shared character set
+
+//! Hand one of these to IOEventParser::setCharset to let the parser keep
+//! the character set alive for as long as it uses it. Since nobody can
+//! change a snapshot, switching character sets means publishing a new one.
+typedef boost::shared_ptr<const Charset> CharsetSnapshot;
+
 //! A class that intercepts and mirrors lookup operations on charsets
 
 //! This class shadows the []-based lookup operations in Charset and
@@ -211,24 +498,30 @@ struct DotsMirror {
   //! Refers to the Charset object to which this mirror is applied
   const Charset &charset;
 
+  //! Mirror images of all 256 dot patterns, indexed by pattern
+  static const unsigned char mirrors[256];
+
   //! Mirrors the positions of Braille dots around the vertical axis
 
   //! Returns a new dot pattern with dots 1,2,3 swapped with dots 4,5,6
   //! and dot 7 swapped with dot 8. Useful for the Braille Tutor itself,
   //! where users must enter the mirror image of Braille dots into the
-  //! slate cells.
-  static const unsigned char mir(const unsigned char &dots)
-  { return ((dots & 0x07) << 3) | ((dots & 0x38) >> 3) |
-	   ((dots & 0x80) >> 1) | ((dots & 0x40) << 1); }
+  //! slate cells. Looked up in a precomputed table.
+  static inline const unsigned char mir(const unsigned char &dots)
+  { return mirrors[dots]; }
 
   //! Does Charset::operator[](const unsigned char&) with the dots mirrored
   inline const GlyphMapping &operator[](const unsigned char &dots) const
   { return charset[mir(dots)]; }
 
-  //! Does Charset::operator[](const std::wstring&) with the dots mirrored
+  //! Does Charset::isSettled() with the dots mirrored
+  inline bool isSettled(const unsigned char &dots) const
+  { return charset.isSettled(mir(dots)); }
+
+  //! Does Charset::operator[](const std::wstring&) with the dots mirrored.
+  //! (INVALID_DOTS is its own mirror image.)
   inline const unsigned char operator[](const GlyphMapping &letter) const
-  { const unsigned char orig = charset[letter];
-    if(orig == INVALID_DOTS) return INVALID_DOTS; else return mir(orig); }
+  { return mir(charset[letter]); }
 
   //! Constructor: sets our const reference to the current charset
   inline DotsMirror(const Charset &my_charset) : charset(my_charset) { }
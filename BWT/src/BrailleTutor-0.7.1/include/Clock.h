@@ -0,0 +1,148 @@
+#ifndef _LIBBT_CLOCK_H_
+#define _LIBBT_CLOCK_H_
+/*
+ * Braille Tutor interface library
+ * Clock.h, started 19 October 2026
+ *
+ * Where the library's threads get the time and wait for it to pass. The
+ * real clock is TimeInterval::now(); a VirtualClock stands still until a
+ * test harness moves it on, so that timing-dependent behaviour (debouncing,
+ * glyph delays) can be reproduced exactly and a long session can be
+ * simulated in a fraction of the time it would really take.
+ */
+
+#include <vector>
+
+#include "Types.h"
+
+#include <boost/thread/condition.hpp>
+#include <boost/thread.hpp>
+#include <boost/utility.hpp>
+
+namespace BrailleTutorNS {
+
+// Predeclaration
+class TimerService;
+
+//! Abstract source of time, and of timed waits on that time
+
+//! Everything in the library that timestamps or waits takes its time from
+//! a Clock: BrailleTutor, IOEventParser, ShortStylusSuppressor and
+//! TimerService all have constructors that take one. Those that don't use
+//! Clock::real().
+class Clock : public boost::noncopyable {
+public:
+  //! The current time, as a timestamp since some epoch
+  virtual TimeInterval now() const = 0;
+
+  //! Wait on cond until notified or until deadline by this clock
+
+  //! lock must hold the mutex cond is used with. Returns false once the
+  //! deadline has passed, true if woken (perhaps spuriously) before then.
+  virtual bool waitUntil(boost::condition &cond,
+			 boost::mutex::scoped_lock &lock,
+			 const TimeInterval &deadline) = 0;
+
+  //! Sleep until deadline by this clock
+  virtual void sleepUntil(const TimeInterval &deadline) = 0;
+
+  //! Offer to run a TimerService's callbacks
+
+  //! Returns true if the clock will call the TimerService back itself, in
+  //! which case the TimerService needs no thread of its own. By default,
+  //! clocks decline.
+  inline virtual bool adopt(TimerService &) { return false; }
+  //! Stop running a TimerService's callbacks, if adopt() agreed to
+  inline virtual void disown(TimerService &) { }
+
+  //! The real clock: TimeInterval::now(), monotonic
+  static Clock &real();
+
+  //! Virtual destructor for g++
+  inline virtual ~Clock() { }
+};
+
+//! The real, monotonic clock; see Clock::real()
+class RealClock : public Clock {
+public:
+  //! Returns TimeInterval::now()
+  virtual TimeInterval now() const;
+
+  //! Timed wait on cond until deadline
+  virtual bool waitUntil(boost::condition &cond,
+			 boost::mutex::scoped_lock &lock,
+			 const TimeInterval &deadline);
+
+  //! Sleeps with TimeInterval::sleepUntil(deadline); comes straight back
+  //! if the deadline has already passed
+  virtual void sleepUntil(const TimeInterval &deadline);
+};
+
+//! A clock that only moves when told to
+
+//! Time stands still until advance() or advanceTo() moves it on. Moving
+//! it runs the callbacks of every TimerService built on this clock, in
+//! deadline order and on the advancing thread, with the clock set to each
+//! deadline in turn; then it wakes any threads waiting on the clock. A
+//! pipeline of inline event handlers (see the IOEventParser and
+//! ShortStylusSuppressor constructors that take a TimerService) therefore
+//! runs deterministically: fed the same events at the same virtual times,
+//! it produces the same output, however fast the harness goes. Threaded
+//! handlers also follow the clock, but their threads run when they run.
+class VirtualClock : public Clock {
+public:
+  //! Constructor: time starts at start
+  VirtualClock(const TimeInterval &start=TimeInterval());
+
+  //! The virtual time
+  virtual TimeInterval now() const;
+
+  //! Wait on cond until notified or until the clock is advanced to deadline
+  virtual bool waitUntil(boost::condition &cond,
+			 boost::mutex::scoped_lock &lock,
+			 const TimeInterval &deadline);
+
+  //! Sleep until the clock is advanced to deadline
+  virtual void sleepUntil(const TimeInterval &deadline);
+
+  //! Move the clock on to when, running due timer callbacks on the way
+
+  //! Moving the clock backwards does nothing.
+  void advanceTo(const TimeInterval &when);
+
+  //! Move the clock on by interval, running due timer callbacks on the way
+  inline void advance(const TimeInterval &interval)
+  { advanceTo(now() + interval); }
+
+  //! Take over running a TimerService's callbacks
+  virtual bool adopt(TimerService &ts);
+  //! Stop running a TimerService's callbacks
+  virtual void disown(TimerService &ts);
+
+private:
+  //! A thread waiting on the clock
+  struct Waiter {
+    boost::condition *cond;	//!< What it's waiting on
+    boost::mutex *mutex;	//!< The mutex that goes with cond
+    TimeInterval deadline;	//!< When it wants waking
+  };
+
+  //! The virtual time
+  TimeInterval time;
+  //! Threads waiting on the clock
+  std::vector<Waiter*> waiters;
+  //! TimerServices whose callbacks the clock runs
+  std::vector<TimerService*> services;
+
+  //! Mutex for everything above
+  mutable boost::mutex mutex_time;
+  //! Condition variable signalling that time has moved, for sleepUntil
+  boost::condition cond_time;
+
+  //! Wake the threads waiting for a deadline that has now passed
+  void wakeWaiters();
+};
+
+} // namespace BrailleTutorNS
+
+#endif
@@ -0,0 +1,195 @@
+#ifndef _LIBBT_DICTIONARY_H_
+#define _LIBBT_DICTIONARY_H_
+/*
+ * Braille Tutor interface library
+ * Dictionary.h, started 19 October 2026
+ *
+ * Word-level recognition of what a student writes. A Dictionary holds a
+ * language's word list and scores every word in it against a partly
+ * written word in one pass, by edit distance; WordAssembler gathers the
+ * letters of IOEventParser's CELL_LETTER and BUTTON_LETTER events into
+ * words and keeps the best matches and completions of the word being
+ * written up to date as letters come in.
+ */
+
+#include "Types.h"
+#include "Charset.h"
+#include "IOEvent.h"
+
+#include <map>
+#include <string>
+#include <vector>
+#include <stdint.h>
+
+namespace BrailleTutorNS {
+
+//! A word list searchable by edit distance
+
+//! Words are split into UTF-8 characters, and each distinct character is
+//! given a small number; the words are then stored end to end as those
+//! numbers, so a search streams through one array.
+//!
+//! A search compares the written word with every word in the list using
+//! Myers' bit-parallel edit distance algorithm, in Hyyrö's form for whole
+//! strings: the written word's letters are the bits of a 64-bit word, and
+//! each letter of a list word costs a handful of bitwise operations. The
+//! same pass gives both the distance to the whole list word (for matches)
+//! and the least distance to any of its prefixes (for completions).
+class Dictionary {
+public:
+  //! Letters of a written word that are compared; any after these are
+  //! ignored
+  static const unsigned int MAX_LETTERS = 64;
+
+  //! A list word found by a search
+  struct Match {
+    uint32_t word;	//!< Index of the word in the list
+    uint32_t distance;	//!< Its edit distance (for a completion, its
+			//!< closest prefix's) from the written word
+  };
+
+  //! Constructor. Creates an empty list.
+  Dictionary();
+
+  //! Constructor. Creates a list of words.
+  explicit Dictionary(const std::vector<std::string> &words);
+
+  //! Add a UTF-8 word to the end of the list
+  void add(const std::string &word);
+
+  //! Add UTF-8 words to the end of the list
+  void add(const std::vector<std::string> &words);
+
+  //! The number of words in the list
+  inline size_t size() const { return words.size(); }
+
+  //! A word in the list, by index
+  inline const std::string &operator[](const size_t &i) const
+  { return words[i]; }
+
+  //! Score every word against a written word
+
+  //! Compares written (UTF-8) with each word in the list and puts in
+  //! matches the best max_results words no more than max_distance edits
+  //! (letters added, dropped or changed) away from it, nearest first. In
+  //! completions go the best max_results words longer than written that
+  //! some prefix of is no more than max_distance edits away from it:
+  //! nearest first, then shortest. Ties keep list order. Either output
+  //! vector may be the same one passed last time; its storage is reused.
+  void search(const std::string &written, const unsigned int &max_distance,
+	      const unsigned int &max_results, std::vector<Match> &matches,
+	      std::vector<Match> &completions) const;
+
+private:
+  //! Number for a letter that's in no word
+  static const uint16_t NO_SYMBOL = 0xffff;
+
+  //! The words as given
+  std::vector<std::string> words;
+  //! Every word's letter numbers, end to end
+  std::vector<uint16_t> symbols;
+  //! Where each word starts in symbols, and then symbols.size()
+  std::vector<uint32_t> starts;
+  //! Number of each distinct letter, by Unicode code point
+  std::map<uint32_t, uint16_t> symbol_of;
+};
+
+
+//! Gathers written letters into words, with dictionary hints
+
+//! Letters pushed in, as IOEvents or directly, are added to the word being
+//! written. The word ends when a space is written, when button 0 is
+//! pressed (as the apps use it to finish an answer), or when a letter is
+//! written in a cell that's neither the one before nor next to it; the
+//! letter that does that starts the next word. A cell pattern with no
+//! letter is added as a letter no dictionary word has, so it counts as one
+//! wrong letter.
+//!
+//! After each letter, the written word is searched for in the dictionary,
+//! so matches() and completions() are always ready to offer as hints.
+//! Once a word ends, they stay as they were for it until the next letter.
+//! The dictionary must outlive the assembler.
+class WordAssembler {
+public:
+  //! Constructor. Hints are words of dictionary no more than max_distance
+  //! edits away, at most max_results of each kind.
+  explicit WordAssembler(const Dictionary &dictionary,
+			 const unsigned int &max_distance = 2,
+			 const unsigned int &max_results = 5);
+
+  //! Push in an IOEvent. CELL_START, BUTTON_START, CELL_LETTER,
+  //! BUTTON_LETTER and BUTTON events are used; others are ignored. Button
+  //! 0 ends the word, but since it also flushes the glyph underway, if a
+  //! glyph has started and its letter hasn't come yet, the word ends after
+  //! that letter. Returns true if the event ended a word.
+  bool push(const IOEvent &event);
+
+  //! Add a letter (UTF-8; may be several characters, as contractions are)
+  //! to the word being written. Starts a new word if the last one ended.
+  void addLetter(const std::string &letter);
+
+  //! End the word being written. Returns true if there was one.
+  bool endWord();
+
+  //! Forget the word being written, and the last one
+  void reset();
+
+  //! The word being written, or the last one if it has ended
+  inline const std::string &word() const { return current; }
+
+  //! True if word() has ended
+  inline bool ended() const { return word_ended; }
+
+  //! Dictionary words close to word(), nearest first
+  inline const std::vector<Dictionary::Match> &matches() const
+  { return best_matches; }
+
+  //! Dictionary words that word() could be the start of, nearest first
+  inline const std::vector<Dictionary::Match> &completions() const
+  { return best_completions; }
+
+  //! The single best hint for word(): the nearer of the best match and the
+  //! best completion, or the match if they're as near. NULL if there are
+  //! no hints.
+  const Dictionary::Match *closest() const;
+
+  //! The dictionary searched
+  inline const Dictionary &getDictionary() const { return dictionary; }
+
+private:
+  //! Cell number for "no cell yet"
+  static const unsigned short int NO_CELL = 0xffff;
+
+  //! The word list
+  const Dictionary &dictionary;
+  //! Most edits a hint may be away
+  unsigned int max_distance;
+  //! Most hints of each kind
+  unsigned int max_results;
+
+  //! The word being written, or the last one
+  std::string current;
+  //! Whether current has ended
+  bool word_ended;
+  //! Cell the last letter was written in, or NO_CELL
+  unsigned short int last_cell;
+  //! Whether a glyph has started whose letter hasn't come yet
+  bool glyph_open;
+  //! Whether the word ends after the open glyph's letter
+  bool end_after_glyph;
+
+  //! Hints for current
+  std::vector<Dictionary::Match> best_matches;
+  std::vector<Dictionary::Match> best_completions;
+
+  //! Search the dictionary for current
+  void update();
+
+  //! Note that the open glyph's letter has come. Returns true if that
+  //! ended the word, as button 0 asked.
+  bool closeGlyph();
+};
+
+} // namespace BrailleTutorNS
+
+#endif
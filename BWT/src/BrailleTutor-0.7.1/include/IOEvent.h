@@ -12,8 +12,10 @@
 #include "Dots.h"
 #include "Types.h"
 #include "Charset.h"
+#include "TimerService.h"
 
 #include <deque>
+#include <stdint.h>
 
 #include <boost/thread.hpp>
 #include <boost/utility.hpp>
@@ -76,9 +78,28 @@ struct IOEvent {
       CELL_LETTER,	//!< User enters a letter in a cell
       BUTTON_LETTER,	//!< User enters a letter on buttons
 
+      //! Glyph in a cell can only be this letter, though it's not complete
+      CELL_PROVISIONAL_LETTER,
+      //! Glyph on buttons can only be this letter, though it's not complete
+      BUTTON_PROVISIONAL_LETTER,
+
+      //! User writes letters in a run of adjacent cells (only made when the
+      //! parser assembles cells concurrently; see
+      //! IOEventParser::setConcurrentCells()). cell is the run's first cell
+      //! and dots the number of cells in it; letter holds their letters in
+      //! cell order.
+      WORD,
+
       DONE		//!< The app is terminating; clean up!
   } Type;
 
+  //! A set of event types, one bit per Type. Build these with mask().
+  typedef uint32_t TypeMask;
+
+  //! Returns the TypeMask containing only event type type
+  inline static TypeMask mask(const Type &type)
+  { return ((TypeMask) 1) << type; }
+
   //! Event type
   Type type;
 
@@ -100,8 +121,8 @@ struct IOEvent {
   TimeInterval timestamp;	//!< Timestamp of the event
   TimeInterval duration;	//!< Duration of the event
 
-  //! Letter or word interpretation of the user's dot glyph. It's OK to change
-  //! the data in this GlyphMapping; it's a separate copy.
+  //! Letter or word interpretation of the user's dot glyph. Copying it is
+  //! cheap; short glyphs are stored inline, and long ones share storage.
   GlyphMapping letter;
 
 private:
@@ -115,7 +136,7 @@ private:
 	  const unsigned char &dot_or_dots=INVALID_DOT,
 	  const GlyphMapping &my_letter=GlyphMapping())
   : type(my_type), cell(cell_or_button), dot(dot_or_dots),
-    timestamp(my_timestamp), duration(my_duration), letter(my_letter.dup()) { }
+    timestamp(my_timestamp), duration(my_duration), letter(my_letter) { }
 
 public:
   //! Named constructor for making STYLUS_DOWN events
@@ -217,6 +238,36 @@ public:
   { return IOEvent(my_timestamp, my_duration, BUTTON_LETTER, INVALID_BUTTON,
 		   my_dots, my_letter); }
 
+  //! Named constructor for creating CELL_PROVISIONAL_LETTER events
+
+  //! These come as soon as the glyph in a cell makes a letter that no
+  //! further dots could change (see Charset::isSettled()). The CELL_LETTER
+  //! event for the glyph still follows and is authoritative: if the user
+  //! adds a dot anyway, it will disagree.
+  inline static IOEvent makeCellProvisionalLetterEvent(
+    const TimeInterval &my_timestamp, const TimeInterval &my_duration,
+    const unsigned short int &my_cell, const GlyphMapping &my_letter,
+    const unsigned char &my_dots)
+  { return IOEvent(my_timestamp, my_duration, CELL_PROVISIONAL_LETTER,
+		   my_cell, my_dots, my_letter); }
+
+  //! Named constructor for creating BUTTON_PROVISIONAL_LETTER events
+
+  //! The button counterpart of makeCellProvisionalLetterEvent().
+  inline static IOEvent makeButtonProvisionalLetterEvent(
+    const TimeInterval &my_timestamp, const TimeInterval &my_duration,
+    const GlyphMapping &my_letter, const unsigned char &my_dots)
+  { return IOEvent(my_timestamp, my_duration, BUTTON_PROVISIONAL_LETTER,
+		   INVALID_BUTTON, my_dots, my_letter); }
+
+  //! Named constructor for creating WORD events
+  inline static IOEvent makeWordEvent(
+    const TimeInterval &my_timestamp, const TimeInterval &my_duration,
+    const unsigned short int &my_first_cell,
+    const unsigned char &my_num_cells, const GlyphMapping &my_letters)
+  { return IOEvent(my_timestamp, my_duration, WORD, my_first_cell,
+		   my_num_cells, my_letters); }
+
   //! Named constructor for DONE events. Only to be called internally!
   inline static IOEvent makeDoneEvent()
   { return IOEvent(TimeInterval::now(), TimeInterval(), DONE,
@@ -262,8 +313,31 @@ class IOEventParserCore;
 class IOEventParser : public BaseIOEventHandler, public boost::noncopyable {
 public:
   //! Constructor
+
+  //! Events are decoded in a thread of this object's own, and handed to the
+  //! IOEventHandler from another.
   IOEventParser();
 
+  //! Constructor for a threaded parser keeping time by clock
+
+  //! Don't destroy clock before this object.
+  IOEventParser(Clock &clock);
+
+  //! Constructor for a parser that runs inline, with no threads
+
+  //! Events are decoded and handed to the IOEventHandler on the thread that
+  //! supplies them, and glyphs completed by the glyph delay running out are
+  //! handed over from the timers thread, which may be shared with other
+  //! inline event handlers (e.g. a ShortStylusSuppressor feeding this
+  //! parser). The handler therefore shouldn't dawdle. It's called with no
+  //! parser locks held, on a queue of its own rather than under the events
+  //! list's lock, so it may call back into the parser; events it feeds in
+  //! are handed to it once it returns. An old handler may still be running
+  //! on another thread just after setIOEventHandler() swaps in a new one.
+  //! Time is kept by the timers' clock. Don't destroy timers before this
+  //! object.
+  IOEventParser(TimerService &timers);
+
   //! Callback method for BrailleTutor object to supply events.
   virtual void operator()(std::deque<BaseIOEvent> &events);
 
@@ -275,6 +349,23 @@ public:
   //! delay <= 0. Use a value of infinity (HUGE_VAL in cmath) for no delay.
   void setGlyphDelay(const TimeInterval &delay);
 
+  //! Let the glyph delay adapt to how fast the user writes
+
+  //! Instead of a fixed delay, use a delay learned from the user's recent
+  //! pauses between the dots of a glyph: the given percentile of those
+  //! pauses, with a safety margin, kept between min_delay and max_delay.
+  //! The delay starts out at max_delay and adapts once a few glyphs have
+  //! been written. Calling this again starts learning afresh (say, for a
+  //! new student); calling setGlyphDelay returns to a fixed delay. Will
+  //! throw a BT_EDOM BTException unless 0 < min_delay <= max_delay and
+  //! 0 < percentile <= 1.
+  void setAdaptiveGlyphDelay(const TimeInterval &min_delay,
+			     const TimeInterval &max_delay,
+			     const double &percentile=0.95);
+
+  //! Retrieve the glyph delay currently in effect
+  TimeInterval getGlyphDelay();
+
   //! Flush the current glyph
 
   //! Normally the IOEventParser will not analyze what the user has typed into
@@ -292,6 +383,17 @@ public:
   //! Tells the IOEventParser not to add any events to the event list.
   void clearEvents();
 
+  //! Replace the whole set of event types added to the event list.
+
+  //! Atomically swaps in a complete subscription profile built from
+  //! IOEvent::mask() bits (e.g. mask(IOEvent::CELL_LETTER) |
+  //! mask(IOEvent::BUTTON)), so the parser never decodes a batch of events
+  //! against a half-changed profile. Returns the previous profile, which
+  //! can be handed back later to restore it.
+  IOEvent::TypeMask setEventMask(const IOEvent::TypeMask &mask);
+  //! Retrieve the set of event types currently added to the event list.
+  IOEvent::TypeMask getEventMask() const;
+
   //! Register an IOEventHandler functor with this IOEventParser.
 
   //! Register an IOEventHandler functor with this IOEventParser. The
@@ -316,13 +418,51 @@ public:
   //! while it's in use by an IOEventParser class.
   void setCharset(const Charset &my_charset=Charset::defaultCharset());
 
+  //! Set the current braille character set to a shared snapshot
+
+  //! Like the other setCharset, but the IOEventParser shares ownership of
+  //! the character set, so it's safe to switch character sets at any time
+  //! from any thread: the decoder finishes any batch of events it's working
+  //! on with the old character set, which is freed once nobody uses it. The
+  //! decoder never waits on a lock for the character set. Will throw a
+  //! BT_EDOM BTException if my_charset is null.
+  void setCharset(const CharsetSnapshot &my_charset);
+
+  //! Retrieve the current braille character set
+
+  //! If the character set was given by reference, the snapshot returned
+  //! refers to it without owning it.
+  CharsetSnapshot getCharset() const;
+
+  //! Report how many stray basic events the IOEventParser has ignored
+
+  //! A release of a button or a withdrawal from a hole that the parser
+  //! never saw pushed or entered is ignored and counted, as is a press of
+  //! a button or hole the Braille Tutor doesn't have. Either means that the
+  //! incoming events are corrupt or that some were lost along the way.
+  unsigned long getStrayContacts() const;
+
+  //! Let the user write in several cells at once
+
+  //! Normally a glyph in a cell is deemed complete as soon as the user
+  //! starts writing in another cell. With concurrent cells on, every cell
+  //! keeps its own glyph, complete only once that cell has gone untouched
+  //! for the glyph delay (or on flushGlyph()), so the user can move on
+  //! before a cell is finished and come back to it. A run of adjacent cells
+  //! then also yields a WORD event, once its cells have all been untouched
+  //! for twice the glyph delay, or the user writes elsewhere, uses the
+  //! buttons, or calls flushGlyph(). Changes take effect once no glyph is
+  //! underway. Off by default.
+  void setConcurrentCells(const bool &on=true);
+
   //! Destructor
   virtual ~IOEventParser();
 
   std::deque<IOEvent> out_events;
 private:
-  // Allow one of the thread classes access to our innards
+  // Allow one of the thread classes and the core access to our innards
   friend class FunctorNewIOEvent;
+  friend class IOEventParserCore;
 
   //! Pointer to the current IOEventHandler object
   IOEventHandler *handler;
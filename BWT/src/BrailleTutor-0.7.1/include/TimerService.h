@@ -0,0 +1,118 @@
+#ifndef _LIBBT_TIMER_SERVICE_H_
+#define _LIBBT_TIMER_SERVICE_H_
+/*
+ * Braille Tutor interface library
+ * TimerService.h, started 19 October 2026
+ *
+ * A single thread that calls back any number of clients at times of their
+ * choosing. Event handlers that run inline on their caller's thread (see
+ * the IOEventParser and ShortStylusSuppressor constructors that take a
+ * TimerService) share one of these for their timeouts, instead of each
+ * keeping a thread of its own.
+ */
+
+#include <map>
+
+#include "Types.h"
+#include "Clock.h"
+
+#include <boost/thread/condition.hpp>
+#include <boost/thread.hpp>
+#include <boost/utility.hpp>
+#include <boost/scoped_ptr.hpp>
+
+namespace BrailleTutorNS {
+
+//! Abstract superclass for a class that a TimerService calls back
+struct TimerClient {
+  //! Called from the TimerService thread once the scheduled time is reached
+
+  //! now is the time, by the TimerService's clock, at which the call was
+  //! made.
+  virtual void handleTimer(const TimeInterval &now) = 0;
+
+  //! Virtual destructor for g++
+  inline virtual ~TimerClient() { }
+};
+
+//! Calls TimerClient objects back at scheduled times, from one thread
+
+//! Each client has at most one scheduled time; callbacks happen one at a
+//! time, in order of their scheduled times, on the TimerService's thread.
+//! Clients may schedule and cancel from any thread, including from within
+//! their own handleTimer. Keep handleTimer brief, since other clients wait
+//! on it. A TimerService built on a VirtualClock has no thread; the clock
+//! makes the callbacks as it's advanced.
+class TimerService : public boost::noncopyable {
+public:
+  //! Constructor: starts the timer thread, unless the clock adopts us
+
+  //! Don't destroy clock before this object.
+  TimerService(Clock &my_clock=Clock::real());
+
+  //! Schedule client to be called back at time when
+
+  //! when is a time as reported by the TimerService's clock; a time in the
+  //! past means "as soon as possible". Replaces any time already scheduled
+  //! for the client. The TimerService does not keep a copy of client, so
+  //! cancel() before destroying it.
+  void schedule(TimerClient &client, const TimeInterval &when);
+
+  //! Cancel any callback scheduled for client
+
+  //! If client is being called back on the timer thread right now, waits
+  //! for that to finish (unless called from the callback itself), so that
+  //! once this returns, the client may be destroyed.
+  void cancel(TimerClient &client);
+
+  //! The clock the TimerService keeps time by; clients should use it too
+  inline Clock &getClock() const { return clock; }
+
+  //! Destructor: stops the timer thread. Scheduled callbacks are dropped.
+  ~TimerService();
+
+private:
+  // Allow the timer thread and a virtual clock access to our innards
+  friend struct FunctorTimerService;
+  friend class VirtualClock;
+
+  //! The clock we keep time by
+  Clock &clock;
+
+  //! Scheduled callback times, by client
+  std::map<TimerClient*, TimeInterval> deadlines;
+  //! Client being called back right now, if any
+  TimerClient *running;
+  //! Thread calling running back
+  boost::thread::id running_thread;
+  //! True when the timer thread should quit
+  bool quitting;
+
+  //! Mutex for everything above
+  boost::mutex mutex_deadlines;
+  //! Condition variable signalling changes to the schedule
+  boost::condition cond_deadlines;
+  //! Condition variable signalling the end of a callback
+  boost::condition cond_running;
+
+  //! The timer thread, unless the clock makes our callbacks
+  boost::scoped_ptr<boost::thread> t_timer;
+
+  //! Find the earliest scheduled time. Call with mutex_deadlines held.
+  bool earliest(std::map<TimerClient*, TimeInterval>::iterator &e_iter);
+
+  //! Call back the client with the earliest scheduled time, if that's no
+  //! later than now. Call with mutex_deadlines held in lock_d; it's let go
+  //! during the callback. Returns false if no callback was due.
+  bool callEarliest(boost::mutex::scoped_lock &lock_d, const TimeInterval &now);
+
+  //! Find the earliest scheduled time, for a clock making our callbacks
+  bool nextDeadline(TimeInterval &deadline);
+  //! Make the earliest callback if it's due, for a clock making our
+  //! callbacks
+  void runNext(const TimeInterval &now);
+};
+
+} // namespace BrailleTutorNS
+
+#endif
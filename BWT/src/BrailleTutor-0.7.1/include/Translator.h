@@ -0,0 +1,229 @@
+#ifndef _LIBBT_TRANSLATOR_H_
+#define _LIBBT_TRANSLATOR_H_
+/*
+ * Braille Tutor interface library
+ * Translator.h, started 19 October 2026
+ *
+ * Back-translation of runs of braille cells into glyphs. A Charset maps
+ * one cell to one glyph; a TranslationTable maps sequences of cells to
+ * glyphs as well, for scripts with multi-cell characters (e.g. Devanagari)
+ * and for contracted (grade 2) braille. BackTranslator applies a table to
+ * cells as they are written, one at a time.
+ *
+ * Multi-cell rules are kept in cell rule files, which look like mapping
+ * files except that a rule's dot patterns are separated by dashes:
+ *
+ *    !UTF-8 BEGIN Hindi multi-cell characters
+ *    1235-5	ऋ
+ *    !UTF-8 END
+ *
+ * Lines that don't look like this are skipped, as are blank lines and ones
+ * starting with #.
+ */
+
+#include "Dots.h"
+#include "Types.h"
+#include "Charset.h"
+#include "IOEvent.h"
+
+#include <map>
+#include <deque>
+#include <string>
+#include <vector>
+#include <iostream>
+#include <stdint.h>
+
+namespace BrailleTutorNS {
+
+//! Rules mapping sequences of braille cells to glyphs
+
+//! A TranslationTable holds rules that each map a sequence of one to
+//! MAX_CELLS cell dot patterns to a glyph. It usually starts out with the
+//! one-cell rules of a Charset, to which rules read from a cell rule file
+//! are added; a rule for a sequence replaces any earlier one for the same
+//! sequence.
+//!
+//! The rules are compiled into a trie, laid out in flat arrays: a
+//! 256-entry table for the first cell, then for each deeper node a sorted
+//! run of (dots, child) edges, which is binary searched. Walking it with
+//! next() costs one table lookup for the first cell and a few comparisons
+//! for each cell after.
+class TranslationTable {
+public:
+  //! Longest sequence of cells a rule may have. This is also as far as a
+  //! BackTranslator ever has to look ahead.
+  static const unsigned int MAX_CELLS = 8;
+
+  //! A node of the trie. State ROOT is before any cell has been seen.
+  typedef uint32_t State;
+  //! The trie's root
+  static const State ROOT = 0;
+  //! What next() returns when no rule continues with the given cell
+  static const State NO_STATE = 0xffffffff;
+
+  //! Constructor. Creates a table with no rules.
+  TranslationTable();
+
+  //! Constructor. Creates a table with a one-cell rule for every dot
+  //! pattern charset maps to a glyph.
+  explicit TranslationTable(const Charset &charset);
+
+  //! Named constructor. Creates a table with charset's one-cell rules, plus
+  //! the rules in the cell rule file filename. Will throw a BT_EIO
+  //! BTException if the file can't be opened.
+  static TranslationTable fromFile(const Charset &charset,
+				   const std::string &filename);
+
+  //! Named constructor. Like fromFile(), but a missing rule file just means
+  //! there are no multi-cell rules.
+  static TranslationTable load(const Charset &charset,
+			       const std::string &filename);
+
+  //! Name of the cell rule file that goes with a text mapping file: the
+  //! same name, with a .cells extension in place of any .txt one
+  static std::string rulesFilename(const std::string &mapping_filename);
+
+  //! Add a rule mapping cells to glyph, replacing any rule for cells. An
+  //! empty glyph removes the rule instead. Will throw a BT_EINVAL
+  //! BTException if cells is empty or longer than MAX_CELLS.
+  void add(const std::vector<unsigned char> &cells, const GlyphMapping &glyph);
+
+  //! Add the rules in a cell rule file. Returns the numbers of the lines
+  //! that were skipped because they couldn't be parsed.
+  std::vector<unsigned int> read(std::istream &in);
+  //! Add the rules in a cell rule file. Returns the numbers of the lines
+  //! that were skipped because they couldn't be parsed. Will throw a BT_EIO
+  //! BTException if the file can't be opened.
+  std::vector<unsigned int> read(const std::string &filename);
+
+  //! The number of rules in this table
+  inline unsigned int size() const { return rules.size(); }
+
+  //! The number of cells in the longest rule
+  inline unsigned int maxCells() const { return max_cells; }
+
+  //! The state after reading dots in state state, or NO_STATE if no rule
+  //! starts with the cells read so far followed by dots
+  inline State next(const State &state, const unsigned char &dots) const
+  { if(state == ROOT) return root_children[dots];
+    const TrieNode &node = nodes[state];
+    uint32_t first = node.first_edge, last = first + node.num_edges;
+    const uint32_t end = last;
+    while(first < last) {
+      const uint32_t mid = first + (last - first)/2;
+      if(edge_dots[mid] < dots) first = mid+1; else last = mid; }
+    return ((first < end) && (edge_dots[first] == dots)) ?
+	   edge_child[first] : NO_STATE; }
+
+  //! The glyph of the rule whose cells lead to state; empty if there isn't
+  //! one
+  inline const GlyphMapping &glyph(const State &state) const
+  { return nodes[state].glyph; }
+
+  //! True if some rule has more cells than the ones leading to state
+  inline bool continues(const State &state) const
+  { return (state == ROOT) || (nodes[state].num_edges > 0); }
+
+  //! The cells to write glyph, or an empty vector if no rule yields it.
+  //! When several rules do, the one added last is used, so a cell rule file
+  //! decides how to write a glyph its Charset also has.
+  const std::vector<unsigned char> &cellsFor(const GlyphMapping &glyph) const;
+
+  //! True if writing glyph takes more than one cell
+  inline bool isMultiCell(const GlyphMapping &glyph) const
+  { return cellsFor(glyph).size() > 1; }
+
+private:
+  //! A node of the compiled trie
+  struct TrieNode {
+    uint32_t first_edge;	//!< Index of the node's first edge
+    uint32_t num_edges;		//!< Edges leaving the node
+    GlyphMapping glyph;		//!< Glyph of the rule ending here, if any
+  };
+
+  //! The rules, by cell sequence; the trie is compiled from these
+  std::map<std::vector<unsigned char>, GlyphMapping> rules;
+  //! Cells to write each glyph
+  std::map<GlyphMapping, std::vector<unsigned char> > writing;
+
+  //! Trie nodes; nodes[ROOT] is the root
+  std::vector<TrieNode> nodes;
+  //! Child of the root for each first cell, or NO_STATE
+  State root_children[256];
+  //! Dots of each edge; each node's edges are sorted and contiguous
+  std::vector<unsigned char> edge_dots;
+  //! Node each edge leads to
+  std::vector<State> edge_child;
+  //! Cells in the longest rule
+  unsigned int max_cells;
+
+  //! Set a rule without recompiling the trie
+  void setRule(const std::vector<unsigned char> &cells,
+	       const GlyphMapping &glyph);
+
+  //! Rebuild the trie from the rules
+  void compile();
+};
+
+
+//! Streaming back-translator applying a TranslationTable to written cells
+
+//! Cells are pushed in as they are written. Each is held until it's clear
+//! which rule it belongs to: that is, until no longer rule could still
+//! match. The longest rule matching the held cells then wins, and its glyph
+//! is put out. A cell that starts no rule at all is put out as an empty
+//! glyph, so callers can tell that a cell went by untranslated. At most
+//! TranslationTable::MAX_CELLS cells are ever held.
+//!
+//! The table must outlive the translator. Push cells into a translator
+//! either as dot patterns or as IOEvents, not both.
+//!
+//! No app back-translates written cells yet; LearnLetters uses only the
+//! TranslationTable, to find how a letter is written. The translator is
+//! groundwork for apps that take contracted or multi-cell writing, and is
+//! exercised by tests/test_translator.
+class BackTranslator {
+public:
+  //! Constructor. Translates with table.
+  explicit BackTranslator(const TranslationTable &table);
+
+  //! Push in a written cell; appends any glyphs this completes to out
+  void push(const unsigned char &dots, std::vector<GlyphMapping> &out);
+
+  //! Push in an IOEvent. CELL_DOTS events are translated, and each glyph
+  //! completed is appended to out as a CELL_LETTER event spanning the
+  //! cells that made it, with the dots of its last cell. Other events are
+  //! ignored.
+  void push(const IOEvent &event, std::deque<IOEvent> &out);
+
+  //! Translate any held cells as best as possible, e.g. at the end of a
+  //! word, appending the glyphs to out
+  void flush(std::vector<GlyphMapping> &out);
+  //! As flush(), for held CELL_DOTS events
+  void flush(std::deque<IOEvent> &out);
+
+  //! Forget any held cells
+  inline void reset() { held.clear(); held_events.clear(); }
+
+  //! Number of cells held, waiting for more to decide their translation
+  inline unsigned int pending() const { return held.size(); }
+
+private:
+  //! The rules
+  const TranslationTable &table;
+  //! Cells held
+  std::deque<unsigned char> held;
+  //! CELL_DOTS events held, if cells are pushed as events
+  std::deque<IOEvent> held_events;
+
+  //! Glyphs made by the last drain(), each with its number of cells
+  std::vector<std::pair<GlyphMapping, unsigned int> > made;
+
+  //! Translate held cells while their translation is certain, or all of
+  //! them if flushing, into made
+  void drain(const bool &flushing);
+};
+
+} // namespace BrailleTutorNS
+
+#endif
@@ -11,6 +11,7 @@
 #include <cmath>
 #include <deque>
 #include <string>
+#include <stdint.h>
 
 namespace BrailleTutorNS {
 
@@ -51,81 +52,157 @@ struct BTException {
 //! A class for event timestamps and time intervals.
 
 //! This class furnishes timestamps for Braille Tutor events, as well as a
-//! representation for other time intervals. Time is represented as the sum
-//! of seconds and milliseconds, and for timestamps the class indicates time
-//! since some epoch (c.f. POSIX's struct timeb in ftime(3)). The specific
-//! epoch is not specified and may change between different instances of the
-//! same program; since timestamps are mainly used for computing relative
-//! times, however, this is not expected to be a problem. Additional
-//! operators support basic arithmetic operations (addition etc.) on
-//! time values.
+//! representation for other time intervals. Time is represented as a count
+//! of nanoseconds, and for timestamps the class indicates time since some
+//! epoch on a monotonic clock, one that never jumps when the wall clock is
+//! set. The specific epoch is not specified and may change between
+//! different instances of the same program; since timestamps are mainly
+//! used for computing relative times, however, this is not expected to be
+//! a problem. Additional operators support basic arithmetic operations
+//! (addition etc.) on time values; addition, subtraction and comparison are
+//! exact integer operations.
 //!
-//! Abstraction function: A time interval of xxx.yyy seconds is represented
-//! in fixed-point 3-decimal place resolution with xxx in secs and yyy in msecs.
+//! Abstraction function: A time interval of xxx.yyyyyyyyy seconds is
+//! represented in fixed-point 9-decimal place resolution in nsecs.
 //!
-//! Representation invariant: msecs is always in [0-999].
+//! Representation invariant: none; nsecs may be negative, as when a later
+//! timestamp is subtracted from an earlier one.
 struct TimeInterval {
-  //! Interval duration rounded down to the nearest smaller second.
-  unsigned int secs;
-  //! Number of milliseconds in interval duration - secs.
-  unsigned short int msecs;
+  //! Nanoseconds in one second
+  static const int64_t NSECS_PER_SEC = 1000000000;
 
-  //! Reexpress secs and msecs to satisfy the representation invariant
-  inline void invariant() { secs += msecs / 1000; msecs %= 1000; }
+  //! Largest magnitude, in nanoseconds, a double is converted to (2^61)
+  static const int64_t LIMIT_NSECS = ((int64_t) 1) << 61;
+  //! LIMIT_NSECS in seconds
+  static inline double limitSecs() { return ((double) LIMIT_NSECS) / 1e9; }
+
+  //! Interval duration in nanoseconds
+  int64_t nsecs;
+
+  //! Whole seconds in the interval (rounded towards zero)
+  inline int64_t wholeSecs() const { return nsecs / NSECS_PER_SEC; }
+  //! Nanoseconds in the interval beyond wholeSecs()
+  inline int64_t fracNsecs() const { return nsecs % NSECS_PER_SEC; }
 
   //! Cast operator automatically makes a floating point time value in seconds.
   inline operator double() const
-  { return ((double) secs) + ((double) msecs) / 1000.0; }
+  { return ((double) wholeSecs()) + ((double) fracNsecs()) / 1e9; }
 
   //! Constructor: create a zero length interval
-  inline TimeInterval() : secs(0), msecs(0) { }
+  inline TimeInterval() : nsecs(0) { }
 
   //! Constructor: specify seconds and milliseconds explicitly
   inline TimeInterval(const unsigned int &my_secs,
 		      const unsigned short int &my_msecs)
-  : secs(my_secs), msecs(my_msecs) { invariant(); }
+  : nsecs(((int64_t) my_secs) * NSECS_PER_SEC +
+	  ((int64_t) my_msecs) * 1000000) { }
 
   //! Constructor: specify a floating point time value in seconds
+
+  //! Values beyond about 73 years either way (HUGE_VAL included) are
+  //! clamped there, so that adding a few of them together can't overflow.
   inline TimeInterval(const double &my_secs)
-  : secs((unsigned int) floor(my_secs)),
-    msecs((unsigned short int) rint(1000.0* (my_secs - (double) secs))) { }
+  : nsecs(my_secs >=  limitSecs() ?  LIMIT_NSECS :
+	  my_secs <= -limitSecs() ? -LIMIT_NSECS :
+	  (int64_t) floor(my_secs * 1e9 + 0.5)) { }
+
+  //! Named constructor: specify a count of nanoseconds
+  inline static TimeInterval fromNsecs(const int64_t &my_nsecs)
+  { TimeInterval t; t.nsecs = my_nsecs; return t; }
 
   //! Named constructor: generate a timestamp as time since some epoch
   static TimeInterval now();
 
+  //! Sleep (portably) until deadline, a timestamp as given by now()
+
+  //! Returns at once if deadline has already passed. Since the deadline is
+  //! absolute, time spent before the call, or oversleeping an earlier
+  //! deadline, isn't added on; see PeriodicTicker for periodic loops.
+  static void sleepUntil(const TimeInterval &deadline);
+
   //! Sleep (portably) for this time interval
   void sleep() const;
 };
 
-// TODO: Implement all without floating point conversion
 //! Addition operator for TimeIntervals.
 inline TimeInterval operator+(const TimeInterval &a,
 			      const TimeInterval &b)
-{ return TimeInterval( ((double) a) + ((double) b) ); }
+{ return TimeInterval::fromNsecs(a.nsecs + b.nsecs); }
 //! Subtraction operator for TimeIntervals.
 inline TimeInterval operator-(const TimeInterval &a,
 			      const TimeInterval &b)
-{ return TimeInterval( ((double) a) - ((double) b) ); }
-//! Multiplication operator for TimeIntervals.
+{ return TimeInterval::fromNsecs(a.nsecs - b.nsecs); }
+//! Multiplication operator for TimeIntervals (seconds times seconds).
+
+//! Splits both operands into whole seconds and nanoseconds so that no
+//! partial product overflows; the result is truncated to the nanosecond.
 inline TimeInterval operator*(const TimeInterval &a,
 			      const TimeInterval &b)
-{ return TimeInterval( ((double) a) * ((double) b) ); }
+{
+  const int64_t a1 = a.wholeSecs(), a0 = a.fracNsecs();
+  const int64_t b1 = b.wholeSecs(), b0 = b.fracNsecs();
+  return TimeInterval::fromNsecs(a1*b1*TimeInterval::NSECS_PER_SEC +
+				 a1*b0 + a0*b1 +
+				 a0*b0/TimeInterval::NSECS_PER_SEC);
+}
 //! Division operator for TimeIntervals.
+
+//! Unlike the other operators, this goes through floating point: an exact
+//! quotient would need more than 64 bits of intermediate precision.
 inline TimeInterval operator/(const TimeInterval &a,
 			      const TimeInterval &b)
 { return TimeInterval( ((double) a) / ((double) b) ); }
 //! Less-than comparison for TimeIntervals
 inline bool operator<(const TimeInterval &a, const TimeInterval &b)
-{ return ((double) a) < ((double) b); }
+{ return a.nsecs < b.nsecs; }
 //! Greater-than comparison for TimeIntervals
 inline bool operator>(const TimeInterval &a, const TimeInterval &b)
-{ return ((double) a) > ((double) b); }
+{ return a.nsecs > b.nsecs; }
 //! Less-than-or-equal-to comparison for TimeIntervals
 inline bool operator<=(const TimeInterval &a, const TimeInterval &b)
-{ return ((double) a) <= ((double) b); }
+{ return a.nsecs <= b.nsecs; }
 //! Greater-than-or-equal-to comparison for TimeIntervals
 inline bool operator>=(const TimeInterval &a, const TimeInterval &b)
-{ return ((double) a) >= ((double) b); }
+{ return a.nsecs >= b.nsecs; }
+
+
+//! Paces a periodic loop by absolute deadlines
+
+//! Each tick is scheduled one period after the previous tick's deadline,
+//! not one period after the loop got around to waiting, so the loop's own
+//! work and any lateness in waking don't accumulate as drift. Call wait()
+//! at the top of each iteration. Not thread safe.
+class PeriodicTicker {
+public:
+  //! Constructor: the first tick is one period after start
+
+  //! Will throw a BT_EDOM BTException unless period > 0.
+  PeriodicTicker(const TimeInterval &my_period,
+		 const TimeInterval &start=TimeInterval::now());
+
+  //! Sleep until the next tick
+
+  //! Returns the number of ticks skipped. That's normally zero; if the
+  //! loop has fallen a whole period or more behind, the missed ticks are
+  //! dropped rather than rushed through, keeping the original phase.
+  unsigned int wait();
+
+  //! Change the period, starting from the last tick
+
+  //! Will throw a BT_EDOM BTException unless period > 0.
+  void setPeriod(const TimeInterval &my_period);
+
+  //! The period
+  inline const TimeInterval &getPeriod() const { return period; }
+  //! The deadline wait() will sleep until next
+  inline const TimeInterval &nextTick() const { return next; }
+
+private:
+  //! Time between ticks
+  TimeInterval period;
+  //! Deadline of the next tick
+  TimeInterval next;
+};
 
 
 //! Placeholder/sentinel value for *IOEvent::dot during BUTTON* events
@@ -0,0 +1,62 @@
+/*
+ * Braille Tutor interface library
+ * AdaptiveGlyphDelay.cc, started 19 October 2026
+ *
+ * Implements the adaptive glyph completion delay controller.
+ */
+
+#include <algorithm>
+
+#include "Types.h"
+#include "AdaptiveGlyphDelay.h"
+
+namespace BrailleTutorNS {
+
+// Note the pause before a dot that continued a glyph
+void AdaptiveGlyphDelay::addPause(const TimeInterval &pause)
+{
+  pauses[next_pause] = (double) pause;
+  next_pause = (next_pause + 1) % WINDOW;
+  if(num_pauses < WINDOW) ++num_pauses;
+  if(num_pauses < MIN_SAMPLES) return;
+
+  // Find the percentile in a scratch copy of the pauses
+  double scratch[WINDOW];
+  std::copy(pauses, pauses + num_pauses, scratch);
+  unsigned int rank = (unsigned int) (percentile * num_pauses);
+  if(rank >= num_pauses) rank = num_pauses - 1;
+  std::nth_element(scratch, scratch + rank, scratch + num_pauses);
+
+  const double learned = scratch[rank] * margin;
+  current = TimeInterval(std::min(max_delay, std::max(min_delay, learned)));
+}
+
+// Forget all pauses seen so far
+void AdaptiveGlyphDelay::reset()
+{
+  num_pauses = 0;
+  next_pause = 0;
+  current = TimeInterval(max_delay);
+}
+
+// Constructor
+AdaptiveGlyphDelay::AdaptiveGlyphDelay(const TimeInterval &my_min_delay,
+				       const TimeInterval &my_max_delay,
+				       const double &my_percentile,
+				       const double &my_margin)
+: min_delay(my_min_delay), max_delay(my_max_delay),
+  percentile(my_percentile), margin(my_margin)
+{
+  if((min_delay <= 0.0) || (max_delay < min_delay))
+    throw BTException(BTException::BT_EDOM,
+		      "adaptive glyph delay bounds must satisfy 0 < min <= max");
+  if((percentile <= 0.0) || (percentile > 1.0))
+    throw BTException(BTException::BT_EDOM,
+		      "adaptive glyph delay percentile must be in (0, 1]");
+  if(margin < 1.0)
+    throw BTException(BTException::BT_EDOM,
+		      "adaptive glyph delay margin must be at least 1");
+  reset();
+}
+
+} // namespace BrailleTutorNS
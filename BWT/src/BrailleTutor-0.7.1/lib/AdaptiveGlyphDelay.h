@@ -0,0 +1,74 @@
+#ifndef _LIBBT_ADAPTIVE_GLYPH_DELAY_H_
+#define _LIBBT_ADAPTIVE_GLYPH_DELAY_H_
+/*
+ * Braille Tutor interface library
+ * AdaptiveGlyphDelay.h, started 19 October 2026
+ *
+ * A controller that picks the glyph completion delay for an IOEventParser
+ * from how long the user actually pauses between the dots of a glyph. The
+ * delay tracks a high percentile of the recent pauses, with some margin,
+ * held within configured bounds.
+ */
+
+#include "Types.h"
+
+namespace BrailleTutorNS {
+
+//! Learns a glyph completion delay from the user's pauses between dots
+
+//! Feed it the pause before each dot that continues a glyph (that is, the
+//! time since the glyph's last dot entry or withdrawal); it sets the delay
+//! to the given percentile of the last WINDOW pauses, times a margin. The
+//! margin matters: pauses longer than the delay in effect are never seen,
+//! since the glyph is deemed complete before they end, so without it the
+//! delay could only ever shrink. Until MIN_SAMPLES pauses have been seen,
+//! the delay is the upper bound.
+class AdaptiveGlyphDelay {
+public:
+  //! Number of recent pauses the delay is computed from
+  static const unsigned int WINDOW = 64;
+  //! Number of pauses needed before the delay starts to adapt
+  static const unsigned int MIN_SAMPLES = 8;
+
+  //! Note the pause before a dot that continued a glyph
+  void addPause(const TimeInterval &pause);
+
+  //! The glyph completion delay learned so far
+  inline const TimeInterval &delay() const { return current; }
+
+  //! Forget all pauses seen so far, e.g. when a new user sits down
+  void reset();
+
+  //! Constructor
+
+  //! Will throw a BT_EDOM BTException unless 0 < min_delay <= max_delay,
+  //! 0 < percentile <= 1, and margin >= 1.
+  AdaptiveGlyphDelay(const TimeInterval &my_min_delay=TimeInterval(0, 500),
+		     const TimeInterval &my_max_delay=TimeInterval(5, 0),
+		     const double &my_percentile=0.95,
+		     const double &my_margin=1.5);
+
+private:
+  //! Lower bound on the delay, in seconds
+  double min_delay;
+  //! Upper bound on the delay, in seconds
+  double max_delay;
+  //! Percentile of recent pauses to track
+  double percentile;
+  //! Factor applied to the percentile
+  double margin;
+
+  //! Ring of the most recent pauses, in seconds
+  double pauses[WINDOW];
+  //! Number of pauses seen so far (saturates at WINDOW)
+  unsigned int num_pauses;
+  //! Where the next pause goes in the ring
+  unsigned int next_pause;
+
+  //! The delay in effect
+  TimeInterval current;
+};
+
+} // namespace BrailleTutorNS
+
+#endif
@@ -0,0 +1,79 @@
+/*
+ * BrailleTutor interface library
+ * BT_Registry.cc, started 19 October 2026
+ *
+ * The registry of known Braille Tutor hardware revisions and the
+ * signature-based revision matching used by autodetection.
+ */
+
+#include <deque>
+#include <vector>
+#include <algorithm>
+#include <stdint.h>
+
+#include "Types.h"
+#include "BT_Registry.h"
+#include "BT_StateMachines.h"
+#include "BT_rev0_StateMachine.h"
+
+#include <boost/shared_ptr.hpp>
+
+namespace BrailleTutorNS {
+
+//! Makes a vector with BT_Description objects describing BT hardware versions.
+static std::vector<boost::shared_ptr<BT_Description> > _make_bt_descriptions()
+{
+  std::vector<boost::shared_ptr<BT_Description> > descs;
+  // Revision 0 tutor
+  descs.push_back(boost::shared_ptr<BT_Description>(new BT_rev0_Description()));
+  // MORE DESCRIPTIONS GO HERE
+
+  return descs;
+}
+
+//! All registered descriptions, indexed by version number
+static std::vector<boost::shared_ptr<BT_Description> > bt_descriptions =
+  _make_bt_descriptions();
+
+
+// Number of Braille Tutor revisions in the registry
+unsigned int bt_num_revisions()
+{
+  return bt_descriptions.size();
+}
+
+// Retrieve the description of Braille Tutor revision version
+const BT_Description &bt_revision(const unsigned int &version)
+{
+  if(version >= bt_descriptions.size())
+    throw BTException(BTException::BT_EINVAL,
+		      "invalid Braille Tutor version number");
+  return *bt_descriptions[version];
+}
+
+// List the serial port speeds used by registered revisions
+std::deque<unsigned int> bt_revision_baud_rates()
+{
+  std::deque<unsigned int> bauds;
+  for(unsigned int i=0; i<bt_descriptions.size(); ++i) {
+    const unsigned int baud = bt_descriptions[i]->baudRate();
+    if(std::find(bauds.begin(), bauds.end(), baud) == bauds.end())
+      bauds.push_back(baud);
+  }
+  return bauds;
+}
+
+// Identify a Braille Tutor revision from its autodetect bytes
+bool bt_match_revision(const std::deque<uint8_t> &bytes,
+		       const unsigned int &baud, unsigned int &version)
+{
+  unsigned int best_strength = 0;
+  for(unsigned int i=0; i<bt_descriptions.size(); ++i) {
+    if(bt_descriptions[i]->baudRate() != baud) continue;
+    const unsigned int strength = bt_descriptions[i]->matchSignature(bytes);
+    if(strength > best_strength) { best_strength = strength; version = i; }
+  }
+  return best_strength > 0;
+}
+
+} // namespace BrailleTutorNS
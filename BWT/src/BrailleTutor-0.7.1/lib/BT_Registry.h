@@ -0,0 +1,48 @@
+#ifndef _LIBBT_BT_REGISTRY_H_
+#define _LIBBT_BT_REGISTRY_H_
+/*
+ * BrailleTutor interface library
+ * BT_Registry.h, started 19 October 2026
+ *
+ * The registry of BT_Description objects for every Braille Tutor hardware
+ * revision the library knows about. A revision's position in the registry
+ * is its version number (as reported by BrailleTutor::detect and accepted
+ * by BrailleTutor::ready), so new revisions go on the end. Adding a new
+ * revision means writing its BT_Description and listing it in
+ * BT_Registry.cc---nothing in BrailleTutorIO needs to change.
+ */
+
+#include <deque>
+#include <stdint.h>
+
+#include "Types.h"
+#include "BT_StateMachines.h"
+
+namespace BrailleTutorNS {
+
+//! Number of Braille Tutor revisions in the registry
+unsigned int bt_num_revisions();
+
+//! Retrieve the description of Braille Tutor revision version
+
+//! Throws a BT_EINVAL BTException if there's no such revision.
+const BT_Description &bt_revision(const unsigned int &version);
+
+//! List the serial port speeds used by registered revisions
+
+//! Each speed appears once, in the order of the first revision using it,
+//! so the autodetector tries speeds used by older boards first.
+std::deque<unsigned int> bt_revision_baud_rates();
+
+//! Identify a Braille Tutor revision from its autodetect bytes
+
+//! Offers bytes captured at serial speed baud to the signature matchers of
+//! all registered revisions that talk at that speed, and picks the one
+//! reporting the strongest match (the earliest revision wins ties). Returns
+//! true and fills in version if any matcher accepted the bytes.
+bool bt_match_revision(const std::deque<uint8_t> &bytes,
+		       const unsigned int &baud, unsigned int &version);
+
+} // namespace BrailleTutorNS
+
+#endif
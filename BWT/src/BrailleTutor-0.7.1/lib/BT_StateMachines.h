@@ -31,6 +31,7 @@
 #include <stdint.h>
 
 #include "Types.h"
+#include "Clock.h"
 #include "StateMachine.h"
 
 #include "boost/shared_ptr.hpp"
@@ -55,6 +56,16 @@ struct BTSM_inputT {
   std::deque<uint8_t> bt_to_cpu;
   typedef std::deque<uint8_t>::iterator iterT;
   typedef std::deque<uint8_t>::const_iterator constIterT;
+
+  //! Number of bytes in both queues awaiting the state machine
+  inline size_t pending() const { return cpu_to_bt.size() + bt_to_cpu.size(); }
+
+  //! True if either queue is empty
+
+  //! A state machine that stops consuming bytes while one of the queues is
+  //! empty is most likely waiting on that queue; if both queues have bytes
+  //! and nothing is consumed, the machine is stuck. See StateMachine::run.
+  inline bool starved() const { return cpu_to_bt.empty() || bt_to_cpu.empty(); }
 };
 
 //! Output symbol element type for BrailleTutor state machines
@@ -194,10 +205,16 @@ typedef std::deque<BTSM_Indication> BTSM_outputT;
 //! the BT and the CPU. Consists of a byte for waiting on just bytes and
 //! a std::string to store characters for later parsing---e.g. to determine
 //! from the BT input the cell or stylus hole into which a stylus is inserted.
+//! Also carries the clock that indications are timestamped by.
 struct BTSM_dataT {
   uint8_t byte;
   std::string str;
-  inline BTSM_dataT() : byte(0) { }
+  const Clock *clock;
+  inline BTSM_dataT(const Clock *my_clock=NULL) : byte(0), clock(my_clock) { }
+
+  //! The time by clock, or by the real clock if there's none
+  inline TimeInterval now() const
+  { return (clock != NULL) ? clock->now() : TimeInterval::now(); }
 };
 
 //! Name type for BrailleTutor state machines---just strings
@@ -221,7 +238,8 @@ typedef StateMachine<BTSM_inputT, BTSM_outputT,
 //! Classes derived from this abstract base class can create a state machine
 //! describing a particular model of Braille Tutor, and also furnish
 //! strings of uint8_t bytes that correspond to different commands
-//! (presently: beep the speaker and set/get the I/O pin status).
+//! (presently: beep the speaker and set/get the I/O pin status). They also
+//! tell the autodetector how to recognise their Tutor; see BT_Registry.h.
 struct BT_Description {
   //! Return a state machine description of a particular Braille Tutor
   virtual BT_StateMachine makeStateMachine() = 0;
@@ -242,6 +260,28 @@ struct BT_Description {
   //! The name of this state is stored in the argument string.
   virtual std::deque<uint8_t> makeResetBytes(BTSM_stateNameT &dest) = 0;
 
+  //! Skip to the next frame boundary after a state machine parse error
+
+  //! Called when the state machine chokes on its input: discards bytes
+  //! up to and including the next byte ending a frame of the BT protocol,
+  //! adding the number of BT-to-CPU bytes discarded to dropped. Returns
+  //! true and names the state the machine should resume in via dest if a
+  //! boundary was found; returns false if all bytes were discarded without
+  //! finding one, in which case resync should be called again on new input.
+  virtual bool resync(BTSM_inputT &in, unsigned long &dropped,
+		      BTSM_stateNameT &dest) = 0;
+
+  //! Check bytes captured from a Tutor in autodetect mode for this revision
+
+  //! The autodetector listens to a serial port at baudRate() for a second
+  //! and hands whatever arrived to this method. Returns 0 if the bytes
+  //! don't look like this revision; otherwise a positive strength, so that
+  //! revisions with more specific signatures can outbid generic ones.
+  virtual unsigned int matchSignature(const std::deque<uint8_t> &bytes) const=0;
+
+  //! Return the serial port speed this revision talks at
+  virtual unsigned int baudRate() const = 0;
+
   //! Virtual copy constructor for BT_Description objects
   virtual BT_Description *clone() const = 0;
 
@@ -0,0 +1,147 @@
+/*
+ * BrailleTutor interface library
+ * BT_Trace.cc, started 19 October 2026
+ *
+ * Implements the state machine transition trace ring.
+ */
+
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <stdint.h>
+
+#include "BT_Trace.h"
+
+#ifdef BT_WINDOWS
+#include <Windows.h>
+#else
+#include <time.h>
+#endif
+
+namespace BrailleTutorNS {
+
+//! Read a monotonic clock in nanoseconds for trace timestamps
+static inline uint64_t trace_clock()
+{
+#ifdef BT_WINDOWS
+  static LARGE_INTEGER freq = { { 0, 0 } };
+  if(freq.QuadPart == 0) QueryPerformanceFrequency(&freq);
+  LARGE_INTEGER ticks;
+  QueryPerformanceCounter(&ticks);
+  return (uint64_t) ((double) ticks.QuadPart * 1e9 / (double) freq.QuadPart);
+#else
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t) ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+#endif
+}
+
+// Record the start of a cycle
+void BT_TraceRing::enter(const BT_State &state,
+			 const BTSM_inputT &in, const BTSM_outputT &out)
+{
+  curr = &ring[count++ & (SIZE-1)];
+  curr->nsecs = trace_clock();
+  curr->from = &state;
+  curr->to = NULL;
+  curr->byte = in.bt_to_cpu.empty() ? -1 : in.bt_to_cpu.front();
+  curr->consumed = false;
+  curr->indicated = false;
+  pre_btc = in.bt_to_cpu.size();
+  pre_out = out.size();
+}
+
+// Record the end of a cycle
+void BT_TraceRing::leave(const BT_State &state,
+			 const BTSM_inputT &in, const BTSM_outputT &out)
+{
+  curr->to = &state;
+  curr->consumed = in.bt_to_cpu.size() < pre_btc;
+  if(out.size() > pre_out) {
+    curr->indicated = true;
+    curr->ind_type = out.back().type;
+    curr->ind_cell = out.back().cell;
+    curr->ind_dot  = out.back().dot;
+  }
+}
+
+// Forget all recorded transitions
+void BT_TraceRing::clear()
+{
+  count = dumped = 0;
+}
+
+// Copy recorded transitions to snap, oldest first
+void BT_TraceRing::snapshot(Snapshot &snap, const bool &fresh_only)
+{
+  uint64_t first = (count > SIZE) ? count - SIZE : 0;
+  if(fresh_only && (dumped > first)) first = dumped;
+
+  snap.first = first;
+  snap.entries.clear();
+  snap.entries.reserve(count - first);
+  for(uint64_t i=first; i<count; ++i)
+    snap.entries.push_back(ring[i & (SIZE-1)]);
+
+  if(fresh_only) dumped = count;
+}
+
+// Write the transitions in a snapshot to out. They're formatted into a
+// string first, so an unbuffered stream like std::cerr gets one write.
+void BT_TraceRing::write(std::ostream &out, const Snapshot &snap)
+{
+  const uint64_t count = snap.first + snap.entries.size();
+  std::ostringstream text;
+  text << "BT state machine trace: transitions " << snap.first << " to "
+       << count << " (" << snap.entries.size() << " shown)\n";
+
+  for(uint64_t i=snap.first; i<count; ++i) {
+    const BT_TraceEntry &e = snap.entries[i - snap.first];
+    text << '#' << i << ' ' << e.nsecs / 1000000000ULL << '.'
+	 << std::setw(9) << std::setfill('0') << e.nsecs % 1000000000ULL
+	 << std::setfill(' ') << ' ' << e.from->getName() << " => "
+	 << ((e.to == NULL) ? std::string("(error)") : e.to->getName());
+
+    if(e.byte < 0) text << " [no BT byte]";
+    else {
+      text << " [0x" << std::hex << std::setw(2) << std::setfill('0')
+	   << e.byte << std::dec << std::setfill(' ');
+      if((e.byte >= 0x20) && (e.byte < 0x7f))
+	text << " '" << (char) e.byte << '\'';
+      text << (e.consumed ? " consumed]" : " kept]");
+    }
+
+    if(e.indicated) {
+      switch(e.ind_type) {
+      case BTSM_Indication::STYLUS:
+	text << " STYLUS " << e.ind_cell << ' ' << (unsigned int) e.ind_dot;
+	break;
+      case BTSM_Indication::BUTTON:
+	text << " BUTTON " << e.ind_cell; break;
+      case BTSM_Indication::IOPIN_IN:
+	text << " IOPIN " << e.ind_cell << ' ' << (e.ind_dot ? "high" : "low");
+	break;
+      default:
+	text << " DONE"; break;
+      }
+    }
+    text << '\n';
+  }
+
+  out << text.str();
+  out.flush();
+}
+
+// Write recorded transitions to out, oldest first
+void BT_TraceRing::dump(std::ostream &out, const bool &fresh_only)
+{
+  Snapshot snap;
+  snapshot(snap, fresh_only);
+  write(out, snap);
+}
+
+// Constructor
+BT_TraceRing::BT_TraceRing()
+: count(0), dumped(0), curr(&ring[0]), pre_btc(0), pre_out(0) { }
+
+} // namespace BrailleTutorNS
@@ -0,0 +1,107 @@
+#ifndef _LIBBT_BT_TRACE_H_
+#define _LIBBT_BT_TRACE_H_
+/*
+ * BrailleTutor interface library
+ * BT_Trace.h, started 19 October 2026
+ *
+ * A fixed-size ring buffer recording the most recent transitions of a
+ * Braille Tutor state machine: the states involved, the byte from the
+ * Tutor at the head of the queue, any indication emitted, and a monotonic
+ * timestamp. Unlike the LIBBT_SM_DIAG_PRINT diagnostics, recording is cheap
+ * enough to leave on all the time, so the trace can be dumped after the fact
+ * when the state machine chokes on its input.
+ */
+
+#include <iostream>
+#include <vector>
+#include <stdint.h>
+
+#include "Types.h"
+#include "StateMachine.h"
+#include "BT_StateMachines.h"
+
+namespace BrailleTutorNS {
+
+//! Tracer type for BrailleTutor state machines
+typedef SMTracer<BTSM_inputT, BTSM_outputT,
+		 BTSM_dataT, BTSM_stateNameT> BT_Tracer;
+
+//! One recorded state machine transition
+struct BT_TraceEntry {
+  uint64_t nsecs;		//!< Monotonic timestamp, in nanoseconds
+  const BT_State *from;		//!< State the machine cycled in
+  const BT_State *to;		//!< State it ended up in; NULL if cycle threw
+  int16_t byte;			//!< BT byte at head of queue, or -1 if none
+  bool consumed;		//!< Whether that byte was consumed
+  bool indicated;		//!< Whether the cycle emitted an indication
+  BTSM_Indication::Type ind_type; //!< Type of the last indication emitted
+  unsigned short int ind_cell;	//!< Its cell, button, or I/O pin
+  unsigned char ind_dot;	//!< Its dot or pinstate
+};
+
+//! Ring buffer of the most recent state machine transitions
+
+//! Register an instance with BT_StateMachine::setTracer. The ring holds the
+//! last SIZE transitions; older ones are overwritten. Not thread safe:
+//! callers must serialise snapshots and dumps with the thread cycling the
+//! machine. Since formatting thousands of transitions is slow, a caller
+//! holding a lock that thread needs can take a snapshot() under it and
+//! write() the snapshot once the lock is released.
+class BT_TraceRing : public BT_Tracer {
+public:
+  //! Number of transitions kept in the ring (a power of two)
+  static const unsigned int SIZE = 4096;
+
+  //! Copy of a run of recorded transitions, for writing out later
+  struct Snapshot {
+    uint64_t first;			//!< Number of the first transition
+    std::vector<BT_TraceEntry> entries;	//!< The transitions, oldest first
+  };
+
+  //! Record the start of a cycle
+  virtual void enter(const BT_State &state,
+		     const BTSM_inputT &in, const BTSM_outputT &out);
+
+  //! Record the end of a cycle
+  virtual void leave(const BT_State &state,
+		     const BTSM_inputT &in, const BTSM_outputT &out);
+
+  //! Forget all recorded transitions
+  void clear();
+
+  //! Copy recorded transitions to snap, oldest first
+
+  //! If fresh_only is true, only transitions recorded since the last
+  //! fresh_only snapshot are copied---handy when dumping automatically on
+  //! every error, so repeated errors don't repeat the same history.
+  void snapshot(Snapshot &snap, const bool &fresh_only=false);
+
+  //! Write the transitions in a snapshot to out, in a single write
+  static void write(std::ostream &out, const Snapshot &snap);
+
+  //! Write recorded transitions to out, oldest first
+
+  //! Takes a snapshot() and write()s it; fresh_only is as for snapshot().
+  void dump(std::ostream &out, const bool &fresh_only=false);
+
+  //! Constructor
+  BT_TraceRing();
+
+private:
+  //! The ring itself
+  BT_TraceEntry ring[SIZE];
+  //! Total number of transitions ever entered
+  uint64_t count;
+  //! Value of count at the last fresh_only snapshot
+  uint64_t dumped;
+  //! Entry for the cycle in progress
+  BT_TraceEntry *curr;
+  //! Size of the BT-to-CPU queue when the cycle in progress began
+  size_t pre_btc;
+  //! Size of the output queue when the cycle in progress began
+  size_t pre_out;
+};
+
+} // namespace BrailleTutorNS
+
+#endif
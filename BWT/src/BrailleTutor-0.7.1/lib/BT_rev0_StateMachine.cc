@@ -33,7 +33,7 @@ struct r0_BTSA_makeStylusIndication : public BT_StateAction {
 		 BTException::BT_EINVAL)(a);
 
     a.out->push_back(
-      BTSM_Indication::makeStylusIndication(TimeInterval::now(), cell, dot));
+      BTSM_Indication::makeStylusIndication(a.data->now(), cell, dot));
 #ifdef LIBBT_SM_DIAG_PRINT
     std::cerr << "makeStylusIndication{" << cell << ',' << dot
 	      << '}' << std::flush;
@@ -53,7 +53,7 @@ struct r0_BTSA_makeButtonIndication : public BT_StateAction {
   unsigned short int button;
   inline virtual bool operator()(BT_StateArgs &a)
   { a.out->push_back(
-      BTSM_Indication::makeButtonIndication(TimeInterval::now(), button));
+      BTSM_Indication::makeButtonIndication(a.data->now(), button));
 #ifdef LIBBT_SM_DIAG_PRINT
     std::cerr << "makeButtonIndication{" << button << '}' << std::flush;
 #endif
@@ -73,7 +73,7 @@ struct r0_BTSA_makeIOPinIndication : public BT_StateAction {
   bool pinstate;
   inline virtual bool operator()(BT_StateArgs &a)
   { a.out->push_back(
-      BTSM_Indication::makeIOPinInIndication(TimeInterval::now(),0,pinstate));
+      BTSM_Indication::makeIOPinInIndication(a.data->now(),0,pinstate));
 #ifdef LIBBT_SM_DIAG_PRINT
     std::cerr << "makeIOPinIndication{"
 	      << (pinstate ? "high" : "low") << '}' << std::flush;
@@ -117,6 +117,43 @@ struct BT_rev0_Description : public BT_Description {
     return command;
   }
 
+  //! Check for the revision 0 autodetect signature
+
+  //! A revision 0 Tutor in autodetect mode sends a steady stream of 'n'
+  //! bytes, sometimes preceded by a few zero bytes of line noise. We want
+  //! at least four 'n's and nothing else after the first one.
+  inline virtual unsigned int matchSignature(
+    const std::deque<uint8_t> &bytes) const
+  {
+    std::deque<uint8_t>::const_iterator b_iter = bytes.begin();
+    while((b_iter != bytes.end()) && (*b_iter != 'n')) ++b_iter;
+    if((bytes.end() - b_iter) < 4) return 0;
+    for(; b_iter != bytes.end(); ++b_iter) if(*b_iter != 'n') return 0;
+    return 1;
+  }
+
+  //! Revision 0 Tutors talk at 57600 baud
+  inline virtual unsigned int baudRate() const { return 57600; }
+
+  //! Skip to the next frame boundary on a revision 0 Tutor
+
+  //! Every revision 0 report and command echo ends with an 'n' byte, so we
+  //! discard BT-to-CPU bytes through the next 'n' and resume in the "Base"
+  //! state. CPU-to-BT bytes are ignored by the revision 0 state machine
+  //! anyway and are simply cleared.
+  inline virtual bool resync(BTSM_inputT &in, unsigned long &dropped,
+			     BTSM_stateNameT &dest)
+  {
+    in.cpu_to_bt.clear();
+    while(!in.bt_to_cpu.empty()) {
+      const uint8_t byte = in.bt_to_cpu.front();
+      in.bt_to_cpu.pop_front();
+      ++dropped;
+      if(byte == 'n') { dest = "Base"; return true; }
+    }
+    return false;
+  }
+
   //! Virtual copy constructor for BT_rev0_Description objects
   inline virtual BT_rev0_Description *clone() const
   { return new BT_rev0_Description(*this); }
@@ -21,8 +21,10 @@
 #include "Types.h"
 #include "serial_io.h"
 #include "BrailleTutor.h"
+#include "BT_Trace.h"
+#include "ContactTable.h"
+#include "BT_Registry.h"
 #include "BT_StateMachines.h"
-#include "BT_rev0_StateMachine.h"
 
 #include <boost/thread/condition.hpp>
 #include <boost/thread.hpp>
@@ -32,25 +34,6 @@
 
 namespace BrailleTutorNS {
 
-///////////////////////////////
-//// HARDWARE DESCRIPTIONS ////
-///////////////////////////////
-
-//! Makes a vector with BT_Description objects describing BT hardware versions.
-static std::vector<boost::shared_ptr<BT_Description> > _make_bt_descriptions()
-{
-  std::vector<boost::shared_ptr<BT_Description> > descs;
-  // Revision 0 tutor
-  descs.push_back(boost::shared_ptr<BT_Description>(new BT_rev0_Description()));
-  // MORE DESCRIPTIONS GO HERE
-
-  return descs;
-}
-
-static std::vector<boost::shared_ptr<BT_Description> > bt_descriptions =
-  _make_bt_descriptions();
-
-
 ////////////////////////////////
 //// BRAILLE TUTOR I/O CODE ////
 ////////////////////////////////
@@ -79,12 +62,27 @@ public:
   //! The actual implementation of BrailleTutor::resetSoft()
   bool resetSoft();
 
+  //! The actual implementation of BrailleTutor::setErrorRecovery()
+  void setErrorRecovery(const bool &recover);
+
+  //! The actual implementation of BrailleTutor::getResyncStats()
+  void getResyncStats(unsigned int &resyncs, unsigned long &dropped);
+
+  //! The actual implementation of BrailleTutor::getStrayContacts()
+  unsigned long getStrayContacts();
+
+  //! The actual implementation of BrailleTutor::dumpTrace()
+  void dumpTrace(std::ostream &out);
+
+  //! The actual implementation of BrailleTutor::setTraceDump()
+  void setTraceDump(std::ostream *out);
+
   //! Constructor.
 
   //! The constructor starts the decoder and event dispatcher threads;
   //! other threads wait until a serial connection has been established
-  //! with ready() or detect().
-  BrailleTutorIO(BrailleTutor &my_bt);
+  //! with ready() or detect(). Events are timed by my_clock.
+  BrailleTutorIO(BrailleTutor &my_bt, Clock &my_clock);
 
   //! Destructor. Commands thread death and removes the serial port lockfile
   ~BrailleTutorIO();
@@ -96,6 +94,9 @@ private:
   //! BrailleTutor object whose guts we manipulate
   BrailleTutor &bt;
 
+  //! The clock events are timed by
+  Clock &clock;
+
   //! BrailleTutor hardware description
   boost::scoped_ptr<BT_Description> desc;
 
@@ -119,8 +120,20 @@ private:
   unsigned int last_pin;
   //! The pinstate discovered in the last I/O pin query
   bool last_pinstate;
-
-  //! Mutex for the model input variable
+  //! Number of indications for buttons or holes the BT doesn't have
+  unsigned long stray_contacts;
+  //! Whether the model resynchronises on parse errors instead of dying
+  bool error_recovery;
+  //! Number of times the model has resynchronised after a parse error
+  unsigned int resync_count;
+  //! Number of BT bytes discarded while resynchronising
+  unsigned long dropped_bytes;
+  //! Recent transitions of the state machine model
+  BT_TraceRing trace;
+  //! Where to dump the trace when the model chokes; NULL for nowhere
+  std::ostream *trace_dump;
+
+  //! Mutex for the model input variable (also guards resync and trace fields)
   boost::mutex mutex_model_input;
   //! Mutex for the queue of bytes actually going out to the BT
   boost::mutex mutex_real_cpu_to_bt;
@@ -276,14 +289,14 @@ struct FunctorSerialReader {
   inline void operator()()
   {
     // We poll the serial port every 30 milliseconds---a sloppy solution but
-    // likely to be portable and not too resource-intensive. Here's the
-    // interval for polling:
-    const TimeInterval poll_interval(0, 30);
+    // likely to be portable and not too resource-intensive. Polls are
+    // paced by deadline, so time spent reading doesn't stretch the interval.
+    PeriodicTicker poll(TimeInterval(0, 30));
 
     // Loop forever---check for and read bytes occasionally
     for(;;) {
       // Sleep for polling
-      poll_interval.sleep();
+      poll.wait();
 
       // grab model_input mutex
       boost::mutex::scoped_lock lock_i(mutex_model_input);
@@ -308,6 +321,8 @@ struct FunctorSerialReader {
 struct FunctorModel {
   //! Reference to the state machine model
   BT_StateMachine &model;
+  //! Reference to the BT description (used for resynchronisation)
+  BT_Description &desc;
   //! Reference to the model's copy of the I/O streams
   BTSM_inputT &model_input;
   //! Reference to the event indications output queue
@@ -320,21 +335,56 @@ struct FunctorModel {
   boost::condition &cond_model_input;
   //! Condition variable for new data present in indications
   boost::condition &cond_indications;
+  //! Reference to the error recovery flag (guarded by mutex_model_input)
+  bool &error_recovery;
+  //! Reference to the resync counter (guarded by mutex_model_input)
+  unsigned int &resync_count;
+  //! Reference to the dropped byte counter (guarded by mutex_model_input)
+  unsigned long &dropped_bytes;
+  //! Reference to the model's trace ring (guarded by mutex_model_input)
+  BT_TraceRing &trace;
+  //! Reference to the trace dump stream (guarded by mutex_model_input)
+  std::ostream *&trace_dump;
+  //! Reference to the clock indications are timestamped by
+  const Clock &clock;
+
+  //! Transitions to dump once the locks are released
+  BT_TraceRing::Snapshot pending_trace;
+  //! Where to dump them; NULL if there's nothing to dump
+  std::ostream *pending_dump;
+  //! When the last automatic dump was taken
+  TimeInterval last_dump;
+  //! Whether there has been an automatic dump yet
+  bool have_dumped;
+  //! Model errors since the last automatic dump that weren't dumped
+  unsigned int undumped_errors;
 
   //! Constructor: fills in references
-  inline FunctorModel(BT_StateMachine &my_model, BTSM_inputT &my_model_input,
+  inline FunctorModel(BT_StateMachine &my_model, BT_Description &my_desc,
+		      BTSM_inputT &my_model_input,
 		      BTSM_outputT &my_indications,
 		      boost::mutex &my_mutex_model_input,
 		      boost::mutex &my_mutex_indications,
 		      boost::condition &my_cond_model_input,
-		      boost::condition &my_cond_indications)
-  : model(my_model), model_input(my_model_input), indications(my_indications),
+		      boost::condition &my_cond_indications,
+		      bool &my_error_recovery,
+		      unsigned int &my_resync_count,
+		      unsigned long &my_dropped_bytes,
+		      BT_TraceRing &my_trace,
+		      std::ostream *&my_trace_dump,
+		      const Clock &my_clock)
+  : model(my_model), desc(my_desc),
+    model_input(my_model_input), indications(my_indications),
     mutex_model_input(my_mutex_model_input),
     mutex_indications(my_mutex_indications),
-    cond_model_input(my_cond_model_input), cond_indications(my_cond_indications)
+    cond_model_input(my_cond_model_input), cond_indications(my_cond_indications),
+    error_recovery(my_error_recovery), resync_count(my_resync_count),
+    dropped_bytes(my_dropped_bytes), trace(my_trace),
+    trace_dump(my_trace_dump), clock(my_clock), pending_dump(NULL),
+    have_dumped(false), undumped_errors(0)
   {
     // Clear out the model's data store
-    model.getData() = BTSM_dataT();
+    model.getData() = BTSM_dataT(&clock);
   }
 
   //! Perform this functor's function
@@ -347,6 +397,10 @@ struct FunctorModel {
     unsigned int lastsize_ctb = UINT_MAX;
     unsigned int lastsize_btc = UINT_MAX;
 
+    // True if the model choked on its input and we're discarding bytes
+    // until the next frame boundary.
+    bool resyncing = false;
+
     // Loop forever--wait on model input and generate indications
     for(;;) {
       // grab model_input mutex
@@ -373,24 +427,46 @@ struct FunctorModel {
       const unsigned int presize_inds = indications.size();
 
       // Stuff the model inputs into the state machine's face until it
-      // completely exhausts one of the queues. After that, stuff until the
-      // queue sizes don't change
+      // stops consuming them. If it stops while both queues still have
+      // stuff in them, it's an error in the state machine, since it should
+      // be able to do *something*. In error recovery mode, errors (and
+      // exceptions from the state machine's error states) just send us
+      // off to the next frame boundary; then we carry on.
       for(;;) {
-	const unsigned int presize_ctb = model_input.cpu_to_bt.size();
-	const unsigned int presize_btc = model_input.bt_to_cpu.size();
-	model.cycle(model_input, indications);
-	if(model_input.cpu_to_bt.empty() &&
-	   model_input.bt_to_cpu.empty()) break;
-	// The queue sizes didn't change. What happened?
-	if((presize_ctb == model_input.cpu_to_bt.size()) &&
-	   (presize_btc == model_input.bt_to_cpu.size())) {
-	  // If both queues still have stuff in them, it's an error in the
-	  // state machine, since it should be able to do *something*
-	  if((presize_ctb > 0) && (presize_btc > 0))
-	    throw BTException(BTException::BT_EMISC,
-	      "frozen internal state machine model of the Braille Tutor");
-	  else break;
+	if(resyncing) {
+	  BTSM_stateNameT dest;
+	  if(!desc.resync(model_input, dropped_bytes, dest)) break;
+	  model.setState(dest);
+	  model.getData() = BTSM_dataT(&clock);
+	  resyncing = false;
+	}
+
+	SMRunStatus status;
+	try { status = model.run(model_input, indications); }
+	catch(const BTException &) {
+	  snapshotTrace();
+	  if(!error_recovery) {
+	    lock_n.unlock();
+	    lock_i.unlock();
+	    writeTrace();
+	    throw;
+	  }
+	  resyncing = true;
+	  ++resync_count;
+	  continue;
+	}
+
+	if(status == SM_NEEDS_INPUT) break;
+	snapshotTrace();
+	if(!error_recovery) {
+	  lock_n.unlock();
+	  lock_i.unlock();
+	  writeTrace();
+	  throw BTException(BTException::BT_EMISC,
+	    "frozen internal state machine model of the Braille Tutor");
 	}
+	resyncing = true;
+	++resync_count;
       }
 
       // If the I/O indications size changed, alert that there are more
@@ -400,12 +476,51 @@ struct FunctorModel {
       // Save the sizes of the queues after that last round of processing
       lastsize_ctb = model_input.cpu_to_bt.size();
       lastsize_btc = model_input.bt_to_cpu.size();
+
+      // Write out any trace taken, without holding up the serial reader
+      lock_n.unlock();
+      lock_i.unlock();
+      writeTrace();
     }
   }
+
+  //! Copy out transitions leading up to a model error, if anyone's
+  //! listening, for writeTrace(). Call with mutex_model_input held. Dumps
+  //! come at most once a second; errors in between are just counted, and
+  //! their transitions go out with the next dump.
+  inline void snapshotTrace()
+  {
+    if(trace_dump == NULL) return;
+    const TimeInterval now = clock.now();
+    if(have_dumped && (now < last_dump + TimeInterval(1))) {
+      ++undumped_errors;
+      return;
+    }
+    trace.snapshot(pending_trace, true);
+    pending_dump = trace_dump;
+    last_dump = now;
+    have_dumped = true;
+  }
+
+  //! Write out the transitions copied by snapshotTrace(), if any. Call
+  //! with no locks held.
+  inline void writeTrace()
+  {
+    if(pending_dump == NULL) return;
+    if(undumped_errors > 0)
+      *pending_dump << "BT state machine: " << undumped_errors
+		    << " more model error(s) since the last trace\n";
+    BT_TraceRing::write(*pending_dump, pending_trace);
+    pending_dump = NULL;
+    undumped_errors = 0;
+    pending_trace.entries.clear();
+  }
 };
 
 //! The thread functor that turns I/O indications into BaseIOEvent events
 struct FunctorDecoder {
+  //! Reference to the clock we keep time by
+  Clock &clock;
   //! Reference to event indications from the state machine
   BTSM_outputT &indications;
   //! Reference to new events decoded by this object
@@ -427,14 +542,16 @@ struct FunctorDecoder {
   //! Reference to condition variable for pin query results
   boost::condition &cond_iopin_query;
 
-  //! Contains the most recent indications for active buttons or braille dots
+  //! Reference to the count of stray indications ignored (guarded by
+  //! mutex_indications)
+  unsigned long &stray_contacts;
 
-  //! We use a deque because very few buttons/dots are likely to be active at
-  //! once---searching should be pretty fast.
-  std::deque<BTSM_Indication> actives;
+  //! Active buttons and braille dots, with their most recent indications' times
+  ContactTable contacts;
 
   //! Constructor---fill in references
-  inline FunctorDecoder(BTSM_outputT &my_indications,
+  inline FunctorDecoder(Clock &my_clock,
+			BTSM_outputT &my_indications,
 			std::deque<BaseIOEvent> &my_new_events,
 			unsigned int &my_last_pin,
 			bool &my_last_pinstate,
@@ -443,15 +560,17 @@ struct FunctorDecoder {
 			boost::mutex &my_mutex_iopin_query,
 			boost::condition &my_cond_indications,
 			boost::condition &my_cond_new_events,
-			boost::condition &my_cond_iopin_query)
-  : indications(my_indications), new_events(my_new_events),
+			boost::condition &my_cond_iopin_query,
+			unsigned long &my_stray_contacts)
+  : clock(my_clock), indications(my_indications), new_events(my_new_events),
     last_pin(my_last_pin), last_pinstate(my_last_pinstate),
     mutex_indications(my_mutex_indications),
     mutex_new_events(my_mutex_new_events),
     mutex_iopin_query(my_mutex_iopin_query),
     cond_indications(my_cond_indications),
     cond_new_events(my_cond_new_events),
-    cond_iopin_query(my_cond_iopin_query) { }
+    cond_iopin_query(my_cond_iopin_query),
+    stray_contacts(my_stray_contacts) { }
 
   //! Perform this functor's function
   inline void operator()()
@@ -476,26 +595,16 @@ struct FunctorDecoder {
 
       { // ENCLOSING BLOCK: For grabbing indications mutex
       boost::mutex::scoped_lock lock_i(mutex_indications);
-      if(actives.empty()) cond_indications.wait(lock_i);
-      else {
-	// Add in timeout. First we need to know the xtime for when the
-	// timeout happens
-	boost::xtime time_end;
-	boost::xtime_get(&time_end, boost::TIME_UTC_); // Was TIME_UTC but changed to TIME_UTC_ in Boost 1.50  and greater
-	time_end.sec += poll_interval.secs;
-	const unsigned int nsecs = poll_interval.msecs * 1000000;
-	time_end.nsec += nsecs % 1000000000;
-	time_end.sec  += nsecs / 1000000000;
-	// Then wait for new indications
-	timedout = !cond_indications.timed_wait(lock_i, time_end);
-      }
+      if(contacts.empty()) cond_indications.wait(lock_i);
+      else // Wait for new indications, or for the poll interval to pass
+	timedout = !clock.waitUntil(cond_indications, lock_i,
+				    clock.now() + poll_interval);
 
       // Find the current time
-      now = TimeInterval::now();
+      now = clock.now();
 
-      // New indications? Add them to the actives
+      // New indications? Add them to the active contacts
       BTSM_outputT::const_iterator i_iter;
-      std::deque<BTSM_Indication>::iterator a_iter;
       for(i_iter=indications.begin(); i_iter!=indications.end(); ++i_iter) {
 	// If this indication is the DONE indication, pass the DONE on to
 	// the BaseIOEvent handler and quit.
@@ -519,99 +628,83 @@ struct FunctorDecoder {
 	}
 
 	// Remaining code is for cell dot and button indications. First,
-	// see if this indication exists. If it is, replace that indication
-	// with this newer one.
-	bool found = false;
+	// see if this contact is already active. If it is, note the time of
+	// this newer indication.
+	const unsigned int slot = (i_iter->type == BTSM_Indication::STYLUS) ?
+	  ContactTable::stylusSlot(i_iter->cell, i_iter->dot) :
+	  ContactTable::buttonSlot(i_iter->button);
+	if(contacts.active(slot)) {
+	  contacts.stamp(slot) = i_iter->timestamp;
+	  continue;
+	}
+
 	// For stylus events we have additional processing to eliminate
 	// spurious stylus events originating from poor contact between the
 	// stylus and the slate holes. These events make it appear that
 	// a second stylus has been inserted into a slate hole near the
 	// actual insertion point, which is not something the BT can
 	// actually detect. Thus we filter out new stylus indications if
-	// a stylus indication is already present in the actives queue.
+	// a stylus indication is already present in the active contacts.
+	if((i_iter->type == BTSM_Indication::STYLUS) &&
+	   (contacts.numStylus() > 0)) continue;
+
+	// This is a new contact, so save it to the active contacts and
+	// generate a *_DOWN BaseIOEvent. Contacts the Tutor doesn't have are
+	// ignored (and counted).
+	if(!contacts.press(slot, i_iter->timestamp)) {
+	  stray_contacts = contacts.strays();
+	  continue;
+	}
+
+	// Creating a new *_DOWN event for the new guy. First we indicate
+	// that a new event was made...
+	made_new_events = true;
+
+	// ...then we attain the mutex for the new events queue...
+	boost::mutex::scoped_lock lock(mutex_new_events);
+
+	// then we make the new event
 	if(i_iter->type == BTSM_Indication::STYLUS)
-	  for(a_iter=actives.begin(); a_iter!=actives.end(); ++a_iter) {
-	    if(a_iter->sameIndication(*i_iter)) {
-	      found = true;
-	      *a_iter = *i_iter;
-	      break;
-	    }
-	    else if(a_iter->type == BTSM_Indication::STYLUS)
-	    { found = true; break; }
-	  }
-	// For non-stylus events, handling is straightforward
-	else
-	  for(a_iter=actives.begin(); a_iter!=actives.end(); ++a_iter)
-	    if(a_iter->sameIndication(*i_iter)) {
-	      found = true;
-	      *a_iter = *i_iter;
-	      break;
-	    }
-
-	// We didn't find an indication matching this one, so add it anew
-	// to the indications list and generate a *_DOWN BaseIOEvent.
-	if(!found) {
-	  // Save the indication to the actives list
-	  actives.push_back(*i_iter);
-
-	  // Creating a new *_DOWN event for the new guy. First we indicate
+	  new_events.push_back(
+	    BaseIOEvent::makeStylusDownEvent(now, i_iter->cell, i_iter->dot));
+	else if(i_iter->type == BTSM_Indication::BUTTON)
+	  new_events.push_back(
+	    BaseIOEvent::makeButtonDownEvent(now, i_iter->button));
+      }
+      // Clear out the new indications
+      indications.clear();
+      } // END ENCLOSING BLOCK: Releasing indications mutex
+
+      // If we've timed out, let's check for dead guys among the active
+      // contacts---we kill these and create *_UP BaseIOEvents
+      if(timedout) {
+	const TimeInterval timeout = poll_interval * TimeInterval(6);
+	unsigned int slot;
+	for(slot=contacts.next(); slot!=ContactTable::NO_SLOT;
+	    slot=contacts.next(slot+1)) {
+	  // Check if this contact has timed out; if not, move along.
+	  if(!((contacts.stamp(slot) + timeout) < now)) continue;
+	  TimeInterval last_seen;
+	  contacts.release(slot, last_seen);
+
+	  // Creating a new *_UP event for the doomed guy. First we indicate
 	  // that a new event was made...
 	  made_new_events = true;
 
 	  // ...then we attain the mutex for the new events queue...
 	  boost::mutex::scoped_lock lock(mutex_new_events);
 
-	  // then we make the new event
-	  if(i_iter->type == BTSM_Indication::STYLUS)
+	  // then we make the new event.
+	  if(ContactTable::isStylusSlot(slot))
 	    new_events.push_back(
-	      BaseIOEvent::makeStylusDownEvent(now, i_iter->cell, i_iter->dot));
-	  else if(i_iter->type == BTSM_Indication::BUTTON)
+	      BaseIOEvent::makeStylusUpEvent(now, ContactTable::slotCell(slot),
+					     ContactTable::slotDot(slot)));
+	  else
 	    new_events.push_back(
-	      BaseIOEvent::makeButtonDownEvent(now, i_iter->button));
+	      BaseIOEvent::makeButtonUpEvent(now,
+					     ContactTable::slotButton(slot)));
 	}
       }
-      // Clear out the new indications
-      indications.clear();
-      } // END ENCLOSING BLOCK: Releasing indications mutex
-
-      // If we've timed out, let's check for dead guys in the actives list---
-      // we kill these and create *_UP BaseIOEvents
-      if(timedout) {
-	// Will hold indices of items to erase.
-	std::deque<unsigned int> deads;
-
-	// Here we loop over the actives list
-        unsigned int index=0;
-        std::deque<BTSM_Indication>::iterator a_iter;
-	for(a_iter=actives.begin(); a_iter!=actives.end(); ++a_iter) {
-	  // Check if this event has timed out; if so, dead.
-	  if((a_iter->timestamp + poll_interval * TimeInterval(6)) < now) {
-	    // Mark indication as condemned.
-	    deads.push_front(index);
-
-	    // Creating a new *_UP event for the doomed guy. First we indicate
-	    // that a new event was made...
-	    made_new_events = true;
-
-	    // ...then we attain the mutex for the new events queue...
-	    boost::mutex::scoped_lock lock(mutex_new_events);
-
-	    // then we make the new event.
-	    if(a_iter->type == BTSM_Indication::STYLUS)
-	      new_events.push_back(
-		BaseIOEvent::makeStylusUpEvent(now, a_iter->cell, a_iter->dot));
-	    else if(a_iter->type == BTSM_Indication::BUTTON)
-	      new_events.push_back(
-		BaseIOEvent::makeButtonUpEvent(now, a_iter->button));
-	  }
-	  ++index;
-	}
-
-	// Here we kill all of the condemend actives
-	std::deque<unsigned int>::const_iterator d_iter;
-	for(d_iter=deads.begin(); d_iter!=deads.end(); ++d_iter)
-	  actives.erase(actives.begin() + *d_iter);
-      }
 
       // If we made new events, alert the event thread that more events
       // are ready to go
@@ -716,95 +809,80 @@ void BrailleTutorIO::detect(std::string &my_serial_port, unsigned int &version)
 		      std::string("in detect(): Tutor already connected on ") +
 		      serial_port);
 
-  // Get some suggestions about which serial port to use
+  // Get some suggestions about which serial port to use, and the serial
+  // port speeds used by the Tutor revisions we know about
   std::deque<std::string> suggestions(serial_suggest_ports());
+  const std::deque<unsigned int> bauds(bt_revision_baud_rates());
 
-  // Try each suggestion one by one
+  // Try each suggestion one by one, listening at each speed in turn
+  bool found = false;
   while(!suggestions.empty()) {
-    try { 
+    std::deque<unsigned int>::const_iterator b_iter;
+    for(b_iter=bauds.begin(); b_iter!=bauds.end(); ++b_iter) {
+      try { 
 #ifndef NDEBUG
-      std::cerr << suggestions.front() << "... " << std::endl;
+	std::cerr << suggestions.front() << " @ " << *b_iter << "... "
+		  << std::endl;
 #endif
-      serial_open(suggestions.front(), serial_fd);
+	serial_open(suggestions.front(), serial_fd, *b_iter);
 #ifndef NDEBUG
-      std::cerr << "done." << std::endl;
+	std::cerr << "done." << std::endl;
 #endif
-    }
-    catch(const BTException &e) {
-      if((e.type == BTException::BT_EBUSY) ||
-	 (e.type == BTException::BT_ENOENT) ||
-	 (e.type == BTException::BT_EACCES) ||
-	 (e.type == BTException::BT_EALREADY))
-      { suggestions.pop_front(); continue; }
-      throw;
-    }
-
-    // We have an open serial port. Wait a second and try to detect the
-    // "nnnn" of serial input.
-    TimeInterval(1).sleep();
-    std::deque<uint8_t> nnns;
-    std::back_insert_iterator<std::deque<uint8_t> > inserter(nnns);
-    serial_read(serial_fd, inserter);
-
-    // TODO: This detection method is exclusively for the rev 0 BT. In the
-    // future, collect a second's worth of bytes and query each BT
-    // description until we find a match.
+      }
+      catch(const BTException &e) {
+	// The platform can't do this speed; maybe it can do the next one
+	if(e.type == BTException::BT_EINVAL) continue;
+	// This port is no good at any speed
+	if((e.type == BTException::BT_EBUSY) ||
+	   (e.type == BTException::BT_ENOENT) ||
+	   (e.type == BTException::BT_EACCES) ||
+	   (e.type == BTException::BT_EALREADY)) break;
+	throw;
+      }
 
-    // Sometimes the serial port has some 0 bytes at the head of the data
-    // stream. We first filter out any characters at the beginning of the
-    // nnns list that isn't 'n'.
-/*
-std::cerr << "Things in nnns:";
-for(unsigned int i=0;i<nnns.size();++i)
-  std::cerr << ' ' << (unsigned int) nnns[i];
-std::cerr << std::endl;
-*/
-    while(!nnns.empty())
-      if(nnns.front() == 'n') break;
-      else nnns.pop_front();
-
-    // Fewer than 4 "nnnn" in one second? Not our guy.
-    if(nnns.size() < 4) {
-      serial_close(serial_fd, suggestions.front());
-      suggestions.pop_front();
-      continue;
-    }
+      // We have an open serial port. Wait a second, collect whatever a
+      // Tutor in autodetect mode would be sending us, and see whether any
+      // of the revisions talking at this speed recognise it.
+      TimeInterval(1).sleep();
+      std::deque<uint8_t> sig_bytes;
+      std::back_insert_iterator<std::deque<uint8_t> > inserter(sig_bytes);
+      serial_read(serial_fd, inserter);
 
-    // Make sure that all of the values are "n".
-    bool all_ns = true;
-    while(!nnns.empty()) {
-      if(nnns.front() != 'n') {
-	serial_close(serial_fd, suggestions.front());
-	suggestions.pop_front();
-	all_ns = false;
+      if(bt_match_revision(sig_bytes, *b_iter, version)) {
+	found = true;
 	break;
       }
-      nnns.pop_front();
+
+      // Not our guy, at least not at this speed.
+      serial_close(serial_fd, suggestions.front());
     }
 
-    // If it really was all "n"s, quit the detection loop.
-    if(all_ns) break;
+    // If we found a Tutor, quit the detection loop.
+    if(found) break;
+    suggestions.pop_front();
   }
 
   // See whether we actually opened a serial port
-  if(serial_fd == INVALID_SERIAL_HANDLE)
+  if(!found)
     throw(BTException(BTException::BT_ENOENT,
 		      "failed to detect a waiting Braille Tutor device"));
 
   // We've found the serial port with the working tutor
   my_serial_port = serial_port = suggestions.front();
-  // We have "detected" that this BT is a rev 0 BT. TODO: Real detection
-  version = 0;
   // Initialize local copy of the BT description and the BT model
-  desc.reset(bt_descriptions[version]->clone());
+  desc.reset(bt_revision(version).clone());
   model.reset(new BT_StateMachine(desc->makeStateMachine()));
+  trace.clear();
+  model->setTracer(&trace);
 
   // Start the model thread
   t_model.reset(
     new boost::thread(
-      FunctorModel(*model, model_input, indications,
+      FunctorModel(*model, *desc, model_input, indications,
 		   mutex_model_input, mutex_indications,
-		   cond_model_input, cond_indications)));
+		   cond_model_input, cond_indications,
+		   error_recovery, resync_count, dropped_bytes,
+		   trace, trace_dump, clock)));
 
   // Start the serial threads
   t_serial_writer.reset(
@@ -836,17 +914,15 @@ void BrailleTutorIO::ready(const std::string &my_serial_port,
 		      std::string("in ready(): Tutor already connected on ") +
 		      serial_port);
 
-  // Check version argument
-  if(version >= bt_descriptions.size())
-    throw BTException(BTException::BT_EINVAL,
-		      "invalid Braille Tutor version number");
-
-  // Initialize local copy of the BT description and the BT model
-  desc.reset(bt_descriptions[version]->clone());
+  // Initialize local copy of the BT description and the BT model. This
+  // also checks the version argument.
+  desc.reset(bt_revision(version).clone());
   model.reset(new BT_StateMachine(desc->makeStateMachine()));
+  trace.clear();
+  model->setTracer(&trace);
 
   // Open serial port
-  serial_open(my_serial_port, serial_fd);
+  serial_open(my_serial_port, serial_fd, desc->baudRate());
 
   // Save the name of the I/O port
   serial_port = my_serial_port;
@@ -854,9 +930,11 @@ void BrailleTutorIO::ready(const std::string &my_serial_port,
   // Start the model thread
   t_model.reset(
     new boost::thread(
-      FunctorModel(*model, model_input, indications,
+      FunctorModel(*model, *desc, model_input, indications,
 		   mutex_model_input, mutex_indications,
-		   cond_model_input, cond_indications)));
+		   cond_model_input, cond_indications,
+		   error_recovery, resync_count, dropped_bytes,
+		   trace, trace_dump, clock)));
 
   // May as well command a soft reset here, since that doesn't need the serial
   // threads
@@ -957,12 +1035,54 @@ bool BrailleTutorIO::resetSoft()
   
   // Now reset the state machine model.
   model->setState(dest);
-  model->getData() = BTSM_dataT();
+  model->getData() = BTSM_dataT(&clock);
 
   // No exceptions? I guess we succeeded.
   return true;
 }
 
+// Enable or disable resynchronisation on state machine parse errors
+void BrailleTutorIO::setErrorRecovery(const bool &recover)
+{
+  boost::mutex::scoped_lock lock_m(mutex_model_input);
+  error_recovery = recover;
+}
+
+// Report how often the model has resynchronised and how many bytes it dropped
+void BrailleTutorIO::getResyncStats(unsigned int &resyncs,
+				    unsigned long &dropped)
+{
+  boost::mutex::scoped_lock lock_m(mutex_model_input);
+  resyncs = resync_count;
+  dropped = dropped_bytes;
+}
+
+// Report indications ignored for buttons or holes the BT doesn't have
+unsigned long BrailleTutorIO::getStrayContacts()
+{
+  boost::mutex::scoped_lock lock_i(mutex_indications);
+  return stray_contacts;
+}
+
+// Write the model's recent transitions to a stream. They're copied out
+// under the lock and formatted after, so the serial reader isn't held up.
+void BrailleTutorIO::dumpTrace(std::ostream &out)
+{
+  BT_TraceRing::Snapshot snap;
+  {
+    boost::mutex::scoped_lock lock_m(mutex_model_input);
+    trace.snapshot(snap);
+  }
+  BT_TraceRing::write(out, snap);
+}
+
+// Choose where the model's trace goes when the model chokes on its input
+void BrailleTutorIO::setTraceDump(std::ostream *out)
+{
+  boost::mutex::scoped_lock lock_m(mutex_model_input);
+  trace_dump = out;
+}
+
 // Wait for all the threads to terminate. This will actually never happen in
 // this implementation (in other words, one of your other threads should call
 // exit() when you're ready to quit the program) but it's still considered
@@ -977,16 +1097,18 @@ void BrailleTutorIO::join()
 }
 
 // BrailleTutorIO constructor
-BrailleTutorIO::BrailleTutorIO(BrailleTutor &my_bt)
-: bt(my_bt), last_pin(UINT_MAX), last_pinstate(false),
-  serial_fd(INVALID_SERIAL_HANDLE)
+BrailleTutorIO::BrailleTutorIO(BrailleTutor &my_bt, Clock &my_clock)
+: bt(my_bt), clock(my_clock), last_pin(UINT_MAX), last_pinstate(false), stray_contacts(0),
+  error_recovery(true), resync_count(0), dropped_bytes(0),
+  trace_dump(&std::cerr), serial_fd(INVALID_SERIAL_HANDLE)
 {
   // Start the decoder and dispatcher threads
   t_decoder.reset(
     new boost::thread(
-      FunctorDecoder(indications, new_events, last_pin, last_pinstate,
+      FunctorDecoder(clock, indications, new_events, last_pin, last_pinstate,
 		     mutex_indications, mutex_new_events, mutex_iopin_query,
-		     cond_indications, cond_new_events, cond_iopin_query)));
+		     cond_indications, cond_new_events, cond_iopin_query,
+		     stray_contacts)));
   t_new_events.reset(
     new boost::thread(
       FunctorNewEvents(new_events, mutex_new_events, cond_new_events, bt)));
@@ -1051,7 +1173,11 @@ BrailleTutorIO::~BrailleTutorIO()
 
 // BrailleTutor constructor
 BrailleTutor::BrailleTutor()
-: handler(NULL), btio(NULL) { }
+: handler(NULL), clock(Clock::real()), btio(NULL) { }
+
+// BrailleTutor constructor for timing events by another clock
+BrailleTutor::BrailleTutor(Clock &my_clock)
+: handler(NULL), clock(my_clock), btio(NULL) { }
 
 // Initializes internal resources---mainly constructs the btio object
 void BrailleTutor::init()
@@ -1059,7 +1185,7 @@ void BrailleTutor::init()
   if(btio != NULL)
     throw BTException(BTException::BT_EALREADY,
 		      "BrailleTutor object already initialized");
-  btio = new BrailleTutorIO(*this);
+  btio = new BrailleTutorIO(*this, clock);
 }
 
 // Checks whether init has been called; otherwise throws an exception
@@ -1135,6 +1261,41 @@ bool BrailleTutor::resetSoft()
   return btio->resetSoft();
 }
 
+// Enables or disables resynchronisation on corrupt input from the Tutor
+void BrailleTutor::setErrorRecovery(const bool &recover)
+{
+  checkReady();
+  btio->setErrorRecovery(recover);
+}
+
+// Reports resynchronisations and bytes dropped on corrupt input
+void BrailleTutor::getResyncStats(unsigned int &resyncs, unsigned long &dropped)
+{
+  checkReady();
+  btio->getResyncStats(resyncs, dropped);
+}
+
+// Reports indications ignored for buttons or holes the Tutor doesn't have
+unsigned long BrailleTutor::getStrayContacts()
+{
+  checkReady();
+  return btio->getStrayContacts();
+}
+
+// Writes the recent transitions of the Tutor model to a stream
+void BrailleTutor::dumpTrace(std::ostream &out)
+{
+  checkReady();
+  btio->dumpTrace(out);
+}
+
+// Chooses where the Tutor model trace is dumped on errors
+void BrailleTutor::setTraceDump(std::ostream *out)
+{
+  checkReady();
+  btio->setTraceDump(out);
+}
+
 // Deconstructor
 BrailleTutor::~BrailleTutor()
 {
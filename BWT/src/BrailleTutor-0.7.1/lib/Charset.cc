@@ -13,7 +13,9 @@
 #include "Charset_default.h"
 
 #include <map>
+#include <set>
 #include <cctype>
+#include <algorithm>
 #include <cassert>
 #include <fstream>
 #include <stdint.h>
@@ -171,8 +173,11 @@ static unsigned int local_utf8_encode(const uint32_t *str_32,uint8_t* &str_utf8)
 // Equality test for GlyphMapping objects (compares the str member)
 bool GlyphMapping::equals(const GlyphMapping &gm) const
 {
-  const uint8_t *my_rnr = str.get();
-  const uint8_t *gm_rnr = gm.str.get();
+  // Interned long glyphs may share storage
+  if(long_glyph && (long_glyph == gm.long_glyph)) return true;
+
+  const uint8_t *my_rnr = str();
+  const uint8_t *gm_rnr = gm.str();
 
   for(;;) {
     if(!*my_rnr) {
@@ -192,8 +197,8 @@ bool GlyphMapping::equals(const GlyphMapping &gm) const
 // Comparison for GlyphMapping objects (compares the str_w member)
 bool GlyphMapping::lt(const GlyphMapping &gm) const
 {
-  const uint32_t *my_rnr = str_w.get();
-  const uint32_t *gm_rnr = gm.str_w.get();
+  const uint32_t *my_rnr = str_w();
+  const uint32_t *gm_rnr = gm.str_w();
 
   for(;;) {
     if(!*my_rnr) {
@@ -211,40 +216,77 @@ bool GlyphMapping::lt(const GlyphMapping &gm) const
   return true; // should never get here.
 }
 
+// Store strings of the given lengths inline, or else in a new LongGlyph
+void GlyphMapping::store(const uint8_t *my_str, const unsigned int &len,
+			 const uint32_t *my_str_w, const unsigned int &len_w)
+{
+  if((len < INLINE_BYTES) && (len_w < INLINE_CHARS)) {
+    long_glyph.reset();
+    std::copy(my_str, my_str + len + 1, in_str);
+    std::copy(my_str_w, my_str_w + len_w + 1, in_str_w);
+  }
+  else {
+    LongGlyph *lg = new LongGlyph;
+    lg->str.assign(my_str, my_str + len + 1);
+    lg->str_w.assign(my_str_w, my_str_w + len_w + 1);
+    long_glyph.reset(lg);
+    in_str[0] = 0;
+    in_str_w[0] = 0;
+  }
+}
+
 // Initializes GlyphMapping from a character string
 void GlyphMapping::initFromStr(const uint8_t *my_str)
 {
-  str.reset(new uint8_t[local_strlen(my_str) + 1]);
-  local_strcpy(str.get(), my_str);
-
-  uint32_t *my_str_w;
-  local_utf8_decode(str.get(), my_str_w);
-  str_w.reset(my_str_w);
+  const unsigned int len = local_strlen(my_str);
+
+  // Short strings are decoded on the stack
+  if(len < INLINE_BYTES) {
+    uint32_t my_str_w[INLINE_BYTES];
+    uint32_t *sw_runner = my_str_w;
+    const uint8_t *s_runner = my_str;
+    do { s_runner += local_utf8_decode_char(s_runner, *sw_runner); }
+    while(*sw_runner++);
+    store(my_str, len, my_str_w, sw_runner - my_str_w - 1);
+  }
+  else {
+    uint32_t *my_str_w;
+    const unsigned int len_w = local_utf8_decode(my_str, my_str_w);
+    store(my_str, len, my_str_w, len_w);
+    delete[] my_str_w;
+  }
 }
 
 // Constructor: converts an array of 32-bit ints to a GlyphMapping.
 GlyphMapping::GlyphMapping(const uint32_t *my_str_w)
 {
-  str_w.reset(new uint32_t[local_strlen(my_str_w) + 1]);
-  local_strcpy(str_w.get(), my_str_w);
-
-  uint8_t *my_str;
-  local_utf8_encode(str_w.get(), my_str);
-  str.reset(my_str);
+  const unsigned int len_w = local_strlen(my_str_w);
+
+  // Short strings are encoded on the stack
+  if(len_w < INLINE_CHARS) {
+    uint8_t my_str[INLINE_CHARS*4];
+    uint8_t *s_runner = my_str;
+    const uint32_t *sw_runner = my_str_w;
+    do { s_runner += local_utf8_encode_ch32(*sw_runner, s_runner); }
+    while(*sw_runner++);
+    store(my_str, local_strlen(my_str), my_str_w, len_w);
+  }
+  else {
+    uint8_t *my_str;
+    const unsigned int len = local_utf8_encode(my_str_w, my_str);
+    store(my_str, len, my_str_w, len_w);
+    delete[] my_str;
+  }
 }
 
-// Duplicates this GlyphMapping s.t. the pointers point at new copies of
-// the string data.
+// Returns a GlyphMapping that shares no storage with this GlyphMapping
 GlyphMapping GlyphMapping::dup() const
 {
-  GlyphMapping my_dup;
-
-  my_dup.str.reset(new uint8_t[local_strlen(str.get() + 1)]);
-  my_dup.str_w.reset(new uint32_t[local_strlen(str_w.get() + 1)]);
-
-  local_strcpy(my_dup.str.get(), str.get());
-  local_strcpy(my_dup.str_w.get(), str_w.get());
+  if(isInline()) return *this;
 
+  GlyphMapping my_dup;
+  my_dup.store(str(), long_glyph->str.size() - 1,
+	       str_w(), long_glyph->str_w.size() - 1);
   return my_dup;
 }
 
@@ -278,43 +320,282 @@ static const Charset default_charset = make_default_charset();
 // INVALID_DOTS or the second parameter to the empty wstring.
 void Charset::set(const unsigned char &dots, const GlyphMapping &letter)
 {
-  // Useful variable
-  std::map<GlyphMapping, unsigned char>::iterator i;
+  assign(dots, letter);
+  updateTables();
+}
 
+// Changes the mapping and the letter index only
+void Charset::assign(const unsigned char &dots, const GlyphMapping &letter)
+{
   // The user wants to erase an entry, indexed by the letter.
   if(dots == INVALID_DOTS) {
-    i = letters_to_dots.find(letter);
+    const IndexSlot &slot = letter_index[probe(letter)];
 
     // Nothing doing---no such entry
-    if(i == letters_to_dots.end()) return;
+    if(slot.tag == 0) return;
 
     // Erase the entry
-    dots_to_letters[i->second] = GlyphMapping();
-    letters_to_dots.erase(i);
+    const unsigned char old_dots = slot.dots;
+    unindex(letter, old_dots);
+    dots_to_letters[old_dots] = GlyphMapping();
   }
   // The user wants to erase an entry, indexed by the dot pattern
   else if(letter.isEmpty()) {
     // Nothing doing---no such entry
     if(dots_to_letters[dots].isEmpty()) return;
 
-    // Look up the counterpart in the reverse mapping
-    i = letters_to_dots.find(dots_to_letters[dots]);
-    assert(i != letters_to_dots.end());
-
     // Erase the entry
+    unindex(dots_to_letters[dots], dots);
     dots_to_letters[dots] = GlyphMapping();
-    letters_to_dots.erase(i);
   }
   // The user genuinely wants to change a mapping or insert a new one
   else {
-    dots_to_letters[dots] = letter;
-    letters_to_dots[letter] = dots;
+    if(!dots_to_letters[dots].isEmpty()) unindex(dots_to_letters[dots], dots);
+    dots_to_letters[dots] = intern(letter);
+    index(dots_to_letters[dots], dots);
+  }
+}
+
+// Add letter, mapped from dots, to the letter index. If the letter is
+// already there, it's remapped to dots; the pattern it was mapped from
+// keeps it, as with the old map, but reverse lookups find the newest.
+void Charset::index(const GlyphMapping &letter, const unsigned char &dots)
+{
+  IndexSlot &slot = letter_index[probe(letter)];
+  if(slot.tag == 0) {
+    slot.tag = tagOf(hash(letter));
+    ++num_letters;
+  }
+  slot.dots = dots;
+}
+
+// Remove letter from the letter index if it's mapped from dots there. If
+// another pattern still maps to the letter, the letter is reindexed to it.
+// Removal shifts later slots of the probe sequence back into the gap, so
+// no tombstones are needed.
+void Charset::unindex(const GlyphMapping &letter, const unsigned char &dots)
+{
+  unsigned int hole = probe(letter);
+  if((letter_index[hole].tag == 0) || (letter_index[hole].dots != dots))
+    return;
+
+  letter_index[hole].tag = 0;
+  --num_letters;
+  for(unsigned int s=(hole+1) & (INDEX_SLOTS-1); letter_index[s].tag != 0;
+      s=(s+1) & (INDEX_SLOTS-1)) {
+    // Move this slot back only if the gap lies on its probe sequence
+    const unsigned int home =
+      homeSlot(hash(dots_to_letters[letter_index[s].dots]));
+    if(((s - home) & (INDEX_SLOTS-1)) >= ((s - hole) & (INDEX_SLOTS-1))) {
+      letter_index[hole] = letter_index[s];
+      letter_index[s].tag = 0;
+      hole = s;
+    }
+  }
+
+  for(unsigned int i=0; i<256; ++i)
+    if((i != dots) && dots_to_letters[i].equals(letter)) {
+      index(dots_to_letters[i], i);
+      break;
+    }
+}
+
+// Recompute which dot patterns are mapped and can't be extended to another
+// mapped pattern. Superset patterns are numerically larger, so one sweep
+// down from 255 sees every pattern's supersets before the pattern itself.
+void Charset::updateSettled()
+{
+  // reachable[p]: p or some pattern made by adding dots to p is mapped
+  bool reachable[256];
+
+  for(int p=255; p>=0; --p) {
+    bool extensible = false;
+    for(unsigned int dot=0; dot<8; ++dot) {
+      const unsigned int bit = 1u << dot;
+      if(!(p & bit) && reachable[p | bit]) { extensible = true; break; }
+    }
+    const bool mapped = !dots_to_letters[p].isEmpty();
+    reachable[p] = mapped || extensible;
+    settled[p] = mapped && !extensible;
   }
 }
 
+// Recompute the dot pattern of every one-byte letter. The letter index
+// decides, so when several patterns map to a letter, this agrees with
+// operator[].
+void Charset::updateAscii()
+{
+  ascii_dots[0] = INVALID_DOTS; // no letter is empty
+  for(unsigned int c=1; c<128; ++c) {
+    const uint8_t byte = c;
+    const IndexSlot &slot = letter_index[probe(&byte, 1)];
+    ascii_dots[c] = slot.tag ? slot.dots : INVALID_DOTS;
+  }
+}
+
+// Recompute the nearest mapped patterns to every dot pattern. Candidates
+// are taken in order, so ties come out lowest pattern first.
+void Charset::updateNearest()
+{
+  unsigned char mapped[256];
+  unsigned int num_mapped = 0;
+  for(unsigned int p=0; p<256; ++p)
+    if(!dots_to_letters[p].isEmpty()) mapped[num_mapped++] = p;
+
+  for(unsigned int w=0; w<256; ++w) {
+    Nearest &closest = nearest_table[w];
+    closest.count = 0;
+    closest.mirrored = 0;
+    const unsigned char mirror = DotsMirror::mirrors[w];
+    unsigned int best = ~0u;
+    for(unsigned int m=0; m<num_mapped; ++m) {
+      const unsigned char p = mapped[m];
+      if(p == w) continue;
+      const unsigned int straight = dotDistance(w, p);
+      const unsigned int flipped = MIRROR_COST + dotDistance(mirror, p);
+      const unsigned int distance = (flipped < straight) ? flipped : straight;
+      if(distance > best) continue;
+      if(distance < best) { best = distance; closest.count = 0; closest.mirrored = 0; }
+      if(closest.count == MAX_NEAREST) continue;
+      if(flipped < straight) closest.mirrored |= 1 << closest.count;
+      closest.dots[closest.count++] = p;
+    }
+    closest.distance = closest.count ? best : 0;
+  }
+}
+
+// Dots to change to turn written, as it was meant, into dots[i]
+unsigned char Charset::Nearest::differences(const unsigned char &written,
+					    const unsigned int &i) const
+{
+  const unsigned char meant =
+    (mirrored & (1 << i)) ? DotsMirror::mirrors[written] : written;
+  return meant ^ dots[i];
+}
+
+// Bytes in the UTF-8 character starting with lead. Stray continuation
+// bytes and invalid lead bytes count as characters of their own.
+static inline size_t utf8_char_bytes(const uint8_t &lead)
+{
+  if(lead < 0xc0) return 1;
+  if(lead < 0xe0) return 2;
+  if(lead < 0xf0) return 3;
+  if(lead < 0xf8) return 4;
+  return 1;
+}
+
+// Transcode UTF-8 text into dot patterns, one per character
+size_t Charset::transcode(const char *text, const size_t &length,
+			  unsigned char *dots, const size_t &max_dots) const
+{
+  const uint8_t *c = (const uint8_t*) text;
+  const uint8_t *const end = c + length;
+  size_t n = 0;
+
+  while(c < end) {
+    unsigned char d;
+    if(*c < 0x80) d = ascii_dots[*c++];
+    else {
+      size_t bytes = utf8_char_bytes(*c);
+      if(bytes > (size_t) (end - c)) bytes = end - c;
+      const IndexSlot &slot = letter_index[probe(c, bytes)];
+      d = slot.tag ? slot.dots : INVALID_DOTS;
+      c += bytes;
+    }
+    if(n < max_dots) dots[n] = d;
+    ++n;
+  }
+
+  return n;
+}
+
+// Transcode a list of UTF-8 words into one packed array. A word has no
+// more characters than bytes, so each is transcoded straight into room
+// made for that many, which is then trimmed.
+void Charset::transcode(const std::vector<std::string> &words,
+			std::vector<unsigned char> &dots,
+			std::vector<uint32_t> &starts) const
+{
+  dots.clear();
+  starts.clear();
+  for(unsigned int w=0; w<words.size(); ++w) {
+    const size_t start = dots.size();
+    starts.push_back(start);
+    if(words[w].empty()) continue;
+    dots.resize(start + words[w].size());
+    dots.resize(start + transcode(words[w], &dots[start], words[w].size()));
+  }
+  starts.push_back(dots.size());
+}
+
+// Share storage for a long glyph with an equal one in this character set
+GlyphMapping Charset::intern(const GlyphMapping &letter)
+{
+  if(letter.isInline()) return letter;
+  return *interned.insert(letter).first;
+}
+
 // Facilitates lookup/retrieval of mirrored dot patterns
 DotsMirror Charset::mir() const { return DotsMirror(*this); }
 
+// Mirror images of all 256 dot patterns. A constant table, so it's ready
+// before any static initializer that might want it.
+const unsigned char DotsMirror::mirrors[256] = {
+  0x00, 0x08, 0x10, 0x18, 0x20, 0x28, 0x30, 0x38,
+  0x01, 0x09, 0x11, 0x19, 0x21, 0x29, 0x31, 0x39,
+  0x02, 0x0a, 0x12, 0x1a, 0x22, 0x2a, 0x32, 0x3a,
+  0x03, 0x0b, 0x13, 0x1b, 0x23, 0x2b, 0x33, 0x3b,
+  0x04, 0x0c, 0x14, 0x1c, 0x24, 0x2c, 0x34, 0x3c,
+  0x05, 0x0d, 0x15, 0x1d, 0x25, 0x2d, 0x35, 0x3d,
+  0x06, 0x0e, 0x16, 0x1e, 0x26, 0x2e, 0x36, 0x3e,
+  0x07, 0x0f, 0x17, 0x1f, 0x27, 0x2f, 0x37, 0x3f,
+  0x80, 0x88, 0x90, 0x98, 0xa0, 0xa8, 0xb0, 0xb8,
+  0x81, 0x89, 0x91, 0x99, 0xa1, 0xa9, 0xb1, 0xb9,
+  0x82, 0x8a, 0x92, 0x9a, 0xa2, 0xaa, 0xb2, 0xba,
+  0x83, 0x8b, 0x93, 0x9b, 0xa3, 0xab, 0xb3, 0xbb,
+  0x84, 0x8c, 0x94, 0x9c, 0xa4, 0xac, 0xb4, 0xbc,
+  0x85, 0x8d, 0x95, 0x9d, 0xa5, 0xad, 0xb5, 0xbd,
+  0x86, 0x8e, 0x96, 0x9e, 0xa6, 0xae, 0xb6, 0xbe,
+  0x87, 0x8f, 0x97, 0x9f, 0xa7, 0xaf, 0xb7, 0xbf,
+  0x40, 0x48, 0x50, 0x58, 0x60, 0x68, 0x70, 0x78,
+  0x41, 0x49, 0x51, 0x59, 0x61, 0x69, 0x71, 0x79,
+  0x42, 0x4a, 0x52, 0x5a, 0x62, 0x6a, 0x72, 0x7a,
+  0x43, 0x4b, 0x53, 0x5b, 0x63, 0x6b, 0x73, 0x7b,
+  0x44, 0x4c, 0x54, 0x5c, 0x64, 0x6c, 0x74, 0x7c,
+  0x45, 0x4d, 0x55, 0x5d, 0x65, 0x6d, 0x75, 0x7d,
+  0x46, 0x4e, 0x56, 0x5e, 0x66, 0x6e, 0x76, 0x7e,
+  0x47, 0x4f, 0x57, 0x5f, 0x67, 0x6f, 0x77, 0x7f,
+  0xc0, 0xc8, 0xd0, 0xd8, 0xe0, 0xe8, 0xf0, 0xf8,
+  0xc1, 0xc9, 0xd1, 0xd9, 0xe1, 0xe9, 0xf1, 0xf9,
+  0xc2, 0xca, 0xd2, 0xda, 0xe2, 0xea, 0xf2, 0xfa,
+  0xc3, 0xcb, 0xd3, 0xdb, 0xe3, 0xeb, 0xf3, 0xfb,
+  0xc4, 0xcc, 0xd4, 0xdc, 0xe4, 0xec, 0xf4, 0xfc,
+  0xc5, 0xcd, 0xd5, 0xdd, 0xe5, 0xed, 0xf5, 0xfd,
+  0xc6, 0xce, 0xd6, 0xde, 0xe6, 0xee, 0xf6, 0xfe,
+  0xc7, 0xcf, 0xd7, 0xdf, 0xe7, 0xef, 0xf7, 0xff
+};
+
+// Weight of each dot pattern for dotDistance(): 2 for each of dots 1-6 in
+// it and 1 for each of dots 7 and 8
+const unsigned char Charset::dot_weights[256] = {
+  0, 2, 2, 4, 2, 4, 4, 6, 2, 4, 4, 6, 4, 6, 6, 8,
+  2, 4, 4, 6, 4, 6, 6, 8, 4, 6, 6, 8, 6, 8, 8, 10,
+  2, 4, 4, 6, 4, 6, 6, 8, 4, 6, 6, 8, 6, 8, 8, 10,
+  4, 6, 6, 8, 6, 8, 8, 10, 6, 8, 8, 10, 8, 10, 10, 12,
+  1, 3, 3, 5, 3, 5, 5, 7, 3, 5, 5, 7, 5, 7, 7, 9,
+  3, 5, 5, 7, 5, 7, 7, 9, 5, 7, 7, 9, 7, 9, 9, 11,
+  3, 5, 5, 7, 5, 7, 7, 9, 5, 7, 7, 9, 7, 9, 9, 11,
+  5, 7, 7, 9, 7, 9, 9, 11, 7, 9, 9, 11, 9, 11, 11, 13,
+  1, 3, 3, 5, 3, 5, 5, 7, 3, 5, 5, 7, 5, 7, 7, 9,
+  3, 5, 5, 7, 5, 7, 7, 9, 5, 7, 7, 9, 7, 9, 9, 11,
+  3, 5, 5, 7, 5, 7, 7, 9, 5, 7, 7, 9, 7, 9, 9, 11,
+  5, 7, 7, 9, 7, 9, 9, 11, 7, 9, 9, 11, 9, 11, 11, 13,
+  2, 4, 4, 6, 4, 6, 6, 8, 4, 6, 6, 8, 6, 8, 8, 10,
+  4, 6, 6, 8, 6, 8, 8, 10, 6, 8, 8, 10, 8, 10, 10, 12,
+  4, 6, 6, 8, 6, 8, 8, 10, 6, 8, 8, 10, 8, 10, 10, 12,
+  6, 8, 8, 10, 8, 10, 10, 12, 8, 10, 10, 12, 10, 12, 12, 14
+};
+
 // Returns a const reference to the default character set
 const Charset &Charset::defaultCharset() { return default_charset; }
 
@@ -348,11 +629,21 @@ struct FIOSM_dataT {
   //! Line numbers (1-indexed) of lines containing syntax errors
   std::vector<unsigned int> error_lines;
 
+  //! Line numbers (1-indexed) of lines mapping a dot pattern already
+  //! mapped by an earlier line
+  std::vector<unsigned int> remapped_lines;
+  //! Which dot patterns lines read so far have mapped
+  bool mapped[256];
+  //! Mappings read so far, in file order; read() applies them all at once
+  //! at the end, so the charset's tables are rebuilt only the once
+  std::vector<std::pair<uint8_t, GlyphMapping> > mappings;
+
   //! Adds the current line number to the list of lines with errors
   inline void markError() { error_lines.push_back(lineno); }
 
   //! No-arg ctor sets tmpchr to '\0'
-  inline FIOSM_dataT() : charset(NULL), tmpchr('\0'), lineno(1) { }
+  inline FIOSM_dataT() : charset(NULL), tmpchr('\0'), lineno(1)
+  { std::fill(mapped, mapped + 256, false); }
 };
 
 //! Name type for File IO state machines---just strings
@@ -770,8 +1061,11 @@ struct FIOS_Letr : public FIO_State {
       for(unsigned int i=0; i<data.tmpchrs.size(); ++i)
 	newletter[i] = data.tmpchrs[i];
 
-      // Inject new mapping
-      data.charset->set(data.tmpchr, newletter);
+      // Queue new mapping, noting if an earlier line mapped the pattern
+      if(data.mapped[data.tmpchr]) data.remapped_lines.push_back(data.lineno);
+      data.mapped[data.tmpchr] = true;
+      data.mappings.push_back(std::make_pair(data.tmpchr,
+					     GlyphMapping(newletter)));
 
       // Increment line number.
       // Note last char so we don't count redundantly for CR/LF.
@@ -868,6 +1162,14 @@ static FIO_StateMachine assemble_FIOSM(Charset *charset)
 
 // Load a mapping from a UTF-8 input stream
 std::vector<unsigned int> Charset::read(std::istream &in)
+{
+  std::vector<unsigned int> remapped_lines;
+  return read(in, remapped_lines);
+}
+
+// Load a mapping from a UTF-8 input stream, noting remapped dot patterns
+std::vector<unsigned int> Charset::read(std::istream &in,
+					std::vector<unsigned int> &remapped_lines)
 {
   // Create the state machine itself...
   FIO_StateMachine fiosm(assemble_FIOSM(this));
@@ -883,11 +1185,27 @@ std::vector<unsigned int> Charset::read(std::istream &in)
     fiosm.cycle(in_chr, not_finished_yet);
   }
 
+  // Apply the mappings read, then rebuild the derived tables once
+  const std::vector<std::pair<uint8_t, GlyphMapping> > &mappings =
+    fiosm.getData().mappings;
+  for(unsigned int i=0; i<mappings.size(); ++i)
+    assign(mappings[i].first, mappings[i].second);
+  if(!mappings.empty()) updateTables();
+
+  remapped_lines = fiosm.getData().remapped_lines;
   return fiosm.getData().error_lines;
 }
 
 // Load a mapping from a UTF-8 file
 std::vector<unsigned int> Charset::read(const std::string &filename)
+{
+  std::vector<unsigned int> remapped_lines;
+  return read(filename, remapped_lines);
+}
+
+// Load a mapping from a UTF-8 file, noting remapped dot patterns
+std::vector<unsigned int> Charset::read(const std::string &filename,
+					std::vector<unsigned int> &remapped_lines)
 {
 
   // Open the file
@@ -899,14 +1217,14 @@ std::vector<unsigned int> Charset::read(const std::string &filename)
 		      " for reading");
 
   // Read in info
-  return read(in);
+  return read(in, remapped_lines);
 }
 
 // Write a mapping to a UTF-8 output stream
 void Charset::write(std::ostream &out) const
 {
   // Write the header text, charset name included
-  out << "!UTF-8 BEGIN " << name.str.get() << std::endl;
+  out << "!UTF-8 BEGIN " << name.str() << std::endl;
 
   // Write out non-empty mappings
   for(unsigned int i=0; i<256; ++i)
@@ -925,7 +1243,7 @@ void Charset::write(std::ostream &out) const
       if(i_as_char == 0x00) out << "0x00";
 
       // Now the mapped "letter"
-      out << '\t' << dots_to_letters[i].str.get() << std::endl;
+      out << '\t' << dots_to_letters[i].str() << std::endl;
     }
 
   // Footer text
@@ -0,0 +1,317 @@
+/*
+ * Braille Tutor interface library
+ * CharsetImage.cc, started 19 October 2026
+ *
+ * Implements the compiled binary form of Charset objects. Text mapping
+ * files stay the source of truth; compile_charset (see tools/) turns them
+ * into images that load by mapping the file into memory and copying its
+ * tables in whole, with no parsing and no rehashing.
+ *
+ * A compiled charset is laid out like so, all integers in the byte order of
+ * the machine that wrote it:
+ *
+ *    CompiledHeader		magic, byte order mark, version, sizes
+ *    uint32_t[256]		offset of each dot pattern's glyph in the
+ *				string pool, or NO_GLYPH
+ *    IndexSlot[INDEX_SLOTS]	Charset's letter index, verbatim
+ *    uint8_t[256]		Charset's settled table (not read back: it
+ *				follows from the mapping, and is rebuilt)
+ *    uint8_t[256]		DotsMirror's mirror table
+ *    char[pool_size]		string pool: null-terminated UTF-8 strings
+ *
+ * The letter index depends on Charset's hash function and table size, so
+ * changing either means bumping COMPILED_VERSION.
+ */
+
+#include "Types.h"
+#include "Charset.h"
+
+#include <string>
+#include <vector>
+#include <cstring>
+#include <fstream>
+#include <stdint.h>
+
+#include <sys/types.h>
+#include <sys/stat.h>
+
+#ifdef BT_WINDOWS
+#include "Windows.h"
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#endif
+
+#include <boost/utility.hpp>
+
+namespace BrailleTutorNS {
+
+//! Identifies a compiled charset file
+static const char compiled_magic[8] = { 'B','T','C','H','R','S','E','T' };
+//! Written as is, so a reader can tell the writer's byte order from its own
+static const uint32_t compiled_byte_order = 0x01020304;
+//! Version of the compiled format; bump it when the layout or hash changes
+static const uint32_t COMPILED_VERSION = 1;
+//! Glyph offset for dot patterns without a glyph
+static const uint32_t NO_GLYPH = 0xffffffff;
+
+//! Header of a compiled charset file
+struct CompiledHeader {
+  char magic[8];		//!< compiled_magic
+  uint32_t byte_order;		//!< compiled_byte_order, as written
+  uint32_t version;		//!< COMPILED_VERSION
+  uint32_t index_slots;		//!< Charset::INDEX_SLOTS
+  uint32_t num_letters;		//!< Letters in the letter index
+  uint32_t name;		//!< Offset of the charset's name in the pool
+  uint32_t pool_size;		//!< Bytes in the string pool
+};
+
+//! A file mapped read-only into memory, for as long as this object lives
+class MappedFile : public boost::noncopyable {
+public:
+  //! Map filename; will throw a BT_EIO BTException if that fails
+  MappedFile(const std::string &filename);
+  //! Unmap the file
+  ~MappedFile();
+
+  //! The file's contents
+  inline const uint8_t *data() const { return bytes; }
+  //! The file's size in bytes
+  inline size_t size() const { return length; }
+
+private:
+  //! The file's contents; NULL if the file is empty
+  const uint8_t *bytes;
+  //! The file's size in bytes
+  size_t length;
+
+#ifdef BT_WINDOWS
+  //! Handle of the open file
+  HANDLE file;
+  //! Handle of the file mapping
+  HANDLE mapping;
+#endif
+
+  //! Throw a BT_EIO BTException about filename
+  static inline void fail(const std::string &filename)
+  { throw BTException(BTException::BT_EIO,
+		      std::string("failed to map file ") + filename +
+		      " for reading"); }
+};
+
+#ifdef BT_WINDOWS
+// Map filename
+MappedFile::MappedFile(const std::string &filename)
+: bytes(NULL), length(0), file(INVALID_HANDLE_VALUE), mapping(NULL)
+{
+  file = CreateFileA(filename.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL,
+		     OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+  if(file == INVALID_HANDLE_VALUE) fail(filename);
+
+  length = GetFileSize(file, NULL);
+  if(length == 0) return;
+
+  mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+  if(mapping != NULL)
+    bytes = (const uint8_t *) MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+  if(bytes == NULL) {
+    if(mapping != NULL) CloseHandle(mapping);
+    CloseHandle(file);
+    fail(filename);
+  }
+}
+
+// Unmap the file
+MappedFile::~MappedFile()
+{
+  if(bytes != NULL) UnmapViewOfFile(bytes);
+  if(mapping != NULL) CloseHandle(mapping);
+  CloseHandle(file);
+}
+#else
+// Map filename. The descriptor can be closed once the mapping is made.
+MappedFile::MappedFile(const std::string &filename)
+: bytes(NULL), length(0)
+{
+  const int fd = open(filename.c_str(), O_RDONLY);
+  if(fd < 0) fail(filename);
+
+  struct stat info;
+  if(fstat(fd, &info) != 0) { close(fd); fail(filename); }
+  length = info.st_size;
+
+  if(length > 0) {
+    void *mapped = mmap(NULL, length, PROT_READ, MAP_PRIVATE, fd, 0);
+    if(mapped == MAP_FAILED) { close(fd); fail(filename); }
+    bytes = (const uint8_t *) mapped;
+  }
+  close(fd);
+}
+
+// Unmap the file
+MappedFile::~MappedFile()
+{ if(bytes != NULL) munmap((void *) bytes, length); }
+#endif
+
+//! True if a null-terminated string starts at offset in the string pool
+static inline bool pool_string(const char *pool, const uint32_t &pool_size,
+			       const uint32_t &offset)
+{ return (offset < pool_size) &&
+	 (std::memchr(pool + offset, 0, pool_size - offset) != NULL); }
+
+//! Throw a BT_EINVAL BTException about a bad compiled charset
+static inline void bad_compiled(const std::string &filename,
+				const std::string &why)
+{ throw BTException(BTException::BT_EINVAL,
+		    std::string("bad compiled charset ") + filename + ": " + why); }
+
+// Load a mapping compiled by writeCompiled()
+void Charset::readCompiled(const std::string &filename)
+{
+  const MappedFile file(filename);
+
+  // Carve the file up into its sections, checking they're all there
+  const size_t tables_size = sizeof(CompiledHeader) + 256*sizeof(uint32_t) +
+			     INDEX_SLOTS*sizeof(IndexSlot) + 256 + 256;
+  if(file.size() < tables_size) bad_compiled(filename, "truncated");
+
+  CompiledHeader header;
+  std::memcpy(&header, file.data(), sizeof(header));
+  if(std::memcmp(header.magic, compiled_magic, sizeof(compiled_magic)) != 0)
+    bad_compiled(filename, "not a compiled charset");
+  if(header.byte_order != compiled_byte_order)
+    bad_compiled(filename, "written with another byte order");
+  if(header.version != COMPILED_VERSION)
+    bad_compiled(filename, "unsupported version");
+  if(header.index_slots != INDEX_SLOTS)
+    bad_compiled(filename, "letter index has the wrong size");
+  if(file.size() != tables_size + header.pool_size)
+    bad_compiled(filename, "truncated");
+
+  const uint8_t *section = file.data() + sizeof(CompiledHeader);
+  uint32_t glyphs[256];
+  std::memcpy(glyphs, section, sizeof(glyphs));
+  section += sizeof(glyphs);
+  const uint8_t *index_section = section;
+  section += INDEX_SLOTS*sizeof(IndexSlot);
+  section += 256; // settled table, rebuilt below
+  if(std::memcmp(section, DotsMirror::mirrors, 256) != 0)
+    bad_compiled(filename, "mirror table doesn't match this library's");
+  section += 256;
+  const char *pool = (const char *) section;
+
+  // Build the charset aside, so that a bad file changes nothing
+  if(!pool_string(pool, header.pool_size, header.name))
+    bad_compiled(filename, "bad name");
+  Charset loaded(GlyphMapping((const uint8_t *) pool + header.name));
+
+  for(unsigned int p=0; p<256; ++p) {
+    if(glyphs[p] == NO_GLYPH) continue;
+    if(!pool_string(pool, header.pool_size, glyphs[p]) || (p == INVALID_DOTS))
+      bad_compiled(filename, "bad glyph");
+    loaded.dots_to_letters[p] =
+      loaded.intern(GlyphMapping((const uint8_t *) pool + glyphs[p]));
+  }
+
+  std::memcpy(loaded.letter_index, index_section,
+	      INDEX_SLOTS*sizeof(IndexSlot));
+
+  // The index must hold exactly the mapped letters, where probes find them.
+  // Counting first makes sure there are empty slots to end the probes.
+  unsigned int used = 0;
+  for(unsigned int s=0; s<INDEX_SLOTS; ++s)
+    if(loaded.letter_index[s].tag != 0) ++used;
+  if((used != header.num_letters) || (used > 256))
+    bad_compiled(filename, "bad letter count");
+  loaded.num_letters = used;
+
+  for(unsigned int s=0; s<INDEX_SLOTS; ++s) {
+    const IndexSlot &slot = loaded.letter_index[s];
+    if(slot.tag == 0) continue;
+    if(loaded.dots_to_letters[slot.dots].isEmpty() ||
+       (loaded.probe(loaded.dots_to_letters[slot.dots]) != s))
+      bad_compiled(filename, "bad letter index");
+  }
+  for(unsigned int p=0; p<256; ++p)
+    if(!loaded.dots_to_letters[p].isEmpty() &&
+       (loaded[loaded.dots_to_letters[p]] == INVALID_DOTS))
+      bad_compiled(filename, "letter missing from the letter index");
+
+  loaded.updateTables();
+  *this = loaded;
+}
+
+// Write this mapping in the compiled binary format
+void Charset::writeCompiled(const std::string &filename) const
+{
+  // Lay out the string pool: the name, then each glyph
+  std::vector<char> pool;
+  CompiledHeader header;
+  std::memcpy(header.magic, compiled_magic, sizeof(compiled_magic));
+  header.byte_order = compiled_byte_order;
+  header.version = COMPILED_VERSION;
+  header.index_slots = INDEX_SLOTS;
+  header.num_letters = num_letters;
+  header.name = pool.size();
+  pool.insert(pool.end(), (const char *) name.str(),
+	      (const char *) name.str() + std::strlen((const char *) name.str())+1);
+
+  uint32_t glyphs[256];
+  for(unsigned int p=0; p<256; ++p) {
+    if(dots_to_letters[p].isEmpty()) { glyphs[p] = NO_GLYPH; continue; }
+    const char *glyph = (const char *) dots_to_letters[p].str();
+    glyphs[p] = pool.size();
+    pool.insert(pool.end(), glyph, glyph + std::strlen(glyph) + 1);
+  }
+  header.pool_size = pool.size();
+
+  uint8_t settled_bytes[256];
+  for(unsigned int p=0; p<256; ++p) settled_bytes[p] = settled[p] ? 1 : 0;
+
+  std::ofstream out(filename.c_str(), std::ios::out | std::ios::binary);
+  if(!out.good())
+    throw BTException(BTException::BT_EIO,
+		      std::string("failed to open file ") + filename +
+		      " for writing");
+
+  out.write((const char *) &header, sizeof(header));
+  out.write((const char *) glyphs, sizeof(glyphs));
+  out.write((const char *) letter_index, INDEX_SLOTS*sizeof(IndexSlot));
+  out.write((const char *) settled_bytes, sizeof(settled_bytes));
+  out.write((const char *) DotsMirror::mirrors, 256);
+  if(!pool.empty()) out.write(&pool[0], pool.size());
+
+  if(!out.good())
+    throw BTException(BTException::BT_EIO,
+		      std::string("failed to write file ") + filename);
+}
+
+// Loads a text mapping file, from its compiled image if that's up to date
+Charset Charset::load(const std::string &filename)
+{
+  const std::string compiled = compiledFilename(filename);
+
+  struct stat text_info, compiled_info;
+  if((stat(compiled.c_str(), &compiled_info) == 0) &&
+     ((stat(filename.c_str(), &text_info) != 0) ||
+      (compiled_info.st_mtime >= text_info.st_mtime))) {
+    try { return fromCompiledFile(compiled); }
+    catch(const BTException &) { } // Fall back on the text
+  }
+
+  return fromFile(filename);
+}
+
+// Name of the compiled image of a text mapping file
+std::string Charset::compiledFilename(const std::string &filename)
+{
+  const std::string text_ext(".txt");
+  if((filename.size() >= text_ext.size()) &&
+     (filename.compare(filename.size() - text_ext.size(), text_ext.size(),
+		       text_ext) == 0))
+    return filename.substr(0, filename.size() - text_ext.size()) + ".btc";
+  return filename + ".btc";
+}
+
+} // namespace BrailleTutorNS
@@ -0,0 +1,182 @@
+/*
+ * Braille Tutor interface library
+ * Clock.cc, started 19 October 2026
+ *
+ * Implementations of the real and virtual clocks.
+ */
+
+#include <vector>
+#include <algorithm>
+
+#include "Types.h"
+#include "Clock.h"
+#include "TimerService.h"
+
+#include <boost/thread/condition.hpp>
+#include <boost/thread.hpp>
+
+namespace BrailleTutorNS {
+
+///////////////////
+//// RealClock ////
+///////////////////
+
+// The real clock
+Clock &Clock::real()
+{
+  static RealClock real_clock;
+  return real_clock;
+}
+
+// The time now
+TimeInterval RealClock::now() const
+{ return TimeInterval::now(); }
+
+// Timed wait on cond until deadline. Boost waits on the wall clock, so the
+// deadline is turned into an interval from now; a wall clock change during
+// the wait can make it end early or late, but callers check the time again
+// once it ends.
+bool RealClock::waitUntil(boost::condition &cond,
+			  boost::mutex::scoped_lock &lock,
+			  const TimeInterval &deadline)
+{
+  const TimeInterval left = deadline - TimeInterval::now();
+  if(left.nsecs <= 0) return false;
+
+  boost::xtime time_end;
+  boost::xtime_get(&time_end, boost::TIME_UTC_);
+  time_end.sec  += left.wholeSecs();
+  time_end.nsec += left.fracNsecs();
+  if(time_end.nsec >= TimeInterval::NSECS_PER_SEC) {
+    time_end.sec  += 1;
+    time_end.nsec -= TimeInterval::NSECS_PER_SEC;
+  }
+  return cond.timed_wait(lock, time_end);
+}
+
+// Sleep until deadline
+void RealClock::sleepUntil(const TimeInterval &deadline)
+{ TimeInterval::sleepUntil(deadline); }
+
+//////////////////////
+//// VirtualClock ////
+//////////////////////
+
+// Constructor
+VirtualClock::VirtualClock(const TimeInterval &start) : time(start) { }
+
+// The virtual time
+TimeInterval VirtualClock::now() const
+{
+  boost::mutex::scoped_lock lock_t(mutex_time);
+  return time;
+}
+
+// Wait on cond until notified or until the clock reaches deadline. The
+// waiter signs up while still holding its own mutex, and the clock grabs
+// that mutex before notifying, so a wakeup can't slip in between signing
+// up and waiting.
+bool VirtualClock::waitUntil(boost::condition &cond,
+			     boost::mutex::scoped_lock &lock,
+			     const TimeInterval &deadline)
+{
+  Waiter waiter;
+  waiter.cond = &cond;
+  waiter.mutex = lock.mutex();
+  waiter.deadline = deadline;
+
+  {
+    boost::mutex::scoped_lock lock_t(mutex_time);
+    if(time >= waiter.deadline) return false;
+    waiters.push_back(&waiter);
+  }
+
+  cond.wait(lock);
+
+  boost::mutex::scoped_lock lock_t(mutex_time);
+  waiters.erase(std::find(waiters.begin(), waiters.end(), &waiter));
+  return time < waiter.deadline;
+}
+
+// Sleep until the clock reaches deadline
+void VirtualClock::sleepUntil(const TimeInterval &deadline)
+{
+  boost::mutex::scoped_lock lock_t(mutex_time);
+  while(time < deadline) cond_time.wait(lock_t);
+}
+
+// Move the clock on, stopping at each timer callback due on the way
+void VirtualClock::advanceTo(const TimeInterval &when)
+{
+  for(;;) {
+    // Find the TimerService with the earliest callback due by when. (The
+    // services' own mutexes are never held while taking ours, but to be
+    // safe we don't hold ours while taking theirs either.)
+    std::vector<TimerService*> services_copy;
+    { boost::mutex::scoped_lock lock_t(mutex_time);
+      services_copy = services; }
+
+    TimerService *due_ts = NULL;
+    TimeInterval due;
+    std::vector<TimerService*>::iterator s_iter;
+    for(s_iter=services_copy.begin(); s_iter!=services_copy.end(); ++s_iter) {
+      TimeInterval deadline;
+      if((*s_iter)->nextDeadline(deadline) && (deadline <= when) &&
+	 ((due_ts == NULL) || (deadline < due))) {
+	due_ts = *s_iter;
+	due = deadline;
+      }
+    }
+    if(due_ts == NULL) break;
+
+    // Move to that time and make the callback
+    TimeInterval now;
+    { boost::mutex::scoped_lock lock_t(mutex_time);
+      if(due > time) time = due;
+      now = time; }
+    wakeWaiters();
+    due_ts->runNext(now);
+  }
+
+  { boost::mutex::scoped_lock lock_t(mutex_time);
+    if(when > time) time = when; }
+  wakeWaiters();
+}
+
+// Take over running a TimerService's callbacks
+bool VirtualClock::adopt(TimerService &ts)
+{
+  boost::mutex::scoped_lock lock_t(mutex_time);
+  services.push_back(&ts);
+  return true;
+}
+
+// Stop running a TimerService's callbacks
+void VirtualClock::disown(TimerService &ts)
+{
+  boost::mutex::scoped_lock lock_t(mutex_time);
+  services.erase(std::remove(services.begin(), services.end(), &ts),
+		 services.end());
+}
+
+// Wake the threads waiting for a deadline that has now passed
+void VirtualClock::wakeWaiters()
+{
+  std::vector<Waiter> due;
+  {
+    boost::mutex::scoped_lock lock_t(mutex_time);
+    cond_time.notify_all();
+    std::vector<Waiter*>::iterator w_iter;
+    for(w_iter=waiters.begin(); w_iter!=waiters.end(); ++w_iter)
+      if((*w_iter)->deadline <= time) due.push_back(**w_iter);
+  }
+
+  // Holding each waiter's mutex while notifying means it's really waiting
+  std::vector<Waiter>::iterator d_iter;
+  for(d_iter=due.begin(); d_iter!=due.end(); ++d_iter) {
+    boost::mutex::scoped_lock lock_w(*d_iter->mutex);
+    d_iter->cond->notify_all();
+  }
+}
+
+} // namespace BrailleTutorNS
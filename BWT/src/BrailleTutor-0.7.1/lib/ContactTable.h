@@ -0,0 +1,158 @@
+#ifndef _LIBBT_CONTACT_TABLE_H_
+#define _LIBBT_CONTACT_TABLE_H_
+/*
+ * Braille Tutor interface library
+ * ContactTable.h, started 19 October 2026
+ *
+ * A fixed-slot table of the slate holes and buttons currently in contact
+ * with a stylus or finger. The Tutor's geometry is fixed, so every hole
+ * (cell, dot) and every button has its own slot holding a timestamp, and a
+ * bitmap of occupied slots allows iteration over just the active contacts.
+ * Pressing, releasing, and looking up a contact take constant time.
+ */
+
+#include <stdint.h>
+
+#include "Types.h"
+
+namespace BrailleTutorNS {
+
+//! Table of active contacts: stylus-occupied holes and pressed buttons
+
+//! Contacts outside the table's geometry, and releases of contacts that
+//! aren't active, are ignored and counted as strays (see strays()); both
+//! come only from corrupt input. Not thread safe.
+class ContactTable {
+public:
+  //! Number of cells the table has room for
+  static const unsigned int NUM_CELLS = 32;
+  //! Number of dots per cell the table has room for (six, plus two spare)
+  static const unsigned int DOTS_PER_CELL = 8;
+  //! Number of buttons the table has room for
+  static const unsigned int NUM_BUTTONS = 32;
+
+  //! Total number of slots; stylus slots come first, then button slots
+  static const unsigned int NUM_SLOTS = NUM_CELLS*DOTS_PER_CELL + NUM_BUTTONS;
+  //! Slot value meaning "no slot"
+  static const unsigned int NO_SLOT = NUM_SLOTS;
+
+  //! Slot for a hole, or NO_SLOT if it's outside the table
+  static inline unsigned int stylusSlot(const unsigned short int &cell,
+					const unsigned char &dot)
+  { return ((cell < NUM_CELLS) && (dot < DOTS_PER_CELL)) ?
+	   cell*DOTS_PER_CELL + dot : NO_SLOT; }
+  //! Slot for a button, or NO_SLOT if it's outside the table
+  static inline unsigned int buttonSlot(const unsigned short int &button)
+  { return (button < NUM_BUTTONS) ? NUM_CELLS*DOTS_PER_CELL + button
+				  : NO_SLOT; }
+
+  //! Returns true if slot is for a hole (otherwise it's for a button)
+  static inline bool isStylusSlot(const unsigned int &slot)
+  { return slot < NUM_CELLS*DOTS_PER_CELL; }
+  //! Cell for a stylus slot
+  static inline unsigned short int slotCell(const unsigned int &slot)
+  { return slot / DOTS_PER_CELL; }
+  //! Dot for a stylus slot
+  static inline unsigned char slotDot(const unsigned int &slot)
+  { return slot % DOTS_PER_CELL; }
+  //! Button for a button slot
+  static inline unsigned short int slotButton(const unsigned int &slot)
+  { return slot - NUM_CELLS*DOTS_PER_CELL; }
+
+  //! Mark a slot active as of time t
+
+  //! Returns false (and counts a stray) if slot is NO_SLOT. If the slot is
+  //! already active, its timestamp is left alone and false is returned.
+  inline bool press(const unsigned int &slot, const TimeInterval &t)
+  {
+    if(slot == NO_SLOT) { ++num_strays; return false; }
+    if(active(slot)) return false;
+    bits[slot/32] |= bit(slot);
+    stamps[slot] = t;
+    if(isStylusSlot(slot)) ++num_stylus;
+    return true;
+  }
+
+  //! Mark a slot inactive, retrieving the timestamp it held
+
+  //! Returns false (and counts a stray) if the slot isn't active.
+  inline bool release(const unsigned int &slot, TimeInterval &t)
+  {
+    if((slot == NO_SLOT) || !active(slot)) { ++num_strays; return false; }
+    bits[slot/32] &= ~bit(slot);
+    t = stamps[slot];
+    if(isStylusSlot(slot)) --num_stylus;
+    return true;
+  }
+
+  //! Returns true if slot is active
+  inline bool active(const unsigned int &slot) const
+  { return (slot != NO_SLOT) && (bits[slot/32] & bit(slot)); }
+
+  //! Timestamp held by an active slot; may be changed
+  inline TimeInterval &stamp(const unsigned int &slot) { return stamps[slot]; }
+
+  //! First active slot at or after slot, or NO_SLOT if there are none
+  inline unsigned int next(unsigned int slot=0) const
+  {
+    while(slot < NUM_SLOTS) {
+      const uint32_t word = bits[slot/32] & ~(bit(slot) - 1);
+      if(word) return (slot & ~31u) + lowestBit(word);
+      slot = (slot & ~31u) + 32;
+    }
+    return NO_SLOT;
+  }
+
+  //! Returns true if any hole in cell is active
+  inline bool cellActive(const unsigned short int &cell) const
+  { return (cell < NUM_CELLS) &&
+	   ((bits[cell/(32/DOTS_PER_CELL)] >>
+	     ((cell % (32/DOTS_PER_CELL)) * DOTS_PER_CELL)) & 0xff); }
+
+  //! Number of active holes
+  inline unsigned int numStylus() const { return num_stylus; }
+  //! Bitmap of active buttons (bit n set means button n is down)
+  inline uint32_t buttons() const { return bits[NUM_SLOTS/32 - 1]; }
+  //! Returns true if nothing is active
+  inline bool empty() const { return (num_stylus == 0) && (buttons() == 0); }
+
+  //! Number of stray presses and releases ignored so far
+  inline unsigned long strays() const { return num_strays; }
+
+  //! Make all slots inactive (the stray count is kept)
+  inline void clear()
+  { for(unsigned int i=0; i<NUM_SLOTS/32; ++i) bits[i] = 0; num_stylus = 0; }
+
+  //! Constructor: no contacts active
+  inline ContactTable() : num_stylus(0), num_strays(0) { clear(); }
+
+private:
+  //! Bitmap of active slots
+  uint32_t bits[NUM_SLOTS/32];
+  //! Timestamps for active slots
+  TimeInterval stamps[NUM_SLOTS];
+  //! Number of active holes
+  unsigned int num_stylus;
+  //! Number of strays counted
+  unsigned long num_strays;
+
+  //! Bit for slot within its bitmap word
+  static inline uint32_t bit(const unsigned int &slot)
+  { return ((uint32_t) 1) << (slot % 32); }
+
+  //! Index of the lowest set bit in a nonzero word
+  static inline unsigned int lowestBit(const uint32_t &word)
+  {
+#ifdef __GNUC__
+    return __builtin_ctz(word);
+#else
+    unsigned int index = 0;
+    while(!(word & (((uint32_t) 1) << index))) ++index;
+    return index;
+#endif
+  }
+};
+
+} // namespace BrailleTutorNS
+
+#endif
@@ -0,0 +1,287 @@
+/*
+ * Braille Tutor interface library
+ * Dictionary.cc, started 19 October 2026
+ *
+ * Implements Dictionary, which scores a word list against a written word
+ * with Myers' bit-parallel edit distance algorithm, and WordAssembler,
+ * which gathers written letters into words.
+ */
+
+#include "Types.h"
+#include "Charset.h"
+#include "IOEvent.h"
+#include "Dictionary.h"
+
+#include <map>
+#include <string>
+#include <vector>
+#include <stdint.h>
+
+namespace BrailleTutorNS {
+
+//! What an unmapped cell pattern is written as: U+FFFD, the Unicode
+//! replacement character, which no word list should have
+static const char *unknown_letter = "\xef\xbf\xbd";
+
+const unsigned int Dictionary::MAX_LETTERS;
+const uint16_t Dictionary::NO_SYMBOL;
+const unsigned short int WordAssembler::NO_CELL;
+
+// Constructor: no words
+Dictionary::Dictionary()
+: starts(1, 0)
+{ }
+
+// Constructor: a list of words
+Dictionary::Dictionary(const std::vector<std::string> &my_words)
+: starts(1, 0)
+{ add(my_words); }
+
+// Add a word, numbering any letters not seen before
+void Dictionary::add(const std::string &word)
+{
+  const GlyphMapping glyph(word);
+  for(const uint32_t *c = glyph.str_w(); *c; ++c) {
+    std::map<uint32_t, uint16_t>::const_iterator s = symbol_of.find(*c);
+    if(s == symbol_of.end()) {
+      if(symbol_of.size() >= NO_SYMBOL)
+	throw BTException(BTException::BT_EINVAL,
+			  "Dictionary::add: too many distinct letters");
+      s = symbol_of.insert(std::make_pair(*c, (uint16_t) symbol_of.size())).first;
+    }
+    symbols.push_back(s->second);
+  }
+  starts.push_back(symbols.size());
+  words.push_back(word);
+}
+
+// Add words
+void Dictionary::add(const std::vector<std::string> &my_words)
+{
+  for(unsigned int i=0; i<my_words.size(); ++i) add(my_words[i]);
+}
+
+//! Ranking of a match: nearest, then closest in length, then list order
+struct MatchRank {
+  uint32_t distance, length_gap, word;
+  inline bool operator<(const MatchRank &r) const
+  { if(distance != r.distance) return distance < r.distance;
+    if(length_gap != r.length_gap) return length_gap < r.length_gap;
+    return word < r.word; }
+};
+
+//! Keeps the best max_results of the ranks offered to it, in order
+class BestRanks {
+public:
+  BestRanks(const unsigned int &my_max) : max(my_max) { ranks.reserve(max+1); }
+
+  //! True if a rank with this distance could still get in
+  inline bool wants(const uint32_t &distance) const
+  { return (ranks.size() < max) || (distance <= ranks.back().distance); }
+
+  //! Offer a rank
+  inline void offer(const MatchRank &rank)
+  { if(max == 0) return;
+    if((ranks.size() == max) && !(rank < ranks.back())) return;
+    std::vector<MatchRank>::iterator r = ranks.end();
+    while((r != ranks.begin()) && (rank < *(r-1))) --r;
+    ranks.insert(r, rank);
+    if(ranks.size() > max) ranks.pop_back(); }
+
+  //! The ranks kept, as Matches
+  void results(std::vector<Dictionary::Match> &out) const
+  { out.clear();
+    for(unsigned int i=0; i<ranks.size(); ++i) {
+      const Dictionary::Match m = { ranks[i].word, ranks[i].distance };
+      out.push_back(m); } }
+
+private:
+  unsigned int max;
+  std::vector<MatchRank> ranks;
+};
+
+// Score every word against a written word. The written word is the
+// pattern: bit i of each vector stands for its letter i. For each list word
+// the vertical deltas Pv/Mv of the last dynamic programming column are
+// carried letter by letter, and score tracks the bottom cell, the distance
+// from the whole written word to the list word read so far; its least
+// value along the way is the distance to the list word's closest prefix.
+void Dictionary::search(const std::string &written,
+			const unsigned int &max_distance,
+			const unsigned int &max_results,
+			std::vector<Match> &matches,
+			std::vector<Match> &completions) const
+{
+  // The written word's letters, as list letter numbers
+  const GlyphMapping glyph(written);
+  std::vector<uint16_t> pattern;
+  for(const uint32_t *c = glyph.str_w(); *c && (pattern.size() < MAX_LETTERS); ++c) {
+    std::map<uint32_t, uint16_t>::const_iterator s = symbol_of.find(*c);
+    pattern.push_back((s == symbol_of.end()) ? NO_SYMBOL : s->second);
+  }
+  const uint32_t m = pattern.size();
+
+  // Where each letter is in the written word; letters in no list word
+  // match nothing, so they need no bits
+  std::vector<uint64_t> peq(symbol_of.size(), 0);
+  for(uint32_t i=0; i<m; ++i)
+    if(pattern[i] != NO_SYMBOL) peq[pattern[i]] |= ((uint64_t) 1) << i;
+  const uint32_t shift = m ? m-1 : 0;
+  const uint64_t last = m ? ((uint64_t) 1) << shift : 0;
+
+  const uint16_t *all = symbols.empty() ? 0 : &symbols[0];
+  BestRanks best_matches(max_results), best_completions(max_results);
+  for(uint32_t w=0; w<words.size(); ++w) {
+    const uint16_t *s = all + starts[w];
+    const uint32_t n = starts[w+1] - starts[w];
+    // Neither kind of hint is possible for a word this short
+    if(n + max_distance < m) continue;
+
+    // Letters past m + max_distance put every prefix further away than
+    // that, and the whole word too
+    const uint32_t reach = (n < m + max_distance) ? n : m + max_distance;
+
+    uint64_t pv = ~(uint64_t) 0, mv = 0;
+    uint32_t score = m, closest = m;
+    for(uint32_t j=0; j<reach; ++j) {
+      const uint64_t eq = peq[s[j]];
+      const uint64_t xv = eq | mv;
+      const uint64_t xh = (((eq & pv) + pv) ^ pv) | eq;
+      uint64_t ph = mv | ~(xh | pv);
+      uint64_t mh = pv & xh;
+      score += (uint32_t) ((ph & last) >> shift);
+      score -= (uint32_t) ((mh & last) >> shift);
+      // The top row is j+1 edits from the empty word, so it always rises
+      ph = (ph << 1) | 1;
+      mh <<= 1;
+      pv = mh | ~(xv | ph);
+      mv = ph & xv;
+      if(score < closest) closest = score;
+    }
+    if(m == 0) score = n; // no bits to count with
+
+    if((reach == n) && (score <= max_distance) && best_matches.wants(score)) {
+      const MatchRank r = { score, (n > m) ? n - m : m - n, w };
+      best_matches.offer(r);
+    }
+    if((n > m) && (closest <= max_distance) &&
+       best_completions.wants(closest)) {
+      const MatchRank r = { closest, n, w };
+      best_completions.offer(r);
+    }
+  }
+
+  best_matches.results(matches);
+  best_completions.results(completions);
+}
+
+
+// Constructor
+WordAssembler::WordAssembler(const Dictionary &my_dictionary,
+			     const unsigned int &my_max_distance,
+			     const unsigned int &my_max_results)
+: dictionary(my_dictionary), max_distance(my_max_distance),
+  max_results(my_max_results), word_ended(false), last_cell(NO_CELL),
+  glyph_open(false), end_after_glyph(false)
+{ }
+
+// Push in an IOEvent
+bool WordAssembler::push(const IOEvent &event)
+{
+  switch(event.type) {
+  case IOEvent::CELL_START:
+  case IOEvent::BUTTON_START:
+    glyph_open = true;
+    return false;
+
+  // Button 0 flushes the glyph underway; if there is one, the word ends
+  // once its letter has come
+  case IOEvent::BUTTON:
+    if(event.button != 0) return false;
+    if(glyph_open) {
+      end_after_glyph = true;
+      return false;
+    }
+    return endWord();
+
+  case IOEvent::CELL_LETTER: {
+    // Skipping a cell, or going back more than one, starts a new word
+    const bool moved = (last_cell != NO_CELL) && (event.cell != last_cell) &&
+		       (event.cell + 1 != last_cell) && (event.cell != last_cell + 1);
+    bool ended = moved && endWord();
+    last_cell = event.cell;
+    if(std::string(event.letter) == " ") ended = endWord() || ended;
+    else addLetter(event.letter.isEmpty() ? std::string(unknown_letter) :
+		   std::string(event.letter));
+    return closeGlyph() || ended;
+  }
+
+  case IOEvent::BUTTON_LETTER: {
+    bool ended = false;
+    if(std::string(event.letter) == " ") ended = endWord();
+    else addLetter(event.letter.isEmpty() ? std::string(unknown_letter) :
+		   std::string(event.letter));
+    return closeGlyph() || ended;
+  }
+
+  default:
+    return false;
+  }
+}
+
+// Add a letter to the word being written
+void WordAssembler::addLetter(const std::string &letter)
+{
+  if(word_ended) { current.clear(); word_ended = false; }
+  current += letter;
+  update();
+}
+
+// Note that the open glyph's letter has come, ending the word if button 0
+// asked for that
+bool WordAssembler::closeGlyph()
+{
+  glyph_open = false;
+  if(!end_after_glyph) return false;
+  end_after_glyph = false;
+  return endWord();
+}
+
+// End the word being written
+bool WordAssembler::endWord()
+{
+  if(word_ended || current.empty()) return false;
+  word_ended = true;
+  return true;
+}
+
+// Forget everything written
+void WordAssembler::reset()
+{
+  current.clear();
+  word_ended = false;
+  last_cell = NO_CELL;
+  glyph_open = end_after_glyph = false;
+  best_matches.clear();
+  best_completions.clear();
+}
+
+// The best hint of either kind
+const Dictionary::Match *WordAssembler::closest() const
+{
+  if(best_completions.empty())
+    return best_matches.empty() ? NULL : &best_matches[0];
+  if(best_matches.empty() ||
+     (best_completions[0].distance < best_matches[0].distance))
+    return &best_completions[0];
+  return &best_matches[0];
+}
+
+// Search the dictionary for the word being written
+void WordAssembler::update()
+{
+  dictionary.search(current, max_distance, max_results,
+		    best_matches, best_completions);
+}
+
+} // namespace BrailleTutorNS
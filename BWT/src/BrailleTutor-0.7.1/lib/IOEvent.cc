@@ -7,11 +7,12 @@
  * complex events (e.g. whole braille letters).
  */
 
-#include <set>
 #include <queue>
+#include <vector>
 #include <cassert>
 #include <climits>
 
+#include <boost/atomic.hpp>
 #include <boost/thread/condition.hpp>
 #include <boost/thread.hpp>
 #include <boost/utility.hpp>
@@ -20,6 +21,9 @@
 #include "Types.h"
 #include "Charset.h"
 #include "IOEvent.h"
+#include "IOEventDecoder.h"
+#include "TimerService.h"
+#include "AdaptiveGlyphDelay.h"
 
 
 
@@ -29,10 +33,43 @@ namespace BrailleTutorNS {
 //// CORE I/O EVENT PARSER CODE ////
 ////////////////////////////////////
 
+//// CHARACTER SET SNAPSHOTS ////
+
+//! Deleter for snapshots of character sets that somebody else owns
+struct UnownedCharsetDeleter {
+  inline void operator()(const Charset *) const { }
+};
+
+//! Wraps a character set the caller keeps alive as a snapshot
+static inline CharsetSnapshot unownedCharset(const Charset &charset)
+{ return CharsetSnapshot(&charset, UnownedCharsetDeleter()); }
+
+//// GLYPH DELAY LEARNING ////
+
+//! Let an adaptive glyph delay, if any, learn from the pauses the decoder
+//! saw in its last batch of events, updating glyph_delay to match
+static void learnGlyphDelay(const IOEventDecoder &decoder,
+			    TimeInterval &glyph_delay,
+			    boost::mutex &mutex_glyph_delay,
+			    boost::scoped_ptr<AdaptiveGlyphDelay> &adaptive_delay)
+{
+  if(decoder.dotPauses().empty()) return;
+
+  boost::mutex::scoped_lock lock_gd(mutex_glyph_delay);
+  if(!adaptive_delay) return;
+  std::vector<TimeInterval>::const_iterator p_iter;
+  for(p_iter=decoder.dotPauses().begin();
+      p_iter!=decoder.dotPauses().end(); ++p_iter)
+    adaptive_delay->addPause(*p_iter);
+  glyph_delay = adaptive_delay->delay();
+}
+
 //// PARSER THREADS ////
 
 //! The thread functor that turns BaseIOEvent events into IOEvent events
 struct FunctorIOEventDecoder {
+  //! Reference to the clock we keep time by
+  Clock &clock;
   //! Reference to BaseIOEvent events to turn into IOEvent events
   std::deque<BaseIOEvent> &in_bevents;
   //! Reference to the IOEvent events we made
@@ -50,47 +87,34 @@ struct FunctorIOEventDecoder {
   TimeInterval &glyph_delay;
   //! Reference to mutex for the glyph delay
   boost::mutex &mutex_glyph_delay;
+  //! Reference to the adaptive glyph delay controller, if any (guarded by
+  //! mutex_glyph_delay)
+  boost::scoped_ptr<AdaptiveGlyphDelay> &adaptive_delay;
 
-  //! Reference to a pointer to the current character set
-  const Charset* &charset;
-  //! Reference to mutex for the charset pointer
-  boost::mutex &mutex_charset;
-
-  //! Reference to the set of events we should bother decoding
-  std::set<IOEvent::Type> &watchset;
-  //! Reference to mutex for the event watch set
-  boost::mutex &mutex_watchset;
+  //! Reference to the current character set snapshot
 
-  //! Contains the pushdown events for active buttons or braille dots
+  //! The decoder takes its own reference to the snapshot once per batch of
+  //! events, with boost::atomic_load and without locking; the snapshot
+  //! stays alive until the batch is done even if it's swapped meanwhile.
+  CharsetSnapshot &charset;
 
-  //! Contains the BaseIOEvent saying when "active" buttons or dots (i.e.
-  //! those that a finger is currently on or a stylus is currently in)
-  //! were pushed down. We use a deque because very few buttons/dots are
-  //! likely to be active at once---searching should be very fast.
-  std::deque<BaseIOEvent> actives;
-
-  //! Datatype saying where and whether a dot glyph is under construction
-  typedef enum { NONE,		//!< No glyph is currently under construction
-		 BUTTONS,	//!< Glyph under construction on the buttons
-		 CELL,		//!< Glyph under construction in a braille cell
-	  } GlyphLoc;
+  //! Reference to the set of events we should bother decoding
 
-  //! Indicates whether and where a dot glyph is currently under construction
-  GlyphLoc glyph_where;
+  //! The decoder reads this once per batch of events, without locking.
+  boost::atomic<IOEvent::TypeMask> &watchmask;
 
-  //! If a cell's being used to make a dot glyph, says which cell
-  unsigned short int glyph_cell;
+  //! Reference to the count of stray input events the decoder has ignored
+  boost::atomic<unsigned long> &stray_contacts;
 
-  //! Time when the glyph under construction was begun
-  TimeInterval glyph_began;
-  //! Time of the last dot entry for the glyph under construction
-  TimeInterval glyph_last;
+  //! Reference to whether glyphs should be assembled per cell
+  boost::atomic<bool> &concurrent_cells;
 
-  //! Dots for the current glyph under development
-  unsigned char glyph_dots;
+  //! The decoder proper; this functor just feeds it
+  IOEventDecoder decoder;
 
   //! Constructor
-  inline FunctorIOEventDecoder(std::deque<BaseIOEvent> &my_in_bevents,
+  inline FunctorIOEventDecoder(Clock &my_clock,
+			       std::deque<BaseIOEvent> &my_in_bevents,
 			       std::deque<IOEvent> &my_new_events,
 			       boost::mutex &my_mutex_in_bevents,
 			       boost::mutex &my_mutex_new_events,
@@ -98,18 +122,21 @@ struct FunctorIOEventDecoder {
 			       boost::condition &my_cond_new_events,
 			       TimeInterval &my_glyph_delay,
 			       boost::mutex &my_mutex_glyph_delay,
-			       const Charset* &my_charset,
-			       boost::mutex &my_mutex_charset,
-			       std::set<IOEvent::Type> &my_watchset,
-			       boost::mutex &my_mutex_watchset)
-  : in_bevents(my_in_bevents), new_events(my_new_events),
+			       boost::scoped_ptr<AdaptiveGlyphDelay>
+				 &my_adaptive_delay,
+			       CharsetSnapshot &my_charset,
+			       boost::atomic<IOEvent::TypeMask> &my_watchmask,
+			       boost::atomic<unsigned long> &my_stray_contacts,
+			       boost::atomic<bool> &my_concurrent_cells)
+  : clock(my_clock), in_bevents(my_in_bevents), new_events(my_new_events),
     mutex_in_bevents(my_mutex_in_bevents),
     mutex_new_events(my_mutex_new_events),
     cond_in_bevents(my_cond_in_bevents), cond_new_events(my_cond_new_events),
     glyph_delay(my_glyph_delay), mutex_glyph_delay(my_mutex_glyph_delay),
-    charset(my_charset), mutex_charset(my_mutex_charset),
-    watchset(my_watchset), mutex_watchset(my_mutex_watchset),
-    glyph_where(NONE), glyph_cell(INVALID_CELL), glyph_dots(0) { }
+    adaptive_delay(my_adaptive_delay),
+    charset(my_charset),
+    watchmask(my_watchmask), stray_contacts(my_stray_contacts),
+    concurrent_cells(my_concurrent_cells) { }
 
   //! Perform this functor's function
   inline void operator()()
@@ -131,21 +158,29 @@ struct FunctorIOEventDecoder {
       { // ENCLOSING BLOCK: For grabbing in_bevents mutex
       boost::mutex::scoped_lock lock_b(mutex_in_bevents);
 
+      // Glyph delay in effect for this iteration
+      TimeInterval delay;
+      { boost::mutex::scoped_lock lock_gd(mutex_glyph_delay);
+	delay = glyph_delay; }
+
+      // Switch between one glyph at a time and a glyph per cell if asked
+      // (the decoder puts this off until it's idle)
+      decoder.setConcurrentCells(concurrent_cells.load());
+
       // If there are no events waiting, wait for new events to arise.
       // Note special handling if there is already a glyph underway.
       if(in_bevents.empty()) {
-	if(glyph_where == NONE) cond_in_bevents.wait(lock_b);
+	TimeInterval deadline;
+	if(!decoder.glyphUnderway()) cond_in_bevents.wait(lock_b);
+	// With one glyph at a time, it's done once input stops for the delay
+	else if(!decoder.concurrentCells())
+	  timedout = !clock.waitUntil(cond_in_bevents, lock_b,
+				      clock.now() + delay);
+	// With a glyph per cell, wait for the first one that could be done
+	else if(!decoder.nextDeadline(delay, deadline))
+	  cond_in_bevents.wait(lock_b);
 	else {
-	  // Add in timeout. First we need to know the xtime for when the
-	  // timeout happents
-	  boost::xtime time_end;
-	  boost::xtime_get(&time_end, boost::TIME_UTC_);	// Changed by Gary Giger since TIME_UTC does not exist in boost 1.53.0 and was replaced with TIME_UTC_
-	  time_end.sec += glyph_delay.secs;
-	  const unsigned int nsecs = glyph_delay.msecs * 1000000;
-	  time_end.nsec += nsecs % 1000000000;
-	  time_end.sec  += nsecs / 1000000000;
-	  // Then wait for new indications
-	  timedout = !cond_in_bevents.timed_wait(lock_b, time_end);
+	  timedout = !clock.waitUntil(cond_in_bevents, lock_b, deadline);
 	}
       }
 
@@ -164,277 +199,28 @@ struct FunctorIOEventDecoder {
 	}
       }
       else {
-	// Grab mutexes
+	// Grab mutex and snapshots of the events we're watching and of the
+	// character set
 	boost::mutex::scoped_lock lock_n(mutex_new_events);
-	boost::mutex::scoped_lock lock_w(mutex_watchset);
-	boost::mutex::scoped_lock lock_c(mutex_charset);
-	std::deque<BaseIOEvent>::const_iterator ib_iter;
+	const IOEvent::TypeMask watch = watchmask.load();
+	const CharsetSnapshot batch_charset = boost::atomic_load(&charset);
 
 	// Will be useful for determining whether new events were made
 	const unsigned int old_new_events_size = new_events.size();
 
-        // Check for DONE BaseIOEvent; if so, push a DONE IOEvent and then
-        // quit.
-	for(ib_iter=in_bevents.begin(); ib_iter!=in_bevents.end(); ++ib_iter)
-	  if(ib_iter->type == BaseIOEvent::DONE) {
-	    new_events.push_back(IOEvent::makeDoneEvent());
-	    cond_new_events.notify_one();
-	    return;
-	  }
-
-	// Check for FLUSH_GLYPH event; if so, activate the "timeout" portion
-	// of this routine---the one that reports the current glyph. Note that
-	// if lots of events pile up, this approach might cause trouble: one
-	// possible scenario involves the user building up an event queue like
-	// this:
-	//    press button 1
-	//    press button 2
-	//    flush glyph
-	//    stylus c1d1
-	//    stylus c1d2
-	// The user actually wanted the button glyph flushed, but then decided
-	// to begin working on a new glyph with the stylus. The button glyph
-	// is flushed anyway, but with the flush glyph flag on, the system
-	// will go ahead and flush the stylus glyph too regardless of whether
-	// the user is done. This is something that we will mark as FIXME, but
-	// it shouldn't be an issue unless the user is fast enough to build
-	// up many events in the queue (or unless the computer is REALLY slow).
-	for(ib_iter=in_bevents.begin(); ib_iter!=in_bevents.end(); ++ib_iter)
-	  if(ib_iter->type == BaseIOEvent::FLUSH_GLYPH)
-	    { flush_glyph = true; break; }
-
-	// First easy ones: if the user is subscribed to events that represent
-	// the same thing as BaseIOEvent objects
-	if(watchset.find(IOEvent::STYLUS_DOWN) != watchset.end())
-	  for(ib_iter=in_bevents.begin(); ib_iter!=in_bevents.end(); ++ib_iter)
-	    if(ib_iter->type == BaseIOEvent::STYLUS_DOWN)
-	      new_events.push_back(
-		IOEvent::makeStylusDownEvent(
-		  ib_iter->timestamp, ib_iter->cell, ib_iter->dot));
-
-	if(watchset.find(IOEvent::STYLUS_UP) != watchset.end())
-	  for(ib_iter=in_bevents.begin(); ib_iter!=in_bevents.end(); ++ib_iter)
-	    if(ib_iter->type == BaseIOEvent::STYLUS_UP)
-	      new_events.push_back(
-		IOEvent::makeStylusUpEvent(
-		  ib_iter->timestamp, ib_iter->cell, ib_iter->dot));
-
-	if(watchset.find(IOEvent::BUTTON_DOWN) != watchset.end())
-	  for(ib_iter=in_bevents.begin(); ib_iter!=in_bevents.end(); ++ib_iter)
-	    if(ib_iter->type == BaseIOEvent::BUTTON_DOWN)
-	      new_events.push_back(
-		IOEvent::makeButtonDownEvent(
-		  ib_iter->timestamp, ib_iter->button));
-
-	if(watchset.find(IOEvent::BUTTON_UP) != watchset.end())
-	  for(ib_iter=in_bevents.begin(); ib_iter!=in_bevents.end(); ++ib_iter)
-	    if(ib_iter->type == BaseIOEvent::BUTTON_UP)
-	      new_events.push_back(
-		IOEvent::makeButtonUpEvent(
-		  ib_iter->timestamp, ib_iter->button));
-
-	// Next, intermediate difficulty: STYLUS and BUTTON events
-	if(watchset.find(IOEvent::STYLUS) != watchset.end())
-	  for(ib_iter=in_bevents.begin(); ib_iter!=in_bevents.end(); ++ib_iter){
-	    // Stylus up? Make indication
-	    if(ib_iter->type == BaseIOEvent::STYLUS_UP) {
-	      std::deque<BaseIOEvent>::iterator a_iter;
-	      for(a_iter=actives.begin(); a_iter!=actives.end(); ++a_iter)
-		if((a_iter->type == BaseIOEvent::STYLUS_DOWN) &&
-		   (a_iter->cell==ib_iter->cell) &&
-		   (a_iter->dot==ib_iter->dot)) {
-		  new_events.push_back(
-		    IOEvent::makeStylusEvent(a_iter->timestamp,
-		      ib_iter->timestamp - a_iter->timestamp,
-		      a_iter->cell, a_iter->dot));
-		  break;
-		}
-	    }
-	  }
-
-	if(watchset.find(IOEvent::BUTTON) != watchset.end())
-	  for(ib_iter=in_bevents.begin(); ib_iter!=in_bevents.end(); ++ib_iter){
-	    // Button up? Make indication
-	    if(ib_iter->type == BaseIOEvent::BUTTON_UP) {
-	      std::deque<BaseIOEvent>::iterator a_iter;
-	      for(a_iter=actives.begin(); a_iter!=actives.end(); ++a_iter)
-		if((a_iter->type == BaseIOEvent::BUTTON_DOWN) &&
-		   (a_iter->button == ib_iter->button)) {
-		  new_events.push_back(
-		    IOEvent::makeButtonEvent(a_iter->timestamp,
-		      ib_iter->timestamp - a_iter->timestamp, a_iter->button));
-		  break;
-		}
-	    }
-	  }
-
-	// We maintain the actives list regardless of whether anyone needs
-	// it---it's easier that way, especially with the glyph timeout code.
-	// First handle the _UP events---find their _DOWN twins in actives
-	// and delete them.
-	for(ib_iter=in_bevents.begin(); ib_iter!=in_bevents.end(); ++ib_iter)
-	  if(ib_iter->type == BaseIOEvent::STYLUS_UP) {
-	    std::deque<BaseIOEvent>::iterator a_iter;
-	    for(a_iter=actives.begin(); a_iter!=actives.end(); ++a_iter)
-	      if((a_iter->type == BaseIOEvent::STYLUS_DOWN) &&
-		 (a_iter->cell==ib_iter->cell) &&
-		 (a_iter->dot==ib_iter->dot)) break;
-	    assert(a_iter != actives.end());
-	    actives.erase(a_iter);
-	  }
-	for(ib_iter=in_bevents.begin(); ib_iter!=in_bevents.end(); ++ib_iter)
-	  if(ib_iter->type == BaseIOEvent::BUTTON_UP) {
-	    std::deque<BaseIOEvent>::iterator a_iter;
-	    for(a_iter=actives.begin(); a_iter!=actives.end(); ++a_iter)
-	      if((a_iter->type == BaseIOEvent::BUTTON_DOWN) &&
-		 (a_iter->button == ib_iter->button)) break;
-	    assert(a_iter != actives.end());
-	    actives.erase(a_iter);
-	  }
-	// Next we add DOWN events to the actives list
-	for(ib_iter=in_bevents.begin(); ib_iter!=in_bevents.end(); ++ib_iter)
-	  if((ib_iter->type == BaseIOEvent::STYLUS_DOWN) ||
-	     (ib_iter->type == BaseIOEvent::BUTTON_DOWN))
-	    actives.push_back(*ib_iter);
-
-	// Next, high difficulty: DOTS and LETTER events
-	const bool want_cell_start =
-	  (watchset.find(IOEvent::CELL_START) != watchset.end());
-	const bool want_button_start =
-	  (watchset.find(IOEvent::BUTTON_START) != watchset.end());
-	const bool want_cell_done =
-	  (watchset.find(IOEvent::CELL_DONE) != watchset.end());
-	const bool want_button_done =
-	  (watchset.find(IOEvent::BUTTON_DONE) != watchset.end());
-	const bool want_cell_dots =
-	  (watchset.find(IOEvent::CELL_DOTS) != watchset.end());
-	const bool want_button_dots =
-	  (watchset.find(IOEvent::BUTTON_DOTS) != watchset.end());
-	const bool want_cell_letter =
-	  (watchset.find(IOEvent::CELL_LETTER) != watchset.end());
-	const bool want_button_letter =
-	  (watchset.find(IOEvent::BUTTON_LETTER) != watchset.end());
-
-	for(ib_iter=in_bevents.begin(); ib_iter!=in_bevents.end(); ++ib_iter) {
-	  // Handle glyphmaking on the buttons
-	  if((ib_iter->type == BaseIOEvent::BUTTON_DOWN) &&
-	     (ib_iter->dot != INVALID_DOT)) {
-	    // See if the user is starting a new glyph on the buttons
-	    if(glyph_where != BUTTONS) {
-	      // If an old glyph was being made on a cell, signal completion
-	      if(glyph_where == CELL) {
-		const TimeInterval duration = glyph_last - glyph_began;
-		if(want_cell_done)
-		  new_events.push_back(
-		    IOEvent::makeCellDoneEvent(glyph_last,glyph_cell,duration));
-		if(want_cell_dots)
-		  new_events.push_back(
-		    IOEvent::makeCellDotsEvent(glyph_began, duration,
-					       glyph_cell, glyph_dots));
-		if(want_cell_letter)
-		  new_events.push_back(
-		    IOEvent::makeCellLetterEvent(glyph_began,
-		      duration, glyph_cell,
-		      charset->mir()[glyph_dots], glyph_dots));
-	      }
-	      // Then prepare glyph tracking variables
-	      glyph_where = BUTTONS;
-	      glyph_began = glyph_last = ib_iter->timestamp;
-	      glyph_dots = dot_mask(ib_iter->dot);
-	      // Signal new glyph under construction
-	      if(want_button_start)
-		new_events.push_back(
-		  IOEvent::makeButtonStartEvent(ib_iter->timestamp));
-	    }
-	    // User is continuing a glyph on the buttons
-	    else {
-	      glyph_dots |= dot_mask(ib_iter->dot);
-	      glyph_last = ib_iter->timestamp;
-	    }
-	  }
-	  // Handle glyphmaking in a braille cell
-	  else if(ib_iter->type == BaseIOEvent::STYLUS_DOWN) {
-	    // See if the user is starting a new glyph after timing out
-	    if(glyph_where == NONE) {
-	      // Prepare glyph tracking variables
-	      glyph_where = CELL;
-	      glyph_began = glyph_last = ib_iter->timestamp;
-	      glyph_cell = ib_iter->cell;
-	      glyph_dots = dot_mask(ib_iter->dot);
-	      // Signal new glyph under construction
-	      if(want_cell_start)
-		new_events.push_back(
-		  IOEvent::makeCellStartEvent(ib_iter->timestamp, glyph_cell));
-	    }
-	    // See if user was making a glyph on buttons beforehand
-	    else if(glyph_where == BUTTONS) {
-	      // Signal completion of old glyph
-	      const TimeInterval duration = glyph_last - glyph_began;
-	      if(want_button_done)
-		new_events.push_back(
-		  IOEvent::makeButtonDoneEvent(glyph_last, duration));
-	      if(want_button_dots)
-		new_events.push_back(
-		  IOEvent::makeButtonDotsEvent(glyph_began,
-					       duration, glyph_dots));
-	      if(want_button_letter)
-		new_events.push_back(
-		  IOEvent::makeButtonLetterEvent(glyph_began, duration,
-		    charset->mir()[glyph_dots], glyph_dots));
-	      // Then prepare glyph tracking variables
-	      glyph_where = CELL;
-	      glyph_began = glyph_last = ib_iter->timestamp;
-	      glyph_cell = ib_iter->cell;
-	      glyph_dots = dot_mask(ib_iter->dot);
-	      // Signal new glyph under construction
-	      if(want_cell_start)
-		new_events.push_back(
-		  IOEvent::makeCellStartEvent(ib_iter->timestamp, glyph_cell));
-	    }
-	    // See if user is starting a glyph in a new cell
-	    else if(glyph_cell != ib_iter->cell) {
-	      // Signal completion of old glyph
-	      const TimeInterval duration = glyph_last - glyph_began;
-	      if(want_cell_done)
-		new_events.push_back(
-		  IOEvent::makeCellDoneEvent(glyph_last, glyph_cell, duration));
-	      if(want_cell_dots)
-		new_events.push_back(
-		  IOEvent::makeCellDotsEvent(glyph_began, duration,
-					     glyph_cell, glyph_dots));
-	      if(want_cell_letter)
-		new_events.push_back(
-		  IOEvent::makeCellLetterEvent(glyph_began,duration,glyph_cell,
-		    charset->mir()[glyph_dots], glyph_dots));
-	      // Then prepare glyph tracking variables
-	      glyph_where = CELL;
-	      glyph_began = glyph_last = ib_iter->timestamp;
-	      glyph_cell = ib_iter->cell;
-	      glyph_dots = dot_mask(ib_iter->dot);
-	      // Signal new glyph under construction
-	      if(want_cell_start)
-		new_events.push_back(
-		  IOEvent::makeCellStartEvent(ib_iter->timestamp, glyph_cell));
-	    }
-	    // User is continuing a glyph in this cell
-	    else {
-	      glyph_dots |= dot_mask(ib_iter->dot);
-	      glyph_last = ib_iter->timestamp;
-	    }
-	  }
-	  // Handle button up timekeeping for glyphmaking
-	  else if((ib_iter->type == BaseIOEvent::BUTTON_UP) &&
-		  (ib_iter->dot != INVALID_DOT) &&
-		  (glyph_where == BUTTONS))
-	    glyph_last = ib_iter->timestamp;
-	  // Handle stylus up timekeeping for glyphmaking
-	  else if((ib_iter->type == BaseIOEvent::STYLUS_UP) &&
-		  (glyph_where == CELL))
-	    glyph_last = ib_iter->timestamp;
+	// Decode the batch. A DONE BaseIOEvent means it's time to quit.
+	if(decoder.decode(in_bevents, new_events, watch, *batch_charset,
+			  flush_glyph)) {
+	  cond_new_events.notify_one();
+	  return;
 	}
 
 	// Clear out input events---we've seen 'em all now
 	in_bevents.clear();
+	stray_contacts.store(decoder.strayContacts());
+
+	// Let an adaptive glyph delay learn from the user's pauses
+	learnGlyphDelay(decoder, glyph_delay, mutex_glyph_delay, adaptive_delay);
 	// See if new events were made
 	if(old_new_events_size != new_events.size()) made_new_events = true;
       }
@@ -442,60 +228,20 @@ struct FunctorIOEventDecoder {
       // If we've timed out or been told to flush the current glyph, let's
       // check to see if there's a glyph underway and if so, signal that
       // it's done.
-      if((timedout || flush_glyph) && (glyph_where != NONE)) {
-	// grab watchset, new_events mutexes
+      if((timedout || flush_glyph) && decoder.glyphUnderway()) {
+	// grab new_events mutex and the events and charset we're watching
 	boost::mutex::scoped_lock lock_n(mutex_new_events);
-	boost::mutex::scoped_lock lock_w(mutex_watchset);
-	boost::mutex::scoped_lock lock_c(mutex_charset);
+	const IOEvent::TypeMask watch = watchmask.load();
+	const CharsetSnapshot batch_charset = boost::atomic_load(&charset);
 
 	// Will be useful for determining whether new events were made
 	const unsigned int old_new_events_size = new_events.size();
 
-	// First scan the actives lists to check whether any buttons or
-	// cell pins are still active
-	bool button_active = false;
-	bool stylus_active = false;
-	std::deque<BaseIOEvent>::const_iterator a_iter;
-	for(a_iter=actives.begin(); a_iter!=actives.end(); ++a_iter) {
-	  if((a_iter->type == BaseIOEvent::BUTTON_DOWN) &&
-	     (a_iter->dot != INVALID_DOT)) button_active = true;
-	  if(a_iter->type == BaseIOEvent::STYLUS_DOWN) stylus_active = true;
-	  if(button_active && stylus_active) break;
-	}
-
-	if((glyph_where == BUTTONS) && (!button_active)) {
-	  const TimeInterval duration = glyph_last - glyph_began;
-	  if(watchset.find(IOEvent::BUTTON_DONE) != watchset.end())
-	    new_events.push_back(
-	      IOEvent::makeButtonDoneEvent(glyph_last, duration));
-	  if(watchset.find(IOEvent::BUTTON_DOTS) != watchset.end())
-	    new_events.push_back(
-	      IOEvent::makeButtonDotsEvent(glyph_began, duration, glyph_dots));
-	  if(watchset.find(IOEvent::BUTTON_LETTER) != watchset.end())
-	    new_events.push_back(
-	      IOEvent::makeButtonLetterEvent(glyph_began, duration,
-		charset->mir()[glyph_dots], glyph_dots));
-	}
-	else if((glyph_where == CELL) && (!stylus_active)) {
-	  const TimeInterval duration = glyph_last - glyph_began;
-	  if(watchset.find(IOEvent::CELL_DONE) != watchset.end())
-	    new_events.push_back(
-	      IOEvent::makeCellDoneEvent(glyph_last, glyph_cell, duration));
-	  if(watchset.find(IOEvent::CELL_DOTS) != watchset.end())
-	    new_events.push_back(
-	      IOEvent::makeCellDotsEvent(glyph_began, duration,
-					 glyph_cell, glyph_dots));
-	  if(watchset.find(IOEvent::CELL_LETTER) != watchset.end())
-	    new_events.push_back(
-	      IOEvent::makeCellLetterEvent(glyph_began, duration, glyph_cell,
-		charset->mir()[glyph_dots], glyph_dots));
-	}
-
-	// Set glyph tracking variables to "no glyph"
-	if(!(button_active | stylus_active)) {
-	  glyph_where = NONE;
-	  glyph_dots = (unsigned char) 0x00;
-	}
+	if(flush_glyph || !decoder.concurrentCells())
+	  decoder.finishGlyph(new_events, watch, *batch_charset);
+	else
+	  decoder.expireGlyphs(new_events, clock.now(), delay,
+			       watch, *batch_charset);
 
 	// See if events were made
 	if(old_new_events_size != new_events.size()) made_new_events = true;
@@ -591,7 +337,13 @@ struct FunctorNewIOEvent {
 //// IOEventParserCore definition ////
 
 //! Actual functional implementation of the IOEventParser
-class IOEventParserCore : public boost::noncopyable {
+
+//! Normally runs an IOEventDecoder in a decoder thread, with another thread
+//! to hand new events to the IOEventHandler. Given a TimerService, it
+//! instead runs the decoder inline on whatever thread supplies events, or
+//! on the TimerService thread when a glyph delay runs out, and calls the
+//! IOEventHandler from there.
+class IOEventParserCore : public boost::noncopyable, public TimerClient {
 public:
   //! The actual implementation of IOEventParser::operator()
   void operator()(std::deque<BaseIOEvent> &events);
@@ -599,6 +351,14 @@ public:
   //! The actual implementation of IOEventParser::setGlyphDelay
   inline void setGlyphDelay(const TimeInterval &delay);
 
+  //! The actual implementation of IOEventParser::setAdaptiveGlyphDelay
+  inline void setAdaptiveGlyphDelay(const TimeInterval &min_delay,
+				    const TimeInterval &max_delay,
+				    const double &percentile);
+
+  //! The actual implementation of IOEventParser::getGlyphDelay
+  inline TimeInterval getGlyphDelay();
+
   //! The actual implementation of IOEventParser::flushGlyph
   inline void flushGlyph();
 
@@ -613,13 +373,35 @@ public:
   //! The actual implementation of IOEventParser::clearEvents
   inline void clearEvents();
 
+  //! The actual implementation of IOEventParser::setEventMask
+  inline IOEvent::TypeMask setEventMask(const IOEvent::TypeMask &mask);
+
+  //! The actual implementation of IOEventParser::getEventMask
+  inline IOEvent::TypeMask getEventMask() const;
+
   //! The actual implementation of IOEventParser::setCharset
-  inline void setCharset(const Charset &my_charset);
+  inline void setCharset(const CharsetSnapshot &my_charset);
+
+  //! The actual implementation of IOEventParser::getCharset
+  inline CharsetSnapshot getCharset() const;
+
+  //! The actual implementation of IOEventParser::getStrayContacts
+  inline unsigned long getStrayContacts() const;
+
+  //! The actual implementation of IOEventParser::setConcurrentCells
+  inline void setConcurrentCells(const bool &on);
+
+  //! Timer handler for the inline parser: a glyph delay may have run out
+  virtual void handleTimer(const TimeInterval &now);
 
   //! Constructor.
 
-  //! The constructor starts the decoder and event dispatcher threads
-  IOEventParserCore(IOEventParser &my_iep);
+  //! The constructor starts the decoder and event dispatcher threads,
+  //! which keep time by my_clock
+  IOEventParserCore(IOEventParser &my_iep, Clock &my_clock);
+
+  //! Constructor for running inline, with no threads
+  IOEventParserCore(IOEventParser &my_iep, TimerService &my_timers);
 
   //! Destructor. Commands thread death.
   ~IOEventParserCore();
@@ -628,6 +410,9 @@ private:
   //! IOEventParser object whose guts we manipulate
   IOEventParser &iep;
 
+  //! The clock we keep time by
+  Clock &clock;
+
   //! BaseIOEvent events received for parsing
   std::deque<BaseIOEvent> in_bevents;
   //! Freshly parsed IOEvent events
@@ -647,16 +432,45 @@ private:
   TimeInterval glyph_delay;
   //! Mutex for the glyph delay
   boost::mutex mutex_glyph_delay;
-
-  //! Pointer to the current character set
-  const Charset *charset;
-  //! Mutex for the charset pointer
-  boost::mutex mutex_charset;
-
-  //! Pointer to the current character set
-  std::set<IOEvent::Type> watchset;
-  //! Mutex for the charset pointer
-  boost::mutex mutex_watchset;
+  //! Controller adapting the glyph delay to the user, if enabled
+  boost::scoped_ptr<AdaptiveGlyphDelay> adaptive_delay;
+
+  //! The current character set; only touch with boost::atomic_load and
+  //! boost::atomic_store
+  CharsetSnapshot charset;
+
+  //! The set of events we should bother decoding, as an IOEvent::TypeMask
+  boost::atomic<IOEvent::TypeMask> watchmask;
+
+  //! Number of stray input events the decoder has ignored
+  boost::atomic<unsigned long> stray_contacts;
+
+  //! Whether the decoder should assemble a glyph per cell
+  boost::atomic<bool> concurrent_cells;
+
+  //! Shared timer service when running inline, otherwise NULL
+  TimerService *timers;
+  //! The decoder, when running inline (guarded by mutex_in_bevents)
+  boost::scoped_ptr<IOEventDecoder> inline_decoder;
+  //! When the inline decoder last got input or gave up waiting on a glyph
+  TimeInterval inline_last_input;
+  //! True once the inline decoder has seen a DONE BaseIOEvent
+  bool inline_done;
+  //! Set by flushGlyph when running inline
+  boost::atomic<bool> inline_flush;
+  //! Events the inline decoder has made that await the handler, in order
+  //! (guarded by mutex_in_bevents)
+  std::deque<IOEvent> inline_made;
+  //! True while some thread is handing inline_made to the handler
+  boost::atomic<bool> inline_delivering;
+
+  //! Run the inline decoder on events (or, if NULL, on a timeout) and pass
+  //! any IOEvent events made to the IOEventHandler
+  void decodeInline(std::deque<BaseIOEvent> *events);
+
+  //! Hand inline_made to the IOEventHandler, holding neither the input nor
+  //! the output events mutex while it runs
+  void deliverInline();
 
   //! IOEvent decoder thread
   boost::scoped_ptr<boost::thread> t_fied;
@@ -673,6 +487,8 @@ private:
 // decoder thread
 void IOEventParserCore::operator()(std::deque<BaseIOEvent> &events)
 {
+  if(timers) { decodeInline(&events); return; }
+
   boost::mutex::scoped_lock lock_b(mutex_in_bevents);
   in_bevents.insert(in_bevents.end(), events.begin(), events.end());
   events.clear();
@@ -683,11 +499,37 @@ void IOEventParserCore::operator()(std::deque<BaseIOEvent> &events)
 void IOEventParserCore::setGlyphDelay(const TimeInterval &my_glyph_delay)
 { // Grab lock on the glyph_delay variable and change it
   boost::mutex::scoped_lock lock_gd(mutex_glyph_delay);
+  adaptive_delay.reset();
   glyph_delay = my_glyph_delay; }
 
+// Start adapting the glyph delay to the user
+void IOEventParserCore::setAdaptiveGlyphDelay(const TimeInterval &min_delay,
+					      const TimeInterval &max_delay,
+					      const double &percentile)
+{
+  // Build the controller first; it checks its arguments
+  AdaptiveGlyphDelay *controller =
+    new AdaptiveGlyphDelay(min_delay, max_delay, percentile);
+  boost::mutex::scoped_lock lock_gd(mutex_glyph_delay);
+  adaptive_delay.reset(controller);
+  glyph_delay = adaptive_delay->delay();
+}
+
+// Report the glyph delay in effect
+TimeInterval IOEventParserCore::getGlyphDelay()
+{ boost::mutex::scoped_lock lock_gd(mutex_glyph_delay); return glyph_delay; }
+
 // Force interpretation of the current glyph under construction
 void IOEventParserCore::flushGlyph()
 {
+  // Inline, the flush happens soon on the timer thread. (Doing it right
+  // here could deadlock, since this is often called from the handler.)
+  if(timers) {
+    inline_flush.store(true);
+    timers->schedule(*this, clock.now());
+    return;
+  }
+
   boost::mutex::scoped_lock lock_i(mutex_in_bevents);
  
   // The decoder uses a custom FLUSH_GLYPH indication to learn that it's
@@ -705,42 +547,195 @@ void IOEventParserCore::clearQueue()
 
 // Indicate that an event should be monitored
 void IOEventParserCore::wantEvent(const IOEvent::Type &type)
-{ boost::mutex::scoped_lock lock_w(mutex_watchset); watchset.insert(type); }
+{ watchmask.fetch_or(IOEvent::mask(type)); }
 
 //! Indicate that an event should be ignored
 void IOEventParserCore::ignoreEvent(const IOEvent::Type &type)
-{ boost::mutex::scoped_lock lock_w(mutex_watchset);
-  std::set<IOEvent::Type>::iterator w_iter = watchset.find(type);
-  if(w_iter != watchset.end()) watchset.erase(w_iter); }
+{ watchmask.fetch_and(~IOEvent::mask(type)); }
 
 //! Indicate that all events should be ignored
 void IOEventParserCore::clearEvents()
-{ boost::mutex::scoped_lock lock_w(mutex_watchset); watchset.clear(); }
+{ watchmask.store(0); }
+
+//! Swap in a whole new set of events to monitor
+IOEvent::TypeMask IOEventParserCore::setEventMask(const IOEvent::TypeMask &mask)
+{ return watchmask.exchange(mask); }
+
+//! Report the set of events being monitored
+IOEvent::TypeMask IOEventParserCore::getEventMask() const
+{ return watchmask.load(); }
 
 //! Change the current character set
-void IOEventParserCore::setCharset(const Charset &my_charset)
-{ boost::mutex::scoped_lock lock_c(mutex_charset); charset = &my_charset; }
+void IOEventParserCore::setCharset(const CharsetSnapshot &my_charset)
+{ boost::atomic_store(&charset, my_charset); }
+
+//! Retrieve the current character set
+CharsetSnapshot IOEventParserCore::getCharset() const
+{ return boost::atomic_load(&charset); }
+
+//! Report the number of stray input events ignored
+unsigned long IOEventParserCore::getStrayContacts() const
+{ return stray_contacts.load(); }
+
+//! Switch between one glyph at a time and a glyph per cell
+void IOEventParserCore::setConcurrentCells(const bool &on)
+{
+  boost::mutex::scoped_lock lock_b(mutex_in_bevents);
+  concurrent_cells.store(on);
+  cond_in_bevents.notify_one();
+}
 
 // IOEventParserCore constructor
-IOEventParserCore::IOEventParserCore(IOEventParser &my_iep)
+IOEventParserCore::IOEventParserCore(IOEventParser &my_iep, Clock &my_clock)
 : iep(my_iep),
+  clock(my_clock),
   glyph_delay(5U), // five second default glyph delay
-  charset(&Charset::defaultCharset()),
+  charset(unownedCharset(Charset::defaultCharset())),
+  watchmask(0),
+  stray_contacts(0),
+  concurrent_cells(false),
+  timers(NULL),
+  inline_done(false),
+  inline_flush(false),
+  inline_delivering(false),
   t_fied(
    new boost::thread(
-     FunctorIOEventDecoder(in_bevents, new_events,
+     FunctorIOEventDecoder(clock, in_bevents, new_events,
 			   mutex_in_bevents, mutex_new_events,
 			   cond_in_bevents, cond_new_events,
-			   glyph_delay, mutex_glyph_delay,
-			   charset, mutex_charset, watchset, mutex_watchset))),
+			   glyph_delay, mutex_glyph_delay, adaptive_delay,
+			   charset, watchmask, stray_contacts,
+			   concurrent_cells))),
   t_fnie(
    new boost::thread(
      FunctorNewIOEvent(new_events, mutex_new_events, cond_new_events, iep)))
 { }
 
+// IOEventParserCore constructor for running inline
+IOEventParserCore::IOEventParserCore(IOEventParser &my_iep,
+				     TimerService &my_timers)
+: iep(my_iep),
+  clock(my_timers.getClock()),
+  glyph_delay(5U), // five second default glyph delay
+  charset(unownedCharset(Charset::defaultCharset())),
+  watchmask(0),
+  stray_contacts(0),
+  concurrent_cells(false),
+  timers(&my_timers),
+  inline_decoder(new IOEventDecoder),
+  inline_done(false),
+  inline_flush(false),
+  inline_delivering(false)
+{ }
+
+// Run the inline decoder
+void IOEventParserCore::decodeInline(std::deque<BaseIOEvent> *events)
+{
+  IOEventDecoder &decoder = *inline_decoder;
+  std::deque<IOEvent> made;
+
+  // The in_bevents mutex serializes decoding on the caller's thread with
+  // decoding on the timer thread
+  boost::mutex::scoped_lock lock_b(mutex_in_bevents);
+  if(inline_done) { if(events) events->clear(); return; }
+
+  const TimeInterval now = clock.now();
+  TimeInterval delay;
+  { boost::mutex::scoped_lock lock_gd(mutex_glyph_delay);
+    delay = glyph_delay; }
+  decoder.setConcurrentCells(concurrent_cells.load());
+
+  // Snapshots of the events we're watching and of the character set
+  const IOEvent::TypeMask watch = watchmask.load();
+  const CharsetSnapshot batch_charset = boost::atomic_load(&charset);
+
+  bool flush_glyph = inline_flush.exchange(false);
+
+  // Decode the batch, if there is one. A DONE BaseIOEvent means that
+  // nothing more is coming.
+  if(events && !events->empty()) {
+    inline_done = decoder.decode(*events, made, watch, *batch_charset,
+				 flush_glyph);
+    events->clear();
+    stray_contacts.store(decoder.strayContacts());
+    learnGlyphDelay(decoder, glyph_delay, mutex_glyph_delay, adaptive_delay);
+    inline_last_input = now;
+  }
+
+  if(!inline_done) {
+    // Complete glyphs as needed...
+    if(flush_glyph)
+      decoder.finishGlyph(made, watch, *batch_charset);
+    else if(!events) {
+      if(decoder.concurrentCells())
+	decoder.expireGlyphs(made, now, delay, watch, *batch_charset);
+      else if(decoder.glyphUnderway() && (inline_last_input + delay <= now)) {
+	decoder.finishGlyph(made, watch, *batch_charset);
+	inline_last_input = now; // if still underway, wait another delay
+      }
+    }
+
+    // ...and arrange to look again when the next one could be complete
+    TimeInterval deadline;
+    if(decoder.concurrentCells()) {
+      if(decoder.nextDeadline(delay, deadline))
+	timers->schedule(*this, deadline);
+    }
+    else if(decoder.glyphUnderway())
+      timers->schedule(*this, inline_last_input + delay);
+  }
+
+  // Queue the new events in decoding order, then pass them on with the
+  // decoder let go of
+  if(made.empty()) return;
+  inline_made.insert(inline_made.end(), made.begin(), made.end());
+  lock_b.unlock();
+  deliverInline();
+}
+
+// Hand the inline decoder's events to the IOEventHandler
+void IOEventParserCore::deliverInline()
+{
+  // One thread delivers at a time, so events stay in order. If another is
+  // at it (perhaps this one, with the handler feeding events back in), it
+  // will pass these on too: it only stops once it finds inline_made empty,
+  // and it says so before letting go of in_bevents.
+  if(inline_delivering.exchange(true)) return;
+
+  for(;;) {
+    std::deque<IOEvent> handed;
+    { boost::mutex::scoped_lock lock_b(mutex_in_bevents);
+      if(inline_made.empty()) { inline_delivering.store(false); return; }
+      handed.swap(inline_made); }
+
+    // The handler gets the output queue's events followed by the new ones,
+    // in a queue of its own; whatever it leaves goes back ahead of anything
+    // queued meanwhile
+    IOEventHandler *handler;
+    { boost::mutex::scoped_lock lock_i(iep.out_events_mutex);
+      handler = iep.handler;
+      handed.insert(handed.begin(), iep.out_events.begin(),
+		    iep.out_events.end());
+      iep.out_events.clear(); }
+
+    if(handler) (*handler)(handed);
+
+    boost::mutex::scoped_lock lock_i(iep.out_events_mutex);
+    iep.out_events.insert(iep.out_events.begin(), handed.begin(),
+			  handed.end());
+  }
+}
+
+// Timer handler for the inline parser
+void IOEventParserCore::handleTimer(const TimeInterval &)
+{ decodeInline(NULL); }
+
 // IOEventParserCore destructor
 IOEventParserCore::~IOEventParserCore()
 {
+  // Inline: just make sure the timer service forgets us
+  if(timers) { timers->cancel(*this); return; }
+
   {
     // Grab mutexes for input and output events
     boost::mutex::scoped_lock lock_n(mutex_new_events);
@@ -773,7 +768,15 @@ IOEventParserCore::~IOEventParserCore()
 
 // IOEventParser constructor
 IOEventParser::IOEventParser()
-: handler(NULL), iepc(new IOEventParserCore(*this)) { }
+: handler(NULL), iepc(new IOEventParserCore(*this, Clock::real())) { }
+
+// IOEventParser constructor for keeping time by another clock
+IOEventParser::IOEventParser(Clock &clock)
+: handler(NULL), iepc(new IOEventParserCore(*this, clock)) { }
+
+// IOEventParser constructor for running inline
+IOEventParser::IOEventParser(TimerService &timers)
+: handler(NULL), iepc(new IOEventParserCore(*this, timers)) { }
 
 // Callback method for new BaseIOEvent
 void IOEventParser::operator()(std::deque<BaseIOEvent> &events)
@@ -783,6 +786,16 @@ void IOEventParser::operator()(std::deque<BaseIOEvent> &events)
 void IOEventParser::setGlyphDelay(const TimeInterval &delay)
 { if(iepc != NULL) iepc->setGlyphDelay(delay); }
 
+// Lets the glyph delay adapt to the user's pauses between dots
+void IOEventParser::setAdaptiveGlyphDelay(const TimeInterval &min_delay,
+					  const TimeInterval &max_delay,
+					  const double &percentile)
+{ if(iepc != NULL) iepc->setAdaptiveGlyphDelay(min_delay,max_delay,percentile); }
+
+// Retrieves the glyph delay in effect
+TimeInterval IOEventParser::getGlyphDelay()
+{ return (iepc != NULL) ? iepc->getGlyphDelay() : TimeInterval(); }
+
 // Flushes the current glyph
 void IOEventParser::flushGlyph()
 { if(iepc != NULL) iepc->flushGlyph(); }
@@ -800,6 +813,14 @@ void IOEventParser::ignoreEvent(const IOEvent::Type &type)
 // Removes all IOEvent types from the event watchset
 void IOEventParser::clearEvents() { if(iepc != NULL) iepc->clearEvents(); }
 
+// Replaces the event watchset wholesale
+IOEvent::TypeMask IOEventParser::setEventMask(const IOEvent::TypeMask &mask)
+{ return (iepc != NULL) ? iepc->setEventMask(mask) : 0; }
+
+// Retrieves the event watchset
+IOEvent::TypeMask IOEventParser::getEventMask() const
+{ return (iepc != NULL) ? iepc->getEventMask() : 0; }
+
 // Register an IOEventHandler functor with this IOEventParser
 void IOEventParser::setIOEventHandler(IOEventHandler &ioeh)
 {
@@ -815,9 +836,29 @@ void IOEventParser::pollIOEvents(IOEventHandler &ioeh)
   ioeh(out_events);
 }
 
-// Sets the current braille character set
+// Sets the current braille character set, which the caller keeps alive
 void IOEventParser::setCharset(const Charset &my_charset)
-{ if(iepc != NULL) iepc->setCharset(my_charset); }
+{ if(iepc != NULL) iepc->setCharset(unownedCharset(my_charset)); }
+
+// Sets the current braille character set to a shared snapshot
+void IOEventParser::setCharset(const CharsetSnapshot &my_charset)
+{
+  if(!my_charset)
+    throw BTException(BTException::BT_EDOM, "null character set snapshot");
+  if(iepc != NULL) iepc->setCharset(my_charset);
+}
+
+// Retrieves the current braille character set
+CharsetSnapshot IOEventParser::getCharset() const
+{ return (iepc != NULL) ? iepc->getCharset() : CharsetSnapshot(); }
+
+// Reports the number of stray input events ignored
+unsigned long IOEventParser::getStrayContacts() const
+{ return (iepc != NULL) ? iepc->getStrayContacts() : 0; }
+
+// Switches between one glyph at a time and a glyph per cell
+void IOEventParser::setConcurrentCells(const bool &on)
+{ if(iepc != NULL) iepc->setConcurrentCells(on); }
 
 // IOEventParser deconstructor
 IOEventParser::~IOEventParser() { if(iepc != NULL) delete iepc; }
@@ -0,0 +1,543 @@
+/*
+ * Braille Tutor interface library
+ * IOEventDecoder.cc, started 19 October 2026
+ *
+ * Implementation of the IOEventDecoder, the synchronous core of the
+ * IOEventParser.
+ */
+
+#include <deque>
+#include <string>
+#include <vector>
+#include <stdint.h>
+
+#include "Dots.h"
+#include "Types.h"
+#include "Charset.h"
+#include "IOEvent.h"
+#include "ContactTable.h"
+#include "IOEventDecoder.h"
+
+namespace BrailleTutorNS {
+
+// Append CELL_DONE, CELL_DOTS, CELL_LETTER events for a glyph to out
+void IOEventDecoder::reportCellGlyph(std::deque<IOEvent> &out,
+				     const IOEvent::TypeMask &watch,
+				     const Charset &charset,
+				     const unsigned short int &cell,
+				     const TimeInterval &began,
+				     const TimeInterval &last,
+				     const unsigned char &dots)
+{
+  const TimeInterval duration = last - began;
+
+  if(watch & IOEvent::mask(IOEvent::CELL_DONE))
+    out.push_back(IOEvent::makeCellDoneEvent(last, cell, duration));
+  if(watch & IOEvent::mask(IOEvent::CELL_DOTS))
+    out.push_back(IOEvent::makeCellDotsEvent(began, duration, cell, dots));
+  if(watch & IOEvent::mask(IOEvent::CELL_LETTER))
+    out.push_back(IOEvent::makeCellLetterEvent(began, duration, cell,
+					       charset.mir()[dots], dots));
+}
+
+// Append *_DONE, *_DOTS, *_LETTER events for the current glyph to out
+void IOEventDecoder::reportGlyph(std::deque<IOEvent> &out,
+				 const IOEvent::TypeMask &watch,
+				 const Charset &charset)
+{
+  const TimeInterval duration = glyph_last - glyph_began;
+
+  if(glyph_where == CELL)
+    reportCellGlyph(out, watch, charset,
+		    glyph_cell, glyph_began, glyph_last, glyph_dots);
+  else if(glyph_where == BUTTONS) {
+    if(watch & IOEvent::mask(IOEvent::BUTTON_DONE))
+      out.push_back(
+	IOEvent::makeButtonDoneEvent(glyph_last, duration));
+    if(watch & IOEvent::mask(IOEvent::BUTTON_DOTS))
+      out.push_back(
+	IOEvent::makeButtonDotsEvent(glyph_began, duration, glyph_dots));
+    if(watch & IOEvent::mask(IOEvent::BUTTON_LETTER))
+      out.push_back(
+	IOEvent::makeButtonLetterEvent(glyph_began, duration,
+	  charset.mir()[glyph_dots], glyph_dots));
+  }
+}
+
+// Start a new glyph at a button or stylus down
+void IOEventDecoder::startGlyph(std::deque<IOEvent> &out,
+				const BaseIOEvent &down, const GlyphLoc &where,
+				const IOEvent::TypeMask &watch)
+{
+  glyph_where = where;
+  glyph_began = glyph_last = down.timestamp;
+  glyph_dots = dot_mask(down.dot);
+
+  if(where == CELL) {
+    glyph_cell = down.cell;
+    if(watch & IOEvent::mask(IOEvent::CELL_START))
+      out.push_back(IOEvent::makeCellStartEvent(down.timestamp, glyph_cell));
+  }
+  else if(watch & IOEvent::mask(IOEvent::BUTTON_START))
+    out.push_back(IOEvent::makeButtonStartEvent(down.timestamp));
+}
+
+// Report the letter for the glyph under construction early if no further
+// dots could change it. Each dot added to a glyph changes its pattern, so
+// this reports at most once per glyph unless the user keeps adding dots to
+// a settled glyph, which can only unsettle it.
+void IOEventDecoder::checkSettled(std::deque<IOEvent> &out,
+				  const GlyphLoc &where,
+				  const unsigned short int &cell,
+				  const TimeInterval &began,
+				  const unsigned char &dots,
+				  const TimeInterval &when,
+				  const IOEvent::TypeMask &watch,
+				  const Charset &charset)
+{
+  // Nothing to do unless someone wants the letter
+  const IOEvent::TypeMask wanted =
+    IOEvent::mask((where == CELL) ? IOEvent::CELL_PROVISIONAL_LETTER :
+				    IOEvent::BUTTON_PROVISIONAL_LETTER);
+  if(!(watch & wanted)) return;
+
+  const DotsMirror mirror = charset.mir();
+  if(!mirror.isSettled(dots)) return;
+
+  if(where == CELL)
+    out.push_back(
+      IOEvent::makeCellProvisionalLetterEvent(began, when - began,
+					      cell, mirror[dots], dots));
+  else
+    out.push_back(
+      IOEvent::makeButtonProvisionalLetterEvent(began, when - began,
+						mirror[dots], dots));
+}
+
+// Note the pause before a dot continuing a glyph under construction
+inline void IOEventDecoder::notePause(const TimeInterval &last,
+				      const TimeInterval &when)
+{ if(last <= when) pauses.push_back(when - last); }
+
+// Returns true if a glyph begun in cell would belong to the word under
+// construction. The cells of a word always form a run, since a glyph that
+// doesn't adjoin the run ends the word.
+inline bool IOEventDecoder::adjoinsWord(const unsigned short int &cell) const
+{
+  const uint32_t run = open_cells | word_cells;
+  return (run == 0) || (((run | (run << 1) | (run >> 1)) >> cell) & 1);
+}
+
+// Handle a stylus down when cells are assembled concurrently
+void IOEventDecoder::concurrentStylusDown(std::deque<IOEvent> &out,
+					  const BaseIOEvent &down,
+					  const IOEvent::TypeMask &watch,
+					  const Charset &charset)
+{
+  // Cells the Tutor doesn't have were already counted as strays
+  const unsigned short int cell = down.cell;
+  if(cell >= ContactTable::NUM_CELLS) return;
+
+  // Writing in a cell ends any glyph on the buttons
+  if(glyph_where == BUTTONS) {
+    reportGlyph(out, watch, charset);
+    glyph_where = NONE;
+    glyph_dots = (unsigned char) 0x00;
+  }
+
+  CellGlyph &glyph = cell_glyphs[cell];
+  const uint32_t bit = ((uint32_t) 1) << cell;
+
+  // Continuing the glyph in this cell?
+  if(open_cells & bit) {
+    notePause(glyph.last, down.timestamp);
+    const unsigned char old_dots = glyph.dots;
+    glyph.dots |= dot_mask(down.dot);
+    glyph.last = down.timestamp;
+    if(glyph.dots != old_dots)
+      checkSettled(out, CELL, cell, glyph.began, glyph.dots,
+		   down.timestamp, watch, charset);
+    return;
+  }
+
+  // A glyph away from the word under construction ends the word, including
+  // any of its glyphs still underway
+  if(!adjoinsWord(cell)) {
+    closeCells(out, watch, charset);
+    reportWord(out, watch);
+  }
+
+  open_cells |= bit;
+  glyph.began = glyph.last = down.timestamp;
+  glyph.dots = dot_mask(down.dot);
+  if(watch & IOEvent::mask(IOEvent::CELL_START))
+    out.push_back(IOEvent::makeCellStartEvent(down.timestamp, cell));
+  checkSettled(out, CELL, cell, glyph.began, glyph.dots,
+	       down.timestamp, watch, charset);
+}
+
+// Report the glyph underway in cell as complete and add it to the word
+void IOEventDecoder::completeCell(std::deque<IOEvent> &out,
+				  const unsigned short int &cell,
+				  const IOEvent::TypeMask &watch,
+				  const Charset &charset)
+{
+  const CellGlyph &glyph = cell_glyphs[cell];
+  const uint32_t bit = ((uint32_t) 1) << cell;
+  reportCellGlyph(out, watch, charset,
+		  cell, glyph.began, glyph.last, glyph.dots);
+
+  if(word_cells == 0) { word_began = glyph.began; word_last = glyph.last; }
+  else {
+    if(glyph.began < word_began) word_began = glyph.began;
+    if(glyph.last > word_last) word_last = glyph.last;
+  }
+  word_letters[cell] = charset.mir()[glyph.dots];
+  word_cells |= bit;
+  open_cells &= ~bit;
+}
+
+// Report all glyphs underway in cells as complete, in cell order
+void IOEventDecoder::closeCells(std::deque<IOEvent> &out,
+				const IOEvent::TypeMask &watch,
+				const Charset &charset)
+{
+  for(unsigned short int cell=0; open_cells != 0; ++cell)
+    if((open_cells >> cell) & 1) completeCell(out, cell, watch, charset);
+}
+
+// Report the word under construction, if any, and start a new one
+void IOEventDecoder::reportWord(std::deque<IOEvent> &out,
+				const IOEvent::TypeMask &watch)
+{
+  if(word_cells == 0) return;
+
+  if(watch & IOEvent::mask(IOEvent::WORD)) {
+    std::string letters;
+    unsigned short int first_cell = ContactTable::NUM_CELLS;
+    unsigned char num_cells = 0;
+    for(unsigned short int cell=0; cell<ContactTable::NUM_CELLS; ++cell) {
+      if(!((word_cells >> cell) & 1)) continue;
+      if(num_cells++ == 0) first_cell = cell;
+      letters += (const char *) word_letters[cell].str();
+    }
+    out.push_back(IOEvent::makeWordEvent(word_began, word_last - word_began,
+					 first_cell, num_cells,
+					 GlyphMapping(letters)));
+  }
+
+  word_cells = 0;
+}
+
+// Make the IOEvent of a group before OUT_GLYPH for a BaseIOEvent (and,
+// for STYLUS and BUTTON, the time the contact was made)
+inline IOEvent IOEventDecoder::makeEvent(const OutGroup &group,
+					 const BaseIOEvent &event,
+					 const TimeInterval &down)
+{
+  switch(group) {
+  case OUT_STYLUS_DOWN:
+    return IOEvent::makeStylusDownEvent(event.timestamp, event.cell, event.dot);
+  case OUT_STYLUS_UP:
+    return IOEvent::makeStylusUpEvent(event.timestamp, event.cell, event.dot);
+  case OUT_BUTTON_DOWN:
+    return IOEvent::makeButtonDownEvent(event.timestamp, event.button);
+  case OUT_BUTTON_UP:
+    return IOEvent::makeButtonUpEvent(event.timestamp, event.button);
+  case OUT_STYLUS:
+    return IOEvent::makeStylusEvent(down, event.timestamp - down,
+				    event.cell, event.dot);
+  default:
+    return IOEvent::makeButtonEvent(down, event.timestamp - down,
+				    event.button);
+  }
+}
+
+// Note an event of a group before OUT_GLYPH in its group's buffer
+inline void IOEventDecoder::hold(const OutGroup &group,
+				 const BaseIOEvent &event,
+				 const TimeInterval &down)
+{
+  const Held held = { &event, down };
+  group_held[group].push_back(held);
+  held_groups |= 1 << group;
+}
+
+// Decode one batch of BaseIOEvent events
+bool IOEventDecoder::decode(const std::deque<BaseIOEvent> &in,
+			    std::deque<IOEvent> &out,
+			    const IOEvent::TypeMask &watch,
+			    const Charset &charset, bool &flush_glyph)
+{
+  pauses.clear();
+
+  const bool want_stylus_down = watch & IOEvent::mask(IOEvent::STYLUS_DOWN);
+  const bool want_stylus_up = watch & IOEvent::mask(IOEvent::STYLUS_UP);
+  const bool want_button_down = watch & IOEvent::mask(IOEvent::BUTTON_DOWN);
+  const bool want_button_up = watch & IOEvent::mask(IOEvent::BUTTON_UP);
+  const bool want_stylus = watch & IOEvent::mask(IOEvent::STYLUS);
+  const bool want_button = watch & IOEvent::mask(IOEvent::BUTTON);
+
+  // First pass: keep the active contacts, and sort the events watched
+  // that come before the glyph events into their groups' buffers. Glyph
+  // making doesn't look at the contacts, so they can be kept apart.
+  std::deque<BaseIOEvent>::const_iterator ib_iter;
+  for(ib_iter=in.begin(); ib_iter!=in.end(); ++ib_iter) {
+    switch(ib_iter->type) {
+    // A DONE BaseIOEvent trumps everything else in the batch: drop what
+    // was sorted of it, push a DONE IOEvent and tell the caller to quit.
+    case BaseIOEvent::DONE:
+      for(unsigned int g=0; g<OUT_GLYPH; ++g) group_held[g].clear();
+      held_groups = 0;
+      out.push_back(IOEvent::makeDoneEvent());
+      return true;
+
+    case BaseIOEvent::STYLUS_DOWN:
+      if(want_stylus_down) hold(OUT_STYLUS_DOWN, *ib_iter, TimeInterval());
+      contacts.press(ContactTable::stylusSlot(ib_iter->cell, ib_iter->dot),
+		     ib_iter->timestamp);
+      break;
+
+    // Retire the hole from the active contacts and note a STYLUS event.
+    // A withdrawal from a hole that was never entered is just counted.
+    case BaseIOEvent::STYLUS_UP: {
+      if(want_stylus_up) hold(OUT_STYLUS_UP, *ib_iter, TimeInterval());
+      TimeInterval down;
+      if(contacts.release(
+	   ContactTable::stylusSlot(ib_iter->cell, ib_iter->dot), down) &&
+	 want_stylus)
+	hold(OUT_STYLUS, *ib_iter, down);
+      break;
+    }
+
+    case BaseIOEvent::BUTTON_DOWN:
+      if(want_button_down) hold(OUT_BUTTON_DOWN, *ib_iter, TimeInterval());
+      contacts.press(ContactTable::buttonSlot(ib_iter->button),
+		     ib_iter->timestamp);
+      break;
+
+    // Retire the button from the active contacts and note a BUTTON event.
+    // Release of a button that was never pressed is just counted.
+    case BaseIOEvent::BUTTON_UP: {
+      if(want_button_up) hold(OUT_BUTTON_UP, *ib_iter, TimeInterval());
+      TimeInterval down;
+      if(contacts.release(ContactTable::buttonSlot(ib_iter->button), down) &&
+	 want_button)
+	hold(OUT_BUTTON, *ib_iter, down);
+      break;
+    }
+
+    default:
+      break;
+    }
+  }
+
+  // Then the groups, in order, straight into out
+  for(unsigned int g=0; held_groups; ++g) {
+    if(!((held_groups >> g) & 1)) continue;
+    held_groups &= ~(1 << g);
+    std::vector<Held>::const_iterator h_iter;
+    for(h_iter=group_held[g].begin(); h_iter!=group_held[g].end(); ++h_iter)
+      out.push_back(makeEvent(OutGroup(g), *h_iter->event, h_iter->down));
+    group_held[g].clear();
+  }
+
+  // Second pass: glyphmaking, whose events come last, so they're simply
+  // appended to out
+  for(ib_iter=in.begin(); ib_iter!=in.end(); ++ib_iter) {
+    switch(ib_iter->type) {
+    // A FLUSH_GLYPH event tells the caller to report the current glyph
+    // once the batch is done. Note that if lots of events pile up, this
+    // approach might cause trouble: one possible scenario involves the user
+    // building up an event queue like this:
+    //    press button 1
+    //    press button 2
+    //    flush glyph
+    //    stylus c1d1
+    //    stylus c1d2
+    // The user actually wanted the button glyph flushed, but then decided
+    // to begin working on a new glyph with the stylus. The button glyph
+    // is flushed anyway, but with the flush glyph flag on, the system
+    // will go ahead and flush the stylus glyph too regardless of whether
+    // the user is done. This is something that we will mark as FIXME, but
+    // it shouldn't be an issue unless the user is fast enough to build
+    // up many events in the queue (or unless the computer is REALLY slow).
+    case BaseIOEvent::FLUSH_GLYPH:
+      flush_glyph = true;
+      break;
+
+    case BaseIOEvent::STYLUS_DOWN:
+      // Glyphmaking in a braille cell, with a glyph underway per cell...
+      if(concurrent_cells) {
+	concurrentStylusDown(out, *ib_iter, watch, charset);
+	break;
+      }
+      // ...or just one. Continuing a glyph in this cell?
+      if((glyph_where == CELL) && (glyph_cell == ib_iter->cell)) {
+	notePause(glyph_last, ib_iter->timestamp);
+	const unsigned char old_dots = glyph_dots;
+	glyph_dots |= dot_mask(ib_iter->dot);
+	glyph_last = ib_iter->timestamp;
+	if(glyph_dots != old_dots)
+	  checkSettled(out, glyph_where, glyph_cell, glyph_began, glyph_dots,
+		       ib_iter->timestamp, watch, charset);
+      }
+      // Otherwise signal completion of any old glyph (on the buttons or in
+      // another cell) and start a new one here.
+      else {
+	if(glyph_where != NONE) reportGlyph(out, watch, charset);
+	startGlyph(out, *ib_iter, CELL, watch);
+	checkSettled(out, glyph_where, glyph_cell, glyph_began, glyph_dots,
+		     ib_iter->timestamp, watch, charset);
+      }
+      break;
+
+    case BaseIOEvent::STYLUS_UP:
+      // Stylus up timekeeping for glyphmaking
+      if(concurrent_cells) {
+	if((ib_iter->cell < ContactTable::NUM_CELLS) &&
+	   ((open_cells >> ib_iter->cell) & 1))
+	  cell_glyphs[ib_iter->cell].last = ib_iter->timestamp;
+      }
+      else if(glyph_where == CELL) glyph_last = ib_iter->timestamp;
+      break;
+
+    case BaseIOEvent::BUTTON_DOWN:
+      // Glyphmaking on the buttons (the ones that stand for dots, anyway)
+      if(ib_iter->dot == INVALID_DOT) break;
+      // Continuing a glyph on the buttons?
+      if(glyph_where == BUTTONS) {
+	notePause(glyph_last, ib_iter->timestamp);
+	const unsigned char old_dots = glyph_dots;
+	glyph_dots |= dot_mask(ib_iter->dot);
+	glyph_last = ib_iter->timestamp;
+	if(glyph_dots != old_dots)
+	  checkSettled(out, glyph_where, glyph_cell, glyph_began, glyph_dots,
+		       ib_iter->timestamp, watch, charset);
+      }
+      // Otherwise signal completion of any glyph in a cell (or of all of
+      // them, and their word) and start anew.
+      else {
+	if(glyph_where == CELL) reportGlyph(out, watch, charset);
+	if(concurrent_cells) {
+	  closeCells(out, watch, charset);
+	  reportWord(out, watch);
+	}
+	startGlyph(out, *ib_iter, BUTTONS, watch);
+	checkSettled(out, glyph_where, glyph_cell, glyph_began, glyph_dots,
+		     ib_iter->timestamp, watch, charset);
+      }
+      break;
+
+    case BaseIOEvent::BUTTON_UP:
+      // Button up timekeeping for glyphmaking
+      if((ib_iter->dot != INVALID_DOT) && (glyph_where == BUTTONS))
+	glyph_last = ib_iter->timestamp;
+      break;
+
+    default:
+      break;
+    }
+  }
+
+  return false;
+}
+
+// Report the glyph under construction as complete, if it can be
+void IOEventDecoder::finishGlyph(std::deque<IOEvent> &out,
+				 const IOEvent::TypeMask &watch,
+				 const Charset &charset)
+{
+  // Check whether any buttons that stand for dots (i.e. not button 0) or
+  // cell holes are still active
+  const bool button_active = (contacts.buttons() & ~((uint32_t) 1)) != 0;
+  const bool stylus_active = contacts.numStylus() > 0;
+
+  // With a glyph underway per cell, report every glyph that nothing is
+  // still pressing on, then the word if that was all of it
+  if(concurrent_cells) {
+    for(unsigned short int cell=0; cell<ContactTable::NUM_CELLS; ++cell)
+      if(((open_cells >> cell) & 1) && !contacts.cellActive(cell))
+	completeCell(out, cell, watch, charset);
+    if((glyph_where == BUTTONS) && !button_active) {
+      reportGlyph(out, watch, charset);
+      glyph_where = NONE;
+      glyph_dots = (unsigned char) 0x00;
+    }
+    if(open_cells == 0) reportWord(out, watch);
+    return;
+  }
+
+  if(glyph_where == NONE) return;
+
+  if(((glyph_where == BUTTONS) && (!button_active)) ||
+     ((glyph_where == CELL) && (!stylus_active)))
+    reportGlyph(out, watch, charset);
+
+  // Set glyph tracking variables to "no glyph"
+  if(!(button_active | stylus_active)) {
+    glyph_where = NONE;
+    glyph_dots = (unsigned char) 0x00;
+  }
+}
+
+// Report glyphs and words that have gone untouched for long enough
+void IOEventDecoder::expireGlyphs(std::deque<IOEvent> &out,
+				  const TimeInterval &now,
+				  const TimeInterval &delay,
+				  const IOEvent::TypeMask &watch,
+				  const Charset &charset)
+{
+  if(!concurrent_cells) return;
+
+  for(unsigned short int cell=0; cell<ContactTable::NUM_CELLS; ++cell)
+    if(((open_cells >> cell) & 1) && !contacts.cellActive(cell) &&
+       (cell_glyphs[cell].last + delay <= now))
+      completeCell(out, cell, watch, charset);
+
+  if((glyph_where == BUTTONS) &&
+     !(contacts.buttons() & ~((uint32_t) 1)) && (glyph_last + delay <= now)) {
+    reportGlyph(out, watch, charset);
+    glyph_where = NONE;
+    glyph_dots = (unsigned char) 0x00;
+  }
+
+  if((open_cells == 0) && (word_last + delay + delay <= now))
+    reportWord(out, watch);
+}
+
+// Find when expireGlyphs next has anything to do
+bool IOEventDecoder::nextDeadline(const TimeInterval &delay,
+				  TimeInterval &deadline) const
+{
+  bool found = false;
+
+  for(unsigned short int cell=0; cell<ContactTable::NUM_CELLS; ++cell)
+    if(((open_cells >> cell) & 1) && !contacts.cellActive(cell)) {
+      const TimeInterval when = cell_glyphs[cell].last + delay;
+      if(!found || (when < deadline)) { deadline = when; found = true; }
+    }
+
+  if((glyph_where == BUTTONS) && !(contacts.buttons() & ~((uint32_t) 1))) {
+    const TimeInterval when = glyph_last + delay;
+    if(!found || (when < deadline)) { deadline = when; found = true; }
+  }
+
+  if((open_cells == 0) && (word_cells != 0)) {
+    const TimeInterval when = word_last + delay + delay;
+    if(!found || (when < deadline)) { deadline = when; found = true; }
+  }
+
+  return found;
+}
+
+// Switch between one glyph at a time and a glyph per cell
+void IOEventDecoder::setConcurrentCells(const bool &on)
+{ if(!glyphUnderway()) concurrent_cells = on; }
+
+// Constructor
+IOEventDecoder::IOEventDecoder()
+: glyph_where(NONE), glyph_cell(INVALID_CELL), glyph_dots(0),
+  concurrent_cells(false), open_cells(0), word_cells(0), held_groups(0) { }
+
+} // namespace BrailleTutorNS
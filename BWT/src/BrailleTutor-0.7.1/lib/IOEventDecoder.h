@@ -0,0 +1,244 @@
+#ifndef _LIBBT_IO_EVENT_DECODER_H_
+#define _LIBBT_IO_EVENT_DECODER_H_
+/*
+ * Braille Tutor interface library
+ * IOEventDecoder.h, started 19 October 2026
+ *
+ * The synchronous heart of the IOEventParser: turns batches of BaseIOEvent
+ * events into IOEvent events, tracking active buttons and dots and the
+ * glyph under construction. IOEventParser runs one of these in its decoder
+ * thread; it is kept separate from the thread so that it can be driven
+ * directly, e.g. by tests replaying recorded event streams.
+ */
+
+#include <deque>
+#include <vector>
+#include <stdint.h>
+
+#include "Types.h"
+#include "Charset.h"
+#include "IOEvent.h"
+#include "ContactTable.h"
+
+namespace BrailleTutorNS {
+
+//! Turns batches of BaseIOEvent events into IOEvent events
+
+//! Each batch is decoded in two passes that dispatch on event type. The
+//! first keeps the active contacts and sorts the press and release
+//! events, and the STYLUS and BUTTON events, into a buffer per group,
+//! which are then appended in order; the second makes glyphs, straight
+//! into the output. Output for a batch always appears in the same order:
+//! STYLUS_DOWN, STYLUS_UP, BUTTON_DOWN, BUTTON_UP, STYLUS, and BUTTON
+//! events, then glyph events (*_START, *_PROVISIONAL_LETTER, *_DONE,
+//! *_DOTS, *_LETTER); within each group, events follow the order of the
+//! input events that caused them.
+//!
+//! By default there is one glyph under construction at a time, and writing
+//! in another cell completes it. With setConcurrentCells(), each cell has a
+//! glyph of its own, completed when it goes untouched for the glyph delay
+//! (see expireGlyphs()), and glyphs in a run of adjacent cells also make up
+//! a WORD.
+class IOEventDecoder {
+public:
+  //! Decode one batch of BaseIOEvent events
+
+  //! Appends IOEvent events decoded from in to out, making only the types
+  //! in watch (DONE is always made). If in contains a FLUSH_GLYPH event,
+  //! sets flush_glyph to true; the caller should then call finishGlyph.
+  //! If in contains a DONE event, out receives only a DONE IOEvent and
+  //! decode returns true: time to shut down. Otherwise returns false.
+  bool decode(const std::deque<BaseIOEvent> &in, std::deque<IOEvent> &out,
+	      const IOEvent::TypeMask &watch, const Charset &charset,
+	      bool &flush_glyph);
+
+  //! Report the glyph under construction as complete, if it can be
+
+  //! Called when the glyph delay expires or a glyph flush is requested.
+  //! If no button or stylus is still down where the glyph is being made,
+  //! appends the glyph's *_DONE, *_DOTS, and *_LETTER events (as watched)
+  //! to out. The glyph is abandoned once nothing at all is active. With
+  //! concurrent cells, reports each cell glyph that nothing is pressing on,
+  //! and the word once no cell glyph is left.
+  void finishGlyph(std::deque<IOEvent> &out,
+		   const IOEvent::TypeMask &watch, const Charset &charset);
+
+  //! Report glyphs and words that have gone untouched for long enough
+
+  //! For concurrent cell assembly only (otherwise does nothing). Appends
+  //! events for each cell glyph that nothing is pressing on and that has
+  //! gone untouched since delay before now, and likewise for any glyph on
+  //! the buttons. Once no cell glyph is left, a word whose last dot came
+  //! twice delay before now is reported too.
+  void expireGlyphs(std::deque<IOEvent> &out, const TimeInterval &now,
+		    const TimeInterval &delay,
+		    const IOEvent::TypeMask &watch, const Charset &charset);
+
+  //! Find the next time expireGlyphs could have anything to report
+
+  //! For concurrent cell assembly. Returns false if nothing will expire
+  //! without more input, e.g. because the stylus is still in every cell
+  //! with a glyph underway.
+  bool nextDeadline(const TimeInterval &delay, TimeInterval &deadline) const;
+
+  //! Assemble a glyph per cell (if on) or one glyph at a time (if not)
+
+  //! The change is put off while any glyph or word is underway; call this
+  //! again later to make it take effect.
+  void setConcurrentCells(const bool &on);
+
+  //! Returns true if glyphs are being assembled per cell
+  inline bool concurrentCells() const { return concurrent_cells; }
+
+  //! Returns true if a glyph (or, for concurrent cells, a word) is under
+  //! construction
+  inline bool glyphUnderway() const
+  { return (glyph_where != NONE) || (open_cells != 0) || (word_cells != 0); }
+
+  //! Pauses the user made before dots that continued a glyph
+
+  //! For each dot added to a glyph under construction in the last batch
+  //! decoded, the time since the glyph's previous dot entry or withdrawal.
+  //! These are the pauses the glyph delay must outlast.
+  inline const std::vector<TimeInterval> &dotPauses() const { return pauses; }
+
+  //! Number of stray input events ignored so far
+
+  //! Counts releases of buttons or holes that were never pressed, as well
+  //! as presses of buttons or holes the Tutor doesn't have. Both mean that
+  //! the input is corrupt (or that events were lost upstream).
+  inline unsigned long strayContacts() const { return contacts.strays(); }
+
+  //! Constructor
+  IOEventDecoder();
+
+private:
+  //! Buttons and braille dots currently pushed, with when they were pushed
+  ContactTable contacts;
+
+  //! Datatype saying where and whether a dot glyph is under construction
+  typedef enum { NONE,		//!< No glyph is currently under construction
+		 BUTTONS,	//!< Glyph under construction on the buttons
+		 CELL,		//!< Glyph under construction in a braille cell
+	  } GlyphLoc;
+
+  //! Indicates whether and where a dot glyph is currently under construction
+  GlyphLoc glyph_where;
+
+  //! If a cell's being used to make a dot glyph, says which cell
+  unsigned short int glyph_cell;
+
+  //! Time when the glyph under construction was begun
+  TimeInterval glyph_began;
+  //! Time of the last dot entry for the glyph under construction
+  TimeInterval glyph_last;
+
+  //! Dots for the current glyph under development
+  unsigned char glyph_dots;
+
+  //! True if glyphs are assembled per cell
+  bool concurrent_cells;
+
+  //! A glyph under construction in one cell, for concurrent cell assembly
+  struct CellGlyph {
+    TimeInterval began;		//!< When the glyph was begun
+    TimeInterval last;		//!< Time of its last dot entry or withdrawal
+    unsigned char dots;		//!< Its dots so far
+  };
+
+  //! Glyphs under construction, by cell, for concurrent cell assembly
+  CellGlyph cell_glyphs[ContactTable::NUM_CELLS];
+  //! Bitmap of cells with a glyph under construction
+  uint32_t open_cells;
+
+  //! Bitmap of cells with a completed glyph in the word under construction
+  uint32_t word_cells;
+  //! Letters of the completed glyphs in the word, by cell
+  GlyphMapping word_letters[ContactTable::NUM_CELLS];
+  //! When the first glyph of the word under construction was begun
+  TimeInterval word_began;
+  //! Time of the word's last dot entry or withdrawal
+  TimeInterval word_last;
+
+  //! Output groups, in the order their events are appended to the output
+  typedef enum { OUT_STYLUS_DOWN, OUT_STYLUS_UP,
+		 OUT_BUTTON_DOWN, OUT_BUTTON_UP,
+		 OUT_STYLUS, OUT_BUTTON, OUT_GLYPH } OutGroup;
+
+  //! An event of a group before OUT_GLYPH, held back while a batch is
+  //! sorted: the BaseIOEvent it comes of, and for STYLUS and BUTTON
+  //! events, the time the contact was made
+  struct Held {
+    const BaseIOEvent *event;
+    TimeInterval down;
+  };
+  //! A batch's events of each group before OUT_GLYPH (emptied after
+  //! every batch, but kept to reuse their storage)
+  std::vector<Held> group_held[OUT_GLYPH];
+  //! Bitmap of the groups with events held
+  unsigned int held_groups;
+
+  //! Make the IOEvent of a group before OUT_GLYPH for a BaseIOEvent
+  inline static IOEvent makeEvent(const OutGroup &group,
+				  const BaseIOEvent &event,
+				  const TimeInterval &down);
+  //! Note an event of a group before OUT_GLYPH in its group's buffer
+  inline void hold(const OutGroup &group, const BaseIOEvent &event,
+		   const TimeInterval &down);
+
+  //! Pauses before dots continuing glyphs in the last batch decoded
+  std::vector<TimeInterval> pauses;
+
+  //! Note the pause before a dot continuing a glyph whose last dot entry
+  //! or withdrawal was at last
+  inline void notePause(const TimeInterval &last, const TimeInterval &when);
+
+  //! Append CELL_DONE, CELL_DOTS, CELL_LETTER events for a glyph to out
+  void reportCellGlyph(std::deque<IOEvent> &out,
+		       const IOEvent::TypeMask &watch, const Charset &charset,
+		       const unsigned short int &cell,
+		       const TimeInterval &began, const TimeInterval &last,
+		       const unsigned char &dots);
+
+  //! Append *_DONE, *_DOTS, *_LETTER events for the current glyph to out
+  void reportGlyph(std::deque<IOEvent> &out,
+		   const IOEvent::TypeMask &watch, const Charset &charset);
+
+  //! Append a *_PROVISIONAL_LETTER event to out, as watched, if a glyph
+  //! under construction is settled as of time when
+  void checkSettled(std::deque<IOEvent> &out,
+		    const GlyphLoc &where, const unsigned short int &cell,
+		    const TimeInterval &began, const unsigned char &dots,
+		    const TimeInterval &when,
+		    const IOEvent::TypeMask &watch, const Charset &charset);
+
+  //! Returns true if a glyph begun in cell would join the word underway
+  inline bool adjoinsWord(const unsigned short int &cell) const;
+
+  //! Handle a stylus down when cells are assembled concurrently
+  void concurrentStylusDown(std::deque<IOEvent> &out,
+			    const BaseIOEvent &down,
+			    const IOEvent::TypeMask &watch,
+			    const Charset &charset);
+
+  //! Report the glyph underway in cell as complete and add it to the word
+  void completeCell(std::deque<IOEvent> &out,
+		    const unsigned short int &cell,
+		    const IOEvent::TypeMask &watch, const Charset &charset);
+
+  //! Report all glyphs underway in cells as complete, in cell order
+  void closeCells(std::deque<IOEvent> &out,
+		  const IOEvent::TypeMask &watch, const Charset &charset);
+
+  //! Report the word under construction, if any, as WORD is watched
+  void reportWord(std::deque<IOEvent> &out, const IOEvent::TypeMask &watch);
+
+  //! Start a new glyph (announcing it as watched) at a button or stylus down
+  void startGlyph(std::deque<IOEvent> &out,
+		  const BaseIOEvent &down, const GlyphLoc &where,
+		  const IOEvent::TypeMask &watch);
+};
+
+} // namespace BrailleTutorNS
+
+#endif
@@ -14,6 +14,7 @@
 
 #include <map>
 #include <deque>
+#include <vector>
 #include <iterator>
 #include <iostream>
 
@@ -53,6 +54,41 @@ struct SMState {
 };
 
 
+//! Templated abstract base class for state machine transition tracers
+
+//! A tracer registered with StateMachine::setTracer is shown the machine's
+//! input and output on either side of every cycle. Tracers are called on
+//! the hot path, so implementations should record what they need and get
+//! out of the way. Template arguments are as for SMState.
+template <typename inputT, typename outputT,
+	  typename dataT,  typename stateNameT>
+struct SMTracer {
+  //! Shorthand for the type of states handled by this tracer
+  typedef SMState<inputT, outputT, dataT, stateNameT> stateT;
+
+  //! Called just before the machine cycles in state on input in
+  virtual void enter(const stateT &state,
+		     const inputT &in, const outputT &out) = 0;
+
+  //! Called after a cycle has left the machine in state
+
+  //! Not called if the cycle threw an exception, so tracers can tell
+  //! failed cycles from those that completed.
+  virtual void leave(const stateT &state,
+		     const inputT &in, const outputT &out) = 0;
+
+  //! For G++
+  inline virtual ~SMTracer() { }
+};
+
+
+//! Reasons for StateMachine::run() to hand control back to its caller
+typedef enum {
+  SM_NEEDS_INPUT,	//!< Input exhausted, or the machine awaits more of it
+  SM_ERROR		//!< Machine made no progress on input it should handle
+} SMRunStatus;
+
+
 //! Templated class for state machine processing
 
 //! Stores state information and manages execution of a state machine.
@@ -86,6 +122,12 @@ private:
   //! Pointer to the current state
   stateT *curr_state;
 
+  //! Shorthand for the type of tracers used by this state machine
+  typedef SMTracer<inputT, outputT, dataT, stateNameT> tracerT;
+
+  //! Pointer to the transition tracer, if any
+  tracerT *tracer;
+
 public:
   //! Submit a single input to the state machine and cycle the clock.
   inline void cycle(inputT &in, outputT &out)
@@ -94,6 +136,7 @@ public:
 #ifdef LIBBT_SM_DIAG_PRINT
 std::cerr << '[' << curr_state->getName() << ' ' << std::flush;
 #endif
+    if(tracer != NULL) tracer->enter(*curr_state, in, out);
     (*curr_state)(in, out, data, new_state_name);
     states_iter s_iter = states.find(new_state_name);
     if(s_iter == states.end()) {
@@ -104,12 +147,38 @@ std::cerr << " => NONEXISTANT STATE \"" << new_state_name << "\"]" << std::endl;
 			"state machine tried to jump to a nonexistant state");
     }
     curr_state = s_iter->second.get();
+    if(tracer != NULL) tracer->leave(*curr_state, in, out);
 #ifdef LIBBT_SM_DIAG_PRINT
 std::cerr << " => " << curr_state->getName() << "] "
 	  << (double) TimeInterval::now() << std::endl;
 #endif
   }
 
+  //! Cycle the state machine until it blocks on its input.
+
+  //! Submits in to the state machine over and over until the machine can
+  //! make no more progress, placing any output in the caller's out. This
+  //! saves callers with whole buffers of input from having to watch the
+  //! input shrink cycle by cycle themselves. Only usable with input types
+  //! that describe their own backlog: inputT must supply pending(), the
+  //! number of input symbols not yet consumed, and starved(), true if the
+  //! machine may legitimately stall waiting for more input. Returns
+  //! SM_NEEDS_INPUT if the input ran dry or the machine stalled on a starved
+  //! input; SM_ERROR if it stalled anyway. Exceptions thrown by states
+  //! propagate to the caller as with cycle().
+  inline SMRunStatus run(inputT &in, outputT &out)
+  {
+    size_t remaining = in.pending();
+    while(remaining > 0) {
+      cycle(in, out);
+      const size_t now_remaining = in.pending();
+      if(now_remaining == remaining)
+	return in.starved() ? SM_NEEDS_INPUT : SM_ERROR;
+      remaining = now_remaining;
+    }
+    return SM_NEEDS_INPUT;
+  }
+
   //! An alias for cycle
   inline void operator()(inputT &in, outputT &out) { cycle(in, out); }
 
@@ -158,6 +227,12 @@ std::cerr << " => " << curr_state->getName() << "] "
   //! Retrieve the data object for this automaton
   inline dataT &getData() { return data; }
 
+  //! Register a tracer to watch every cycle; NULL removes the tracer.
+
+  //! The state machine does NOT keep its own copy of the tracer, so don't
+  //! destroy it while it's still registered.
+  inline void setTracer(tracerT *my_tracer) { tracer = my_tracer; }
+
   //! Constructor
 
   //! Constructs a state machine from a vector of smart pointers to states;
@@ -167,7 +242,7 @@ std::cerr << " => " << curr_state->getName() << "] "
   inline StateMachine(
     const std::vector<boost::shared_ptr<stateT> >
       &my_states=std::vector<boost::shared_ptr<stateT> >())
-  : curr_state(NULL)
+  : curr_state(NULL), tracer(NULL)
   { for(unsigned int i=0; i<my_states.size(); ++i) addState(*my_states[i]); }
 
   //! Assignment operator
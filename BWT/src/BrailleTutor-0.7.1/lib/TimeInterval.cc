@@ -4,47 +4,75 @@
  *
  * Implements the now() named constructor of the TimeInterval class (see
  * Types.h), which creates a TimeInterval object representing the elapsed
- * time since some unspecified epoch (in this implementation, near the
- * start of the program).
+ * time on a monotonic clock since some unspecified epoch (in this
+ * implementation, the start of the program), along with sleeping until
+ * such a timestamp and the PeriodicTicker built on that.
  */
 
 #include "Types.h"
 
-#include <boost/thread/condition.hpp>
-#include <boost/thread.hpp>
+#ifdef BT_WINDOWS
+#include "Windows.h"
+#else
+#include <time.h>
+#include <errno.h>
+#include <unistd.h>
+#endif
 
 namespace BrailleTutorNS {
 
+// Definitions for TimeInterval's constants, should they be used by reference
+const int64_t TimeInterval::NSECS_PER_SEC;
+const int64_t TimeInterval::LIMIT_NSECS;
+
 #ifdef BT_WINDOWS
 //
 // Windows implementation
 //
-#include "Windows.h"
 
-// Returns the current time (Windows version).
-inline static LARGE_INTEGER get_now()
+// Returns the performance counter's current count. The counter is
+// monotonic.
+inline static LONGLONG get_now()
 {
-  FILETIME now;
-  GetSystemTimeAsFileTime(&now);
-  LARGE_INTEGER now_as_lint;
-  now_as_lint.LowPart  = now.dwLowDateTime;
-  now_as_lint.HighPart = now.dwHighDateTime;
-  return now_as_lint;
+  LARGE_INTEGER now;
+  QueryPerformanceCounter(&now);
+  return now.QuadPart;
 }
 
+// Returns the performance counter's frequency, which is fixed at boot.
+inline static LONGLONG get_frequency()
+{
+  LARGE_INTEGER freq;
+  QueryPerformanceFrequency(&freq);
+  return freq.QuadPart;
+}
+
+// The counter frequency, in counts per second
+static LONGLONG frequency = get_frequency();
 // The epoch---here, the exact moment of program start.
-static LARGE_INTEGER epoch = get_now();
+static LONGLONG epoch = get_now();
 
 // Implementation of TimeInterval::now() for Windows.
 TimeInterval TimeInterval::now()
 {
-  LARGE_INTEGER now_as_lint = get_now();
-  LONGLONG interval = now_as_lint.QuadPart - epoch.QuadPart;
+  const LONGLONG interval = get_now() - epoch;
 
-  LONGLONG secs = interval / ((LONGLONG) 1e7);
-  LONGLONG usecs = (interval % ((LONGLONG) 1e7)) / ((LONGLONG) 1e4);
+  // Split the conversion so the multiplication can't overflow
+  return TimeInterval::fromNsecs(
+    (interval / frequency) * NSECS_PER_SEC +
+    ((interval % frequency) * NSECS_PER_SEC) / frequency);
+}
 
-  return TimeInterval((unsigned int) secs, (unsigned short int) usecs);
+// Implementation of TimeInterval::sleepUntil() for Windows. There's no
+// absolute sleep on the performance counter, so sleep whatever is left
+// until there's nothing left.
+void TimeInterval::sleepUntil(const TimeInterval &deadline)
+{
+  for(;;) {
+    const TimeInterval left = deadline - now();
+    if(left.nsecs <= 0) return;
+    Sleep((DWORD) ((left.nsecs + 999999) / 1000000));
+  }
 }
 
 
@@ -52,50 +80,94 @@ TimeInterval TimeInterval::now()
 //
 // UNIX implementation
 //
-#include <ctime>
-#include <sys/time.h>
 
-// The epoch---here, the nearest second less than the exact moment
-// of program start.
-static time_t epoch = time(NULL);
+// Returns the monotonic clock's current reading, in nanoseconds
+inline static int64_t get_now()
+{
+  struct timespec tspec;
+  clock_gettime(CLOCK_MONOTONIC, &tspec);
+  return ((int64_t) tspec.tv_sec) * TimeInterval::NSECS_PER_SEC +
+	 tspec.tv_nsec;
+}
+
+// The epoch---here, the exact moment of program start.
+static int64_t epoch = get_now();
 
-// Implementation of TimeInterval::now() for UNIX
+// Implementation of TimeInterval::now() for UNIX. Unlike gettimeofday(),
+// CLOCK_MONOTONIC doesn't jump when NTP or a user sets the clock.
 TimeInterval TimeInterval::now()
-{
-  struct timeval tval;
-  gettimeofday(&tval, NULL);
+{ return TimeInterval::fromNsecs(get_now() - epoch); }
 
-  return TimeInterval((unsigned int) (tval.tv_sec - epoch),
-		      (unsigned int) (tval.tv_usec / 1000));
+// Implementation of TimeInterval::sleepUntil() for UNIX
+void TimeInterval::sleepUntil(const TimeInterval &deadline)
+{
+#if defined(_POSIX_CLOCK_SELECTION) && (_POSIX_CLOCK_SELECTION > 0)
+  // Sleep until the deadline on the same clock now() reads. Signals may
+  // interrupt; the deadline stays put, so just go back to sleep.
+  const int64_t wake = epoch + deadline.nsecs;
+  struct timespec tspec;
+  tspec.tv_sec  = wake / NSECS_PER_SEC;
+  tspec.tv_nsec = wake % NSECS_PER_SEC;
+  while(clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &tspec, NULL) == EINTR)
+    ;
+#else
+  // No absolute sleeps on this system (e.g. Mac OS X); sleep whatever is
+  // left until there's nothing left.
+  for(;;) {
+    const TimeInterval left = deadline - now();
+    if(left.nsecs <= 0) return;
+    struct timespec tspec;
+    tspec.tv_sec  = left.wholeSecs();
+    tspec.tv_nsec = left.fracNsecs();
+    nanosleep(&tspec, NULL);
+  }
+#endif
 }
 
 #endif
 
 
-// Portable fine-resolution sleeping. This is KLUDGY, and Boost doesn't
-// guarantee resolution better than a second for the technique we're using
-// here. Nevertheless, this is nominally portable. We do it by making a
-// mutex, grabbing it, and then waiting on a condition that's never satisfied.
+// Portable fine-resolution sleeping
 void TimeInterval::sleep() const
+{ sleepUntil(now() + *this); }
+
+
+//// PeriodicTicker ////
+
+// Constructor
+PeriodicTicker::PeriodicTicker(const TimeInterval &my_period,
+			       const TimeInterval &start)
+: period(my_period), next(start + my_period)
+{
+  if(period.nsecs <= 0)
+    throw BTException(BTException::BT_EDOM,
+		      "periodic ticker period must be positive");
+}
+
+// Sleep until the next tick
+unsigned int PeriodicTicker::wait()
+{
+  TimeInterval::sleepUntil(next);
+
+  // The next deadline follows from this one, not from the time now
+  next = next + period;
+  const TimeInterval now = TimeInterval::now();
+  if(next > now) return 0;
+
+  // We've fallen behind by a period or more. Skip the ticks we missed.
+  const int64_t missed = (now - next).nsecs / period.nsecs + 1;
+  next = next + TimeInterval::fromNsecs(missed * period.nsecs);
+  return (unsigned int) missed;
+}
+
+// Change the period, starting from the last tick
+void PeriodicTicker::setPeriod(const TimeInterval &my_period)
 {
-  // First get the time right now
-  boost::xtime time_begin;
-  boost::xtime_get(&time_begin, boost::TIME_UTC_);	// Gary: Changed from TIME_UTC to TIME_UTC_ in 1.53.0
-
-  // Now set up the dummy mutex and condition variable, then grab mutex
-  boost::mutex			dummy_mutex;
-  boost::condition		dummy_wait;
-  boost::mutex::scoped_lock	dummy_lock(dummy_mutex);
-
-  // Determine end time of wait
-  boost::xtime time_end(time_begin);
-  time_end.sec += secs;
-  const unsigned int nsecs = msecs * 1000000;
-  time_end.nsec += nsecs % 1000000000;
-  time_end.sec  += nsecs / 1000000000;
-
-  // Wait out the rest of our sentence
-  dummy_wait.timed_wait(dummy_lock, time_end);
+  if(my_period.nsecs <= 0)
+    throw BTException(BTException::BT_EDOM,
+		      "periodic ticker period must be positive");
+  next = next - period + my_period;
+  period = my_period;
 }
 
 } // namespace BrailleTutorNS
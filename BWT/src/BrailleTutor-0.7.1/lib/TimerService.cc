@@ -0,0 +1,145 @@
+/*
+ * Braille Tutor interface library
+ * TimerService.cc, started 19 October 2026
+ *
+ * Implementation of the TimerService, which calls back any number of
+ * TimerClient objects from a single thread.
+ */
+
+#include <map>
+
+#include "Types.h"
+#include "TimerService.h"
+
+#include <boost/thread/condition.hpp>
+#include <boost/thread.hpp>
+
+namespace BrailleTutorNS {
+
+//! The thread functor that waits out a TimerService's deadlines
+struct FunctorTimerService {
+  //! Reference to the TimerService we're working for
+  TimerService &ts;
+
+  //! Constructor---fill in references
+  inline FunctorTimerService(TimerService &my_ts) : ts(my_ts) { }
+
+  //! Perform this functor's function
+  inline void operator()()
+  {
+    boost::mutex::scoped_lock lock_d(ts.mutex_deadlines);
+
+    // Loop until told to quit
+    for(;;) {
+      if(ts.quitting) return;
+
+      // Find the client with the earliest deadline; wait if there are none
+      std::map<TimerClient*, TimeInterval>::iterator earliest;
+      if(!ts.earliest(earliest)) { ts.cond_deadlines.wait(lock_d); continue; }
+
+      // Not time yet? Wait until it is, or until the schedule changes.
+      const TimeInterval now = ts.clock.now();
+      const TimeInterval deadline = earliest->second;
+      if(deadline > now) {
+	ts.clock.waitUntil(ts.cond_deadlines, lock_d, deadline);
+	continue;
+      }
+
+      ts.callEarliest(lock_d, now);
+    }
+  }
+};
+
+// Constructor: starts the timer thread, unless the clock adopts us
+TimerService::TimerService(Clock &my_clock)
+: clock(my_clock), running(NULL), quitting(false)
+{
+  if(!clock.adopt(*this))
+    t_timer.reset(new boost::thread(FunctorTimerService(*this)));
+}
+
+// Schedule a client to be called back
+void TimerService::schedule(TimerClient &client, const TimeInterval &when)
+{
+  boost::mutex::scoped_lock lock_d(mutex_deadlines);
+  deadlines[&client] = when;
+  cond_deadlines.notify_one();
+}
+
+// Cancel any callback scheduled for a client
+void TimerService::cancel(TimerClient &client)
+{
+  boost::mutex::scoped_lock lock_d(mutex_deadlines);
+  deadlines.erase(&client);
+
+  // A callback in progress must finish first, unless this is that callback
+  if((running == &client) &&
+     (running_thread == boost::this_thread::get_id())) return;
+  while(running == &client) cond_running.wait(lock_d);
+}
+
+// Find the earliest scheduled time
+bool TimerService::earliest(
+  std::map<TimerClient*, TimeInterval>::iterator &e_iter)
+{
+  if(deadlines.empty()) return false;
+  std::map<TimerClient*, TimeInterval>::iterator d_iter;
+  e_iter = deadlines.begin();
+  for(d_iter=deadlines.begin(); d_iter!=deadlines.end(); ++d_iter)
+    if(d_iter->second < e_iter->second) e_iter = d_iter;
+  return true;
+}
+
+// Call back the client with the earliest scheduled time, if it's due
+bool TimerService::callEarliest(boost::mutex::scoped_lock &lock_d,
+				const TimeInterval &now)
+{
+  std::map<TimerClient*, TimeInterval>::iterator e_iter;
+  if(!earliest(e_iter) || (e_iter->second > now)) return false;
+
+  // Call the client back without holding the lock, so it can schedule
+  // itself again
+  TimerClient *client = e_iter->first;
+  deadlines.erase(e_iter);
+  running = client;
+  running_thread = boost::this_thread::get_id();
+  lock_d.unlock();
+  client->handleTimer(now);
+  lock_d.lock();
+  running = NULL;
+  cond_running.notify_all();
+  return true;
+}
+
+// Find the earliest scheduled time, for a clock making our callbacks
+bool TimerService::nextDeadline(TimeInterval &deadline)
+{
+  boost::mutex::scoped_lock lock_d(mutex_deadlines);
+  std::map<TimerClient*, TimeInterval>::iterator e_iter;
+  if(!earliest(e_iter)) return false;
+  deadline = e_iter->second;
+  return true;
+}
+
+// Make the earliest callback if it's due, for a clock making our callbacks
+void TimerService::runNext(const TimeInterval &now)
+{
+  boost::mutex::scoped_lock lock_d(mutex_deadlines);
+  callEarliest(lock_d, now);
+}
+
+// Destructor: stops the timer thread
+TimerService::~TimerService()
+{
+  if(!t_timer) { clock.disown(*this); return; }
+
+  {
+    boost::mutex::scoped_lock lock_d(mutex_deadlines);
+    quitting = true;
+    cond_deadlines.notify_one();
+  }
+
+  t_timer->join();
+}
+
+} // namespace BrailleTutorNS
@@ -0,0 +1,345 @@
+/*
+ * Braille Tutor interface library
+ * Translator.cc, started 19 October 2026
+ *
+ * Implements TranslationTable, which compiles cell sequence rules into a
+ * trie, and BackTranslator, which walks that trie over cells as they are
+ * written.
+ */
+
+#include "Dots.h"
+#include "Types.h"
+#include "Charset.h"
+#include "IOEvent.h"
+#include "Translator.h"
+
+#include <map>
+#include <deque>
+#include <string>
+#include <vector>
+#include <fstream>
+#include <sstream>
+
+namespace BrailleTutorNS {
+
+// Constructor: no rules
+TranslationTable::TranslationTable()
+{ compile(); }
+
+// Constructor: charset's one-cell rules
+TranslationTable::TranslationTable(const Charset &charset)
+{
+  std::vector<unsigned char> cell(1);
+  for(unsigned int p=0; p<256; ++p)
+    if(!charset[p].isEmpty()) { cell[0] = p; setRule(cell, charset[p]); }
+  compile();
+}
+
+// Named constructor: charset's rules plus a cell rule file's
+TranslationTable TranslationTable::fromFile(const Charset &charset,
+					    const std::string &filename)
+{ TranslationTable t(charset); t.read(filename); return t; }
+
+// Named constructor: charset's rules plus a cell rule file's, if it exists
+TranslationTable TranslationTable::load(const Charset &charset,
+					const std::string &filename)
+{
+  TranslationTable t(charset);
+  std::ifstream in(filename.c_str());
+  if(in.good()) t.read(in);
+  return t;
+}
+
+// Name of the cell rule file that goes with a text mapping file
+std::string TranslationTable::rulesFilename(const std::string &mapping)
+{
+  const std::string text_ext(".txt");
+  if((mapping.size() >= text_ext.size()) &&
+     (mapping.compare(mapping.size() - text_ext.size(), text_ext.size(),
+		      text_ext) == 0))
+    return mapping.substr(0, mapping.size() - text_ext.size()) + ".cells";
+  return mapping + ".cells";
+}
+
+// Add a rule and recompile
+void TranslationTable::add(const std::vector<unsigned char> &cells,
+			   const GlyphMapping &glyph)
+{
+  if(cells.empty() || (cells.size() > MAX_CELLS))
+    throw BTException(BTException::BT_EINVAL,
+		      "TranslationTable::add: rules must have 1 to MAX_CELLS cells");
+  setRule(cells, glyph);
+  compile();
+}
+
+// Set a rule, keeping the glyph-to-cells map in step
+void TranslationTable::setRule(const std::vector<unsigned char> &cells,
+			       const GlyphMapping &glyph)
+{
+  // Forget how the glyph this replaces was written, if it was this way
+  std::map<std::vector<unsigned char>, GlyphMapping>::iterator old;
+  old = rules.find(cells);
+  if(old != rules.end()) {
+    const GlyphMapping replaced = old->second;
+    rules.erase(old);
+    std::map<GlyphMapping, std::vector<unsigned char> >::iterator w;
+    w = writing.find(replaced);
+    if((w != writing.end()) && (w->second == cells)) {
+      writing.erase(w);
+      // Fall back on any other rule for it
+      for(old = rules.begin(); old != rules.end(); ++old)
+	if(old->second.equals(replaced)) writing[replaced] = old->first;
+    }
+  }
+
+  if(glyph.isEmpty()) return;
+  rules[cells] = glyph;
+  writing[glyph] = cells;
+}
+
+//! Iterator over a TranslationTable's rules
+typedef std::map<std::vector<unsigned char>, GlyphMapping>::const_iterator
+	RuleIt;
+
+//! Rules sharing their first depth cells, which lead to trie node node
+struct RuleRun {
+  TranslationTable::State node;
+  RuleIt first, last;
+  unsigned int depth;
+};
+
+// Rebuild the trie from the rules. Rules are visited in their map order,
+// which puts every rule sharing a prefix in one run, the prefix itself
+// first. Nodes are made breadth first, so each node's edges are made
+// together and sit contiguously, sorted by dots.
+void TranslationTable::compile()
+{
+  nodes.clear();
+  edge_dots.clear();
+  edge_child.clear();
+  max_cells = 0;
+  for(unsigned int p=0; p<256; ++p) root_children[p] = NO_STATE;
+
+  const TrieNode root = { 0, 0, GlyphMapping() };
+  nodes.push_back(root);
+
+  std::deque<RuleRun> runs;
+  const RuleRun all = { ROOT, rules.begin(), rules.end(), 0 };
+  runs.push_back(all);
+  while(!runs.empty()) {
+    const RuleRun run = runs.front();
+    runs.pop_front();
+
+    RuleIt r = run.first;
+    if((r != run.last) && (r->first.size() == run.depth)) {
+      nodes[run.node].glyph = r->second;
+      if(run.depth > max_cells) max_cells = run.depth;
+      ++r;
+    }
+    nodes[run.node].first_edge = edge_dots.size();
+
+    // One child for each distinct next cell
+    while(r != run.last) {
+      const unsigned char dots = r->first[run.depth];
+      RuleIt end = r;
+      while((end != run.last) && (end->first[run.depth] == dots)) ++end;
+
+      const State child = nodes.size();
+      const TrieNode node = { 0, 0, GlyphMapping() };
+      nodes.push_back(node);
+      if(run.node == ROOT) root_children[dots] = child;
+      else {
+	edge_dots.push_back(dots);
+	edge_child.push_back(child);
+	++nodes[run.node].num_edges;
+      }
+
+      const RuleRun child_run = { child, r, end, run.depth+1 };
+      runs.push_back(child_run);
+      r = end;
+    }
+  }
+}
+
+// Parse a cell rule line's dots: patterns of digits 1-8 (or 0 for an empty
+// cell) separated by dashes. Returns false if it isn't one.
+static bool parse_cells(const std::string &spec,
+			std::vector<unsigned char> &cells)
+{
+  cells.clear();
+  bool in_cell = false;
+  unsigned char dots = 0;
+  for(unsigned int i=0; i<=spec.size(); ++i) {
+    const char c = (i < spec.size()) ? spec[i] : '-';
+    if(c == '-') {
+      if(!in_cell) return false;
+      cells.push_back(dots);
+      in_cell = false;
+      dots = 0;
+    }
+    else if((c == '0') && !in_cell) in_cell = true;
+    else if((c >= '1') && (c <= '8')) {
+      const unsigned char dot = 1 << (c - '1');
+      if(dots & dot) return false;
+      dots |= dot;
+      in_cell = true;
+    }
+    else return false;
+  }
+  return !cells.empty() && (cells.size() <= TranslationTable::MAX_CELLS);
+}
+
+// Add the rules in a cell rule file
+std::vector<unsigned int> TranslationTable::read(std::istream &in)
+{
+  static const char *whitespace = " \t\r";
+  std::vector<unsigned int> error_lines;
+  std::string line;
+  std::vector<unsigned char> cells;
+
+  for(unsigned int line_no=1; std::getline(in, line); ++line_no) {
+    // Drop any UTF-8 byte order mark, as Windows editors like to add
+    if((line_no == 1) && (line.compare(0, 3, "\xef\xbb\xbf") == 0))
+      line.erase(0, 3);
+
+    const std::string::size_type start = line.find_first_not_of(whitespace);
+    if((start == std::string::npos) || (line[start] == '#') ||
+       (line[start] == '!')) continue;
+
+    const std::string::size_type spec_end =
+      line.find_first_of(whitespace, start);
+    const std::string::size_type glyph_start = (spec_end == std::string::npos) ?
+      std::string::npos : line.find_first_not_of(whitespace, spec_end);
+    if(glyph_start == std::string::npos) {
+      error_lines.push_back(line_no);
+      continue;
+    }
+    const std::string::size_type glyph_end =
+      line.find_last_not_of(whitespace) + 1;
+
+    if(!parse_cells(line.substr(start, spec_end - start), cells)) {
+      error_lines.push_back(line_no);
+      continue;
+    }
+    setRule(cells, GlyphMapping(line.substr(glyph_start,
+					    glyph_end - glyph_start)));
+  }
+
+  compile();
+  return error_lines;
+}
+
+// Add the rules in a cell rule file
+std::vector<unsigned int> TranslationTable::read(const std::string &filename)
+{
+  std::ifstream in(filename.c_str());
+  if(!in.good())
+    throw BTException(BTException::BT_EIO,
+		      std::string("failed to open file ") + filename +
+		      " for reading");
+  return read(in);
+}
+
+// Cells to write glyph
+const std::vector<unsigned char> &
+TranslationTable::cellsFor(const GlyphMapping &glyph) const
+{
+  static const std::vector<unsigned char> none;
+  std::map<GlyphMapping, std::vector<unsigned char> >::const_iterator w;
+  w = writing.find(glyph);
+  return (w == writing.end()) ? none : w->second;
+}
+
+
+// Constructor
+BackTranslator::BackTranslator(const TranslationTable &my_table)
+: table(my_table)
+{ }
+
+// Translate held cells while their translation is certain: walk the trie
+// over them, remembering the longest rule matched. If every held cell was
+// matched and some rule is longer still, wait for more cells (unless
+// flushing); otherwise the longest rule wins.
+void BackTranslator::drain(const bool &flushing)
+{
+  while(!held.empty()) {
+    TranslationTable::State state = TranslationTable::ROOT;
+    unsigned int best_cells = 0;
+    unsigned int i;
+    for(i=0; i<held.size(); ++i) {
+      state = table.next(state, held[i]);
+      if(state == TranslationTable::NO_STATE) break;
+      if(!table.glyph(state).isEmpty()) best_cells = i+1;
+    }
+    if(!flushing && (i == held.size()) && table.continues(state)) return;
+
+    if(best_cells == 0) {
+      made.push_back(std::make_pair(GlyphMapping(), 1u));
+      held.pop_front();
+      continue;
+    }
+
+    state = TranslationTable::ROOT;
+    for(i=0; i<best_cells; ++i) state = table.next(state, held[i]);
+    made.push_back(std::make_pair(table.glyph(state), best_cells));
+    held.erase(held.begin(), held.begin() + best_cells);
+  }
+}
+
+// Push in a written cell
+void BackTranslator::push(const unsigned char &dots,
+			  std::vector<GlyphMapping> &out)
+{
+  made.clear();
+  held.push_back(dots);
+  drain(false);
+  for(unsigned int i=0; i<made.size(); ++i) out.push_back(made[i].first);
+}
+
+// Translate any held cells
+void BackTranslator::flush(std::vector<GlyphMapping> &out)
+{
+  made.clear();
+  drain(true);
+  for(unsigned int i=0; i<made.size(); ++i) out.push_back(made[i].first);
+}
+
+// Turn glyphs made from held events into CELL_LETTER events
+static void letter_events(std::deque<IOEvent> &held_events,
+			  const std::vector<std::pair<GlyphMapping,
+						      unsigned int> > &made,
+			  std::deque<IOEvent> &out)
+{
+  for(unsigned int i=0; i<made.size(); ++i) {
+    const IOEvent &first = held_events[0];
+    const IOEvent &last = held_events[made[i].second - 1];
+    out.push_back(IOEvent::makeCellLetterEvent(
+		    first.timestamp,
+		    last.timestamp + last.duration - first.timestamp,
+		    last.cell, made[i].first, last.dots));
+    held_events.erase(held_events.begin(),
+		      held_events.begin() + made[i].second);
+  }
+}
+
+// Push in an IOEvent
+void BackTranslator::push(const IOEvent &event, std::deque<IOEvent> &out)
+{
+  if(event.type != IOEvent::CELL_DOTS) return;
+
+  made.clear();
+  held.push_back(event.dots);
+  held_events.push_back(event);
+  drain(false);
+  letter_events(held_events, made, out);
+}
+
+// Translate any held CELL_DOTS events
+void BackTranslator::flush(std::deque<IOEvent> &out)
+{
+  made.clear();
+  drain(true);
+  letter_events(held_events, made, out);
+}
+
+} // namespace BrailleTutorNS
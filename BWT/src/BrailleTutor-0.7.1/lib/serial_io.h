@@ -55,6 +55,9 @@ typedef int serial_handle;
 static const serial_handle INVALID_SERIAL_HANDLE = UINT_MAX;
 #endif
 
+//! Serial port speed used by Braille Tutors unless they say otherwise
+static const unsigned int SERIAL_DEFAULT_BAUD = 57600;
+
 //! Creates a listing of serial ports to try in detect()
 
 //! Generates a list of serial ports to try out when attempting to detect
@@ -74,8 +77,10 @@ std::deque<std::string> serial_suggest_ports();
 //! exclusive anyway (check?). Throws appropriate exceptions on error.
 //! BT_EIO exceptions always correspond to a critical I/O error; other
 //! exceptions may refer to less urgent situations (e.g. port busy); see
-//! code for details.
-void serial_open(const std::string &port, serial_handle &handle);
+//! code for details. The port runs at baud bits per second, 8N1; baud
+//! rates the platform can't do yield a BT_EINVAL exception.
+void serial_open(const std::string &port, serial_handle &handle,
+		 const unsigned int &baud=SERIAL_DEFAULT_BAUD);
 
 //! Close an open serial port
 
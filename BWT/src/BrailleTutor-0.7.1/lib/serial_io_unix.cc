@@ -91,11 +91,28 @@ std::string portname_to_lockname(const std::string &port)
 // lock access to the serial port.
 // TODO: Add special case opening of a UNIX domain socket for local
 // simulation.
-void serial_open(const std::string &port, serial_handle &handle)
+void serial_open(const std::string &port, serial_handle &handle,
+		 const unsigned int &baud)
 {
   // Useful in two spots
   struct stat stats;
 
+  // Translate the baud rate to a termios speed before we lock anything
+  speed_t speed;
+  switch(baud) {
+  case 9600:	speed = B9600;   break;
+  case 19200:	speed = B19200;  break;
+  case 38400:	speed = B38400;  break;
+  case 57600:	speed = B57600;  break;
+  case 115200:	speed = B115200; break;
+  case 230400:	speed = B230400; break;
+  default: {
+    std::ostringstream errstr;
+    errstr << "unsupported serial port speed " << baud;
+    throw(BTException(BTException::BT_EINVAL, errstr.str()));
+  }
+  }
+
   // Make sure this port exists. Some port "suggestions" don't.
   if(stat(port.c_str(), &stats))
     throw(BTException(BTException::BT_ENOENT,
@@ -205,8 +222,8 @@ void serial_open(const std::string &port, serial_handle &handle)
 		      openerr + ' ' + port + " (3): " + strerror(errno)));
   }
 
-  cfsetispeed(&options, B57600);
-  cfsetospeed(&options, B57600);
+  cfsetispeed(&options, speed);
+  cfsetospeed(&options, speed);
 
   options.c_cflag |= (CLOCAL | CREAD);
 
@@ -46,7 +46,8 @@ std::deque<std::string> serial_suggest_ports()
 
 // Open a serial port identified by a string identifier
 // TODO: Add special case opening of a Windows pipe for local simulation.
-void serial_open(const std::string &port, serial_handle &handle)
+void serial_open(const std::string &port, serial_handle &handle,
+		 const unsigned int &baud)
 {
   // Well, here goes nothin'. Try to open the file.
   handle = CreateFile(port.c_str(), GENERIC_READ | GENERIC_WRITE,
@@ -102,7 +103,7 @@ void serial_open(const std::string &port, serial_handle &handle)
   if(!GetCommState(handle, &port_dcb))
     win_io_barf(std::string("error retrieving serial port ")+port+" state: ");
 
-  port_dcb.BaudRate = CBR_57600;
+  port_dcb.BaudRate = baud;
   port_dcb.ByteSize = 8;
   port_dcb.Parity   = NOPARITY;
   port_dcb.StopBits = ONESTOPBIT;
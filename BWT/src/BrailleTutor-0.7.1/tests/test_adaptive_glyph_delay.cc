@@ -0,0 +1,223 @@
+#include "Types.h"
+#include "Clock.h"
+#include "IOEvent.h"
+#include "TimerService.h"
+#include "AdaptiveGlyphDelay.h"
+
+#include <deque>
+#include <vector>
+#include <string>
+#include <iostream>
+
+using namespace BrailleTutorNS;
+
+// Checks and benchmark for the adaptive glyph completion delay. The
+// controller is first fed pauses directly, then a writer with a steady
+// rhythm is replayed through an inline IOEventParser on a VirtualClock, and
+// the time each letter comes out after the glyph's last dot is checked
+// against the delay the parser should have learned by then.
+//
+// Usage: test_adaptive_glyph_delay
+
+//! Results are stored here so the optimizer can't drop the benchmark loop
+volatile double sink;
+
+//! Report a failed check
+static unsigned int check(const bool &ok, const std::string &what)
+{
+  if(!ok) std::cerr << "FAILED: " << what << std::endl;
+  return ok ? 0 : 1;
+}
+
+//! True if two times are within a microsecond (learned delays come from
+//! doubles, so they may be a nanosecond off what's written here)
+static bool near_enough(const TimeInterval &a, const TimeInterval &b)
+{
+  const TimeInterval gap = (a < b) ? b - a : a - b;
+  return gap < TimeInterval(0.000001);
+}
+
+//! Feed a controller count pauses of the same length
+static void feed(AdaptiveGlyphDelay &agd, const unsigned int &count,
+		 const TimeInterval &pause)
+{
+  for(unsigned int i=0; i<count; ++i) agd.addPause(pause);
+}
+
+//! Notes, for each CELL_LETTER, when on the virtual clock it came out
+struct LetterTimer : public IOEventHandler {
+  const Clock &clock;
+  std::vector<TimeInterval> when;
+
+  LetterTimer(const Clock &my_clock) : clock(my_clock) { }
+
+  virtual void operator()(std::deque<IOEvent> &events)
+  {
+    std::deque<IOEvent>::const_iterator e_iter;
+    for(e_iter=events.begin(); e_iter!=events.end(); ++e_iter)
+      if(e_iter->type == IOEvent::CELL_LETTER) when.push_back(clock.now());
+    events.clear();
+  }
+};
+
+//! Write a three-dot glyph in cell starting at t, pausing pause between
+//! lifting the stylus and putting it in again; returns when the last dot
+//! was lifted
+static TimeInterval write_glyph(VirtualClock &clock, IOEventParser &iep,
+				const unsigned short int &cell, TimeInterval t,
+				const TimeInterval &pause)
+{
+  const TimeInterval hold(0.2);
+  for(unsigned char dot=0; dot<3; ++dot) {
+    if(dot > 0) t = t + pause;
+    clock.advanceTo(t);
+    std::deque<BaseIOEvent> down(1,
+      BaseIOEvent::makeStylusDownEvent(t, cell, dot));
+    iep(down);
+
+    t = t + hold;
+    clock.advanceTo(t);
+    std::deque<BaseIOEvent> up(1, BaseIOEvent::makeStylusUpEvent(t, cell, dot));
+    iep(up);
+  }
+  return t;
+}
+
+int fakemain(int argc, char **argv)
+{
+  unsigned int failures = 0;
+  const TimeInterval min_delay(0.25), max_delay(5.0);
+
+  // The controller on its own
+  {
+    AdaptiveGlyphDelay agd(min_delay, max_delay, 0.95, 1.5);
+    failures += check(agd.delay() == max_delay, "starts at the upper bound");
+    feed(agd, AdaptiveGlyphDelay::MIN_SAMPLES - 1, TimeInterval(0.3));
+    failures += check(agd.delay() == max_delay,
+		      "holds the upper bound until MIN_SAMPLES pauses");
+    feed(agd, 1, TimeInterval(0.3));
+    failures += check(near_enough(agd.delay(), TimeInterval(0.45)),
+		      "percentile times margin once MIN_SAMPLES are in");
+
+    // A full window: 60 short pauses and 4 long ones. The 95th percentile
+    // is the 61st of 64, one of the long ones.
+    agd.reset();
+    feed(agd, 60, TimeInterval(0.3));
+    feed(agd, 4, TimeInterval(1.0));
+    failures += check(near_enough(agd.delay(), TimeInterval(1.5)),
+		      "95th percentile of a full window");
+    // A window of short pauses pushes the long ones out
+    feed(agd, AdaptiveGlyphDelay::WINDOW, TimeInterval(0.3));
+    failures += check(near_enough(agd.delay(), TimeInterval(0.45)),
+		      "old pauses leave the window");
+
+    feed(agd, AdaptiveGlyphDelay::WINDOW, TimeInterval(0.01));
+    failures += check(agd.delay() == min_delay, "kept above the lower bound");
+    feed(agd, AdaptiveGlyphDelay::WINDOW, TimeInterval(10.0));
+    failures += check(agd.delay() == max_delay, "kept below the upper bound");
+    agd.reset();
+    failures += check(agd.delay() == max_delay, "reset() starts over");
+
+    unsigned int rejected = 0;
+    try { AdaptiveGlyphDelay bad(TimeInterval(), max_delay); }
+    catch(const BTException &e) { ++rejected; }
+    try { AdaptiveGlyphDelay bad(max_delay, min_delay); }
+    catch(const BTException &e) { ++rejected; }
+    try { AdaptiveGlyphDelay bad(min_delay, max_delay, 1.5); }
+    catch(const BTException &e) { ++rejected; }
+    try { AdaptiveGlyphDelay bad(min_delay, max_delay, 0.95, 0.5); }
+    catch(const BTException &e) { ++rejected; }
+    failures += check(rejected == 4, "bad settings rejected");
+  }
+
+  // An inline parser learning from a writer who pauses 0.3 s between dots.
+  // Each glyph has two such pauses, so MIN_SAMPLES pauses are in partway
+  // through the fourth glyph; it and every glyph after it should complete
+  // 0.45 s after its last dot, the ones before it after max_delay.
+  {
+    VirtualClock clock(TimeInterval(100.0));
+    TimerService timers(clock);
+    IOEventParser iep(timers);
+    LetterTimer letters(clock);
+    iep.setIOEventHandler(letters);
+    iep.wantEvent(IOEvent::CELL_LETTER);
+    iep.setAdaptiveGlyphDelay(min_delay, max_delay, 0.95);
+    failures += check(iep.getGlyphDelay() == max_delay,
+		      "parser starts at the upper bound");
+
+    const unsigned int num_glyphs = 10;
+    const unsigned int learned_at = (AdaptiveGlyphDelay::MIN_SAMPLES + 1) / 2;
+    std::vector<TimeInterval> lifted;
+    TimeInterval t(101.0);
+    for(unsigned int g=0; g<num_glyphs; ++g) {
+      lifted.push_back(write_glyph(clock, iep, g % 16, t, TimeInterval(0.3)));
+      // Think long enough for any delay to run out
+      t = lifted.back() + TimeInterval(10.0);
+      clock.advanceTo(t);
+    }
+
+    bool on_time = (letters.when.size() == num_glyphs);
+    for(unsigned int g=0; on_time && (g<num_glyphs); ++g) {
+      const TimeInterval expected = (g + 1 < learned_at) ? max_delay :
+				    TimeInterval(0.45);
+      on_time = near_enough(letters.when[g] - lifted[g], expected);
+      if(!on_time)
+	std::cerr << "glyph " << g << " completed after "
+		  << (double) (letters.when[g] - lifted[g]) << " s, not "
+		  << (double) expected << " s" << std::endl;
+    }
+    failures += check(on_time, "letters complete after the learned delay");
+    failures += check(near_enough(iep.getGlyphDelay(), TimeInterval(0.45)),
+		      "parser reports the learned delay");
+
+    // Slowing down to pauses that still fit in the delay raises it again
+    for(unsigned int g=0; g<AdaptiveGlyphDelay::WINDOW / 2; ++g) {
+      const TimeInterval last =
+	write_glyph(clock, iep, g % 16, t, TimeInterval(0.4));
+      t = last + TimeInterval(10.0);
+      clock.advanceTo(t);
+    }
+    failures += check(near_enough(iep.getGlyphDelay(), TimeInterval(0.6)),
+		      "delay grows when the writer slows down");
+
+    // A fixed delay turns learning off
+    iep.setGlyphDelay(TimeInterval(2.0));
+    write_glyph(clock, iep, 0, t, TimeInterval(0.1));
+    failures += check(iep.getGlyphDelay() == TimeInterval(2.0),
+		      "setGlyphDelay() stops the adapting");
+  }
+
+  if(failures > 0) {
+    std::cerr << failures << " check(s) FAILED" << std::endl;
+    return 1;
+  }
+  std::cout << "checks: OK" << std::endl;
+
+  // Benchmark: the controller's work for each dot written
+  AdaptiveGlyphDelay agd(min_delay, max_delay);
+  const unsigned long pauses = 1000000;
+  const TimeInterval start = TimeInterval::now();
+  for(unsigned long p=0; p<pauses; ++p)
+    agd.addPause(TimeInterval(0, 100 + (p * 7919) % 600));
+  const double secs = (double) (TimeInterval::now() - start);
+  sink = (double) agd.delay();
+
+  std::cout << "addPause(): " << secs / pauses * 1e9 << " ns" << std::endl;
+
+  return 0;
+}
+
+int main(int argc, char **argv)
+{
+  try { return fakemain(argc, argv); }
+  catch(const BTException &e) {
+    std::cerr << "BTException: " << e.why << std::endl;
+    return -1;
+  }
+  catch(...) {
+    std::cerr << "Some other exception happened" << std::endl;
+    return -1;
+  }
+
+  return 0;
+}
@@ -6,6 +6,7 @@
 #include <vector>
 #include <string>
 #include <fstream>
+#include <sstream>
 #include <iostream>
 
 using namespace BrailleTutorNS;
@@ -37,18 +38,18 @@ int fakemain(int argc, char **argv)
     widestr[0] = 0x939; // char 2
     test_charset.set(DOT_2 | DOT_3, widestr);
 
-    if((test_charset[DOT_1|DOT_2].str[0] == 0xe0) &&
-       (test_charset[DOT_1|DOT_2].str[1] == 0xa4) &&
-       (test_charset[DOT_1|DOT_2].str[2] == 0xa7) &&
-       (test_charset[DOT_1|DOT_2].str[3] == '\0') &&
-       (test_charset[DOT_1|DOT_3].str[0] == 0xe0) &&
-       (test_charset[DOT_1|DOT_3].str[1] == 0xa4) &&
-       (test_charset[DOT_1|DOT_3].str[2] == 0x8b) &&
-       (test_charset[DOT_1|DOT_3].str[3] == '\0') &&
-       (test_charset[DOT_2|DOT_3].str[0] == 0xe0) &&
-       (test_charset[DOT_2|DOT_3].str[1] == 0xa4) &&
-       (test_charset[DOT_2|DOT_3].str[2] == 0xb9) &&
-       (test_charset[DOT_2|DOT_3].str[3] == '\0'))
+    if((test_charset[DOT_1|DOT_2].str()[0] == 0xe0) &&
+       (test_charset[DOT_1|DOT_2].str()[1] == 0xa4) &&
+       (test_charset[DOT_1|DOT_2].str()[2] == 0xa7) &&
+       (test_charset[DOT_1|DOT_2].str()[3] == '\0') &&
+       (test_charset[DOT_1|DOT_3].str()[0] == 0xe0) &&
+       (test_charset[DOT_1|DOT_3].str()[1] == 0xa4) &&
+       (test_charset[DOT_1|DOT_3].str()[2] == 0x8b) &&
+       (test_charset[DOT_1|DOT_3].str()[3] == '\0') &&
+       (test_charset[DOT_2|DOT_3].str()[0] == 0xe0) &&
+       (test_charset[DOT_2|DOT_3].str()[1] == 0xa4) &&
+       (test_charset[DOT_2|DOT_3].str()[2] == 0xb9) &&
+       (test_charset[DOT_2|DOT_3].str()[3] == '\0'))
       std::cerr << "Charset 1 UTF-32->UTF-8 conversion correct." << std::endl;
 
     test_charset.write("test_charset_1.charset");
@@ -77,12 +78,12 @@ int fakemain(int argc, char **argv)
     str[1] = 0x8a;
     test_charset.set(DOT_2 | DOT_3, str);
 
-    if((test_charset[DOT_1|DOT_2].str_w[0] == 0x62a) &&
-       (test_charset[DOT_1|DOT_2].str_w[1] == 0) &&
-       (test_charset[DOT_1|DOT_3].str_w[0] == 0x634) &&
-       (test_charset[DOT_1|DOT_3].str_w[1] == 0) &&
-       (test_charset[DOT_2|DOT_3].str_w[0] == 0x64a) &&
-       (test_charset[DOT_2|DOT_3].str_w[1] == 0))
+    if((test_charset[DOT_1|DOT_2].str_w()[0] == 0x62a) &&
+       (test_charset[DOT_1|DOT_2].str_w()[1] == 0) &&
+       (test_charset[DOT_1|DOT_3].str_w()[0] == 0x634) &&
+       (test_charset[DOT_1|DOT_3].str_w()[1] == 0) &&
+       (test_charset[DOT_2|DOT_3].str_w()[0] == 0x64a) &&
+       (test_charset[DOT_2|DOT_3].str_w()[1] == 0))
       std::cerr << "Charset 2 UTF-8->UTF-32 conversion correct." << std::endl;
 
     test_charset.write("test_charset_2.charset");
@@ -127,16 +128,27 @@ int fakemain(int argc, char **argv)
 
     // Clone the test character set using the UTF-32 info only
     Charset test_charset_2("");
-    test_charset_2.setName(test_charset.getName().str_w.get());
+    test_charset_2.setName(test_charset.getName().str_w());
     for(unsigned int i=0; i<256; ++i) {
       if(test_charset[i].isEmpty()) continue;
-      test_charset_2.set((uint8_t) i, test_charset[i].str_w.get());
+      test_charset_2.set((uint8_t) i, test_charset[i].str_w());
     }
 
     // Write out the torture file from the copied data
     test_charset_2.write("test_charset_4.charset");
     std::cerr << "Charset 4 written (the torture one again)." << std::endl;
     std::cerr << "Should be identical to Charset 3 (check it!)." << std::endl;
+
+    // A dot pattern mapped twice
+    std::istringstream remapping("!UTF-8 BEGIN Remapping\n"
+				 "1 a\n12 b\n1 c\n!UTF-8 END\n");
+    Charset test_charset_5("");
+    std::vector<unsigned int> remapped_lines;
+    test_charset_5.read(remapping, remapped_lines);
+    std::cerr << "Loaded remapping charset. Remapped lines";
+    for(unsigned int i=0; i<remapped_lines.size(); ++i)
+      std::cerr << ' ' << remapped_lines[i];
+    std::cerr << " (should be 4)." << std::endl;
   }
 
   return 0;
@@ -0,0 +1,282 @@
+#include "Dots.h"
+#include "Types.h"
+#include "Charset.h"
+
+#include <vector>
+#include <algorithm>
+#include <string>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <stdint.h>
+
+#include <utime.h>
+
+using namespace BrailleTutorNS;
+
+// Checks and load benchmark for compiled charset images. Charsets are
+// written with writeCompiled() and read back, and must come back the same;
+// damaged images (cut short, from another version, with a broken letter
+// index) must be turned away, leaving the charset as it was; a damaged
+// settled table must make no difference, as it's rebuilt. Then load() must
+// take the image only while it's at least as new as the text file, and
+// fall back on the text when the image is bad. The benchmark times loading
+// a charset from text and from its image.
+//
+// Usage: test_charset_image [scratch prefix]
+// Scratch files are named by adding suffixes to the prefix
+// (test_charset_image by default), and removed afterward.
+
+//! Results are stored here so the optimizer can't drop the benchmark loops
+volatile unsigned long sink;
+
+//! Report a failed check
+static unsigned int check(const bool &ok, const std::string &what)
+{
+  if(!ok) std::cerr << "FAILED: " << what << std::endl;
+  return ok ? 0 : 1;
+}
+
+//! A two-character glyph for a number, as in devanagari conjuncts
+static GlyphMapping syntheticGlyph(const unsigned int &n)
+{
+  uint32_t str_w[3];
+  str_w[0] = 0x915 + n % 40;
+  str_w[1] = 0x93e + n / 40;
+  str_w[2] = 0;
+  return GlyphMapping(str_w);
+}
+
+//! True if two charsets map, look up, settle and find nearest alike
+static bool same(const Charset &a, const Charset &b)
+{
+  if((a.size() != b.size()) || !a.getName().equals(b.getName())) return false;
+  for(unsigned int p=0; p<256; ++p) {
+    if(!a[p].equals(b[p]) || (a.isSettled(p) != b.isSettled(p))) return false;
+    if(!a[p].isEmpty() && (a[a[p]] != b[b[p]])) return false;
+
+    const Charset::Nearest &na = a.nearest(p), &nb = b.nearest(p);
+    if((na.count != nb.count) || (na.distance != nb.distance) ||
+       (na.mirrored != nb.mirrored) ||
+       (std::memcmp(na.dots, nb.dots, na.count) != 0)) return false;
+  }
+  return true;
+}
+
+//! A file's bytes
+static std::vector<char> slurp(const std::string &filename)
+{
+  std::ifstream in(filename.c_str(), std::ios::in | std::ios::binary);
+  return std::vector<char>(std::istreambuf_iterator<char>(in),
+			   std::istreambuf_iterator<char>());
+}
+
+//! Write bytes to a file
+static void spew(const std::string &filename, const std::vector<char> &bytes)
+{
+  std::ofstream out(filename.c_str(), std::ios::out | std::ios::binary);
+  if(!bytes.empty()) out.write(&bytes[0], bytes.size());
+}
+
+//! Set a 32-bit header field of a compiled image
+static void poke32(std::vector<char> &bytes, const size_t &offset,
+		   const uint32_t &value)
+{ std::memcpy(&bytes[offset], &value, sizeof(value)); }
+
+//! Get a 32-bit header field of a compiled image
+static uint32_t peek32(const std::vector<char> &bytes, const size_t &offset)
+{ uint32_t value; std::memcpy(&value, &bytes[offset], sizeof(value));
+  return value; }
+
+//! Header field offsets: magic, byte order, version, index slots, letters,
+//! name, pool size (see lib/CharsetImage.cc)
+static const size_t VERSION_AT = 12, LETTERS_AT = 20, POOL_SIZE_AT = 28;
+static const size_t HEADER_SIZE = 32;
+
+//! True if readCompiled() turns bytes away with a BT_EINVAL BTException,
+//! leaving charset as it was
+static bool rejected(const std::string &filename,
+		     const std::vector<char> &bytes, Charset &charset)
+{
+  spew(filename, bytes);
+  const Charset before = charset;
+  try { charset.readCompiled(filename); }
+  catch(const BTException &e) {
+    return (e.type == BTException::BT_EINVAL) && same(before, charset);
+  }
+  return false;
+}
+
+//! Set a file's modification time
+static void touch(const std::string &filename, const time_t &when)
+{
+  struct utimbuf times;
+  times.actime = times.modtime = when;
+  utime(filename.c_str(), &times);
+}
+
+int fakemain(int argc, char **argv)
+{
+  unsigned int failures = 0;
+  const std::string prefix = (argc > 1) ? argv[1] : "test_charset_image";
+  const std::string image = prefix + ".btc";
+  const std::string damaged = prefix + ".bad.btc";
+  const std::string text = prefix + ".txt";
+  const std::string text_image = Charset::compiledFilename(text);
+
+  // Round trips: the default charset, and one with long glyphs and holes
+  const Charset &def = Charset::defaultCharset();
+  def.writeCompiled(image);
+  failures += check(same(def, Charset::fromCompiledFile(image)),
+		    "default charset round trip");
+
+  Charset synthetic("synthetic");
+  for(unsigned int n=0; n<200; n+=3) synthetic.set(n, syntheticGlyph(n));
+  synthetic.set(0x3f, GlyphMapping(std::string(40, 'x')));
+  synthetic.writeCompiled(image);
+  failures += check(same(synthetic, Charset::fromCompiledFile(image)),
+		    "synthetic charset round trip");
+
+  Charset empty("");
+  empty.writeCompiled(damaged);
+  failures += check(same(empty, Charset::fromCompiledFile(damaged)),
+		    "empty charset round trip");
+
+  // Damaged images
+  const std::vector<char> good = slurp(image);
+  const uint32_t pool_size = peek32(good, POOL_SIZE_AT);
+  const size_t index_at = HEADER_SIZE + 256*sizeof(uint32_t);
+  const size_t settled_at = good.size() - pool_size - 256 - 256;
+  Charset target = def;
+
+  failures += check(rejected(damaged, std::vector<char>(), target),
+		    "empty file rejected");
+  failures += check(rejected(damaged, std::vector<char>(good.begin(),
+							good.begin() + 40),
+			     target), "truncated header rejected");
+  failures += check(rejected(damaged, std::vector<char>(good.begin(),
+							good.end() - 1),
+			     target), "truncated string pool rejected");
+  std::vector<char> longer(good);
+  longer.push_back('\0');
+  failures += check(rejected(damaged, longer, target),
+		    "trailing bytes rejected");
+
+  std::vector<char> bad(good);
+  bad[0] = 'X';
+  failures += check(rejected(damaged, bad, target), "bad magic rejected");
+  bad = good;
+  poke32(bad, VERSION_AT, peek32(good, VERSION_AT) + 1);
+  failures += check(rejected(damaged, bad, target), "wrong version rejected");
+  bad = good;
+  poke32(bad, LETTERS_AT, peek32(good, LETTERS_AT) + 1);
+  failures += check(rejected(damaged, bad, target),
+		    "wrong letter count rejected");
+  bad = good;
+  std::fill(bad.begin() + index_at, bad.begin() + settled_at, 0);
+  failures += check(rejected(damaged, bad, target), "empty index rejected");
+
+  // An index whose slots are all there, but not where probes find them
+  bad = good;
+  const size_t slot_size = (settled_at - index_at) / 512; // INDEX_SLOTS
+  std::rotate(bad.begin() + index_at, bad.begin() + index_at + slot_size,
+	      bad.begin() + settled_at);
+  failures += check(rejected(damaged, bad, target),
+		    "misplaced index slots rejected");
+
+  // A glyph offset past the end of the string pool
+  bad = good;
+  poke32(bad, HEADER_SIZE, pool_size + 10);
+  failures += check(rejected(damaged, bad, target), "bad glyph rejected");
+
+  // The settled table is rebuilt from the mapping, not trusted
+  bad = good;
+  std::fill(bad.begin() + settled_at, bad.begin() + settled_at + 256, 1);
+  spew(damaged, bad);
+  failures += check(same(synthetic, Charset::fromCompiledFile(damaged)),
+		    "settled table rebuilt on loading");
+
+  // load(): the image while it's up to date, the text otherwise
+  Charset from_text("from text");
+  from_text.set(1, GlyphMapping(std::string("a")));
+  from_text.write(text);
+  Charset from_image("from image");
+  from_image.set(1, GlyphMapping(std::string("b")));
+  from_image.writeCompiled(text_image);
+
+  touch(text, 1000000000);
+  touch(text_image, 1000000100);
+  failures += check(same(from_image, Charset::load(text)),
+		    "load() takes a newer image");
+  touch(text_image, 1000000000);
+  failures += check(same(from_image, Charset::load(text)),
+		    "load() takes an image as new as the text");
+  touch(text, 1000000200);
+  failures += check(same(from_text, Charset::load(text)),
+		    "load() skips a stale image");
+
+  spew(text_image, std::vector<char>(good.begin(), good.begin() + 100));
+  touch(text_image, 1000000300);
+  failures += check(same(from_text, Charset::load(text)),
+		    "load() falls back on the text for a bad image");
+
+  from_image.writeCompiled(text_image);
+  std::remove(text.c_str());
+  failures += check(same(from_image, Charset::load(text)),
+		    "load() takes the image when there's no text");
+  from_text.write(text);
+  std::remove(text_image.c_str());
+  failures += check(same(from_text, Charset::load(text)),
+		    "load() reads the text when there's no image");
+
+  if(failures > 0) {
+    std::cerr << failures << " check(s) FAILED" << std::endl;
+    std::remove(image.c_str());
+    std::remove(damaged.c_str());
+    std::remove(text.c_str());
+    return 1;
+  }
+  std::cout << "checks: OK" << std::endl;
+
+  // Benchmark: loading the synthetic charset from text and from its image
+  synthetic.write(text);
+  synthetic.writeCompiled(image);
+  const unsigned int loads = 2000;
+  unsigned long total = 0;
+  TimeInterval start = TimeInterval::now();
+  for(unsigned int l=0; l<loads; ++l)
+    total += Charset::fromFile(text).size();
+  const double text_secs = (double) (TimeInterval::now() - start);
+
+  start = TimeInterval::now();
+  for(unsigned int l=0; l<loads; ++l)
+    total += Charset::fromCompiledFile(image).size();
+  const double image_secs = (double) (TimeInterval::now() - start);
+  sink = total;
+
+  std::cout << "load (" << synthetic.size() << " letters): text "
+	    << text_secs / loads * 1e6 << " us, image "
+	    << image_secs / loads * 1e6 << " us" << std::endl;
+
+  std::remove(image.c_str());
+  std::remove(damaged.c_str());
+  std::remove(text.c_str());
+  return 0;
+}
+
+int main(int argc, char **argv)
+{
+  try { return fakemain(argc, argv); }
+  catch(const BTException &e) {
+    std::cerr << "BTException: " << e.why << std::endl;
+    return -1;
+  }
+  catch(...) {
+    std::cerr << "Some other exception happened" << std::endl;
+    return -1;
+  }
+
+  return 0;
+}
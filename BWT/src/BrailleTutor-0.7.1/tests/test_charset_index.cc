@@ -0,0 +1,197 @@
+#include "Dots.h"
+#include "Types.h"
+#include "Charset.h"
+
+#include <map>
+#include <vector>
+#include <string>
+#include <cstdlib>
+#include <iostream>
+
+using namespace BrailleTutorNS;
+
+// Checks and lookup benchmark for the Charset letter index, which replaced
+// a std::map<GlyphMapping, unsigned char> ordered by GlyphMapping::lt. A
+// random sequence of set() calls is applied to a Charset, and after every
+// few, each letter's lookup must name a dot pattern that maps to the letter
+// (INVALID_DOTS if none does). The benchmark then times letter-to-dots
+// lookups, mirrored as the apps make them, hits and misses, by the map and
+// by the index.
+//
+// Usage: test_charset_index [mapping file ...]
+// Without arguments, the benchmark uses the default character set and a
+// synthetic set of 200 multibyte glyphs.
+
+//! Results are stored here so the optimizer can't drop the benchmark loops
+volatile unsigned long sink;
+
+//! Report a failed check
+static unsigned int check(const bool &ok, const std::string &what)
+{
+  if(!ok) std::cerr << "FAILED: " << what << std::endl;
+  return ok ? 0 : 1;
+}
+
+//! A two-character glyph for a number, as in devanagari conjuncts
+GlyphMapping syntheticGlyph(const unsigned int &n)
+{
+  uint32_t str_w[3];
+  str_w[0] = 0x915 + n % 40;
+  str_w[1] = 0x93e + n / 40;
+  str_w[2] = 0;
+  return GlyphMapping(str_w);
+}
+
+//! Check a Charset's letter lookups against its dot pattern lookups
+unsigned int consistent(const Charset &charset,
+			const std::vector<GlyphMapping> &letters)
+{
+  unsigned int mapped = 0;
+  for(unsigned int i=0; i<letters.size(); ++i) {
+    bool present = false;
+    for(unsigned int d=0; d<256; ++d)
+      if(charset[d].equals(letters[i])) present = true;
+    if(present) ++mapped;
+
+    const unsigned char dots = charset[letters[i]];
+    if(!present && (dots != INVALID_DOTS)) return 1;
+    if(present && ((dots == INVALID_DOTS) || !charset[dots].equals(letters[i])))
+      return 1;
+    if(charset.mir()[letters[i]] != DotsMirror::mir(dots)) return 1;
+  }
+  return (mapped == charset.size()) ? 0 : 1;
+}
+
+//! Seconds per lookup of each of probes, by the map and by the Charset
+void benchmark(const std::string &name, const Charset &charset,
+	       const std::vector<GlyphMapping> &probes,
+	       const unsigned long &rounds)
+{
+  std::map<GlyphMapping, unsigned char> map;
+  for(unsigned int d=0; d<256; ++d)
+    if(!charset[d].isEmpty()) map[charset[d]] = d;
+
+  unsigned long total = 0;
+  TimeInterval start = TimeInterval::now();
+  for(unsigned long r=0; r<rounds; ++r)
+    for(unsigned int i=0; i<probes.size(); ++i) {
+      std::map<GlyphMapping, unsigned char>::const_iterator m;
+      m = map.find(probes[i]);
+      total += (m == map.end()) ? INVALID_DOTS : DotsMirror::mir(m->second);
+    }
+  const double map_secs = (double) (TimeInterval::now() - start);
+
+  start = TimeInterval::now();
+  for(unsigned long r=0; r<rounds; ++r)
+    for(unsigned int i=0; i<probes.size(); ++i)
+      total += charset.mir()[probes[i]];
+  const double index_secs = (double) (TimeInterval::now() - start);
+
+  sink = total;
+  const double lookups = (double) rounds * probes.size();
+  std::cout << name << " (" << charset.size() << " letters): map "
+	    << map_secs / lookups * 1e9 << " ns/lookup, index "
+	    << index_secs / lookups * 1e9 << " ns/lookup" << std::endl;
+}
+
+//! Every letter in a charset, plus as many that aren't in it
+std::vector<GlyphMapping> probesFor(const Charset &charset)
+{
+  std::vector<GlyphMapping> probes;
+  for(unsigned int d=0; d<256; ++d)
+    if(!charset[d].isEmpty()) {
+      probes.push_back(charset[d]);
+      probes.push_back(GlyphMapping(std::string((char*) charset[d].str()) +
+				    "?"));
+    }
+  return probes;
+}
+
+int fakemain(int argc, char **argv)
+{
+  unsigned int failures = 0;
+
+  // A pool of letters, some long enough not to be stored inline
+  std::vector<GlyphMapping> letters;
+  for(unsigned int n=0; n<300; ++n) letters.push_back(syntheticGlyph(n));
+  for(unsigned int n=0; n<20; ++n)
+    letters.push_back(GlyphMapping(std::string(20 + n, 'a' + n)));
+
+  // Random churn: maps, remaps and erasures, by dots and by letter
+  srand(1);
+  Charset charset("churn");
+  bool churn_ok = true;
+  for(unsigned int step=0; (step<20000) && churn_ok; ++step) {
+    const unsigned char dots = rand() % 255;
+    const GlyphMapping &letter = letters[rand() % letters.size()];
+    switch(rand() % 4) {
+    case 0:  charset.set(INVALID_DOTS, letter); break;
+    case 1:  charset.set(dots, GlyphMapping()); break;
+    default: charset.set(dots, letter); break;
+    }
+    if(step % 50 == 0) churn_ok = consistent(charset, letters) == 0;
+  }
+  failures += check(churn_ok && (consistent(charset, letters) == 0),
+		    "lookups stay consistent through random churn");
+
+  // Copies keep working, and clearing empties the index
+  const Charset copy = charset;
+  failures += check(consistent(copy, letters) == 0, "copies");
+  charset.clear();
+  failures += check((charset.size() == 0) &&
+		    (charset[letters[0]] == INVALID_DOTS), "clear");
+
+  // The mirror table matches the bit twiddling it replaced
+  bool mirrors_ok = true;
+  for(unsigned int d=0; d<256; ++d)
+    if(DotsMirror::mir(d) != (((d & 0x07) << 3) | ((d & 0x38) >> 3) |
+			      ((d & 0x80) >> 1) | ((d & 0x40) << 1)))
+      mirrors_ok = false;
+  failures += check(mirrors_ok, "mirror table");
+
+  // The default charset looks its own letters up
+  const Charset &def = Charset::defaultCharset();
+  bool default_ok = true;
+  for(unsigned int d=0; d<256; ++d)
+    if(!def[d].isEmpty() && (def[def[d]] != d)) default_ok = false;
+  failures += check(default_ok, "default charset round trip");
+
+  if(failures > 0) {
+    std::cerr << failures << " check(s) FAILED" << std::endl;
+    return 1;
+  }
+  std::cout << "checks: OK" << std::endl;
+
+  // Benchmark
+  const unsigned long rounds = 20000;
+  if(argc > 1) {
+    for(int i=1; i<argc; ++i) {
+      Charset loaded("");
+      loaded.read(argv[i]);
+      benchmark(argv[i], loaded, probesFor(loaded), rounds);
+    }
+  }
+  else {
+    benchmark("default charset", def, probesFor(def), rounds);
+    Charset synthetic("synthetic");
+    for(unsigned int n=0; n<200; ++n) synthetic.set(n, syntheticGlyph(n));
+    benchmark("synthetic charset", synthetic, probesFor(synthetic), rounds);
+  }
+
+  return 0;
+}
+
+int main(int argc, char **argv)
+{
+  try { return fakemain(argc, argv); }
+  catch(const BTException &e) {
+    std::cerr << "BTException: " << e.why << std::endl;
+    return -1;
+  }
+  catch(...) {
+    std::cerr << "Some other exception happened" << std::endl;
+    return -1;
+  }
+
+  return 0;
+}
@@ -0,0 +1,175 @@
+#include "Dots.h"
+#include "Types.h"
+#include "Charset.h"
+
+#include <string>
+#include <cstdio>
+#include <vector>
+#include <iostream>
+
+using namespace BrailleTutorNS;
+
+// Checks and benchmark for Charset::nearest(). The table is checked against
+// a brute-force search for every dot pattern, and on a small charset by
+// hand; then rebuilding it after set() and looking patterns up are timed.
+//
+// Usage: test_charset_nearest [mapping file]
+// Without an argument, the default character set is used.
+
+//! Results are stored here so the optimizer can't drop the benchmark loops
+volatile unsigned long sink;
+
+//! Report a failed check
+static unsigned int check(const bool &ok, const std::string &what)
+{
+  if(!ok) std::cerr << "FAILED: " << what << std::endl;
+  return ok ? 0 : 1;
+}
+
+//! Check charset's nearest() for every pattern against a search of all
+//! mapped patterns
+unsigned int brute_force(const Charset &charset)
+{
+  for(unsigned int w=0; w<256; ++w) {
+    // Least distance, straight or mirrored, to each other mapped pattern
+    unsigned int best = ~0u;
+    std::vector<unsigned int> distance(256, ~0u);
+    for(unsigned int p=0; p<256; ++p) {
+      if((p == w) || charset[p].isEmpty()) continue;
+      const unsigned int straight = Charset::dotDistance(w, p);
+      const unsigned int flipped =
+	Charset::MIRROR_COST + Charset::dotDistance(DotsMirror::mir(w), p);
+      distance[p] = (flipped < straight) ? flipped : straight;
+      if(distance[p] < best) best = distance[p];
+    }
+
+    std::vector<unsigned char> expected;
+    for(unsigned int p=0; p<256; ++p)
+      if((distance[p] == best) && (expected.size() < Charset::MAX_NEAREST))
+	expected.push_back(p);
+
+    const Charset::Nearest &closest = charset.nearest(w);
+    if(closest.count != expected.size()) return 1;
+    if(closest.count && (closest.distance != best)) return 1;
+    for(unsigned int i=0; i<closest.count; ++i) {
+      if(closest.dots[i] != expected[i]) return 1;
+      if(Charset::dotDistance(0, closest.differences(w, i)) +
+	 ((closest.mirrored & (1 << i)) ? Charset::MIRROR_COST : 0) != best)
+	return 1;
+    }
+  }
+  return 0;
+}
+
+//! True if two charsets have the same nearest() table
+bool same_nearest(const Charset &a, const Charset &b)
+{
+  for(unsigned int w=0; w<256; ++w) {
+    const Charset::Nearest &x = a.nearest(w), &y = b.nearest(w);
+    if((x.count != y.count) || (x.distance != y.distance) ||
+       (x.mirrored != y.mirrored)) return false;
+    for(unsigned int i=0; i<x.count; ++i)
+      if(x.dots[i] != y.dots[i]) return false;
+  }
+  return true;
+}
+
+int fakemain(int argc, char **argv)
+{
+  unsigned int failures = 0;
+
+  const Charset charset = (argc > 1) ? Charset::fromFile(argv[1]) :
+				       Charset::defaultCharset();
+  failures += check(brute_force(charset) == 0, "nearest() table");
+
+  // Dots 1-6 cost more than dots 7 and 8
+  failures += check((Charset::dotDistance(0x00, 0x01) == 2) &&
+		    (Charset::dotDistance(0x00, 0x40) == 1) &&
+		    (Charset::dotDistance(0xff, 0x00) == 14) &&
+		    (Charset::dotDistance(0x2d, 0x2d) == 0), "dotDistance()");
+
+  // A small set worked out by hand: A=1, B=12, C=14, L=123
+  Charset small("small");
+  failures += check(small.nearest(0x01).count == 0, "empty set");
+  small.set(0x01, GlyphMapping("A"));
+  small.set(0x03, GlyphMapping("B"));
+  small.set(0x09, GlyphMapping("C"));
+  small.set(0x07, GlyphMapping("L"));
+  failures += check(brute_force(small) == 0, "small set table");
+
+  // A's neighbours, leaving A itself out
+  const Charset::Nearest &closest_a = small.nearest(0x01);
+  failures += check((closest_a.count == 2) && (closest_a.distance == 2) &&
+		    (closest_a.dots[0] == 0x03) && (closest_a.dots[1] == 0x09) &&
+		    (closest_a.mirrored == 0), "neighbours of a letter");
+
+  // Dot 4 alone is A mirrored, or C missing dot 1
+  const Charset::Nearest &closest_4 = small.nearest(0x08);
+  failures += check((closest_4.count == 2) && (closest_4.distance == 2) &&
+		    (closest_4.dots[0] == 0x01) && (closest_4.dots[1] == 0x09) &&
+		    (closest_4.mirrored == 1) &&
+		    (closest_4.differences(0x08, 0) == 0) &&
+		    (closest_4.differences(0x08, 1) == 0x01), "mirror image");
+
+  // Taking a letter out updates the table
+  small.set(0x09, GlyphMapping());
+  failures += check((small.nearest(0x08).count == 1) &&
+		    (small.nearest(0x08).dots[0] == 0x01) &&
+		    (brute_force(small) == 0), "set() updates the table");
+
+  // Compiled images get the table too
+  const std::string compiled = "test_charset_nearest.btc";
+  charset.writeCompiled(compiled);
+  const Charset loaded = Charset::fromCompiledFile(compiled);
+  std::remove(compiled.c_str());
+  failures += check(same_nearest(charset, loaded), "compiled image");
+
+  if(failures > 0) {
+    std::cerr << failures << " check(s) FAILED" << std::endl;
+    return 1;
+  }
+  std::cout << "checks: OK" << std::endl;
+
+  // Benchmark: building the table, and looking every pattern up
+  const unsigned long builds = 2000, rounds = 100000;
+  Charset scratch = charset;
+  const unsigned char some_dots = charset[GlyphMapping("A")] != INVALID_DOTS ?
+				  charset[GlyphMapping("A")] : 0x01;
+  const GlyphMapping some_letter = charset[some_dots];
+  unsigned long total = 0;
+
+  TimeInterval start = TimeInterval::now();
+  for(unsigned long b=0; b<builds; ++b) {
+    scratch.set(some_dots, (b & 1) ? some_letter : GlyphMapping());
+    total += scratch.nearest(some_dots).count;
+  }
+  const double build_secs = (double) (TimeInterval::now() - start);
+
+  start = TimeInterval::now();
+  for(unsigned long r=0; r<rounds; ++r)
+    for(unsigned int w=0; w<256; ++w)
+      total += charset.nearest(w ^ (r & 0xff)).dots[0];
+  const double lookup_secs = (double) (TimeInterval::now() - start);
+
+  sink = total;
+  std::cout << charset.size() << " letters: set() with table rebuild "
+	    << build_secs / builds * 1e6 << " us, nearest() "
+	    << lookup_secs / (rounds * 256.0) * 1e9 << " ns" << std::endl;
+
+  return 0;
+}
+
+int main(int argc, char **argv)
+{
+  try { return fakemain(argc, argv); }
+  catch(const BTException &e) {
+    std::cerr << "BTException: " << e.why << std::endl;
+    return -1;
+  }
+  catch(...) {
+    std::cerr << "Some other exception happened" << std::endl;
+    return -1;
+  }
+
+  return 0;
+}
@@ -0,0 +1,174 @@
+#include "Dots.h"
+#include "Types.h"
+#include "Charset.h"
+
+#include <string>
+#include <vector>
+#include <iostream>
+
+using namespace BrailleTutorNS;
+
+// Checks and benchmark for Charset::transcode() and Charset::dotsFor().
+// Every character of some text must transcode to what looking the
+// character up as a GlyphMapping gives, and word lists must pack the same
+// way; then transcoding is timed against the letter-at-a-time lookups the
+// apps used to make.
+//
+// Usage: test_charset_transcode [mapping file [word ...]]
+// Without arguments, the default character set and some English words are
+// used.
+
+//! Results are stored here so the optimizer can't drop the benchmark loops
+volatile unsigned long sink;
+
+//! Report a failed check
+static unsigned int check(const bool &ok, const std::string &what)
+{
+  if(!ok) std::cerr << "FAILED: " << what << std::endl;
+  return ok ? 0 : 1;
+}
+
+//! Split UTF-8 text into characters, as the apps do
+std::vector<std::string> characters(const std::string &text)
+{
+  std::vector<std::string> chars;
+  for(size_t i=0; i<text.size();) {
+    const unsigned char lead = text[i];
+    size_t bytes = (lead < 0xc0) ? 1 : (lead < 0xe0) ? 2 :
+		   (lead < 0xf0) ? 3 : (lead < 0xf8) ? 4 : 1;
+    if(bytes > text.size() - i) bytes = text.size() - i;
+    chars.push_back(text.substr(i, bytes));
+    i += bytes;
+  }
+  return chars;
+}
+
+//! Check transcode() and dotsFor() against GlyphMapping lookups for text
+unsigned int consistent(const Charset &charset, const std::string &text)
+{
+  const std::vector<std::string> chars = characters(text);
+  std::vector<unsigned char> dots(chars.size() + 1, 0x55);
+  if(charset.transcode(text, &dots[0], chars.size()) != chars.size())
+    return 1;
+  if(dots[chars.size()] != 0x55) return 1; // wrote past max_dots
+  for(unsigned int i=0; i<chars.size(); ++i) {
+    const unsigned char expected = charset[GlyphMapping(chars[i])];
+    if((dots[i] != expected) || (charset.dotsFor(chars[i]) != expected))
+      return 1;
+  }
+  return 0;
+}
+
+int fakemain(int argc, char **argv)
+{
+  unsigned int failures = 0;
+
+  Charset charset = Charset::defaultCharset();
+  std::vector<std::string> words;
+  if(argc > 1) {
+    charset = Charset::fromFile(argv[1]);
+    for(int i=2; i<argc; ++i) words.push_back(argv[i]);
+  }
+  if(words.empty()) {
+    // Letters the charset has, then some words made from them
+    std::string letters;
+    for(unsigned int d=0; d<256; ++d)
+      if(!charset[d].isEmpty()) letters += std::string(charset[d]);
+    words.push_back(letters);
+    const char *english[] = { "CAT", "DOG", "HORSE", "ELEPHANT", "GIRAFFE",
+			      "ZEBRA", "MONKEY", "" };
+    for(unsigned int i=0; i<sizeof(english)/sizeof(english[0]); ++i)
+      words.push_back(english[i]);
+  }
+
+  // Characters transcode as they look up, mapped or not
+  bool all_ok = true;
+  for(unsigned int i=0; i<words.size(); ++i)
+    if(consistent(charset, words[i]) != 0) all_ok = false;
+  failures += check(all_ok, "transcode() agrees with operator[]");
+  failures += check(consistent(charset, "a?\xc3\xa9\xe0\xa4\x85\x80z") == 0,
+		    "unmapped, non-ASCII and stray bytes");
+
+  // A short buffer gets what fits, and the full count comes back
+  unsigned char two[3] = { 0, 0, 0x55 };
+  failures += check((charset.transcode("ABCD", 4, two, 2) == 4) &&
+		    (two[0] == charset.dotsFor("A")) &&
+		    (two[1] == charset.dotsFor("B")) && (two[2] == 0x55),
+		    "short buffer");
+
+  // Word lists pack end to end
+  std::vector<unsigned char> dots;
+  std::vector<uint32_t> starts;
+  charset.transcode(words, dots, starts);
+  bool packed_ok = (starts.size() == words.size() + 1) &&
+		   (starts.back() == dots.size());
+  for(unsigned int w=0; packed_ok && (w<words.size()); ++w) {
+    const std::vector<std::string> chars = characters(words[w]);
+    packed_ok = (starts[w+1] - starts[w] == chars.size());
+    for(unsigned int i=0; packed_ok && (i<chars.size()); ++i)
+      packed_ok = (dots[starts[w] + i] == charset.dotsFor(chars[i]));
+  }
+  failures += check(packed_ok, "word lists");
+
+  // Remapping a letter updates the ASCII table, copies included
+  Charset changed = charset;
+  changed.set(INVALID_DOTS, GlyphMapping("A"));
+  changed.set(0x3f, GlyphMapping("A"));
+  const Charset copy = changed;
+  failures += check((copy.dotsFor("A") == 0x3f) &&
+		    (charset.dotsFor("A") == charset[GlyphMapping("A")]),
+		    "ASCII table follows set()");
+
+  if(failures > 0) {
+    std::cerr << failures << " check(s) FAILED" << std::endl;
+    return 1;
+  }
+  std::cout << "checks: OK" << std::endl;
+
+  // Benchmark: the word list, letter at a time and in one batch
+  const unsigned long rounds = 20000;
+  unsigned long total = 0;
+  size_t num_chars = 0;
+  std::vector<std::vector<std::string> > split;
+  for(unsigned int w=0; w<words.size(); ++w) {
+    split.push_back(characters(words[w]));
+    num_chars += split.back().size();
+  }
+
+  TimeInterval start = TimeInterval::now();
+  for(unsigned long r=0; r<rounds; ++r)
+    for(unsigned int w=0; w<split.size(); ++w)
+      for(unsigned int i=0; i<split[w].size(); ++i)
+	total += charset[GlyphMapping(split[w][i])];
+  const double glyph_secs = (double) (TimeInterval::now() - start);
+
+  start = TimeInterval::now();
+  for(unsigned long r=0; r<rounds; ++r) {
+    charset.transcode(words, dots, starts);
+    total += dots.back();
+  }
+  const double batch_secs = (double) (TimeInterval::now() - start);
+
+  sink = total;
+  const double lookups = (double) rounds * num_chars;
+  std::cout << num_chars << " characters: GlyphMapping lookups "
+	    << glyph_secs / lookups * 1e9 << " ns/char, transcode "
+	    << batch_secs / lookups * 1e9 << " ns/char" << std::endl;
+
+  return 0;
+}
+
+int main(int argc, char **argv)
+{
+  try { return fakemain(argc, argv); }
+  catch(const BTException &e) {
+    std::cerr << "BTException: " << e.why << std::endl;
+    return -1;
+  }
+  catch(...) {
+    std::cerr << "Some other exception happened" << std::endl;
+    return -1;
+  }
+
+  return 0;
+}
@@ -0,0 +1,265 @@
+#include "Dots.h"
+#include "Types.h"
+#include "Charset.h"
+#include "IOEvent.h"
+#include "Dictionary.h"
+
+#include <string>
+#include <vector>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <algorithm>
+
+using namespace BrailleTutorNS;
+
+// Checks and benchmark for Dictionary and WordAssembler. Searches of random
+// word lists are compared with a plain dynamic programming edit distance,
+// words are assembled from letter events, and then searches of a large word
+// list are timed, one per letter of a word being written.
+//
+// Usage: test_dictionary [word list file, one word per line]
+// Without an argument, 50000 random words are made up for the benchmark.
+
+//! Results are stored here so the optimizer can't drop the benchmark loop
+volatile unsigned long sink;
+
+//! Report a failed check
+static unsigned int check(const bool &ok, const std::string &what)
+{
+  if(!ok) std::cerr << "FAILED: " << what << std::endl;
+  return ok ? 0 : 1;
+}
+
+//! Edit distance between a and b, and the least between a and a prefix of b
+void reference(const std::string &a, const std::string &b,
+	       unsigned int &whole, unsigned int &prefix)
+{
+  std::vector<unsigned int> col(a.size()+1), next(a.size()+1);
+  for(unsigned int i=0; i<=a.size(); ++i) col[i] = i;
+  prefix = a.size();
+  for(unsigned int j=0; j<b.size(); ++j) {
+    next[0] = j+1;
+    for(unsigned int i=1; i<=a.size(); ++i)
+      next[i] = std::min(std::min(col[i] + 1, next[i-1] + 1),
+			 col[i-1] + (a[i-1] == b[j] ? 0 : 1));
+    col.swap(next);
+    prefix = std::min(prefix, col[a.size()]);
+  }
+  whole = col[a.size()];
+}
+
+//! A random word over a few letters, so near misses are common
+std::string random_word(const unsigned int &max_length)
+{
+  std::string w(1 + rand() % max_length, ' ');
+  for(unsigned int i=0; i<w.size(); ++i) w[i] = "ABCDE"[rand() % 5];
+  return w;
+}
+
+//! Check one search against the reference distances
+unsigned int consistent(const Dictionary &dict, const std::string &written,
+			const unsigned int &max_distance,
+			const unsigned int &max_results)
+{
+  std::vector<Dictionary::Match> matches, completions;
+  dict.search(written, max_distance, max_results, matches, completions);
+
+  // Rank every word as search() should, then compare
+  std::vector<std::pair<std::pair<unsigned int, unsigned int>, unsigned int> >
+    want_matches, want_completions;
+  for(unsigned int w=0; w<dict.size(); ++w) {
+    unsigned int whole, prefix;
+    reference(written, dict[w], whole, prefix);
+    const unsigned int n = dict[w].size(), m = written.size();
+    if(whole <= max_distance)
+      want_matches.push_back(std::make_pair(
+	std::make_pair(whole, (n > m) ? n - m : m - n), w));
+    if((n > m) && (prefix <= max_distance))
+      want_completions.push_back(std::make_pair(std::make_pair(prefix, n), w));
+  }
+  std::sort(want_matches.begin(), want_matches.end());
+  std::sort(want_completions.begin(), want_completions.end());
+  if(want_matches.size() > max_results) want_matches.resize(max_results);
+  if(want_completions.size() > max_results)
+    want_completions.resize(max_results);
+
+  if((matches.size() != want_matches.size()) ||
+     (completions.size() != want_completions.size())) return 1;
+  for(unsigned int i=0; i<matches.size(); ++i)
+    if((matches[i].word != want_matches[i].second) ||
+       (matches[i].distance != want_matches[i].first.first)) return 1;
+  for(unsigned int i=0; i<completions.size(); ++i)
+    if((completions[i].word != want_completions[i].second) ||
+       (completions[i].distance != want_completions[i].first.first)) return 1;
+  return 0;
+}
+
+//! A CELL_LETTER event for letter in cell
+IOEvent letter_in(const std::string &letter, const unsigned short int &cell)
+{
+  return IOEvent::makeCellLetterEvent(TimeInterval(), TimeInterval(), cell,
+				      GlyphMapping(letter), 0);
+}
+
+int fakemain(int argc, char **argv)
+{
+  unsigned int failures = 0;
+
+  // Random lists against the reference
+  srand(1);
+  bool all_ok = true;
+  for(unsigned int round=0; round<200; ++round) {
+    std::vector<std::string> words;
+    for(unsigned int w=0; w<30; ++w) words.push_back(random_word(9));
+    const Dictionary dict(words);
+    const std::string written = (round % 10 == 0) ? std::string() :
+				random_word(7);
+    if(consistent(dict, written, round % 4, 1 + round % 6) != 0)
+      all_ok = false;
+  }
+  failures += check(all_ok, "search() agrees with dynamic programming");
+
+  // Long and non-ASCII words
+  std::vector<std::string> words;
+  words.push_back(std::string(70, 'A'));
+  words.push_back(std::string(64, 'A') + "B");
+  words.push_back("\xe0\xa4\x95\xe0\xa4\xae\xe0\xa4\xb2");   // कमल
+  words.push_back("");
+  const Dictionary odd(words);
+  std::vector<Dictionary::Match> matches, completions;
+  odd.search(std::string(64, 'A'), 1, 5, matches, completions);
+  failures += check((matches.size() == 1) && (matches[0].word == 1) &&
+		    (completions.size() == 2) && (completions[0].word == 1) &&
+		    (completions[0].distance == 0), "64-letter written word");
+  odd.search("\xe0\xa4\x95\xe0\xa4\xb2", 1, 5, matches, completions); // कल
+  failures += check((matches.size() == 1) && (matches[0].word == 2) &&
+		    (matches[0].distance == 1), "non-ASCII letters");
+
+  // Assembling words from events
+  {
+    const char *list[] = { "CAT", "CART", "DOG", "DOGS", "COW" };
+    const Dictionary animals(std::vector<std::string>(list, list + 5));
+    WordAssembler wa(animals, 1, 3);
+    wa.push(letter_in("C", 0));
+    wa.push(letter_in("A", 1));
+    const bool partial = !wa.ended() && (wa.word() == "CA") &&
+			 (wa.completions().size() == 3) &&
+			 (animals[wa.completions()[0].word] == "CAT") &&
+			 (animals[wa.completions()[1].word] == "CART");
+    wa.push(letter_in("R", 2));
+    const bool typo = (wa.matches().size() == 2) &&
+		      (animals[wa.matches()[0].word] == "CAT") &&
+		      (animals[wa.matches()[1].word] == "CART");
+    // CAR is a whole letter from CAT, but starts CART
+    const bool closest = wa.closest() &&
+			 (animals[wa.closest()->word] == "CART") &&
+			 (wa.closest()->distance == 0);
+    // A skipped cell ends the word and starts the next
+    const bool ended = wa.push(letter_in("D", 4)) && (wa.word() == "D");
+    wa.push(letter_in("O", 5));
+    wa.push(letter_in("", 6));	// a pattern that isn't a letter
+    const bool unknown = (wa.matches().size() == 1) &&
+			 (animals[wa.matches()[0].word] == "DOG");
+    const bool button = wa.push(IOEvent::makeButtonEvent(TimeInterval(),
+							 TimeInterval(), 0)) &&
+			wa.ended() && (wa.word() == "DO\xef\xbf\xbd") &&
+			(wa.matches().size() == 1);
+    const bool whole = wa.closest() &&
+		       (animals[wa.closest()->word] == "DOG");
+    wa.addLetter("C");
+    const bool restarted = (wa.word() == "C");
+    wa.reset();
+    failures += check(partial && typo && closest && ended && unknown &&
+		      button && whole && restarted && !wa.closest(),
+		      "WordAssembler");
+  }
+
+  // Two words written in the same cell: the first ends as a word spelled
+  // out does, the second with button 0 pressed while its last glyph is
+  // underway, and the letter button 0 flushes still belongs to it
+  {
+    const char *list[] = { "CAT", "DOG", "DOGS" };
+    const Dictionary animals(std::vector<std::string>(list, list + 3));
+    WordAssembler wa(animals, 1, 3);
+    const std::string cat = "CAT", dogs = "DOGS";
+    for(unsigned int i=0; i<cat.size(); ++i) {
+      wa.push(IOEvent::makeCellStartEvent(TimeInterval(), 0));
+      wa.push(letter_in(cat.substr(i, 1), 0));
+    }
+    const bool spelled = wa.closest() && (wa.closest()->distance == 0) &&
+			 (animals[wa.closest()->word] == wa.word());
+    wa.endWord();
+    for(unsigned int i=0; i<dogs.size(); ++i) {
+      wa.push(IOEvent::makeCellStartEvent(TimeInterval(), 0));
+      if(i == dogs.size()-1)
+	wa.push(IOEvent::makeButtonEvent(TimeInterval(), TimeInterval(), 0));
+      if(wa.push(letter_in(dogs.substr(i, 1), 0)) != (i == dogs.size()-1))
+	failures += check(false, "button 0 ends a word after its last letter");
+    }
+    const bool second = wa.ended() && (wa.word() == "DOGS");
+    wa.push(IOEvent::makeCellStartEvent(TimeInterval(), 0));
+    wa.push(letter_in("C", 0));
+    failures += check(spelled && second && (wa.word() == "C"),
+		      "two words in the same cell");
+  }
+
+  if(failures > 0) {
+    std::cerr << failures << " check(s) FAILED" << std::endl;
+    return 1;
+  }
+  std::cout << "checks: OK" << std::endl;
+
+  // Benchmark: search as each letter of some words is written
+  std::vector<std::string> corpus;
+  if(argc > 1) {
+    std::ifstream in(argv[1]);
+    if(!in.good())
+      throw BTException(BTException::BT_EIO,
+			std::string("failed to open file ") + argv[1]);
+    std::string line;
+    while(std::getline(in, line)) if(!line.empty()) corpus.push_back(line);
+  }
+  else {
+    for(unsigned int w=0; w<50000; ++w) {
+      std::string word(3 + rand() % 8, ' ');
+      for(unsigned int i=0; i<word.size(); ++i) word[i] = 'A' + rand() % 26;
+      corpus.push_back(word);
+    }
+  }
+  const Dictionary big(corpus);
+
+  const unsigned int num_words = 20;
+  unsigned long letters = 0, total = 0;
+  const TimeInterval start = TimeInterval::now();
+  for(unsigned int w=0; w<num_words; ++w) {
+    const std::string &target = corpus[(w * 7919) % corpus.size()];
+    WordAssembler wa(big, 2, 5);
+    for(unsigned int i=0; i<target.size(); ++i, ++letters) {
+      wa.addLetter(target.substr(i, 1));
+      total += wa.completions().size() + wa.matches().size();
+    }
+  }
+  const double secs = (double) (TimeInterval::now() - start);
+  sink = total;
+
+  std::cout << big.size() << " words: " << secs / letters * 1e3
+	    << " ms per letter written" << std::endl;
+
+  return 0;
+}
+
+int main(int argc, char **argv)
+{
+  try { return fakemain(argc, argv); }
+  catch(const BTException &e) {
+    std::cerr << "BTException: " << e.why << std::endl;
+    return -1;
+  }
+  catch(...) {
+    std::cerr << "Some other exception happened" << std::endl;
+    return -1;
+  }
+
+  return 0;
+}
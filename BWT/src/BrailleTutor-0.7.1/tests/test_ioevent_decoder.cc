@@ -0,0 +1,718 @@
+#include "Dots.h"
+#include "Types.h"
+#include "Charset.h"
+#include "IOEvent.h"
+#include "IOEventDecoder.h"
+
+#include <map>
+#include <deque>
+#include <vector>
+#include <utility>
+#include <algorithm>
+#include <string>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include <iostream>
+
+using namespace BrailleTutorNS;
+
+// Differential test and throughput benchmark for the single-pass
+// IOEventDecoder. The reference decoder below is the multi-pass decoder
+// that FunctorIOEventDecoder used before, lifted out of its thread. Both
+// decoders are fed the same recorded BaseIOEvent streams, batch by batch,
+// and must produce identical IOEvent streams.
+//
+// Usage: test_ioevent_decoder [recorded stream file ...]
+// Recorded stream files have one BaseIOEvent per line:
+//    <seconds> SD|SU <cell> <dot>     (stylus down/up, dot zero-indexed)
+//    <seconds> BD|BU <button>         (button down/up)
+//    <seconds> FLUSH                  (flush glyph)
+// A blank line ends a batch; a line reading "timeout" means the glyph
+// delay expired before the next batch. Without arguments, the test replays
+// a set of streams generated from simulated writing sessions.
+
+//! The old multi-pass decoder, for reference
+struct ReferenceDecoder {
+  std::deque<BaseIOEvent> actives;
+  typedef enum { NONE, BUTTONS, CELL } GlyphLoc;
+  GlyphLoc glyph_where;
+  unsigned short int glyph_cell;
+  TimeInterval glyph_began;
+  TimeInterval glyph_last;
+  unsigned char glyph_dots;
+
+  ReferenceDecoder()
+  : glyph_where(NONE), glyph_cell(INVALID_CELL), glyph_dots(0) { }
+
+  bool glyphUnderway() const { return glyph_where != NONE; }
+
+  void cellGlyph(std::deque<IOEvent> &out, const IOEvent::TypeMask &watch,
+		 const Charset &charset)
+  {
+    const TimeInterval duration = glyph_last - glyph_began;
+    if(watch & IOEvent::mask(IOEvent::CELL_DONE))
+      out.push_back(
+	IOEvent::makeCellDoneEvent(glyph_last, glyph_cell, duration));
+    if(watch & IOEvent::mask(IOEvent::CELL_DOTS))
+      out.push_back(
+	IOEvent::makeCellDotsEvent(glyph_began, duration,
+				   glyph_cell, glyph_dots));
+    if(watch & IOEvent::mask(IOEvent::CELL_LETTER))
+      out.push_back(
+	IOEvent::makeCellLetterEvent(glyph_began, duration, glyph_cell,
+				     charset.mir()[glyph_dots], glyph_dots));
+  }
+
+  void buttonGlyph(std::deque<IOEvent> &out, const IOEvent::TypeMask &watch,
+		   const Charset &charset)
+  {
+    const TimeInterval duration = glyph_last - glyph_began;
+    if(watch & IOEvent::mask(IOEvent::BUTTON_DONE))
+      out.push_back(IOEvent::makeButtonDoneEvent(glyph_last, duration));
+    if(watch & IOEvent::mask(IOEvent::BUTTON_DOTS))
+      out.push_back(
+	IOEvent::makeButtonDotsEvent(glyph_began, duration, glyph_dots));
+    if(watch & IOEvent::mask(IOEvent::BUTTON_LETTER))
+      out.push_back(
+	IOEvent::makeButtonLetterEvent(glyph_began, duration,
+				       charset.mir()[glyph_dots], glyph_dots));
+  }
+
+  void startCell(const BaseIOEvent &e, std::deque<IOEvent> &out,
+		 const IOEvent::TypeMask &watch)
+  {
+    glyph_where = CELL;
+    glyph_began = glyph_last = e.timestamp;
+    glyph_cell = e.cell;
+    glyph_dots = dot_mask(e.dot);
+    if(watch & IOEvent::mask(IOEvent::CELL_START))
+      out.push_back(IOEvent::makeCellStartEvent(e.timestamp, glyph_cell));
+  }
+
+  bool decode(const std::deque<BaseIOEvent> &in, std::deque<IOEvent> &out,
+	      const IOEvent::TypeMask &watch, const Charset &charset,
+	      bool &flush_glyph)
+  {
+    std::deque<BaseIOEvent>::const_iterator ib;
+
+    for(ib=in.begin(); ib!=in.end(); ++ib)
+      if(ib->type == BaseIOEvent::DONE) {
+	out.push_back(IOEvent::makeDoneEvent());
+	return true;
+      }
+
+    for(ib=in.begin(); ib!=in.end(); ++ib)
+      if(ib->type == BaseIOEvent::FLUSH_GLYPH) { flush_glyph = true; break; }
+
+    if(watch & IOEvent::mask(IOEvent::STYLUS_DOWN))
+      for(ib=in.begin(); ib!=in.end(); ++ib)
+	if(ib->type == BaseIOEvent::STYLUS_DOWN)
+	  out.push_back(
+	    IOEvent::makeStylusDownEvent(ib->timestamp, ib->cell, ib->dot));
+    if(watch & IOEvent::mask(IOEvent::STYLUS_UP))
+      for(ib=in.begin(); ib!=in.end(); ++ib)
+	if(ib->type == BaseIOEvent::STYLUS_UP)
+	  out.push_back(
+	    IOEvent::makeStylusUpEvent(ib->timestamp, ib->cell, ib->dot));
+    if(watch & IOEvent::mask(IOEvent::BUTTON_DOWN))
+      for(ib=in.begin(); ib!=in.end(); ++ib)
+	if(ib->type == BaseIOEvent::BUTTON_DOWN)
+	  out.push_back(IOEvent::makeButtonDownEvent(ib->timestamp,ib->button));
+    if(watch & IOEvent::mask(IOEvent::BUTTON_UP))
+      for(ib=in.begin(); ib!=in.end(); ++ib)
+	if(ib->type == BaseIOEvent::BUTTON_UP)
+	  out.push_back(IOEvent::makeButtonUpEvent(ib->timestamp, ib->button));
+
+    if(watch & IOEvent::mask(IOEvent::STYLUS))
+      for(ib=in.begin(); ib!=in.end(); ++ib)
+	if(ib->type == BaseIOEvent::STYLUS_UP) {
+	  std::deque<BaseIOEvent>::iterator a;
+	  for(a=actives.begin(); a!=actives.end(); ++a)
+	    if((a->type == BaseIOEvent::STYLUS_DOWN) &&
+	       (a->cell == ib->cell) && (a->dot == ib->dot)) {
+	      out.push_back(IOEvent::makeStylusEvent(a->timestamp,
+		ib->timestamp - a->timestamp, a->cell, a->dot));
+	      break;
+	    }
+	}
+    if(watch & IOEvent::mask(IOEvent::BUTTON))
+      for(ib=in.begin(); ib!=in.end(); ++ib)
+	if(ib->type == BaseIOEvent::BUTTON_UP) {
+	  std::deque<BaseIOEvent>::iterator a;
+	  for(a=actives.begin(); a!=actives.end(); ++a)
+	    if((a->type == BaseIOEvent::BUTTON_DOWN) &&
+	       (a->button == ib->button)) {
+	      out.push_back(IOEvent::makeButtonEvent(a->timestamp,
+		ib->timestamp - a->timestamp, a->button));
+	      break;
+	    }
+	}
+
+    for(ib=in.begin(); ib!=in.end(); ++ib)
+      if(ib->type == BaseIOEvent::STYLUS_UP) {
+	std::deque<BaseIOEvent>::iterator a;
+	for(a=actives.begin(); a!=actives.end(); ++a)
+	  if((a->type == BaseIOEvent::STYLUS_DOWN) &&
+	     (a->cell == ib->cell) && (a->dot == ib->dot)) break;
+	if(a != actives.end()) actives.erase(a);
+      }
+    for(ib=in.begin(); ib!=in.end(); ++ib)
+      if(ib->type == BaseIOEvent::BUTTON_UP) {
+	std::deque<BaseIOEvent>::iterator a;
+	for(a=actives.begin(); a!=actives.end(); ++a)
+	  if((a->type == BaseIOEvent::BUTTON_DOWN) &&
+	     (a->button == ib->button)) break;
+	if(a != actives.end()) actives.erase(a);
+      }
+    for(ib=in.begin(); ib!=in.end(); ++ib)
+      if((ib->type == BaseIOEvent::STYLUS_DOWN) ||
+	 (ib->type == BaseIOEvent::BUTTON_DOWN)) actives.push_back(*ib);
+
+    for(ib=in.begin(); ib!=in.end(); ++ib) {
+      if((ib->type == BaseIOEvent::BUTTON_DOWN) && (ib->dot != INVALID_DOT)) {
+	if(glyph_where != BUTTONS) {
+	  if(glyph_where == CELL) cellGlyph(out, watch, charset);
+	  glyph_where = BUTTONS;
+	  glyph_began = glyph_last = ib->timestamp;
+	  glyph_dots = dot_mask(ib->dot);
+	  if(watch & IOEvent::mask(IOEvent::BUTTON_START))
+	    out.push_back(IOEvent::makeButtonStartEvent(ib->timestamp));
+	}
+	else {
+	  glyph_dots |= dot_mask(ib->dot);
+	  glyph_last = ib->timestamp;
+	}
+      }
+      else if(ib->type == BaseIOEvent::STYLUS_DOWN) {
+	if(glyph_where == NONE) startCell(*ib, out, watch);
+	else if(glyph_where == BUTTONS) {
+	  buttonGlyph(out, watch, charset);
+	  startCell(*ib, out, watch);
+	}
+	else if(glyph_cell != ib->cell) {
+	  cellGlyph(out, watch, charset);
+	  startCell(*ib, out, watch);
+	}
+	else {
+	  glyph_dots |= dot_mask(ib->dot);
+	  glyph_last = ib->timestamp;
+	}
+      }
+      else if((ib->type == BaseIOEvent::BUTTON_UP) &&
+	      (ib->dot != INVALID_DOT) && (glyph_where == BUTTONS))
+	glyph_last = ib->timestamp;
+      else if((ib->type == BaseIOEvent::STYLUS_UP) && (glyph_where == CELL))
+	glyph_last = ib->timestamp;
+    }
+
+    return false;
+  }
+
+  void finishGlyph(std::deque<IOEvent> &out, const IOEvent::TypeMask &watch,
+		   const Charset &charset)
+  {
+    if(glyph_where == NONE) return;
+    bool button_active = false;
+    bool stylus_active = false;
+    std::deque<BaseIOEvent>::const_iterator a;
+    for(a=actives.begin(); a!=actives.end(); ++a) {
+      if((a->type == BaseIOEvent::BUTTON_DOWN) && (a->dot != INVALID_DOT))
+	button_active = true;
+      if(a->type == BaseIOEvent::STYLUS_DOWN) stylus_active = true;
+    }
+    if((glyph_where == BUTTONS) && (!button_active))
+      buttonGlyph(out, watch, charset);
+    else if((glyph_where == CELL) && (!stylus_active))
+      cellGlyph(out, watch, charset);
+    if(!(button_active | stylus_active)) {
+      glyph_where = NONE;
+      glyph_dots = 0;
+    }
+  }
+};
+
+
+//! A recorded stream: batches of events, each maybe followed by a timeout
+struct Recording {
+  std::deque<std::deque<BaseIOEvent> > batches;
+  std::deque<bool> timeouts;
+};
+
+//! Read a recorded stream from a file (format described above)
+Recording readRecording(const char *filename)
+{
+  std::ifstream in(filename);
+  if(!in) throw std::string("can't open recording ") + filename;
+
+  Recording rec;
+  std::deque<BaseIOEvent> batch;
+  std::string line;
+  while(std::getline(in, line)) {
+    if(line.empty() || (line == "timeout")) {
+      if(!batch.empty()) {
+	rec.batches.push_back(batch);
+	rec.timeouts.push_back(line == "timeout");
+	batch.clear();
+      }
+      else if((line == "timeout") && !rec.timeouts.empty())
+	rec.timeouts.back() = true;
+      continue;
+    }
+
+    std::istringstream fields(line);
+    double secs;
+    std::string type;
+    unsigned int a = 0, b = 0;
+    fields >> secs >> type >> a >> b;
+    const TimeInterval t(secs);
+    if(type == "SD") batch.push_back(BaseIOEvent::makeStylusDownEvent(t,a,b));
+    else if(type == "SU") batch.push_back(BaseIOEvent::makeStylusUpEvent(t,a,b));
+    else if(type == "BD") batch.push_back(BaseIOEvent::makeButtonDownEvent(t,a));
+    else if(type == "BU") batch.push_back(BaseIOEvent::makeButtonUpEvent(t,a));
+    else if(type == "FLUSH") batch.push_back(BaseIOEvent::makeFlushGlyphEvent());
+    else throw std::string("bad line in recording: ") + line;
+  }
+  if(!batch.empty()) { rec.batches.push_back(batch); rec.timeouts.push_back(0); }
+  return rec;
+}
+
+//! Simulate a student writing glyphs in cells and on the buttons
+
+//! Mimics what the BrailleTutor hands an IOEventParser: contacts last a
+//! while, sometimes overlap, and are delivered in small batches. Unless
+//! twins_together is set, a contact's UP is never in the same batch as its
+//! DOWN; the reference decoder can't handle that (the old decoder asserted
+//! on it), so such sessions are checked with separateTwins().
+Recording simulateSession(const unsigned int &seed, const unsigned int &glyphs,
+			  const bool &twins_together=false)
+{
+  srand(seed);
+  Recording rec;
+  std::deque<BaseIOEvent> batch;
+  std::deque<BaseIOEvent> pending;	// events yet to be batched, in order
+  std::map<unsigned int, double> released;	// when contacts were let go
+  double t = 100.0;
+
+  for(unsigned int g=0; g<glyphs; ++g) {
+    const bool on_buttons = (rand() % 4) == 0;
+    const unsigned short int cell = rand() % 16;
+    const unsigned int ndots = 1 + rand() % 4;
+    for(unsigned int d=0; d<ndots; ++d) {
+      t += 0.05 + (rand() % 400) / 1000.0;
+      const unsigned short int button = rand() % 7;
+      const unsigned char dot = rand() % 6;
+      // A button or hole can't be pushed again until it's been let go
+      const unsigned int contact = on_buttons ? 1000 + button : cell*8 + dot;
+      if(released[contact] >= t) t = released[contact] + 0.01;
+      const double up = t + 0.2 + (rand() % 300) / 1000.0;
+      released[contact] = up;
+
+      if(on_buttons) {
+	pending.push_back(BaseIOEvent::makeButtonDownEvent(TimeInterval(t),
+							   button));
+	pending.push_back(BaseIOEvent::makeButtonUpEvent(TimeInterval(up),
+							 button));
+      }
+      else {
+	pending.push_back(BaseIOEvent::makeStylusDownEvent(TimeInterval(t),
+							   cell, dot));
+	pending.push_back(BaseIOEvent::makeStylusUpEvent(TimeInterval(up),
+							 cell, dot));
+      }
+      // Make contacts overlap now and then
+      if(rand() % 3) t = up;
+    }
+    if((rand() % 8) == 0) pending.push_back(BaseIOEvent::makeFlushGlyphEvent());
+  }
+
+  // Sort by time. FLUSH_GLYPH events have no timestamp of their own, so
+  // they sort by the time of the event before them.
+  std::vector<std::pair<double, unsigned int> > order;
+  double last_time = 0.0;
+  for(unsigned int i=0; i<pending.size(); ++i) {
+    if(pending[i].type != BaseIOEvent::FLUSH_GLYPH)
+      last_time = (double) pending[i].timestamp;
+    order.push_back(std::make_pair(last_time, i));
+  }
+  std::stable_sort(order.begin(), order.end());
+  std::deque<BaseIOEvent> sorted;
+  for(unsigned int i=0; i<order.size(); ++i)
+    sorted.push_back(pending[order[i].second]);
+
+  // Deal the events out into batches
+  while(!sorted.empty()) {
+    const BaseIOEvent &e = sorted.front();
+    bool twin_in_batch = false;
+    std::deque<BaseIOEvent>::const_iterator b;
+    for(b=batch.begin(); b!=batch.end(); ++b)
+      if(((e.type == BaseIOEvent::STYLUS_UP) &&
+	  (b->type == BaseIOEvent::STYLUS_DOWN) &&
+	  (b->cell == e.cell) && (b->dot == e.dot)) ||
+	 ((e.type == BaseIOEvent::BUTTON_UP) &&
+	  (b->type == BaseIOEvent::BUTTON_DOWN) && (b->button == e.button)))
+	twin_in_batch = true;
+    if((twin_in_batch && !twins_together) ||
+       (batch.size() >= 1 + (unsigned int) (rand() % 6))) {
+      rec.batches.push_back(batch);
+      rec.timeouts.push_back((rand() % 5) == 0);
+      batch.clear();
+    }
+    batch.push_back(e);
+    sorted.pop_front();
+  }
+  if(!batch.empty()) { rec.batches.push_back(batch); rec.timeouts.push_back(1); }
+  return rec;
+}
+
+//! Split a recording's batches so no UP is in the same batch as its DOWN
+
+//! Each batch is cut before any UP whose DOWN is already in the piece. A
+//! batch's timeout, and any FLUSH_GLYPH events in it, go with its last
+//! piece, so glyphs are finished at the same points in the event stream.
+Recording separateTwins(const Recording &rec)
+{
+  Recording out;
+  for(unsigned int i=0; i<rec.batches.size(); ++i) {
+    std::deque<BaseIOEvent> piece, flushes;
+    std::deque<BaseIOEvent>::const_iterator e, b;
+    for(e=rec.batches[i].begin(); e!=rec.batches[i].end(); ++e) {
+      if(e->type == BaseIOEvent::FLUSH_GLYPH) {
+	flushes.push_back(*e);
+	continue;
+      }
+      bool twin_in_piece = false;
+      for(b=piece.begin(); b!=piece.end(); ++b)
+	if(((e->type == BaseIOEvent::STYLUS_UP) &&
+	    (b->type == BaseIOEvent::STYLUS_DOWN) &&
+	    (b->cell == e->cell) && (b->dot == e->dot)) ||
+	   ((e->type == BaseIOEvent::BUTTON_UP) &&
+	    (b->type == BaseIOEvent::BUTTON_DOWN) && (b->button == e->button)))
+	  twin_in_piece = true;
+      if(twin_in_piece) {
+	out.batches.push_back(piece);
+	out.timeouts.push_back(false);
+	piece.clear();
+      }
+      piece.push_back(*e);
+    }
+    piece.insert(piece.end(), flushes.begin(), flushes.end());
+    out.batches.push_back(piece);
+    out.timeouts.push_back(rec.timeouts[i]);
+  }
+  return out;
+}
+
+//! Run a decoder over a recording, returning everything it decoded
+template <typename Decoder>
+std::deque<IOEvent> replay(Decoder &decoder, const Recording &rec,
+			   const IOEvent::TypeMask &watch,
+			   const Charset &charset)
+{
+  std::deque<IOEvent> out;
+  for(unsigned int i=0; i<rec.batches.size(); ++i) {
+    bool flush_glyph = false;
+    if(decoder.decode(rec.batches[i], out, watch, charset, flush_glyph))
+      break;
+    if((flush_glyph || rec.timeouts[i]) && decoder.glyphUnderway())
+      decoder.finishGlyph(out, watch, charset);
+  }
+  return out;
+}
+
+//! Returns true if two IOEvents are identical
+bool sameEvent(const IOEvent &a, const IOEvent &b)
+{
+  return (a.type == b.type) && (a.cell == b.cell) && (a.dot == b.dot) &&
+	 ((double) a.timestamp == (double) b.timestamp) &&
+	 ((double) a.duration == (double) b.duration) &&
+	 ((std::string) a.letter == (std::string) b.letter);
+}
+
+//! Compare both decoders on a recording; returns the number of mismatches
+unsigned int compare(const std::string &name, const Recording &rec,
+		     const IOEvent::TypeMask &watch)
+{
+  ReferenceDecoder ref;
+  IOEventDecoder dut;
+  const std::deque<IOEvent> expected =
+    replay(ref, rec, watch, Charset::defaultCharset());
+  const std::deque<IOEvent> got =
+    replay(dut, rec, watch, Charset::defaultCharset());
+
+  if(expected.size() != got.size()) {
+    std::cerr << name << ": FAILED, " << got.size() << " events instead of "
+	      << expected.size() << std::endl;
+    return 1;
+  }
+  for(unsigned int i=0; i<got.size(); ++i)
+    if(!sameEvent(expected[i], got[i])) {
+      std::cerr << name << ": FAILED, event " << i << " differs (type "
+		<< got[i].type << " instead of " << expected[i].type << ')'
+		<< std::endl;
+      return 1;
+    }
+
+  std::cerr << name << ": OK (" << got.size() << " events)" << std::endl;
+  return 0;
+}
+
+//! Compare the decoder on a recording with UPs batched with their DOWNs
+//! against the reference on the same recording with them split apart.
+//! Splitting a batch changes only how the output groups of its events
+//! interleave, so the events of each type must match, in order.
+unsigned int compareTogether(const std::string &name, const Recording &rec,
+			     const IOEvent::TypeMask &watch)
+{
+  ReferenceDecoder ref;
+  IOEventDecoder dut;
+  const std::deque<IOEvent> expected =
+    replay(ref, separateTwins(rec), watch, Charset::defaultCharset());
+  const std::deque<IOEvent> got =
+    replay(dut, rec, watch, Charset::defaultCharset());
+
+  std::map<int, std::deque<IOEvent> > expected_by_type, got_by_type;
+  for(unsigned int i=0; i<expected.size(); ++i)
+    expected_by_type[expected[i].type].push_back(expected[i]);
+  for(unsigned int i=0; i<got.size(); ++i)
+    got_by_type[got[i].type].push_back(got[i]);
+
+  std::map<int, std::deque<IOEvent> >::const_iterator t;
+  for(t=expected_by_type.begin(); t!=expected_by_type.end(); ++t) {
+    const std::deque<IOEvent> &mine = got_by_type[t->first];
+    bool same = (mine.size() == t->second.size());
+    for(unsigned int i=0; same && (i<mine.size()); ++i)
+      same = sameEvent(t->second[i], mine[i]);
+    if(!same) {
+      std::cerr << name << ": FAILED, events of type " << t->first
+		<< " differ" << std::endl;
+      return 1;
+    }
+  }
+  if(got_by_type.size() != expected_by_type.size()) {
+    std::cerr << name << ": FAILED, unexpected event types" << std::endl;
+    return 1;
+  }
+
+  std::cerr << name << ": OK (" << got.size() << " events)" << std::endl;
+  return 0;
+}
+
+//! Time a decoder over a recording many times; returns BaseIOEvents/second
+template <typename Decoder>
+double throughput(const Recording &rec, const IOEvent::TypeMask &watch,
+		  const unsigned int &reps)
+{
+  unsigned long events = 0;
+  for(unsigned int i=0; i<rec.batches.size(); ++i)
+    events += rec.batches[i].size();
+
+  const TimeInterval start = TimeInterval::now();
+  for(unsigned int r=0; r<reps; ++r) {
+    Decoder decoder;
+    replay(decoder, rec, watch, Charset::defaultCharset());
+  }
+  const double secs = (double) (TimeInterval::now() - start);
+  return (secs > 0.0) ? (events * reps) / secs : 0.0;
+}
+
+int fakemain(int argc, char **argv)
+{
+  // Subscription profiles to test under: everything (save the provisional
+  // letters the reference decoder predates), and what main.cc wants
+  const IOEvent::TypeMask provisional =
+    IOEvent::mask(IOEvent::CELL_PROVISIONAL_LETTER) |
+    IOEvent::mask(IOEvent::BUTTON_PROVISIONAL_LETTER);
+  const IOEvent::TypeMask everything =
+    ((IOEvent::mask(IOEvent::DONE) << 1) - 1) & ~provisional;
+  const IOEvent::TypeMask letters =
+    IOEvent::mask(IOEvent::BUTTON) | IOEvent::mask(IOEvent::STYLUS) |
+    IOEvent::mask(IOEvent::CELL_START) | IOEvent::mask(IOEvent::CELL_LETTER) |
+    IOEvent::mask(IOEvent::BUTTON_LETTER) | IOEvent::mask(IOEvent::CELL_DOTS);
+
+  std::deque<std::string> names;
+  std::deque<Recording> recordings;
+  for(int i=1; i<argc; ++i) {
+    names.push_back(argv[i]);
+    recordings.push_back(readRecording(argv[i]));
+  }
+  if(recordings.empty())
+    for(unsigned int seed=1; seed<=20; ++seed) {
+      std::ostringstream name;
+      name << "simulated session " << seed;
+      names.push_back(name.str());
+      recordings.push_back(simulateSession(seed, 200));
+    }
+
+  unsigned int failures = 0;
+  for(unsigned int i=0; i<recordings.size(); ++i) {
+    failures += compare(names[i] + " (all events)", recordings[i], everything);
+    failures += compare(names[i] + " (letters)", recordings[i], letters);
+  }
+  // Contacts begun and ended within one batch, as when a slow client lets
+  // input pile up
+  if(argc < 2)
+    for(unsigned int seed=1; seed<=20; ++seed) {
+      std::ostringstream name;
+      name << "simulated session " << seed << ", UPs with their DOWNs";
+      const Recording together = simulateSession(seed, 200, true);
+      failures += compareTogether(name.str() + " (all events)", together,
+				  everything);
+      failures += compareTogether(name.str() + " (letters)", together,
+				  letters);
+    }
+  if(failures > 0) {
+    std::cerr << failures << " differential test(s) FAILED" << std::endl;
+    return 1;
+  }
+
+  // Stray releases (and contacts the Tutor doesn't have) should be counted
+  // and otherwise ignored
+  {
+    IOEventDecoder decoder;
+    std::deque<BaseIOEvent> batch;
+    std::deque<IOEvent> out;
+    bool flush_glyph = false;
+    batch.push_back(BaseIOEvent::makeStylusUpEvent(TimeInterval(1.0), 3, 2));
+    batch.push_back(BaseIOEvent::makeButtonUpEvent(TimeInterval(1.1), 4));
+    batch.push_back(BaseIOEvent::makeStylusDownEvent(TimeInterval(1.2),999,0));
+    decoder.decode(batch, out, everything, Charset::defaultCharset(),
+		   flush_glyph);
+    for(unsigned int i=0; i<out.size(); ++i)
+      if((out[i].type == IOEvent::STYLUS) || (out[i].type == IOEvent::BUTTON))
+	throw std::string("stray release made a STYLUS or BUTTON event");
+    if(decoder.strayContacts() != 3)
+      throw std::string("stray contacts miscounted");
+    std::cerr << "stray contacts: OK" << std::endl;
+  }
+
+  // A dot entered and withdrawn within one batch makes a STYLUS event and
+  // leaves nothing active, so its glyph can be finished. (The old decoder
+  // looked for the withdrawal's entry before adding the batch's entries to
+  // its actives, and asserted.)
+  {
+    IOEventDecoder decoder;
+    std::deque<BaseIOEvent> batch;
+    std::deque<IOEvent> out;
+    bool flush_glyph = false;
+    batch.push_back(BaseIOEvent::makeStylusDownEvent(TimeInterval(1.0), 2, 0));
+    batch.push_back(BaseIOEvent::makeStylusUpEvent(TimeInterval(1.2), 2, 0));
+    batch.push_back(BaseIOEvent::makeButtonDownEvent(TimeInterval(1.3), 0));
+    batch.push_back(BaseIOEvent::makeButtonUpEvent(TimeInterval(1.4), 0));
+    decoder.decode(batch, out, letters, Charset::defaultCharset(),
+		   flush_glyph);
+    decoder.finishGlyph(out, letters, Charset::defaultCharset());
+    if((out.size() != 5) ||
+       (out[0].type != IOEvent::STYLUS) ||
+       (out[0].duration != TimeInterval(0.2)) ||
+       (out[1].type != IOEvent::BUTTON) || (out[1].button != 0) ||
+       (out[2].type != IOEvent::CELL_START) ||
+       (out[3].type != IOEvent::CELL_DOTS) ||
+       (out[4].type != IOEvent::CELL_LETTER) || (out[4].cell != 2) ||
+       decoder.glyphUnderway() || (decoder.strayContacts() != 0))
+      throw std::string("DOWN and UP in one batch decoded wrong");
+    std::cerr << "DOWN and UP in one batch: OK" << std::endl;
+  }
+
+  // A provisional letter should come as soon as, and only once, no more
+  // dots could change the letter. Here "a" is dot 1 and "b" is dots 1-2.
+  {
+    Charset ab("ab");
+    ab.set(DotsMirror::mir(dot_mask(0)), "a");
+    ab.set(DotsMirror::mir(dot_mask(0) | dot_mask(1)), "b");
+    IOEventDecoder decoder;
+    std::deque<BaseIOEvent> batch;
+    std::deque<IOEvent> out;
+    bool flush_glyph = false;
+    batch.push_back(BaseIOEvent::makeStylusDownEvent(TimeInterval(1.0), 2, 0));
+    batch.push_back(BaseIOEvent::makeStylusUpEvent(TimeInterval(1.1), 2, 0));
+    decoder.decode(batch, out, provisional, ab, flush_glyph);
+    if(!out.empty()) throw std::string("provisional letter came too soon");
+    batch.clear();
+    batch.push_back(BaseIOEvent::makeStylusDownEvent(TimeInterval(1.5), 2, 1));
+    batch.push_back(BaseIOEvent::makeStylusUpEvent(TimeInterval(1.6), 2, 1));
+    batch.push_back(BaseIOEvent::makeStylusDownEvent(TimeInterval(1.7), 2, 1));
+    batch.push_back(BaseIOEvent::makeStylusUpEvent(TimeInterval(1.8), 2, 1));
+    decoder.decode(batch, out, provisional, ab, flush_glyph);
+    decoder.finishGlyph(out, provisional, ab);
+    if((out.size() != 1) ||
+       (out[0].type != IOEvent::CELL_PROVISIONAL_LETTER) ||
+       (out[0].cell != 2) || !(out[0].letter == GlyphMapping("b")) ||
+       (out[0].duration != TimeInterval(0.5)))
+      throw std::string("provisional letter missing or wrong");
+    std::cerr << "provisional letters: OK" << std::endl;
+  }
+
+  // With concurrent cells, glyphs in two cells can be written interleaved,
+  // each finishing on its own, and then together make a word
+  {
+    Charset ab("ab");
+    ab.set(DotsMirror::mir(dot_mask(0)), "a");
+    ab.set(DotsMirror::mir(dot_mask(0) | dot_mask(1)), "b");
+    const IOEvent::TypeMask watch =
+      IOEvent::mask(IOEvent::CELL_LETTER) | IOEvent::mask(IOEvent::WORD);
+    const TimeInterval delay(1.0);
+    IOEventDecoder decoder;
+    decoder.setConcurrentCells(true);
+    std::deque<BaseIOEvent> batch;
+    std::deque<IOEvent> out;
+    bool flush_glyph = false;
+    batch.push_back(BaseIOEvent::makeStylusDownEvent(TimeInterval(1.0), 2, 0));
+    batch.push_back(BaseIOEvent::makeStylusUpEvent(TimeInterval(1.05), 2, 0));
+    batch.push_back(BaseIOEvent::makeStylusDownEvent(TimeInterval(1.1), 3, 0));
+    batch.push_back(BaseIOEvent::makeStylusUpEvent(TimeInterval(1.15), 3, 0));
+    batch.push_back(BaseIOEvent::makeStylusDownEvent(TimeInterval(1.2), 2, 1));
+    batch.push_back(BaseIOEvent::makeStylusUpEvent(TimeInterval(1.25), 2, 1));
+    decoder.decode(batch, out, watch, ab, flush_glyph);
+    TimeInterval deadline;
+    if(!out.empty() || !decoder.nextDeadline(delay, deadline) ||
+       (deadline != TimeInterval(2.15)))
+      throw std::string("concurrent cells finished too soon");
+    decoder.expireGlyphs(out, TimeInterval(3.0), delay, watch, ab);
+    if((out.size() != 2) ||
+       (out[0].cell != 2) || !(out[0].letter == GlyphMapping("b")) ||
+       (out[1].cell != 3) || !(out[1].letter == GlyphMapping("a")))
+      throw std::string("concurrent cell letters missing or wrong");
+    decoder.expireGlyphs(out, TimeInterval(3.5), delay, watch, ab);
+    if((out.size() != 3) || (out[2].type != IOEvent::WORD) ||
+       (out[2].cell != 2) || (out[2].dots != 2) ||
+       !(out[2].letter == GlyphMapping("ba")) || decoder.glyphUnderway())
+      throw std::string("word missing or wrong");
+    std::cerr << "concurrent cells: OK" << std::endl;
+  }
+
+  // Throughput benchmark on a long simulated session
+  const Recording bench = simulateSession(12345, 5000);
+  const unsigned int reps = 100;
+  std::cerr << "Throughput, all events:     reference "
+	    << throughput<ReferenceDecoder>(bench, everything, reps)
+	    << " events/s, single-pass "
+	    << throughput<IOEventDecoder>(bench, everything, reps)
+	    << " events/s" << std::endl;
+  std::cerr << "Throughput, letters only:   reference "
+	    << throughput<ReferenceDecoder>(bench, letters, reps)
+	    << " events/s, single-pass "
+	    << throughput<IOEventDecoder>(bench, letters, reps)
+	    << " events/s" << std::endl;
+
+  return 0;
+}
+
+int main(int argc, char **argv)
+{
+  try { return fakemain(argc, argv); }
+  catch(const BTException &e) {
+    std::cerr << "BTException: " << e.why << std::endl;
+    return -1;
+  }
+  catch(const std::string &s) {
+    std::cerr << "String exception: " << s << std::endl;
+    return -1;
+  }
+  catch(...) {
+    std::cerr << "Some other exception happened" << std::endl;
+    return -1;
+  }
+
+  return 0;
+}
@@ -0,0 +1,273 @@
+#include "Types.h"
+#include "StylusNoiseProfile.h"
+#include "ShortStylusSuppressor.h"
+
+#include <deque>
+#include <cstdio>
+#include <string>
+#include <sstream>
+#include <iostream>
+
+using namespace BrailleTutorNS;
+
+// Checks and benchmark for the short stylus filter and its per-hole noise
+// profile. Stylus events are fed to a ShortStylusFilter in batches as they
+// might arrive, on time or late, and what comes out (and when) is checked;
+// then a profile is learned, saved and loaded back, to a string and to a
+// file, and malformed profiles must be turned away.
+//
+// Usage: test_stylus_noise [scratch file]
+// The scratch file (test_stylus_noise.tmp by default) is removed afterward.
+
+//! Results are stored here so the optimizer can't drop the benchmark loop
+volatile unsigned long sink;
+
+//! Report a failed check
+static unsigned int check(const bool &ok, const std::string &what)
+{
+  if(!ok) std::cerr << "FAILED: " << what << std::endl;
+  return ok ? 0 : 1;
+}
+
+//! True if two times are within a microsecond
+static bool near_enough(const TimeInterval &a, const TimeInterval &b)
+{
+  const TimeInterval gap = (a < b) ? b - a : a - b;
+  return gap < TimeInterval(0.000001);
+}
+
+//! True if events holds exactly one event, of type type at time when
+static bool only(const std::deque<BaseIOEvent> &events,
+		 const BaseIOEvent::Type &type, const TimeInterval &when)
+{
+  return (events.size() == 1) && (events[0].type == type) &&
+	 (events[0].timestamp == when);
+}
+
+//! Filter a DOWN at down and an UP at up in cell, dot, arriving together
+//! at time now; returns what comes out right away
+static std::deque<BaseIOEvent> contact(ShortStylusFilter &ssf,
+				       const unsigned short int &cell,
+				       const unsigned char &dot,
+				       const TimeInterval &down,
+				       const TimeInterval &up,
+				       const TimeInterval &now)
+{
+  std::deque<BaseIOEvent> events;
+  events.push_back(BaseIOEvent::makeStylusDownEvent(down, cell, dot));
+  events.push_back(BaseIOEvent::makeStylusUpEvent(up, cell, dot));
+  ssf.filter(events, now);
+  return events;
+}
+
+//! True if two profiles have the same statistics in every hole
+static bool same_stats(const StylusNoiseProfile &a, const StylusNoiseProfile &b)
+{
+  for(unsigned short int c=0; c<StylusNoiseProfile::NUM_CELLS; ++c)
+    for(unsigned char d=0; d<StylusNoiseProfile::DOTS_PER_CELL; ++d) {
+      const StylusNoiseProfile::HoleStats &ha = a.stats(c, d), &hb = b.stats(c, d);
+      if((ha.contacts != hb.contacts) || (ha.shorts != hb.shorts) ||
+	 (ha.bounces != hb.bounces) || (ha.ceiling != hb.ceiling)) return false;
+    }
+  return true;
+}
+
+int fakemain(int argc, char **argv)
+{
+  unsigned int failures = 0;
+  const std::string scratch = (argc > 1) ? argv[1] : "test_stylus_noise.tmp";
+
+  // A fixed threshold
+  {
+    ShortStylusFilter ssf(0.3);
+    TimeInterval deadline;
+
+    // A bounce: DOWN and UP 0.1 s apart cancel out
+    std::deque<BaseIOEvent> out =
+      contact(ssf, 2, 0, TimeInterval(10.0), TimeInterval(10.1),
+	      TimeInterval(10.1));
+    failures += check(out.empty(), "nothing comes out of a bounce at once");
+    failures += check(!ssf.nextDeadline(deadline), "a bounce is dropped");
+    ssf.expire(out, TimeInterval(11.0));
+    failures += check(out.empty(), "nothing comes out of a bounce later");
+
+    // The same bounce arriving late is still a bounce
+    out = contact(ssf, 2, 0, TimeInterval(20.0), TimeInterval(20.1),
+		  TimeInterval(21.0));
+    failures += check(out.empty(), "a late bounce is dropped");
+
+    // A real contact arriving late, both events together: the DOWN must
+    // come out (it's long past its threshold) and the UP after it
+    out = contact(ssf, 2, 0, TimeInterval(30.0), TimeInterval(30.5),
+		  TimeInterval(30.6));
+    failures += check(only(out, BaseIOEvent::STYLUS_DOWN, TimeInterval(30.0)),
+		      "a late contact's DOWN is released");
+    failures += check(ssf.nextDeadline(deadline) &&
+		      near_enough(deadline, TimeInterval(30.8)),
+		      "a late contact's UP is held for the threshold");
+    out.clear();
+    ssf.expire(out, deadline);
+    failures += check(only(out, BaseIOEvent::STYLUS_UP, TimeInterval(30.5)),
+		      "a late contact's UP is released in its turn");
+
+    // Arriving later still, both come out at once, in order
+    out = contact(ssf, 2, 0, TimeInterval(40.0), TimeInterval(40.5),
+		  TimeInterval(45.0));
+    failures += check((out.size() == 2) &&
+		      (out[0].type == BaseIOEvent::STYLUS_DOWN) &&
+		      (out[1].type == BaseIOEvent::STYLUS_UP),
+		      "a very late contact comes out whole");
+
+    // A contact, then a bounce on withdrawal: the bounce alone is dropped,
+    // leaving the stylus in
+    out.clear();
+    out.push_back(BaseIOEvent::makeStylusDownEvent(TimeInterval(50.0), 3, 1));
+    out.push_back(BaseIOEvent::makeStylusUpEvent(TimeInterval(50.5), 3, 1));
+    out.push_back(BaseIOEvent::makeStylusDownEvent(TimeInterval(50.55), 3, 1));
+    ssf.filter(out, TimeInterval(51.0));
+    failures += check(only(out, BaseIOEvent::STYLUS_DOWN, TimeInterval(50.0)),
+		      "a bounce after a late contact is dropped");
+    failures += check(!ssf.nextDeadline(deadline), "nothing else is held");
+
+    // Other events go straight through
+    out.clear();
+    out.push_back(BaseIOEvent::makeButtonDownEvent(TimeInterval(60.0), 0));
+    ssf.filter(out, TimeInterval(60.0));
+    failures += check(only(out, BaseIOEvent::BUTTON_DOWN, TimeInterval(60.0)),
+		      "button events aren't held");
+  }
+
+  // Adaptive thresholds: a clean hole's falls to the minimum, a bouncy
+  // hole's to its noise times the margin, an untried hole's stays high
+  StylusNoiseProfile learned(0.03, 0.3);
+  {
+    ShortStylusFilter ssf(0.3);
+    failures += check(ssf.profile() == NULL, "fixed threshold has no profile");
+    ssf.setAdaptiveThreshold(TimeInterval(0.03), TimeInterval(0.3));
+    failures += check(ssf.profile() != NULL, "adaptive threshold has a profile");
+
+    TimeInterval t(100.0);
+    for(unsigned int i=0; i<StylusNoiseProfile::MIN_SAMPLES; ++i) {
+      contact(ssf, 0, 0, t, t + TimeInterval(0.5), t + TimeInterval(0.5));
+      contact(ssf, 1, 0, t, t + TimeInterval(0.1), t + TimeInterval(0.1));
+      t = t + TimeInterval(1.0);
+    }
+    const StylusNoiseProfile &snp = *ssf.profile();
+    failures += check(near_enough(snp.threshold(0, 0), TimeInterval(0.03)),
+		      "a clean hole's threshold falls to the minimum");
+    failures += check(near_enough(snp.threshold(1, 0), TimeInterval(0.15)),
+		      "a bouncy hole's threshold is its noise times the margin");
+    failures += check(snp.threshold(2, 0) == TimeInterval(0.3),
+		      "an untried hole's threshold stays at the maximum");
+    failures += check((snp.stats(1, 0).contacts == 4) &&
+		      (snp.stats(1, 0).shorts == 4), "bounces are counted");
+
+    // Once the last withdrawals are out, an insertion in the clean hole
+    // gets through well before 0.3 s
+    std::deque<BaseIOEvent> out;
+    ssf.expire(out, t);
+    out.assign(1, BaseIOEvent::makeStylusDownEvent(t, 0, 0));
+    ssf.filter(out, t + TimeInterval(0.05));
+    failures += check(only(out, BaseIOEvent::STYLUS_DOWN, t),
+		      "a clean hole releases sooner");
+
+    ssf.setThreshold(TimeInterval(0.3));
+    failures += check(ssf.profile() == NULL, "setThreshold() stops adapting");
+
+    // Keep a profile with some noise in it for the save and load checks
+    for(unsigned int i=0; i<20; ++i) {
+      const unsigned short int cell = (i * 7) % StylusNoiseProfile::NUM_CELLS;
+      const TimeInterval held(0.01 * (i % 9) + 0.013);
+      learned.observe(BaseIOEvent::makeStylusDownEvent(t, cell, i % 6));
+      learned.observe(BaseIOEvent::makeStylusUpEvent(t + held, cell, i % 6));
+      t = t + TimeInterval(0.7);
+    }
+  }
+
+  // Saving and loading
+  {
+    std::stringstream saved;
+    learned.write(saved);
+    StylusNoiseProfile loaded(0.03, 0.3);
+    loaded.read(saved);
+    failures += check(same_stats(learned, loaded), "profile round trip");
+
+    learned.write(scratch);
+    StylusNoiseProfile from_file(0.03, 0.3);
+    from_file.read(scratch);
+    std::remove(scratch.c_str());
+    failures += check(same_stats(learned, from_file),
+		      "profile round trip through a file");
+
+    // Malformed profiles are turned away, leaving the profile as it was
+    const char *bad[] = {
+      "",
+      "!STYLUS NOISE PROFILE 2\n!END\n",
+      "!STYLUS NOISE PROFILE 1\n0 0 4 0 0 0.01\n",
+      "!STYLUS NOISE PROFILE 1\n0 0 4 0\n!END\n",
+      "!STYLUS NOISE PROFILE 1\n32 0 4 0 0 0.01\n!END\n",
+      "!STYLUS NOISE PROFILE 1\n0 8 4 0 0 0.01\n!END\n",
+      "!STYLUS NOISE PROFILE 1\n0 0 4 0 0 -0.01\n!END\n",
+    };
+    unsigned int rejected = 0;
+    for(unsigned int b=0; b<sizeof(bad)/sizeof(bad[0]); ++b) {
+      std::istringstream in(bad[b]);
+      try { loaded.read(in); }
+      catch(const BTException &e) {
+	if(e.type == BTException::BT_EINVAL) ++rejected;
+      }
+    }
+    failures += check(rejected == sizeof(bad)/sizeof(bad[0]),
+		      "malformed profiles rejected");
+    failures += check(same_stats(learned, loaded),
+		      "a rejected profile changes nothing");
+
+    unsigned int missing = 0;
+    try { loaded.read(scratch); }
+    catch(const BTException &e) {
+      if(e.type == BTException::BT_EIO) ++missing;
+    }
+    failures += check(missing == 1, "a missing file is an I/O error");
+  }
+
+  if(failures > 0) {
+    std::cerr << failures << " check(s) FAILED" << std::endl;
+    return 1;
+  }
+  std::cout << "checks: OK" << std::endl;
+
+  // Benchmark: filtering a contact, with the threshold adapting
+  ShortStylusFilter ssf(0.3);
+  ssf.setAdaptiveThreshold(TimeInterval(0.03), TimeInterval(0.3));
+  const unsigned long contacts = 1000000;
+  unsigned long released = 0;
+  TimeInterval t(1000.0);
+  const TimeInterval start = TimeInterval::now();
+  for(unsigned long c=0; c<contacts; ++c) {
+    const TimeInterval held(0, 20 + (c * 7919) % 400);
+    released += contact(ssf, c % 16, c % 6, t, t + held, t + held).size();
+    t = t + TimeInterval(0.5);
+  }
+  const double secs = (double) (TimeInterval::now() - start);
+  sink = released;
+
+  std::cout << "filter(), per contact: " << secs / contacts * 1e9 << " ns"
+	    << std::endl;
+
+  return 0;
+}
+
+int main(int argc, char **argv)
+{
+  try { return fakemain(argc, argv); }
+  catch(const BTException &e) {
+    std::cerr << "BTException: " << e.why << std::endl;
+    return -1;
+  }
+  catch(...) {
+    std::cerr << "Some other exception happened" << std::endl;
+    return -1;
+  }
+
+  return 0;
+}
@@ -68,7 +68,7 @@ bool just_erased; // FIXME
     // exactly 32 cells.
     if(events.front().type == IOEvent::CELL_LETTER) {
       char letter_chr[2];
-      letter_chr[0] = (char) events.front().letter.str[0];
+      letter_chr[0] = (char) events.front().letter.str()[0];
       letter_chr[1] = '\0';
       std::string letter = letter_chr;
 if(just_erased) { just_erased = false; } else // FIXME
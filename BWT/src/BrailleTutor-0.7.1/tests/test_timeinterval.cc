@@ -0,0 +1,173 @@
+#include "Types.h"
+
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+
+#include <sys/time.h>
+
+using namespace BrailleTutorNS;
+
+// Checks and timestamp benchmark for the integer-nanosecond TimeInterval.
+// The legacy class below is the seconds-plus-milliseconds TimeInterval from
+// before, with arithmetic that round-trips through double and a now() built
+// on gettimeofday(). The benchmark times now() and a typical mix of
+// timestamp arithmetic (deadline computation and comparison) for both.
+//
+// Usage: test_timeinterval [iterations]
+
+//! The old TimeInterval, for reference
+struct LegacyTimeInterval {
+  unsigned int secs;
+  unsigned short int msecs;
+
+  inline operator double() const
+  { return ((double) secs) + ((double) msecs) / 1000.0; }
+
+  inline LegacyTimeInterval() : secs(0), msecs(0) { }
+
+  inline LegacyTimeInterval(const unsigned int &my_secs,
+			    const unsigned short int &my_msecs)
+  : secs(my_secs + my_msecs / 1000), msecs(my_msecs % 1000) { }
+
+  inline LegacyTimeInterval(const double &my_secs)
+  : secs((unsigned int) floor(my_secs)),
+    msecs((unsigned short int) rint(1000.0* (my_secs - (double) secs))) { }
+
+  static LegacyTimeInterval now()
+  {
+    static const time_t epoch = time(NULL);
+    struct timeval tval;
+    gettimeofday(&tval, NULL);
+    return LegacyTimeInterval((unsigned int) (tval.tv_sec - epoch),
+			      (unsigned short int) (tval.tv_usec / 1000));
+  }
+};
+
+inline LegacyTimeInterval operator+(const LegacyTimeInterval &a,
+				    const LegacyTimeInterval &b)
+{ return LegacyTimeInterval( ((double) a) + ((double) b) ); }
+inline LegacyTimeInterval operator-(const LegacyTimeInterval &a,
+				    const LegacyTimeInterval &b)
+{ return LegacyTimeInterval( ((double) a) - ((double) b) ); }
+inline bool operator<=(const LegacyTimeInterval &a,
+		       const LegacyTimeInterval &b)
+{ return ((double) a) <= ((double) b); }
+
+//! Results are stored here so the optimizer can't drop the benchmark loops
+volatile double sink;
+
+//! Report a failed check
+static unsigned int check(const bool &ok, const char *what)
+{
+  if(!ok) std::cerr << "FAILED: " << what << std::endl;
+  return ok ? 0 : 1;
+}
+
+//! Seconds per call of now(), for either TimeInterval class
+template <typename Interval>
+double nowCost(const unsigned long &iters)
+{
+  const TimeInterval start = TimeInterval::now();
+  for(unsigned long i=0; i<iters; ++i) sink = (double) Interval::now();
+  return ((double) (TimeInterval::now() - start)) / iters;
+}
+
+//! Seconds per round of timestamp arithmetic, for either TimeInterval class
+
+//! Each round does what the event pipeline does per event: adds a delay
+//! to a timestamp to get a deadline, compares it with the time, and
+//! measures the time left.
+template <typename Interval>
+double arithmeticCost(const unsigned long &iters)
+{
+  const Interval delay(0, 300);
+  const Interval step(0, 7);
+  Interval stamp(1, 0), now(1, 250), left;
+  unsigned long due = 0;
+
+  const TimeInterval start = TimeInterval::now();
+  for(unsigned long i=0; i<iters; ++i) {
+    const Interval deadline = stamp + delay;
+    if(deadline <= now) ++due;
+    else left = deadline - now;
+    stamp = stamp + step;
+    now = now + step;
+  }
+  const double secs = (double) (TimeInterval::now() - start);
+  sink = due + (double) left;
+  return secs / iters;
+}
+
+int fakemain(int argc, char **argv)
+{
+  unsigned int failures = 0;
+
+  // Construction and conversion
+  failures += check(TimeInterval(1, 500).nsecs == 1500000000LL,
+		    "seconds/milliseconds constructor");
+  failures += check(TimeInterval(0.25).nsecs == 250000000LL,
+		    "double constructor");
+  failures += check((double) TimeInterval(2, 125) == 2.125,
+		    "conversion to double");
+  failures += check(TimeInterval(HUGE_VAL).nsecs == TimeInterval::LIMIT_NSECS,
+		    "infinity clamps");
+
+  // Integer arithmetic is exact where the double round trip wasn't
+  TimeInterval sum;
+  for(unsigned int i=0; i<1000000; ++i) sum = sum + TimeInterval(0, 1);
+  failures += check(sum.nsecs == 1000LL * TimeInterval::NSECS_PER_SEC,
+		    "repeated addition is exact");
+  failures += check((TimeInterval(1, 0) - TimeInterval(2, 500)).nsecs ==
+		    -1500000000LL, "negative differences");
+  failures += check((TimeInterval(3, 0) * TimeInterval(0, 500)).nsecs ==
+		    1500000000LL, "multiplication");
+  failures += check((TimeInterval(1, 500) * TimeInterval(1, 500)).nsecs ==
+		    2250000000LL, "multiplication of fractions");
+  failures += check(TimeInterval::fromNsecs(1) > TimeInterval(),
+		    "nanosecond resolution");
+
+  // The clock mustn't go backwards
+  TimeInterval last = TimeInterval::now();
+  bool monotonic = true;
+  for(unsigned int i=0; i<100000; ++i) {
+    const TimeInterval t = TimeInterval::now();
+    if(t < last) monotonic = false;
+    last = t;
+  }
+  failures += check(monotonic, "now() is monotonic");
+
+  if(failures > 0) {
+    std::cerr << failures << " check(s) FAILED" << std::endl;
+    return 1;
+  }
+  std::cout << "checks: OK" << std::endl;
+
+  // Benchmark
+  const unsigned long iters = (argc > 1) ? std::atol(argv[1]) : 10000000;
+  std::cout << "now():      legacy "
+	    << nowCost<LegacyTimeInterval>(iters) * 1e9 << " ns/call, "
+	    << "integer " << nowCost<TimeInterval>(iters) * 1e9 << " ns/call"
+	    << std::endl;
+  std::cout << "arithmetic: legacy "
+	    << arithmeticCost<LegacyTimeInterval>(iters) * 1e9 << " ns/round, "
+	    << "integer " << arithmeticCost<TimeInterval>(iters) * 1e9
+	    << " ns/round" << std::endl;
+
+  return 0;
+}
+
+int main(int argc, char **argv)
+{
+  try { return fakemain(argc, argv); }
+  catch(const BTException &e) {
+    std::cerr << "BTException: " << e.why << std::endl;
+    return -1;
+  }
+  catch(...) {
+    std::cerr << "Some other exception happened" << std::endl;
+    return -1;
+  }
+
+  return 0;
+}
@@ -0,0 +1,210 @@
+#include "Dots.h"
+#include "Types.h"
+#include "Charset.h"
+#include "IOEvent.h"
+#include "Translator.h"
+
+#include <deque>
+#include <string>
+#include <vector>
+#include <cstdlib>
+#include <sstream>
+#include <iostream>
+
+using namespace BrailleTutorNS;
+
+// Checks and benchmark for TranslationTable and BackTranslator. Cell
+// sequences are back-translated one cell at a time and the glyphs put out
+// are compared with what's expected; then random cell streams are timed.
+//
+// Usage: test_translator [cell rule file]
+// With a rule file (e.g. language_mapping_files/english_contractions.cells),
+// its rules are added to the default charset's for the benchmark.
+
+//! Results are stored here so the optimizer can't drop the benchmark loop
+volatile unsigned long sink;
+
+//! Report a failed check
+static unsigned int check(const bool &ok, const std::string &what)
+{
+  if(!ok) std::cerr << "FAILED: " << what << std::endl;
+  return ok ? 0 : 1;
+}
+
+//! True if two TimeIntervals are equal
+static bool same(const TimeInterval &a, const TimeInterval &b)
+{ return (a <= b) && (a >= b); }
+
+//! Cells from a rule-file-style spec, e.g. "5-145"
+std::vector<unsigned char> cells(const std::string &spec)
+{
+  std::vector<unsigned char> c(1, 0);
+  for(unsigned int i=0; i<spec.size(); ++i) {
+    if(spec[i] == '-') c.push_back(0);
+    else c.back() |= 1 << (spec[i] - '1');
+  }
+  return c;
+}
+
+//! Back-translate cells, flushing at the end, and join the glyphs with
+//! spaces (untranslated cells show as ?)
+std::string translate(const TranslationTable &table,
+		      const std::vector<unsigned char> &input)
+{
+  BackTranslator bt(table);
+  std::vector<GlyphMapping> out;
+  for(unsigned int i=0; i<input.size(); ++i) bt.push(input[i], out);
+  bt.flush(out);
+
+  std::string joined;
+  for(unsigned int i=0; i<out.size(); ++i) {
+    if(i > 0) joined += ' ';
+    joined += out[i].isEmpty() ? std::string("?") : std::string(out[i]);
+  }
+  return joined;
+}
+
+int fakemain(int argc, char **argv)
+{
+  unsigned int failures = 0;
+  const Charset &def = Charset::defaultCharset();
+
+  std::istringstream rules("!UTF-8 BEGIN test rules\n"
+			   "# a comment\n"
+			   "5-145\tDAY\n"
+			   "5-1345\tNAME\n"
+			   "5-1345-1\tNAMEA\n"
+			   "56-1345\tTION\n"
+			   "1235-5\tRU\n"
+			   "12-x\tbad\n"
+			   "9 bad\n"
+			   "1-\tbad\n"
+			   "!UTF-8 END\n");
+  TranslationTable table(def);
+  const std::vector<unsigned int> errors = table.read(rules);
+  failures += check((errors.size() == 3) && (errors[0] == 8) &&
+		    (errors[2] == 10), "bad rule lines are reported");
+  failures += check(table.size() == def.size() + 5, "rule count");
+  failures += check(table.maxCells() == 3, "longest rule");
+
+  // One-cell rules come from the charset
+  failures += check(translate(table, cells("1-12-14")) == "A B C",
+		    "letters translate one cell at a time");
+  // Longest match wins, and waits for the cells that could extend it
+  failures += check(translate(table, cells("5-145-1")) == "DAY A",
+		    "two-cell rule");
+  failures += check(translate(table, cells("5-1345-1-1")) == "NAMEA A",
+		    "longest rule wins");
+  failures += check(translate(table, cells("5-1345-12")) == "NAME B",
+		    "falls back on a shorter rule");
+  // 56 is a one-cell rule of its own ("-") as well as a prefix
+  failures += check(translate(table, cells("56-1345-56-1")) == "TION - A",
+		    "prefix that is a glyph too");
+  // A cell starting no rule is put out empty; a bare prefix too
+  failures += check(translate(table, cells("5-1-5")) == "? A ?",
+		    "untranslatable cells");
+  // A rule can shadow the one-cell reading of its first cell (R)
+  failures += check(translate(table, cells("1235-5-1235-1")) == "RU R A",
+		    "rule starting with a letter");
+
+  // Glyphs are put out as soon as they're certain
+  {
+    BackTranslator bt(table);
+    std::vector<GlyphMapping> out;
+    bt.push(cells("1")[0], out);
+    const bool a_now = (out.size() == 1) && (bt.pending() == 0);
+    bt.push(cells("5")[0], out);
+    bt.push(cells("1345")[0], out);
+    const bool held = (out.size() == 1) && (bt.pending() == 2);
+    bt.push(cells("1")[0], out);
+    failures += check(a_now && held && (out.size() == 2) &&
+		      (std::string(out[1]) == "NAMEA") && (bt.pending() == 0),
+		      "streaming holds only undecided cells");
+  }
+
+  // Forward lookups: rules added later decide how a glyph is written
+  failures += check(table.cellsFor(GlyphMapping("NAME")) == cells("5-1345"),
+		    "cells for a multi-cell glyph");
+  failures += check(table.cellsFor(GlyphMapping("A")) == cells("1"),
+		    "cells for a letter");
+  failures += check(table.isMultiCell(GlyphMapping("RU")) &&
+		    !table.isMultiCell(GlyphMapping("R")), "isMultiCell");
+  table.add(cells("4-1"), GlyphMapping("A"));
+  failures += check(table.cellsFor(GlyphMapping("A")) == cells("4-1"),
+		    "a later rule for a glyph is used");
+  table.add(cells("4-1"), GlyphMapping());
+  failures += check((table.cellsFor(GlyphMapping("A")) == cells("1")) &&
+		    (translate(table, cells("4-1")) == "? A"),
+		    "removing a rule falls back on the glyph's other rule");
+
+  // CELL_DOTS events come out as CELL_LETTER events spanning their cells
+  {
+    BackTranslator bt(table);
+    std::deque<IOEvent> out;
+    const std::vector<unsigned char> in = cells("5-145-12");
+    for(unsigned int i=0; i<in.size(); ++i)
+      bt.push(IOEvent::makeCellDotsEvent(TimeInterval(i, 0),
+					 TimeInterval(0, 500),
+					 i, in[i]), out);
+    bt.push(IOEvent::makeCellStartEvent(TimeInterval(9, 0), 3), out);
+    bt.flush(out);
+    failures += check((out.size() == 2) &&
+		      (out[0].type == IOEvent::CELL_LETTER) &&
+		      (std::string(out[0].letter) == "DAY") &&
+		      (out[0].cell == 1) &&
+		      same(out[0].timestamp, TimeInterval(0, 0)) &&
+		      same(out[0].duration, TimeInterval(1, 500)) &&
+		      (std::string(out[1].letter) == "B"), "IOEvents");
+  }
+
+  if(failures > 0) {
+    std::cerr << failures << " check(s) FAILED" << std::endl;
+    return 1;
+  }
+  std::cout << "checks: OK" << std::endl;
+
+  // Benchmark: random streams of the cells that start rules
+  TranslationTable bench_table(def);
+  if(argc > 1) bench_table.read(argv[1]);
+  else { std::istringstream again(rules.str()); bench_table.read(again); }
+
+  std::vector<unsigned char> starts;
+  for(unsigned int p=0; p<256; ++p)
+    if(bench_table.next(TranslationTable::ROOT, p) != TranslationTable::NO_STATE)
+      starts.push_back(p);
+  srand(1);
+  std::vector<unsigned char> stream(1000000);
+  for(unsigned int i=0; i<stream.size(); ++i)
+    stream[i] = starts[rand() % starts.size()];
+
+  BackTranslator bt(bench_table);
+  std::vector<GlyphMapping> out;
+  out.reserve(stream.size());
+  const TimeInterval start = TimeInterval::now();
+  for(unsigned int i=0; i<stream.size(); ++i) bt.push(stream[i], out);
+  bt.flush(out);
+  const double secs = (double) (TimeInterval::now() - start);
+  sink = out.size();
+
+  std::cout << bench_table.size() << " rules, up to "
+	    << bench_table.maxCells() << " cells: " << out.size()
+	    << " glyphs from " << stream.size() << " cells, "
+	    << secs / stream.size() * 1e9 << " ns/cell" << std::endl;
+
+  return 0;
+}
+
+int main(int argc, char **argv)
+{
+  try { return fakemain(argc, argv); }
+  catch(const BTException &e) {
+    std::cerr << "BTException: " << e.why << std::endl;
+    return -1;
+  }
+  catch(...) {
+    std::cerr << "Some other exception happened" << std::endl;
+    return -1;
+  }
+
+  return 0;
+}
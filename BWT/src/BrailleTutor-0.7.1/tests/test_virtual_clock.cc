@@ -0,0 +1,250 @@
+#include "Types.h"
+#include "Clock.h"
+#include "IOEvent.h"
+#include "TimerService.h"
+#include "ShortStylusSuppressor.h"
+
+#include <deque>
+#include <vector>
+#include <string>
+#include <cstdlib>
+#include <sstream>
+#include <iostream>
+
+using namespace BrailleTutorNS;
+
+// Replays a long simulated writing session through an inline
+// ShortStylusSuppressor and IOEventParser sharing a TimerService on a
+// VirtualClock. The session's raw events, including the short spurious
+// contacts the suppressor should drop, are handed over at their virtual
+// times, with the clock advanced between them so that suppressor
+// thresholds and glyph delays run out exactly when they would have. The
+// session is replayed twice and the two IOEvent streams must be identical,
+// down to the nanosecond timestamps; the time each replay took on the real
+// clock is reported next to the time it simulates. Last, a handler that
+// calls back into the parser, feeding it a button press, must get that
+// press's events after the ones it was handling, without deadlocking.
+//
+// Usage: test_virtual_clock [session minutes]
+
+//! A raw event, and whether it's noise the suppressor should drop
+struct RawEvent {
+  BaseIOEvent event;
+  bool noise;
+  RawEvent(const BaseIOEvent &my_event, const bool &my_noise)
+  : event(my_event), noise(my_noise) { }
+};
+
+//! Simulate a student writing letters into the Tutor's cells for minutes
+std::vector<RawEvent> simulateSession(const unsigned int &seed,
+				      const unsigned int &minutes)
+{
+  srand(seed);
+  std::vector<RawEvent> session;
+  const TimeInterval end(60 * minutes, 0);
+  TimeInterval t(1, 0);
+
+  while(t < end) {
+    // A glyph: a few dots in one cell, each held for a while
+    const unsigned short int cell = rand() % 16;
+    const unsigned int ndots = 1 + rand() % 4;
+    for(unsigned int d=0; d<ndots; ++d) {
+      const unsigned char dot = rand() % 6;
+      t = t + TimeInterval(0, 100 + rand() % 300);
+
+      // Now and then the stylus bounces going in
+      if((rand() % 6) == 0) {
+	session.push_back(RawEvent(
+	  BaseIOEvent::makeStylusDownEvent(t, cell, dot), true));
+	t = t + TimeInterval(0, 5 + rand() % 20);
+	session.push_back(RawEvent(
+	  BaseIOEvent::makeStylusUpEvent(t, cell, dot), true));
+	t = t + TimeInterval(0, 5 + rand() % 20);
+      }
+
+      session.push_back(RawEvent(
+	BaseIOEvent::makeStylusDownEvent(t, cell, dot), false));
+      t = t + TimeInterval(0, 250 + rand() % 400);
+      session.push_back(RawEvent(
+	BaseIOEvent::makeStylusUpEvent(t, cell, dot), false));
+    }
+
+    // Pause before the next glyph, sometimes long enough to think
+    t = t + TimeInterval(0, 500 + rand() % 2000);
+    if((rand() % 10) == 0) t = t + TimeInterval(5 + rand() % 20, 0);
+  }
+
+  return session;
+}
+
+//! Writes down every IOEvent it's handed, one per line
+struct EventRecorder : public IOEventHandler {
+  std::ostringstream out;
+  unsigned long events;
+  unsigned long letters;
+
+  EventRecorder() : events(0), letters(0) { }
+
+  virtual void operator()(std::deque<IOEvent> &events_in)
+  {
+    std::deque<IOEvent>::const_iterator e_iter;
+    for(e_iter=events_in.begin(); e_iter!=events_in.end(); ++e_iter) {
+      out << e_iter->type << ' ' << e_iter->cell << ' '
+	  << (unsigned int) e_iter->dots << ' '
+	  << e_iter->timestamp.nsecs << ' ' << e_iter->duration.nsecs << ' '
+	  << (const char *) e_iter->letter.str() << '\n';
+      ++events;
+      if(e_iter->type == IOEvent::CELL_LETTER) ++letters;
+    }
+    events_in.clear();
+  }
+};
+
+//! Feeds a button press back into its parser the first time it's handed a
+//! stylus event, as an app reacting to input might; notes the event types
+struct ReentrantHandler : public IOEventHandler {
+  IOEventParser &iep;
+  std::vector<int> types;
+  bool fed;
+
+  ReentrantHandler(IOEventParser &my_iep) : iep(my_iep), fed(false) { }
+
+  virtual void operator()(std::deque<IOEvent> &events_in)
+  {
+    std::deque<IOEvent>::const_iterator e_iter;
+    for(e_iter=events_in.begin(); e_iter!=events_in.end(); ++e_iter) {
+      types.push_back(e_iter->type);
+      if(fed || (e_iter->type != IOEvent::STYLUS)) continue;
+      fed = true;
+      iep.setConcurrentCells(false);
+      std::deque<BaseIOEvent> press;
+      press.push_back(BaseIOEvent::makeButtonDownEvent(e_iter->timestamp, 1));
+      press.push_back(BaseIOEvent::makeButtonUpEvent(
+			e_iter->timestamp + TimeInterval(0, 50), 1));
+      iep(press);
+    }
+    events_in.clear();
+  }
+};
+
+//! Replay session on a fresh virtual clock; returns the real seconds taken
+double replay(const std::vector<RawEvent> &session, EventRecorder &recorder)
+{
+  const TimeInterval start = TimeInterval::now();
+
+  VirtualClock clock;
+  {
+    TimerService timers(clock);
+    IOEventParser iep(timers);
+    ShortStylusSuppressor sss(timers, TimeInterval(0, 100));
+    iep.setIOEventHandler(recorder);
+    iep.wantEvent(IOEvent::STYLUS);
+    iep.wantEvent(IOEvent::CELL_LETTER);
+    sss.setBaseIOEventHandler(iep);
+
+    std::vector<RawEvent>::const_iterator r_iter;
+    for(r_iter=session.begin(); r_iter!=session.end(); ++r_iter) {
+      clock.advanceTo(r_iter->event.timestamp);
+      std::deque<BaseIOEvent> batch(1, r_iter->event);
+      sss(batch);
+    }
+
+    // Let the last glyph run out
+    clock.advance(TimeInterval(60, 0));
+  }
+
+  return (double) (TimeInterval::now() - start);
+}
+
+//! Report a failed check
+static unsigned int check(const bool &ok, const char *what)
+{
+  if(!ok) std::cerr << "FAILED: " << what << std::endl;
+  return ok ? 0 : 1;
+}
+
+int fakemain(int argc, char **argv)
+{
+  const unsigned int minutes = (argc > 1) ? std::atoi(argv[1]) : 30;
+  const std::vector<RawEvent> session = simulateSession(42, minutes);
+
+  unsigned long real_contacts = 0;
+  std::vector<RawEvent>::const_iterator r_iter;
+  for(r_iter=session.begin(); r_iter!=session.end(); ++r_iter)
+    if(!r_iter->noise && (r_iter->event.type == BaseIOEvent::STYLUS_UP))
+      ++real_contacts;
+
+  EventRecorder first, second;
+  const double first_secs = replay(session, first);
+  const double second_secs = replay(session, second);
+
+  // Count the complete stylus events that made it through the suppressor
+  unsigned long stylus_events = 0;
+  std::istringstream lines(first.out.str());
+  std::string line;
+  while(std::getline(lines, line)) {
+    std::istringstream fields(line);
+    int type;
+    if((fields >> type) && (type == IOEvent::STYLUS)) ++stylus_events;
+  }
+
+  // A handler feeding events back in
+  std::vector<int> reentrant_types;
+  {
+    VirtualClock clock;
+    TimerService timers(clock);
+    IOEventParser iep(timers);
+    ReentrantHandler handler(iep);
+    iep.setIOEventHandler(handler);
+    iep.wantEvent(IOEvent::STYLUS);
+    iep.wantEvent(IOEvent::BUTTON);
+    std::deque<BaseIOEvent> contact;
+    contact.push_back(BaseIOEvent::makeStylusDownEvent(TimeInterval(1, 0),
+						       0, 0));
+    contact.push_back(BaseIOEvent::makeStylusUpEvent(TimeInterval(1, 200),
+						     0, 0));
+    iep(contact);
+    clock.advance(TimeInterval(60, 0));
+    reentrant_types = handler.types;
+  }
+
+  unsigned int failures = 0;
+  failures += check((reentrant_types.size() == 2) &&
+		    (reentrant_types[0] == IOEvent::STYLUS) &&
+		    (reentrant_types[1] == IOEvent::BUTTON),
+		    "a handler can feed events back to its parser");
+  failures += check(first.events > 0, "the replay produced events");
+  failures += check(first.letters > 0, "the replay produced letters");
+  failures += check(stylus_events == real_contacts,
+		    "noise suppressed, real contacts passed");
+  failures += check(first.out.str() == second.out.str(),
+		    "replays are identical");
+
+  std::cout << minutes << " simulated minutes, " << session.size()
+	    << " raw events, " << first.events << " IOEvents ("
+	    << first.letters << " letters)" << std::endl;
+  std::cout << "replay took " << first_secs * 1000.0 << " ms, then "
+	    << second_secs * 1000.0 << " ms" << std::endl;
+
+  if(failures > 0) {
+    std::cerr << failures << " check(s) FAILED" << std::endl;
+    return 1;
+  }
+  std::cout << "checks: OK" << std::endl;
+  return 0;
+}
+
+int main(int argc, char **argv)
+{
+  try { return fakemain(argc, argv); }
+  catch(const BTException &e) {
+    std::cerr << "BTException: " << e.why << std::endl;
+    return -1;
+  }
+  catch(...) {
+    std::cerr << "Some other exception happened" << std::endl;
+    return -1;
+  }
+
+  return 0;
+}
@@ -0,0 +1,85 @@
+/*
+ * Braille Tutor interface library
+ * compile_charset.cc, started 19 October 2026
+ *
+ * Compiles a text language mapping file into the binary charset format
+ * that Charset::readCompiled() loads (see lib/CharsetImage.cc). The build
+ * runs this over language_mapping_files/ so the images never go stale; the
+ * text files remain the ones to edit.
+ *
+ * Usage: compile_charset <mapping file> [<compiled file>]
+ * The compiled file defaults to Charset::compiledFilename(mapping file).
+ */
+
+#include "Types.h"
+#include "Charset.h"
+
+#include <string>
+#include <vector>
+#include <iostream>
+
+using namespace BrailleTutorNS;
+
+int fakemain(int argc, char **argv)
+{
+  if((argc < 2) || (argc > 3)) {
+    std::cerr << "Usage: " << argv[0]
+	      << " <mapping file> [<compiled file>]" << std::endl;
+    return 2;
+  }
+  const std::string text(argv[1]);
+  const std::string compiled = (argc > 2) ? std::string(argv[2]) :
+					    Charset::compiledFilename(text);
+
+  // Lines the text parser didn't like are skipped, just as they are when
+  // the apps load the text file; say so, but carry on.
+  // Likewise lines that map a dot pattern an earlier line already did: the
+  // later line wins, and the earlier letter is lost.
+  Charset charset("");
+  std::vector<unsigned int> remapped_lines;
+  const std::vector<unsigned int> err_lines = charset.read(text,
+							   remapped_lines);
+  if(!err_lines.empty()) {
+    std::cerr << text << ": warning: skipped lines";
+    for(unsigned int i=0; i<err_lines.size(); ++i)
+      std::cerr << ' ' << err_lines[i];
+    std::cerr << std::endl;
+  }
+  if(!remapped_lines.empty()) {
+    std::cerr << text << ": warning: dot patterns mapped again on lines";
+    for(unsigned int i=0; i<remapped_lines.size(); ++i)
+      std::cerr << ' ' << remapped_lines[i];
+    std::cerr << std::endl;
+  }
+
+  charset.writeCompiled(compiled);
+
+  // Read the image back and make sure it says what the text does
+  const Charset check = Charset::fromCompiledFile(compiled);
+  for(unsigned int p=0; p<256; ++p) {
+    if(!check[p].equals(charset[p]) ||
+       (!charset[p].isEmpty() && (check[charset[p]] != charset[charset[p]])) ||
+       (check.isSettled(p) != charset.isSettled(p))) {
+      std::cerr << compiled << ": compiled image doesn't match "
+		<< text << std::endl;
+      return 1;
+    }
+  }
+
+  return 0;
+}
+
+int main(int argc, char **argv)
+{
+  try { return fakemain(argc, argv); }
+  catch(const BTException &e) {
+    std::cerr << "BTException: " << e.why << std::endl;
+    return -1;
+  }
+  catch(...) {
+    std::cerr << "Some other exception happened" << std::endl;
+    return -1;
+  }
+
+  return 0;
+}
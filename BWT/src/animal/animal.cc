@@ -10,6 +10,7 @@
 #include <assert.h>
 #include <boost/assign/list_of.hpp>
 #include "animal.h"
+#include "common/app_modes.h"
 #define MAX_CATS 3 
 #define SHORT 0
 #define MEDIUM 1
@@ -18,8 +19,22 @@
 
  time_t last_time = time(0);
 
+//The names of all the animals, for the dictionary, leaving out empty ones
+static std::vector<std::string> animalNames(const ForeignLanguage2EnglishMap& sw, const ForeignLanguage2EnglishMap& mw,
+    const ForeignLanguage2EnglishMap& lw)
+{
+  std::vector<std::string> names;
+  const ForeignLanguage2EnglishMap* lists[] = { &sw, &mw, &lw };
+  for(int i = 0; i < 3; i++)
+    for(ForeignLanguage2EnglishMap::const_iterator iter = lists[i]->begin(); iter != lists[i]->end(); ++iter)
+      if( !iter->first.empty() )
+        names.push_back(iter->first);
+  return names;
+}
+
 Animal::Animal(IOEventParser& my_iep, const std::string& path_to_mapping_file, SoundsUtil* my_su, const std::vector<std::string> my_alph, const ForeignLanguage2EnglishMap sw, const ForeignLanguage2EnglishMap mw, const ForeignLanguage2EnglishMap lw, bool f) :
-  IBTApp(my_iep, path_to_mapping_file), iep(my_iep), su(my_su), alphabet(my_alph), short_animals(sw), med_animals(mw), long_animals(lw),
+  IBTApp(my_iep, path_to_mapping_file), iep(my_iep), su(my_su), alphabet(my_alph, *IBTApp::getCurrentCharset()), short_animals(sw), med_animals(mw), long_animals(lw),
+      animal_names(animalNames(sw, mw, lw)), speller(animal_names, 1, 3),
       letter_skill(alphabet.size()), firsttime(true), turncount(0), word(""), last_word(""), target_letter(""), word_pos(0), word_length(0), nomirror(f), animal_s ("./resources/Voice/animal_sounds/", my_iep), three_down(false)
 {
   for(int i = 0; i < alphabet.size(); i++)
@@ -54,6 +69,7 @@ void Animal::processEvent(IOEvent& e)
     /* say the actual word */
     sayName(word);
     word_pos = 0; // restsart the word
+    speller.reset();
     three_down = false; //reset
     firsttime = true; // so will skip later
     return;
@@ -100,6 +116,7 @@ void Animal::sayName(std::string& word){
 void Animal::AL_new()
 {
   srand(time(0));
+  speller.reset();
   std::vector<int> low_letters;
   float min_knowledge = .7;
   //no letter skill to be trained
@@ -188,27 +205,26 @@ std::string Animal::animalNameToSound(const std::string& animal)
 void Animal::AL_attempt(std::string i)
 {
 
-  static const Charset &charset = IBTApp::getCurrentCharset();
-
   ////
   if( target_letter.compare("\0") != 0 )
   { //if we were re-hashing a letter skill then one letter at a time
     if( target_letter.compare((std::string) i) == 0 )
     { //match!
-      int index = alphabeticIndex(alphabet, word, word_pos, target_letter);
+      int index = alphabet.indexOf(target_letter);
 
       letter_skill[index].observe(right);
       std::cout << target_letter << ": " << letter_skill[index].estimate() << std::endl;
       su->saySound(getTeacherVoice(), "good");
       target_letter = "\0";
       word_pos = 0;
+      speller.reset();
       su->saySound(getTeacherVoice(), "please write");
       su->sayLetterSequence(animal_s, word);
       return;
     }
     else
     {
-      int index = alphabeticIndex(alphabet, word, word_pos, target_letter);
+      int index = alphabet.indexOf(target_letter);
       letter_skill[index].observe(wrong);
       std::cout << target_letter << ": " << letter_skill[index].estimate() << std::endl;
       //std::cout << "    (DEBUG)Targetletter wrong" << std::endl;
@@ -221,7 +237,7 @@ void Animal::AL_attempt(std::string i)
         su->saySound(getTeacherVoice(), "to write the letter");
         su->sayLetter(getTeacherVoice(), target_letter);
         su->saySound(getTeacherVoice(), "press");
-        su->sayDotSequence(getTeacherVoice(), charset[GlyphMapping(target_letter)]);//get the dots of the corresponding letter
+        su->sayDotSequence(getTeacherVoice(), alphabet.dots(index));//get the dots of the corresponding letter
         //std::cout << "    (DEBUG)Targetletter wrong, learning this letter" << std::endl;
       }
 
@@ -230,6 +246,7 @@ void Animal::AL_attempt(std::string i)
       //std::cout << "    (DEBUG)Targetletter was asked to be written" << std::endl;
 
       word_pos = 0;
+      speller.reset();
 
       return;
     }
@@ -237,11 +254,12 @@ void Animal::AL_attempt(std::string i)
 
   else
   { // need to spell entire name of animal allowed three chances to guess before it tells you asnwer
-    int num_bytes_in_letter = numBytesInUTF8Letter(word.at(word_pos));
+    int num_bytes_in_letter = alphabet.letterBytes(word, word_pos);
     std::string correct_letter(word, word_pos, num_bytes_in_letter);
     //std::cout << "    (DEBUG)utf8 encoded size is:" << num_bytes_in_letter << "  word.size is:" << word.size() << "  word length is:" << word_length << " Correct letter is:"<<correct_letter<<" Target letter is:"<<target_letter<<" word.at(word_pos) is:"<<word.at(word_pos)<<std::endl;
-    int index = alphabeticIndex(alphabet, word, word_pos, word.at(word_pos));
+    int index = alphabet.indexOf(correct_letter);
     //std::cout << "    (DEBUG)First time,correct letter is" << correct_letter << " at index " << index << std::endl;
+    speller.addLetter(i);
     if( i.compare(correct_letter) == 0 )
     { //letter is next in sequence
       word_pos = word_pos + num_bytes_in_letter; //move to next letter/character
@@ -262,6 +280,16 @@ void Animal::AL_attempt(std::string i)
     else
     { //letter is incorrect
       su->saySound(getTeacherVoice(), "no"); // that is the incorrect animal
+      //If what's been written looks more like another animal, spell it back and name that animal, so the mix-up can
+      //be explained
+      const Dictionary::Match* looks_like = speller.closest();
+      if( looks_like && animal_names[looks_like->word] != word )
+      {
+        std::string other_animal(animal_names[looks_like->word]);
+        std::cout << speller.word() << " looks like " << other_animal << ", not " << word << std::endl;
+        su->sayLetterSequence(getTeacherVoice(), speller.word());
+        sayName(other_animal);
+      }
      
       turncount++;
       //std::cout << "    (DEBUG)Now at turn:" << turncount << std::endl;
@@ -283,13 +311,18 @@ void Animal::AL_attempt(std::string i)
           su->saySound(getTeacherVoice(), "to write the letter");
           su->sayLetter(getTeacherVoice(), correct_letter);
           su->saySound(getTeacherVoice(), "press");
-          su->sayDotSequence(getTeacherVoice(), charset[GlyphMapping(correct_letter)]);
+          su->sayDotSequence(getTeacherVoice(), alphabet.dots(index));
           su->saySound(getTeacherVoice(), "please write");
           su->sayLetter(getTeacherVoice(), correct_letter);
           target_letter = correct_letter;
           word_pos = 0;
           //std::cout << "    (DEBUG)Bad at this letter" << std::endl;
         }
+
+        //The rejected letter isn't part of the word; keep only what's been accepted of it
+        speller.reset();
+        if( word_pos > 0 )
+          speller.addLetter(word.substr(0, word_pos));
       }
       return;
   }
@@ -299,7 +332,7 @@ void Animal::AL_attempt(std::string i)
 //++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
 
 EnglishAnimal::EnglishAnimal(IOEventParser& my_iep) :
-  Animal(my_iep, "", new EnglishSoundsUtil, createAlphabet(), createShortAnimalWords(), createMedAnimalWords(), createLongAnimalWords(), false)
+  Animal(my_iep, AppModes::mappingFile(AppModes::ANIMAL_GAME_ENGLISH), new EnglishSoundsUtil, createAlphabet(), createShortAnimalWords(), createMedAnimalWords(), createLongAnimalWords(), false)
 {
 
 }
@@ -332,7 +365,7 @@ const ForeignLanguage2EnglishMap EnglishAnimal::createLongAnimalWords() const
 //++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
 
 ArabicAnimal::ArabicAnimal(IOEventParser& my_iep) :
-      Animal(my_iep, "./language_mapping_files/arabic_mapping.txt", new ArabicSoundsUtil, createAlphabet(), createShortAnimalWords(), createMedAnimalWords(), createLongAnimalWords(), false)
+      Animal(my_iep, AppModes::mappingFile(AppModes::ANIMAL_GAME_ARABIC), new ArabicSoundsUtil, createAlphabet(), createShortAnimalWords(), createMedAnimalWords(), createLongAnimalWords(), false)
 {
 
 }
@@ -363,7 +396,7 @@ const ForeignLanguage2EnglishMap ArabicAnimal::createLongAnimalWords() const
 //++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
 
 FrenchAnimal::FrenchAnimal(IOEventParser& my_iep) :
-      Animal(my_iep, "./language_mapping_files/french_mapping.txt", new FrenchSoundsUtil, createAlphabet(), createShortAnimalWords(), createMedAnimalWords(), createLongAnimalWords(), false)
+      Animal(my_iep, AppModes::mappingFile(AppModes::ANIMAL_GAME_FRENCH), new FrenchSoundsUtil, createAlphabet(), createShortAnimalWords(), createMedAnimalWords(), createLongAnimalWords(), false)
 {
 
 }
@@ -396,7 +429,7 @@ const ForeignLanguage2EnglishMap FrenchAnimal::createLongAnimalWords() const
 //++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
 
 KiswahiliAnimal::KiswahiliAnimal(IOEventParser& my_iep) :
-      Animal(my_iep, "", new KiswahiliSoundsUtil, createAlphabet(), createShortAnimalWords(), createMedAnimalWords(), createLongAnimalWords(), false)
+      Animal(my_iep, AppModes::mappingFile(AppModes::ANIMAL_GAME_SWAHILI), new KiswahiliSoundsUtil, createAlphabet(), createShortAnimalWords(), createMedAnimalWords(), createLongAnimalWords(), false)
 {
 
 }
@@ -427,7 +460,7 @@ const ForeignLanguage2EnglishMap KiswahiliAnimal::createLongAnimalWords() const
 //++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
 
 English2Animal::English2Animal(IOEventParser& my_iep) :
-  Animal(my_iep, "./language_mapping_files/english_mapping_nomirror.txt", new English2SoundsUtil, createAlphabet(), createShortAnimalWords(), createMedAnimalWords(), createLongAnimalWords(), true)
+  Animal(my_iep, AppModes::ENGLISH_NOMIRROR_MAPPING, new English2SoundsUtil, createAlphabet(), createShortAnimalWords(), createMedAnimalWords(), createLongAnimalWords(), true)
 {
 
 }
@@ -458,7 +491,7 @@ const ForeignLanguage2EnglishMap English2Animal::createLongAnimalWords() const
 //++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
 
 Arabic2Animal::Arabic2Animal(IOEventParser& my_iep) :
-      Animal(my_iep, "./language_mapping_files/arabic_mapping_nomirror.txt", new Arabic2SoundsUtil, createAlphabet(), createShortAnimalWords(), createMedAnimalWords(), createLongAnimalWords(), true)
+      Animal(my_iep, AppModes::ARABIC_NOMIRROR_MAPPING, new Arabic2SoundsUtil, createAlphabet(), createShortAnimalWords(), createMedAnimalWords(), createLongAnimalWords(), true)
 {
 
 }
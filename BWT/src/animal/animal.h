@@ -11,8 +11,10 @@
 
 #include "common/utilities.h"
 #include "common/IBTApp.h"
+#include "common/Alphabet.h"
 #include "common/KnowledgeTracer.h"
 #include "common/language_utils.h"
+#include "Dictionary.h"
 //maps the actual names of the animals in a foreign (ie,non-native) language to their english names
   typedef std::map<std::string,std::string> ForeignLanguage2EnglishMap;
   
@@ -41,10 +43,12 @@ private:
   SoundsUtil* su;
   bool three_down;
 
-  const std::vector<std::string> alphabet;
+  const Alphabet alphabet;
   const ForeignLanguage2EnglishMap short_animals;
   const ForeignLanguage2EnglishMap med_animals;
   const ForeignLanguage2EnglishMap long_animals;
+  const Dictionary animal_names; //all of the above, to match what's written against
+  WordAssembler speller; //the word the student is writing, and the animals it looks like
 
   std::vector<KnowledgeTracer> letter_skill;
   bool nomirror;
@@ -9,9 +9,11 @@
 
 #include <cassert>
 #include <fstream>
+#include <set>
 #include <boost/algorithm/string.hpp>
 #include <boost/algorithm/string/predicate.hpp>
 #include "app_dispatcher.h"
+#include "common/CharsetRegistry.h"
 
 #include "dot_scaffold/dot_scaffold.h"
 #include "learn_dots/learn_dots.h"
@@ -342,8 +344,23 @@ void ApplicationDispatcher::processConfigFile()
     modes_list.push_back(ARITHMETIC_PRACTICE_ENGLISH);
 	  modes_list.push_back(HOUSEHOLD_GAME_ENGLISH);
   }
+
+  preloadCharsets();
 }	
 
+//Start loading the mapping files the configured modes will use, so that switching to them doesn't have to
+void ApplicationDispatcher::preloadCharsets() const
+{
+  std::set<std::string> paths;
+  for(unsigned int i = 0; i < modes_list.size(); i++)
+  {
+    const std::string path = mappingFile(modes_list[i]);
+    if(path != DEFAULT_CHARSET) paths.insert(path);
+  }
+
+  CharsetRegistry::instance().preload(std::vector<std::string>(paths.begin(), paths.end()));
+}
+
 
 IBTApp* ApplicationDispatcher::switchToSelectedMode() const {
 	std::cout << "Dispatcher switchToSelectedMode" << std::endl;
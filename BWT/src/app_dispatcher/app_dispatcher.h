@@ -15,61 +15,11 @@
 #include <string>
 #include "common/utilities.h"
 #include "common/IBTApp.h"
+#include "common/app_modes.h"
 
 
-struct ApplicationDispatcher : public IOEventHandler
+struct ApplicationDispatcher : public IOEventHandler, public AppModes //the modes are listed in common/app_modes.h
 {
-  enum modes {
-    FREE_PLAY_ENGLISH,
-    FREE_SPELLING_ENGLISH,
-    FREE_NUMBERS_ENGLISH,
-    LEARN_DOTS_ENGLISH,
-    DOT_PRACTICE_ENGLISH,
-    LEARN_LETTERS_ENGLISH,
-    LETTER_PRACTICE_ENGLISH,
-    LEARN_NUMBERS_ENGLISH,
-    DOMINOS_ENGLISH,
-    HANGMAN_ENGLISH,
-    ANIMAL_GAME_ENGLISH,
-	  HOUSEHOLD_GAME_ENGLISH,
-    ARITHMETIC_PRACTICE_ENGLISH,
-    LEARN_LETTERS_HINDI,
-    LEARN_LETTERS_KANNADA,
-    FREE_PLAY_ARABIC,
-    FREE_SPELLING_ARABIC,
-    FREE_NUMBERS_ARABIC,
-    LEARN_DOTS_ARABIC,
-    DOT_PRACTICE_ARABIC,
-    LEARN_LETTERS_ARABIC,
-    LETTER_PRACTICE_ARABIC,
-    LEARN_NUMBERS_ARABIC,
-    DOMINOS_ARABIC,
-    HANGMAN_ARABIC,
-    ANIMAL_GAME_ARABIC,
-    FREE_PLAY_FRENCH,
-    FREE_SPELLING_FRENCH,
-    FREE_NUMBERS_FRENCH,
-    LEARN_DOTS_FRENCH,
-    DOT_PRACTICE_FRENCH,
-    LEARN_LETTERS_FRENCH,
-    LETTER_PRACTICE_FRENCH,
-    LEARN_NUMBERS_FRENCH,
-    DOMINOS_FRENCH,
-    HANGMAN_FRENCH,
-    ANIMAL_GAME_FRENCH,
-    FREE_PLAY_SWAHILI,
-    FREE_SPELLING_SWAHILI,
-    FREE_NUMBERS_SWAHILI,
-    LEARN_DOTS_SWAHILI,
-    DOT_PRACTICE_SWAHILI,
-    LEARN_LETTERS_SWAHILI,
-    LETTER_PRACTICE_SWAHILI,
-    LEARN_NUMBERS_SWAHILI,
-    DOMINOS_SWAHILI,
-    HANGMAN_SWAHILI,
-    ANIMAL_GAME_SWAHILI
-  };
-  
   static const int SCROLL_OFF = 0;//Events are interpreted as normal events that are passed to the current application
   static const int BZERO_DOWN = 1;//Is Button0 held down?
   static const int SCROLL_ON = 2; //Events are interpreted as scrolling events - this enables us to scroll
@@ -105,6 +55,7 @@ struct ApplicationDispatcher : public IOEventHandler
   void playSelectedMode() const;
   
   void processConfigFile();
+  void preloadCharsets() const;
 };
 
 #endif /* APP_DISPATCHER_H_ */
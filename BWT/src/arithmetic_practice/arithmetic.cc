@@ -5,6 +5,7 @@
 
 
 #include "arithmetic.h"
+#include "common/app_modes.h"
 #include "Dots.h"
 #include <math.h>
 
@@ -141,8 +142,8 @@ void Arithmetic::Fact_new()
     }
     current_sequence = '\0';
     
-    dots1 = convertToDotSequence(IBTApp::getCurrentCharset(), num1);
-    dots2 = convertToDotSequence(IBTApp::getCurrentCharset(), num2);
+    dots1 = convertToDotSequence(*IBTApp::getCurrentCharset(), num1);
+    dots2 = convertToDotSequence(*IBTApp::getCurrentCharset(), num2);
     std::cout<<"question is "<<num1 << " and " << num2 <<std::endl;
     std::cout<<"desired result is:"<<result<<std::endl;
     printf("%d\n",result);
@@ -198,7 +199,8 @@ void Arithmetic::sayArithmeticQuestion(bool say_answer)
 {
   
   std::cout << "sayArithmeticQuestion" << std::endl;
-  static const Charset& charset = IBTApp::getCurrentCharset();
+  const CharsetSnapshot charset_snapshot = IBTApp::getCurrentCharset();
+  const Charset &charset = *charset_snapshot;
   if (!say_answer) {
     su->saySound(math_s, "please_write_the_number_that_is_equal_to");
   }
@@ -283,7 +285,7 @@ void Arithmetic::AP_attempt(unsigned char dot)
   current_target = response_array[strt + digit_position];
   //check to see if they should be entering the braille number indicator
   if (!number_sign){
-    target_sequence = convertToDotSequence(IBTApp::getCurrentCharset(),
+    target_sequence = convertToDotSequence(*IBTApp::getCurrentCharset(),
                                           current_target);
   }
   else {
@@ -338,7 +340,7 @@ void Arithmetic::AP_attempt(unsigned char dot)
 
 //++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
 EnglishArithmeticPractice::EnglishArithmeticPractice(IOEventParser& my_iep) :
-  Arithmetic(my_iep, "./language_mapping_files/number_mapping.txt", 
+  Arithmetic(my_iep, AppModes::mappingFile(AppModes::ARITHMETIC_PRACTICE_ENGLISH), 
   			   new EnglishSoundsUtil, false)
 {
 
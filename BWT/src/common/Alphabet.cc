@@ -0,0 +1,103 @@
+/*
+ * Alphabet.cc
+ *
+ *  Created on: Oct 19, 2026
+ */
+
+#include "Alphabet.h"
+
+#include <stdexcept>
+
+Alphabet::Alphabet(const std::vector<std::string>& letters, const Charset& charset) :
+  longest(1)
+{
+  offsets.reserve(letters.size() + 1);
+  letter_dots.reserve(letters.size());
+  for(unsigned int i = 0; i < letters.size(); i++)
+  {
+    offsets.push_back(storage.size());
+    storage += letters[i];
+    letter_dots.push_back(charset.dotsFor(letters[i]));
+    if(letters[i].size() > longest)
+      longest = letters[i].size();
+  }
+  offsets.push_back(storage.size());
+
+  //At most half full, so probe runs stay short
+  size_t num_slots = 16;
+  while(num_slots < 2 * letters.size())
+    num_slots *= 2;
+  slots.assign(num_slots, 0);
+  for(unsigned int i = 0; i < letters.size(); i++)
+  {
+    if(letters[i].empty() || indexOf(letters[i]) != size())
+      continue; //a letter's first index is the one looked up
+    size_t slot = hash(letters[i].data(), letters[i].size()) & (num_slots - 1);
+    while(slots[slot] != 0)
+      slot = (slot + 1) & (num_slots - 1);
+    slots[slot] = i + 1;
+  }
+}
+
+std::string Alphabet::at(size_t index) const
+{
+  if(index >= size())
+    throw std::out_of_range("Alphabet::at");
+  return (*this)[index];
+}
+
+//FNV-1a
+uint32_t Alphabet::hash(const char* letter, size_t length)
+{
+  uint32_t h = 2166136261u;
+  for(size_t i = 0; i < length; i++)
+  {
+    h ^= (unsigned char) letter[i];
+    h *= 16777619u;
+  }
+  return h;
+}
+
+size_t Alphabet::indexOf(const char* letter, size_t length) const
+{
+  const size_t mask = slots.size() - 1;
+  for(size_t slot = hash(letter, length) & mask; slots[slot] != 0; slot = (slot + 1) & mask)
+  {
+    const size_t index = slots[slot] - 1;
+    if(bytes(index) == length && storage.compare(offsets[index], length, letter, length) == 0)
+      return index;
+  }
+  return size();
+}
+
+size_t Alphabet::letterBytes(const std::string& word, size_t pos) const
+{
+  //Longest letter of the alphabet found at pos, trying the longest first
+  const size_t left = word.size() - pos;
+  for(size_t length = (longest < left) ? longest : left; length > 1; length--)
+    if(indexOf(word.data() + pos, length) != size())
+      return length;
+
+  //Otherwise one UTF-8 character (see numBytesInUTF8Letter())
+  const unsigned char lead = word[pos];
+  size_t length = ((lead & 0xF0) == 0xF0) ? 4 : ((lead & 0xE0) == 0xE0) ? 3 : ((lead & 0xC0) == 0xC0) ? 2 : 1;
+  return (length < left) ? length : left;
+}
+
+Alphabet::LetterIterator::LetterIterator(const Alphabet& my_alphabet, const std::string& my_word, size_t my_pos) :
+  alphabet(my_alphabet), word(my_word), pos(my_pos), num_bytes(0), letter_index(my_alphabet.size())
+{
+  find();
+}
+
+void Alphabet::LetterIterator::find()
+{
+  if(done())
+  {
+    num_bytes = 0;
+    letter_index = alphabet.size();
+    return;
+  }
+  num_bytes = alphabet.letterBytes(word, pos);
+  letter_index = alphabet.indexOf(word.data() + pos, num_bytes);
+}
@@ -0,0 +1,98 @@
+/*
+ * Alphabet.h
+ *
+ *  Created on: Oct 19, 2026
+ *
+ * An app's alphabet: the letters it teaches, in the order its KnowledgeTracers are kept in. Built once when the app
+ * starts and never changed after. The letters are stored end to end in one UTF-8 string, with a hash table from
+ * letter to alphabetic index and each letter's dot pattern (in the app's charset) worked out up front, so looking
+ * a letter of a word up doesn't search or decode anything twice.
+ *
+ * A letter is usually one UTF-8 character, but an alphabet may have letters made of several (e.g. a consonant
+ * and a vowel sign). Words are split into letters the same way throughout: at each position, the longest letter
+ * of the alphabet that's there, or else one UTF-8 character. LetterIterator walks a word like that.
+ */
+
+#ifndef ALPHABET_H_
+#define ALPHABET_H_
+
+#include <string>
+#include <vector>
+#include <stdint.h>
+
+#include "Dots.h"
+#include "Types.h"
+#include "Charset.h"
+
+using namespace BrailleTutorNS;
+
+class Alphabet
+{
+public:
+  //The letters, in order. Dot patterns are looked up in charset; a letter it doesn't have gets INVALID_DOTS.
+  Alphabet(const std::vector<std::string>& letters, const Charset& charset);
+
+  //Number of letters
+  inline size_t size() const { return offsets.size() - 1; }
+
+  //The letter at an alphabetic index
+  inline std::string operator[](size_t index) const
+  { return std::string(storage, offsets[index], offsets[index + 1] - offsets[index]); }
+  //As operator[], but throws std::out_of_range if there's no such letter
+  std::string at(size_t index) const;
+  //Bytes in the letter at an alphabetic index
+  inline size_t bytes(size_t index) const { return offsets[index + 1] - offsets[index]; }
+  //Dot pattern of the letter at an alphabetic index; INVALID_DOTS for size() (a letter that isn't in the alphabet)
+  inline unsigned char dots(size_t index) const { return (index < letter_dots.size()) ? letter_dots[index] : INVALID_DOTS; }
+
+  //Alphabetic index of a letter, or size() if it isn't in the alphabet. If a letter is in the alphabet twice, its
+  //first index.
+  inline size_t indexOf(const std::string& letter) const { return indexOf(letter.data(), letter.size()); }
+  size_t indexOf(const char* letter, size_t length) const;
+
+  //Bytes in the letter of word starting at byte pos (see above)
+  size_t letterBytes(const std::string& word, size_t pos) const;
+  //Alphabetic index of the letter of word starting at byte pos, or size() if it isn't in the alphabet
+  inline size_t indexAt(const std::string& word, size_t pos) const
+  { return indexOf(word.data() + pos, letterBytes(word, pos)); }
+
+  //Walks the letters of a word:
+  //  for(Alphabet::LetterIterator l(alphabet, word); !l.done(); ++l) ... l.index() ... l.letter() ...
+  class LetterIterator
+  {
+  public:
+    LetterIterator(const Alphabet& alphabet, const std::string& word, size_t pos = 0);
+
+    inline bool done() const { return pos >= word.size(); }
+    inline LetterIterator& operator++() { pos += num_bytes; find(); return *this; }
+
+    //Byte offset of the letter in the word
+    inline size_t position() const { return pos; }
+    //Bytes in the letter
+    inline size_t bytes() const { return num_bytes; }
+    //Alphabetic index of the letter, or alphabet.size() if it isn't in the alphabet
+    inline size_t index() const { return letter_index; }
+    //The letter
+    inline std::string letter() const { return word.substr(pos, num_bytes); }
+
+  private:
+    const Alphabet& alphabet;
+    const std::string& word;
+    size_t pos;
+    size_t num_bytes;
+    size_t letter_index;
+
+    void find();
+  };
+
+private:
+  std::string storage; //the letters, end to end
+  std::vector<uint32_t> offsets; //where each letter starts in storage, and then storage.size()
+  std::vector<unsigned char> letter_dots; //dot pattern of each letter
+  std::vector<uint32_t> slots; //hash table: alphabetic index + 1 of the letter hashed here, or 0 if empty
+  size_t longest; //bytes in the longest letter
+
+  static uint32_t hash(const char* letter, size_t length);
+};
+
+#endif /* ALPHABET_H_ */
@@ -0,0 +1,83 @@
+/*
+ * CharsetRegistry.cc
+ *
+ *  Created on: Oct 19, 2026
+ */
+
+#include "CharsetRegistry.h"
+
+//Thread functor that loads a list of mapping files into the registry
+struct FunctorCharsetPreloader
+{
+  CharsetRegistry& registry;
+  std::vector<std::string> paths;
+
+  FunctorCharsetPreloader(CharsetRegistry& my_registry, const std::vector<std::string>& my_paths) :
+    registry(my_registry), paths(my_paths) { }
+
+  void operator()()
+  {
+    for(unsigned int i = 0; i < paths.size(); i++)
+    {
+      try { registry.get(paths[i]); }
+      catch(const BTException&) { } //get() will complain when an app actually wants this one
+    }
+  }
+};
+
+CharsetRegistry::CharsetRegistry()
+{
+}
+
+CharsetRegistry::~CharsetRegistry()
+{
+  if(preloader) preloader->join();
+}
+
+CharsetRegistry& CharsetRegistry::instance()
+{
+  static CharsetRegistry registry;
+  return registry;
+}
+
+CharsetSnapshot CharsetRegistry::get(const std::string& path_to_mapping_file)
+{
+  {
+    boost::mutex::scoped_lock lock(mutex);
+    while(loading.count(path_to_mapping_file)) loaded.wait(lock);
+
+    std::map<std::string, CharsetSnapshot>::const_iterator found = charsets.find(path_to_mapping_file);
+    if(found != charsets.end()) return found->second;
+
+    loading.insert(path_to_mapping_file);
+  }
+
+  //Load without holding the lock, so other files (and lookups of loaded ones) aren't held up
+  CharsetSnapshot snapshot;
+  try { snapshot.reset(new Charset(Charset::load(path_to_mapping_file))); }
+  catch(...)
+  {
+    boost::mutex::scoped_lock lock(mutex);
+    loading.erase(path_to_mapping_file);
+    loaded.notify_all();
+    throw;
+  }
+
+  boost::mutex::scoped_lock lock(mutex);
+  charsets[path_to_mapping_file] = snapshot;
+  loading.erase(path_to_mapping_file);
+  loaded.notify_all();
+  return snapshot;
+}
+
+void CharsetRegistry::preload(const std::vector<std::string>& paths_to_mapping_files)
+{
+  if(preloader) preloader->join(); //one preloader at a time
+  preloader.reset(new boost::thread(FunctorCharsetPreloader(*this, paths_to_mapping_files)));
+}
+
+bool CharsetRegistry::isLoaded(const std::string& path_to_mapping_file)
+{
+  boost::mutex::scoped_lock lock(mutex);
+  return charsets.count(path_to_mapping_file) > 0;
+}
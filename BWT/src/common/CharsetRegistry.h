@@ -0,0 +1,60 @@
+/*
+ * CharsetRegistry.h
+ *
+ *  Created on: Oct 19, 2026
+ *
+ * A process-wide cache of the language charsets the apps use, keyed by mapping file path. Each mapping file is
+ * loaded once (optionally ahead of time, on a background thread) and handed out as a shared immutable
+ * CharsetSnapshot, so switching between modes of the same language never goes back to the filesystem.
+ */
+
+#ifndef CHARSETREGISTRY_H_
+#define CHARSETREGISTRY_H_
+
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "Types.h"
+#include "Charset.h"
+
+#include <boost/thread.hpp>
+#include <boost/thread/condition.hpp>
+#include <boost/scoped_ptr.hpp>
+#include <boost/utility.hpp>
+
+using namespace BrailleTutorNS;
+
+class CharsetRegistry : public boost::noncopyable
+{
+public:
+  //The one registry for the whole program. Call this from the main thread before starting any others.
+  static CharsetRegistry& instance();
+
+  //The charset in a mapping file, loaded on first request (with Charset::load) and shared after that. If the
+  //file is being loaded by another thread (e.g. the preloader), waits for it. Throws whatever Charset::load
+  //throws; failures aren't remembered, so a later call tries again.
+  CharsetSnapshot get(const std::string& path_to_mapping_file);
+
+  //Start loading mapping files on a background thread, so they're ready by the time an app asks for them.
+  //Files that fail to load are skipped quietly here; get() will report the failure.
+  void preload(const std::vector<std::string>& paths_to_mapping_files);
+
+  //True if the mapping file has been loaded already
+  bool isLoaded(const std::string& path_to_mapping_file);
+
+  ~CharsetRegistry(); //waits for the preloader to finish
+
+private:
+  CharsetRegistry();
+
+  boost::mutex mutex; //guards everything below
+  boost::condition loaded; //signalled whenever a file finishes loading (or fails to)
+  std::map<std::string, CharsetSnapshot> charsets; //loaded charsets, by mapping file path
+  std::set<std::string> loading; //mapping files some thread is loading right now
+
+  boost::scoped_ptr<boost::thread> preloader; //background loading thread, if one was started
+};
+
+#endif /* CHARSETREGISTRY_H_ */
@@ -6,8 +6,9 @@
  */
 
 #include "IBTApp.h"
+#include "CharsetRegistry.h"
 
-Charset IBTApp::currentCharset = Charset::defaultCharset();
+CharsetSnapshot IBTApp::currentCharset;
 
 IBTApp::IBTApp(IOEventParser& my_iep, const std::string& path_to_mapping_file) :
   iep(my_iep), teacher_voice("./resources/Voice/teacher/",iep), student_voice("./resources/Voice/student/",iep)
@@ -24,22 +25,37 @@ IBTApp::~IBTApp()
   //Voice::stopAllPlaying(); //XXX: Not sure if this is making a difference
 }
 
+//The default charset, as a snapshot made on first use
+static const CharsetSnapshot& defaultCharsetSnapshot()
+{
+  static const CharsetSnapshot default_snapshot(new Charset(Charset::defaultCharset()));
+  return default_snapshot;
+}
+
+void IBTApp::publishCharset(IOEventParser& parser, const CharsetSnapshot& snapshot)
+{
+  boost::atomic_store(&currentCharset, snapshot);
+  parser.setCharset(snapshot);
+}
+
 void IBTApp::loadDefaultCharset()
 {
-  currentCharset = Charset::defaultCharset();
+  publishCharset(iep, defaultCharsetSnapshot());
 }
 
 void IBTApp::loadLanguageCharset(const std::string& path_to_mapping_file)
 {
   //std::cout << "    (DEBUG)Setting Charset to:" << path_to_mapping_file << std::endl;
-  currentCharset = Charset::fromFile(path_to_mapping_file);
-  iep.setCharset(currentCharset);
+  //The registry reads each mapping file once (see CharsetRegistry.h); after that, every app using the same
+  //language shares the one immutable snapshot, so switching between modes doesn't touch the filesystem.
+  publishCharset(iep, CharsetRegistry::instance().get(path_to_mapping_file));
 }
 
-const Charset& IBTApp::getCurrentCharset()
+CharsetSnapshot IBTApp::getCurrentCharset()
 {
   //std::cout << "		(DEBUG)Inside getCurrentCharset" << std::endl;
-  return currentCharset;
+  const CharsetSnapshot current = boost::atomic_load(&currentCharset);
+  return current ? current : defaultCharsetSnapshot();
 }
 
 const Voice& IBTApp::getTeacherVoice() const
@@ -19,7 +19,7 @@ public:
   virtual ~IBTApp(); //important that this is virtual. Otherwise the destructor of the derived class will not be called. For example, the destructor of the Dominos app is crucial because it stop()s the game, hence preventing previously spawned TimerTask threads from interfering with another BT app.
   const Voice& getTeacherVoice() const;
   const Voice& getStudentVoice() const;
-  static const Charset& getCurrentCharset();
+  static CharsetSnapshot getCurrentCharset();
   IOEventParser& iep;
 public:
   virtual void processEvent(IOEvent& event) = 0;
@@ -33,12 +33,13 @@ private:
   Voice student_voice;
 
   /*
-   * Incase you are wondering why currentCharset member is static(instead of a normal member). First note that
-   * the BT library's IOEventParser.setCharset() method DOES NOT make it's own copy of the Charset, it refers
-   * to the one you specify it IOEventParser::setCharset(currentCharset)...so to be on the "safe" side
-   * currentCharset is static
+   * The charset shared by all apps and the IOEventParser. It is never changed in place: switching language
+   * publishes a new immutable snapshot (with boost::atomic_store), so the decoder thread and any app still
+   * holding the old snapshot keep using it safely until they let go of it. Only touch it with
+   * boost::atomic_load/atomic_store. Empty until the first app loads a charset.
    */
-  static Charset currentCharset;
+  static CharsetSnapshot currentCharset;
+  static void publishCharset(IOEventParser&, const CharsetSnapshot&);
 };
 
 #endif /* BTAPP_H_ */
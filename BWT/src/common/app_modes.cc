@@ -0,0 +1,54 @@
+/*
+ * app_modes.cc
+ *
+ *  Created on: Oct 19, 2026
+ */
+
+#include "app_modes.h"
+
+const char* const AppModes::DEFAULT_CHARSET = "";
+const char* const AppModes::ENGLISH_NOMIRROR_MAPPING = "./language_mapping_files/english_mapping_nomirror.txt";
+const char* const AppModes::ARABIC_MAPPING = "./language_mapping_files/arabic_mapping.txt";
+const char* const AppModes::ARABIC_NOMIRROR_MAPPING = "./language_mapping_files/arabic_mapping_nomirror.txt";
+const char* const AppModes::FRENCH_MAPPING = "./language_mapping_files/french_mapping.txt";
+const char* const AppModes::DEVANAGARI_MAPPING = "./language_mapping_files/devanagari_mapping.txt";
+const char* const AppModes::KANNADA_MAPPING = "./language_mapping_files/kannada_mapping.txt";
+const char* const AppModes::NUMBER_MAPPING = "./language_mapping_files/number_mapping.txt";
+const char* const AppModes::NUMBER_UNMIRRORED_MAPPING = "./language_mapping_files/number_mapping_unmirrored.txt";
+
+const char* AppModes::mappingFile(modes mode)
+{
+  switch(mode) {
+  case LEARN_NUMBERS_ENGLISH:
+  case LEARN_NUMBERS_ARABIC:
+  case LEARN_NUMBERS_FRENCH:
+  case LEARN_NUMBERS_SWAHILI:
+  case ARITHMETIC_PRACTICE_ENGLISH:
+    return NUMBER_MAPPING;
+  case LEARN_LETTERS_HINDI:
+  case LEARN_LETTERS_KANNADA: //runs the Hindi app, Hindi2LearnLetters
+    return DEVANAGARI_MAPPING;
+  case FREE_PLAY_ARABIC:
+  case FREE_SPELLING_ARABIC:
+  case LEARN_DOTS_ARABIC:
+  case DOT_PRACTICE_ARABIC:
+  case LEARN_LETTERS_ARABIC:
+  case LETTER_PRACTICE_ARABIC:
+  case DOMINOS_ARABIC:
+  case HANGMAN_ARABIC:
+  case ANIMAL_GAME_ARABIC:
+    return ARABIC_MAPPING;
+  case FREE_PLAY_FRENCH:
+  case FREE_SPELLING_FRENCH:
+  case LEARN_DOTS_FRENCH:
+  case DOT_PRACTICE_FRENCH:
+  case LEARN_LETTERS_FRENCH:
+  case LETTER_PRACTICE_FRENCH:
+  case DOMINOS_FRENCH:
+  case HANGMAN_FRENCH:
+  case ANIMAL_GAME_FRENCH:
+    return FRENCH_MAPPING;
+  default: //English and Swahili modes, and number scaffolds, use the library's charset
+    return DEFAULT_CHARSET;
+  }
+}
@@ -0,0 +1,84 @@
+/*
+ * app_modes.h
+ *
+ *  Created on: Oct 19, 2026
+ *
+ * The modes the ApplicationDispatcher can switch between, and the language mapping file each mode's app loads.
+ * The apps take their mapping file paths from here, so the dispatcher can preload a mode's charset without
+ * keeping a copy of its own.
+ */
+
+#ifndef APP_MODES_H_
+#define APP_MODES_H_
+
+struct AppModes
+{
+  enum modes {
+    FREE_PLAY_ENGLISH,
+    FREE_SPELLING_ENGLISH,
+    FREE_NUMBERS_ENGLISH,
+    LEARN_DOTS_ENGLISH,
+    DOT_PRACTICE_ENGLISH,
+    LEARN_LETTERS_ENGLISH,
+    LETTER_PRACTICE_ENGLISH,
+    LEARN_NUMBERS_ENGLISH,
+    DOMINOS_ENGLISH,
+    HANGMAN_ENGLISH,
+    ANIMAL_GAME_ENGLISH,
+	  HOUSEHOLD_GAME_ENGLISH,
+    ARITHMETIC_PRACTICE_ENGLISH,
+    LEARN_LETTERS_HINDI,
+    LEARN_LETTERS_KANNADA,
+    FREE_PLAY_ARABIC,
+    FREE_SPELLING_ARABIC,
+    FREE_NUMBERS_ARABIC,
+    LEARN_DOTS_ARABIC,
+    DOT_PRACTICE_ARABIC,
+    LEARN_LETTERS_ARABIC,
+    LETTER_PRACTICE_ARABIC,
+    LEARN_NUMBERS_ARABIC,
+    DOMINOS_ARABIC,
+    HANGMAN_ARABIC,
+    ANIMAL_GAME_ARABIC,
+    FREE_PLAY_FRENCH,
+    FREE_SPELLING_FRENCH,
+    FREE_NUMBERS_FRENCH,
+    LEARN_DOTS_FRENCH,
+    DOT_PRACTICE_FRENCH,
+    LEARN_LETTERS_FRENCH,
+    LETTER_PRACTICE_FRENCH,
+    LEARN_NUMBERS_FRENCH,
+    DOMINOS_FRENCH,
+    HANGMAN_FRENCH,
+    ANIMAL_GAME_FRENCH,
+    FREE_PLAY_SWAHILI,
+    FREE_SPELLING_SWAHILI,
+    FREE_NUMBERS_SWAHILI,
+    LEARN_DOTS_SWAHILI,
+    DOT_PRACTICE_SWAHILI,
+    LEARN_LETTERS_SWAHILI,
+    LETTER_PRACTICE_SWAHILI,
+    LEARN_NUMBERS_SWAHILI,
+    DOMINOS_SWAHILI,
+    HANGMAN_SWAHILI,
+    ANIMAL_GAME_SWAHILI
+  };
+
+  //The language mapping files the apps load. DEFAULT_CHARSET (the empty path) stands for the library's own
+  //charset, which needs no file.
+  static const char* const DEFAULT_CHARSET;
+  static const char* const ENGLISH_NOMIRROR_MAPPING;
+  static const char* const ARABIC_MAPPING;
+  static const char* const ARABIC_NOMIRROR_MAPPING;
+  static const char* const FRENCH_MAPPING;
+  static const char* const DEVANAGARI_MAPPING;
+  static const char* const KANNADA_MAPPING;
+  static const char* const NUMBER_MAPPING;
+  static const char* const NUMBER_UNMIRRORED_MAPPING;
+
+  //The mapping file loaded by the app that ApplicationDispatcher::switchToSelectedMode() runs for a mode. The
+  //apps pass this to IBTApp themselves, so it is always the file they really load.
+  static const char* mappingFile(modes mode);
+};
+
+#endif /* APP_MODES_H_ */
@@ -0,0 +1,169 @@
+/*
+ * test_charset_registry.cc
+ *
+ *  Created on: Oct 19, 2026
+ *
+ * Checks for CharsetRegistry. A mapping file is fed through a named pipe, so its load stays in flight until the
+ * test writes it: a second get() for the same file meanwhile must wait for that load and share its charset, not
+ * start one of its own. Files that fail to load must not be remembered, so a later get() can succeed. The
+ * preloader must leave files loaded, and skip ones it can't load.
+ *
+ * Usage: test_charset_registry [scratch prefix]
+ * Scratch files are named by adding suffixes to the prefix (test_charset_registry by default), and removed
+ * afterward.
+ *
+ * Build from BWT/src, e.g.:
+ *   g++ -DBT_LINUX -IBrailleTutor-0.7.1/include -Icommon common/tests/test_charset_registry.cc
+ *       common/CharsetRegistry.cc -lbt -lboost_thread -lboost_system -lpthread
+ */
+
+#include <cstdio>
+#include <string>
+#include <vector>
+#include <fstream>
+#include <iostream>
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+
+#include "Dots.h"
+#include "Types.h"
+#include "Charset.h"
+#include "CharsetRegistry.h"
+
+#include <boost/thread.hpp>
+
+//Report a failed check
+static unsigned int check(const bool& ok, const std::string& what)
+{
+  if(!ok) std::cerr << "FAILED: " << what << std::endl;
+  return ok ? 0 : 1;
+}
+
+//A small mapping file's text
+static const char* const mapping_text = "!UTF-8 BEGIN Registry test\n1 a\n12 b\n14 c\n!UTF-8 END\n";
+
+//Write a small mapping file
+static void writeMapping(const std::string& path)
+{
+  std::ofstream out(path.c_str());
+  out << mapping_text;
+}
+
+//Thread functor that gets a charset from the registry, noting when it's done
+struct FunctorGetter
+{
+  const std::string path;
+  CharsetSnapshot& result;
+  bool& done;
+
+  FunctorGetter(const std::string& my_path, CharsetSnapshot& my_result, bool& my_done) :
+    path(my_path), result(my_result), done(my_done) { }
+
+  void operator()()
+  {
+    try { result = CharsetRegistry::instance().get(path); }
+    catch(const BTException&) { }
+    done = true;
+  }
+};
+
+int fakemain(int argc, char** argv)
+{
+  unsigned int failures = 0;
+  const std::string prefix = (argc > 1) ? argv[1] : "test_charset_registry";
+  const std::string piped = prefix + ".pipe.txt";
+  const std::string missing = prefix + ".missing.txt";
+  const std::string preloaded = prefix + ".preloaded.txt";
+  CharsetRegistry& registry = CharsetRegistry::instance();
+
+  //A load in flight: the first getter opens the pipe and blocks reading it; opening the pipe for writing
+  //returns only once it has, so by then the file is marked as loading
+  std::remove(piped.c_str());
+  if(mkfifo(piped.c_str(), 0600) != 0)
+  {
+    std::cerr << "couldn't make the named pipe " << piped << std::endl;
+    return -1;
+  }
+
+  CharsetSnapshot first, second;
+  bool first_done = false, second_done = false;
+  boost::thread first_getter(FunctorGetter(piped, first, first_done));
+  const int pipe_fd = open(piped.c_str(), O_WRONLY);
+
+  boost::thread second_getter(FunctorGetter(piped, second, second_done));
+  boost::this_thread::sleep(boost::posix_time::milliseconds(200));
+  failures += check(!first_done && !second_done, "get() waits for a load in flight");
+  failures += check(!registry.isLoaded(piped), "a load in flight isn't loaded yet");
+
+  const std::string text(mapping_text);
+  if(write(pipe_fd, text.data(), text.size()) != (ssize_t) text.size()) std::cerr << "short write" << std::endl;
+  close(pipe_fd);
+
+  const bool joined = first_getter.timed_join(boost::posix_time::seconds(5)) &&
+                      second_getter.timed_join(boost::posix_time::seconds(5));
+  failures += check(joined, "getters finish once the load does");
+  if(!joined)
+  {
+    //The second getter started a load of its own and is stuck opening the pipe; let it through
+    const int unblock_fd = open(piped.c_str(), O_WRONLY);
+    if(unblock_fd >= 0) close(unblock_fd);
+    first_getter.join();
+    second_getter.join();
+  }
+  failures += check(first && (first == second), "a waiting get() shares the loaded charset");
+  failures += check(first && (first->size() == 3), "the charset is the one written");
+  failures += check(registry.isLoaded(piped), "a finished load is loaded");
+  failures += check(registry.get(piped) == first, "later gets share it too");
+  std::remove(piped.c_str());
+
+  //Failures aren't remembered
+  std::remove(missing.c_str());
+  unsigned int thrown = 0;
+  try { registry.get(missing); }
+  catch(const BTException& e) { if(e.type == BTException::BT_EIO) thrown++; }
+  failures += check(thrown == 1, "a missing file throws");
+  failures += check(!registry.isLoaded(missing), "a failed load isn't loaded");
+  writeMapping(missing);
+  CharsetSnapshot retried;
+  try { retried = registry.get(missing); }
+  catch(const BTException&) { }
+  failures += check(retried && (retried->size() == 3), "a failed load is tried again");
+  std::remove(missing.c_str());
+
+  //Preloading loads what it can and skips the rest
+  writeMapping(preloaded);
+  std::vector<std::string> paths;
+  paths.push_back(prefix + ".nonexistent.txt");
+  paths.push_back(preloaded);
+  registry.preload(paths);
+  registry.preload(std::vector<std::string>()); //waits for the first preloader
+  failures += check(registry.isLoaded(preloaded), "preload() loads files");
+  failures += check(!registry.isLoaded(paths[0]), "preload() skips files it can't load");
+  std::remove(preloaded.c_str());
+
+  if(failures > 0)
+  {
+    std::cerr << failures << " check(s) FAILED" << std::endl;
+    return 1;
+  }
+  std::cout << "checks: OK" << std::endl;
+
+  return 0;
+}
+
+int main(int argc, char** argv)
+{
+  try { return fakemain(argc, argv); }
+  catch(const BTException& e) {
+    std::cerr << "BTException: " << e.why << std::endl;
+    return -1;
+  }
+  catch(...) {
+    std::cerr << "Some other exception happened" << std::endl;
+    return -1;
+  }
+
+  return 0;
+}
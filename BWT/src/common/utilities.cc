@@ -127,19 +127,6 @@ size_t numBytesInUTF8Letter(const char c)
   return 1; //1 byte character
 }
 
-size_t alphabeticIndex(const std::vector<std::string>& alphabet, const std::string& word, int word_pos, const std::string& letter_to_search_for)
-{
-  return alphabeticIndex(alphabet, word, word_pos, letter_to_search_for.at(0));
-}
-
-//FIXME: dumb.
-size_t alphabeticIndex(const std::vector<std::string>& alphabet, const std::string& word, int word_pos, const char letter_to_search_for)
-{
-  int num_bytes_in_letter = numBytesInUTF8Letter(letter_to_search_for);
-  std::string correct_letter(word, word_pos, num_bytes_in_letter);
-  return std::distance(alphabet.begin(), std::find(alphabet.begin(), alphabet.end(), correct_letter));
-}
-
 void BT_sleep(size_t seconds)
 {
 #if defined(BT_LINUX)
@@ -154,5 +141,5 @@ DotSequence convertToDotSequence(const Charset& charset, int n)
 {
   std::stringstream out;
   out << n;
-  return charset[GlyphMapping(out.str())];
+  return charset.dotsFor(out.str());
 }
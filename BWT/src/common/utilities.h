@@ -41,14 +41,6 @@ size_t numBytesInUTF8Letter(const std::string& utf8letter);
  */
 size_t numBytesInUTF8Letter(const char utf8letter);
 
-/*
- * Determines the index of UTF8 character in an alphabet array
- * TODO: Write better explanation
- */
-size_t alphabeticIndex(const std::vector<std::string>&, const std::string&, int, const std::string&);
-
-size_t alphabeticIndex(const std::vector<std::string>&, const std::string&, int, const char);
-
 DotSequence convertToDotSequence(const Charset&,int n);
 
 #endif
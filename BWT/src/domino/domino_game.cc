@@ -11,6 +11,7 @@
 #include <unistd.h>
 #include <sstream>
 #include "domino_game.h"
+#include "common/app_modes.h"
 
 unsigned int DominoGame::current_players_index = 0; //Holds the index of the player whose input we are waiting for.
 std::vector<DominoPlayer> DominoGame::players;
@@ -276,7 +277,7 @@ void DominoGame::playGameOverSounds() const
 
 //++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
 EnglishDominoGame::EnglishDominoGame(IOEventParser& my_iep) :
-  DominoGame(my_iep, "", createAlphabetVector(), new EnglishSoundsUtil, "./resources/Voice/domino_sounds/", "./resources/Voice/student/", false)
+  DominoGame(my_iep, AppModes::mappingFile(AppModes::DOMINOS_ENGLISH), createAlphabetVector(), new EnglishSoundsUtil, "./resources/Voice/domino_sounds/", "./resources/Voice/student/", false)
 {
 
 }
@@ -288,7 +289,7 @@ std::vector<std::string> EnglishDominoGame::createAlphabetVector()
 
 //++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
 ArabicDominoGame::ArabicDominoGame(IOEventParser& my_iep) :
-      DominoGame(my_iep, "./language_mapping_files/arabic_mapping.txt", createAlphabetVector(), new ArabicSoundsUtil, "./resources/Voice/domino_sounds/", "./resources/Voice/student/", false)
+      DominoGame(my_iep, AppModes::mappingFile(AppModes::DOMINOS_ARABIC), createAlphabetVector(), new ArabicSoundsUtil, "./resources/Voice/domino_sounds/", "./resources/Voice/student/", false)
 {
 
 }
@@ -299,7 +300,7 @@ std::vector<std::string> ArabicDominoGame::createAlphabetVector()
 }
 //++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
 FrenchDominoGame::FrenchDominoGame(IOEventParser& my_iep) :
-      DominoGame(my_iep, "./language_mapping_files/french_mapping.txt", createAlphabetVector(), new FrenchSoundsUtil, "./resources/Voice/domino_sounds/", "./resources/Voice/teacher/", false)
+      DominoGame(my_iep, AppModes::mappingFile(AppModes::DOMINOS_FRENCH), createAlphabetVector(), new FrenchSoundsUtil, "./resources/Voice/domino_sounds/", "./resources/Voice/teacher/", false)
 {
 
 }
@@ -310,7 +311,7 @@ std::vector<std::string> FrenchDominoGame::createAlphabetVector()
 }
 //++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
 KiswahiliDominoGame::KiswahiliDominoGame(IOEventParser& my_iep) :
-      DominoGame(my_iep, "", createAlphabetVector(), new KiswahiliSoundsUtil, "./resources/Voice/domino_sounds/", "./resources/Voice/teacher/", false)
+      DominoGame(my_iep, AppModes::mappingFile(AppModes::DOMINOS_SWAHILI), createAlphabetVector(), new KiswahiliSoundsUtil, "./resources/Voice/domino_sounds/", "./resources/Voice/teacher/", false)
 {
 
 }
@@ -323,7 +324,7 @@ std::vector<std::string> KiswahiliDominoGame::createAlphabetVector()
 
 //++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
 English2DominoGame::English2DominoGame(IOEventParser& my_iep) :
-  DominoGame(my_iep, "./language_mapping_files/english_mapping_nomirror.txt", createAlphabetVector(), new English2SoundsUtil, "./resources/Voice/domino_sounds/", "./resources/Voice/student/", true)
+  DominoGame(my_iep, AppModes::ENGLISH_NOMIRROR_MAPPING, createAlphabetVector(), new English2SoundsUtil, "./resources/Voice/domino_sounds/", "./resources/Voice/student/", true)
 {
 
 }
@@ -335,7 +336,7 @@ std::vector<std::string> English2DominoGame::createAlphabetVector()
 
 //++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
 Arabic2DominoGame::Arabic2DominoGame(IOEventParser& my_iep) :
-      DominoGame(my_iep, "./language_mapping_files/arabic_mapping_nomirror.txt", createAlphabetVector(), new Arabic2SoundsUtil, "./resources/Voice/domino_sounds/", "./resources/Voice/student/", true)
+      DominoGame(my_iep, AppModes::ARABIC_NOMIRROR_MAPPING, createAlphabetVector(), new Arabic2SoundsUtil, "./resources/Voice/domino_sounds/", "./resources/Voice/student/", true)
 {
 
 }
@@ -64,7 +64,8 @@ int DominoPlayer::updateAndGetScore(const std::string& chosen_letter, const unsi
 unsigned char DominoPlayer::extractRelevantDotPattern(const std::string& letter, const Side side)
 {
   //First, we get the full dot pattern that comprises the letter
-  static const BrailleTutorNS::Charset& game_charset = IBTApp::getCurrentCharset();
+  const BrailleTutorNS::CharsetSnapshot game_charset_snapshot = IBTApp::getCurrentCharset();
+  const BrailleTutorNS::Charset &game_charset = *game_charset_snapshot;
   const unsigned char dot_pattern = game_charset[letter];
 
   //Now we extract those dots that lie on the given Side.
@@ -7,13 +7,15 @@
 #include "timer.h"
 
 TimerTask::TimerTask(const DominoGame& my_game, unsigned int t) :
-  game(my_game),turn(t)
+  game(my_game),turn(t),deadline(TimeInterval::now() + TimeInterval(25, 0))
 {
 }
 
 void TimerTask::operator()()
 {
-  BT_sleep(25);
+  // The turn's 25 seconds run from when the timer was made, however long
+  // the thread took to start
+  TimeInterval::sleepUntil(deadline);
   //sleep(7); //Good for testing the concurrency
   game.notifyTimeoutOccured(turn);
 }
@@ -31,6 +31,7 @@ public:
 private:
   const DominoGame& game;
   unsigned int turn; //the turn at which this thread was invoked
+  TimeInterval deadline; //when the turn times out
 };
 
 #endif /* TIMER_H_ */
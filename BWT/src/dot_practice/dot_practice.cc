@@ -6,6 +6,7 @@
  */
 #include <boost/assign/list_of.hpp>
 #include "dot_practice.h"
+#include "common/app_modes.h"
 
 DotPractice::DotPractice(IOEventParser& my_iep, const std::string& path_to_mapping_file, SoundsUtil* my_su, std::vector<std::string> sl, std::vector<
     std::string> ml, std::vector<std::string> ll, bool f) :
@@ -94,16 +95,14 @@ void DotPractice::PD_new()
       }
     }
 
-    const Charset &charset = IBTApp::getCurrentCharset();
+    const CharsetSnapshot charset_snapshot = IBTApp::getCurrentCharset();
+    const Charset &charset = *charset_snapshot;
     if( need_short )
     {
       for(unsigned int i = 0; i < short_letters.size(); i++)
       {
         //std::cout << "		(DEBUG)Before short letters" << std::endl;
-        GlyphMapping temp(short_letters[i]);
-        //std::cout << "		(DEBUG)temp is:" << (std::string) temp << std::endl;
-        //std::cout << "		(DEBUG)Charset name is:" << (std::string) charset.getName() << std::endl;
-        choices.push_back(charset[temp]);
+        choices.push_back(charset.dotsFor(short_letters[i]));
       }
       target_length = 0;
     }
@@ -112,7 +111,7 @@ void DotPractice::PD_new()
       for(unsigned int i = 0; i < med_letters.size(); i++)
       {
         //std::cout << "    (DEBUG)Before med letters" << std::endl;
-        choices.push_back(charset[GlyphMapping(med_letters[i])]);
+        choices.push_back(charset.dotsFor(med_letters[i]));
       }
       target_length = 1;
     }
@@ -121,7 +120,7 @@ void DotPractice::PD_new()
       for(unsigned int i = 0; i < long_letters.size(); i++)
       {
         //std::cout << "    (DEBUG)Before long letters" << std::endl;
-        choices.push_back(charset[GlyphMapping(long_letters[i])]);
+        choices.push_back(charset.dotsFor(long_letters[i]));
       }
       target_length = 2;
     }
@@ -190,7 +189,7 @@ void DotPractice::PD_attempt(int i)
 }
 //++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
 EnglishDotPractice::EnglishDotPractice(IOEventParser& my_iep) :
-  DotPractice(my_iep, "", new EnglishSoundsUtil, createShortLettersVector(), createMediumLettersVector(), createLongLettersVector(), false)
+  DotPractice(my_iep, AppModes::mappingFile(AppModes::DOT_PRACTICE_ENGLISH), new EnglishSoundsUtil, createShortLettersVector(), createMediumLettersVector(), createLongLettersVector(), false)
 {
 
 }
@@ -211,7 +210,7 @@ std::vector<std::string> EnglishDotPractice::createLongLettersVector()
 }
 //++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
 ArabicDotPractice::ArabicDotPractice(IOEventParser& my_iep) :
-      DotPractice(my_iep, "./language_mapping_files/arabic_mapping.txt", new ArabicSoundsUtil, createShortLettersVector(), createMediumLettersVector(), createLongLettersVector(), false)
+      DotPractice(my_iep, AppModes::mappingFile(AppModes::DOT_PRACTICE_ARABIC), new ArabicSoundsUtil, createShortLettersVector(), createMediumLettersVector(), createLongLettersVector(), false)
 {
 
 }
@@ -232,7 +231,7 @@ std::vector<std::string> ArabicDotPractice::createLongLettersVector()
 }
 //++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
 FrenchDotPractice::FrenchDotPractice(IOEventParser& my_iep) :
-      DotPractice(my_iep, "./language_mapping_files/french_mapping.txt", new FrenchSoundsUtil, createShortLettersVector(), createMediumLettersVector(), createLongLettersVector(), false)
+      DotPractice(my_iep, AppModes::mappingFile(AppModes::DOT_PRACTICE_FRENCH), new FrenchSoundsUtil, createShortLettersVector(), createMediumLettersVector(), createLongLettersVector(), false)
 {
 
 }
@@ -253,7 +252,7 @@ std::vector<std::string> FrenchDotPractice::createLongLettersVector()
 }
 //++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
 KiswahiliDotPractice::KiswahiliDotPractice(IOEventParser& my_iep) :
-      DotPractice(my_iep, "", new KiswahiliSoundsUtil, createShortLettersVector(), createMediumLettersVector(), createLongLettersVector(), false)
+      DotPractice(my_iep, AppModes::mappingFile(AppModes::DOT_PRACTICE_SWAHILI), new KiswahiliSoundsUtil, createShortLettersVector(), createMediumLettersVector(), createLongLettersVector(), false)
 {
 
 }
@@ -275,7 +274,7 @@ std::vector<std::string> KiswahiliDotPractice::createLongLettersVector()
 
 //++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
 English2DotPractice::English2DotPractice(IOEventParser& my_iep) :
-  DotPractice(my_iep, "./language_mapping_files/english_mapping_nomirror.txt", new English2SoundsUtil, createShortLettersVector(), createMediumLettersVector(), createLongLettersVector(), true)
+  DotPractice(my_iep, AppModes::ENGLISH_NOMIRROR_MAPPING, new English2SoundsUtil, createShortLettersVector(), createMediumLettersVector(), createLongLettersVector(), true)
 {
 
 }
@@ -296,7 +295,7 @@ std::vector<std::string> English2DotPractice::createLongLettersVector()
 }
 //++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
 Arabic2DotPractice::Arabic2DotPractice(IOEventParser& my_iep) :
-      DotPractice(my_iep, "./language_mapping_files/arabic_mapping_nomirror.txt", new Arabic2SoundsUtil, createShortLettersVector(), createMediumLettersVector(), createLongLettersVector(), true)
+      DotPractice(my_iep, AppModes::ARABIC_NOMIRROR_MAPPING, new Arabic2SoundsUtil, createShortLettersVector(), createMediumLettersVector(), createLongLettersVector(), true)
 {
 
 }
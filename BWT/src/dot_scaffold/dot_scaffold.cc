@@ -6,6 +6,7 @@
  */
 
 #include "dot_scaffold.h"
+#include "common/app_modes.h"
 
 using namespace BrailleTutorNS;
 
@@ -36,42 +37,42 @@ void DotScaffold::processEvent(IOEvent& e)
 //++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
 
 EnglishDotScaffold::EnglishDotScaffold(IOEventParser& my_iep) :
-  DotScaffold(my_iep, "", new EnglishSoundsUtil, false)
+  DotScaffold(my_iep, AppModes::mappingFile(AppModes::FREE_PLAY_ENGLISH), new EnglishSoundsUtil, false)
 {
   getTeacherVoice().say("free play.wav");
 }
 //++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
 
 ArabicDotScaffold::ArabicDotScaffold(IOEventParser& my_iep) :
-  DotScaffold(my_iep, "./language_mapping_files/arabic_mapping.txt", new ArabicSoundsUtil, false)
+  DotScaffold(my_iep, AppModes::mappingFile(AppModes::FREE_PLAY_ARABIC), new ArabicSoundsUtil, false)
 {
   getTeacherVoice().say("free play_arabic.wav");
 }
 //++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
 
 FrenchDotScaffold::FrenchDotScaffold(IOEventParser& my_iep) :
-  DotScaffold(my_iep, "./language_mapping_files/french_mapping.txt", new FrenchSoundsUtil, false)
+  DotScaffold(my_iep, AppModes::mappingFile(AppModes::FREE_PLAY_FRENCH), new FrenchSoundsUtil, false)
 {
   getTeacherVoice().say("free play_french.wav");
 }
 //++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
 
 KiswahiliDotScaffold::KiswahiliDotScaffold(IOEventParser& my_iep) :
-  DotScaffold(my_iep, "", new KiswahiliSoundsUtil, false)
+  DotScaffold(my_iep, AppModes::mappingFile(AppModes::FREE_PLAY_SWAHILI), new KiswahiliSoundsUtil, false)
 {
   getTeacherVoice().say("free play_kiswahili.wav");
 }
 //++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
 
 English2DotScaffold::English2DotScaffold(IOEventParser& my_iep) :
-  DotScaffold(my_iep, "./language_mapping_files/english_mapping_nomirror.txt", new English2SoundsUtil, true)
+  DotScaffold(my_iep, AppModes::ENGLISH_NOMIRROR_MAPPING, new English2SoundsUtil, true)
 {
   getTeacherVoice().say("free play.wav");
 }
 //++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
 
 Arabic2DotScaffold::Arabic2DotScaffold(IOEventParser& my_iep) :
-  DotScaffold(my_iep, "./language_mapping_files/arabic_mapping_nomirror.txt", new Arabic2SoundsUtil, true)
+  DotScaffold(my_iep, AppModes::ARABIC_NOMIRROR_MAPPING, new Arabic2SoundsUtil, true)
 {
   getTeacherVoice().say("free play_arabic.wav");
 }
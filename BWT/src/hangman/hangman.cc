@@ -8,12 +8,13 @@
 
 #include <boost/assign/list_of.hpp>
 #include "hangman.h"
+#include "common/app_modes.h"
 
 Hangman::Hangman(IOEventParser& my_iep, const std::string& path_to_mapping_file, SoundsUtil* my_su, const std::vector<std::string> my_alph, const std::vector<
     std::string> sw, const std::vector<std::string> mw, const std::vector<std::string> lw, const std::vector<std::string> xlw, const std::vector<
     std::string> xxlw, bool f) :
-  IBTApp(my_iep, path_to_mapping_file), iep(my_iep), su(my_su), alphabet(my_alph), short_words(sw), med_words(mw), long_words(lw), xlong_words(xlw),
-      xxlong_words(xxlw), letter_skill(alphabet.size()), firsttime(true), turncount(0), mistake(0), correctcount(0), j(0), word(""),
+  IBTApp(my_iep, path_to_mapping_file), iep(my_iep), su(my_su), alphabet(my_alph, *IBTApp::getCurrentCharset()), short_words(sw), med_words(mw), long_words(lw), xlong_words(xlw),
+      xxlong_words(xxlw), words(joinWords(sw, mw, lw, xlw, xxlw)), guess(words, 2, 3), letter_skill(alphabet.size()), firsttime(true), turncount(0), mistake(0), correctcount(0), j(0), word(""),
       target_letter(""), word_pos(0), word_length(0), answer(""), nomirror(f)
 {
   for(size_t i = 0; i < alphabet.size(); i++)
@@ -30,6 +31,18 @@ Hangman::Hangman(IOEventParser& my_iep, const std::string& path_to_mapping_file,
   HM_new();
 }
 
+const std::vector<std::string> Hangman::joinWords(const std::vector<std::string>& sw, const std::vector<std::string>& mw,
+    const std::vector<std::string>& lw, const std::vector<std::string>& xlw, const std::vector<std::string>& xxlw)
+{
+  std::vector<std::string> all;
+  const std::vector<std::string>* lists[] = { &sw, &mw, &lw, &xlw, &xxlw };
+  for(int i = 0; i < 5; i++)
+    for(size_t j = 0; j < lists[i]->size(); j++)
+      if( !(*lists[i])[j].empty() )
+        all.push_back((*lists[i])[j]);
+  return all;
+}
+
 void Hangman::processEvent(IOEvent& e)
 {
   //Whenever the user hits Button0 we immediately want the LETTER event to be generated so that he doesnt have to wait for the timeout
@@ -59,13 +72,12 @@ void Hangman::processEvent(IOEvent& e)
 
 void Hangman::HM_new()
 {
-  static const Charset &charset = IBTApp::getCurrentCharset();
-
   //check if we've lost any letter skills
   std::vector<int> low_letters;
   turncount = 0;
   mistake = 0;
   correctcount = 0;
+  guess.reset();
   for(size_t i = 0; i < alphabet.size(); i++)
   {
     if( letter_skill[i].estimate() < .5 )
@@ -78,12 +90,13 @@ void Hangman::HM_new()
   {
     //choose a letter skill to train
     random_shuffle(low_letters.begin(), low_letters.end());
-    target_letter = alphabet.at(low_letters.front());
+    const int target_index = low_letters.front();
+    target_letter = alphabet.at(target_index);
 
     su->saySound(getTeacherVoice(), "to write the letter");
     su->sayLetter(getTeacherVoice(), target_letter);
     su->saySound(getTeacherVoice(), "press");
-    su->sayDotSequence(getTeacherVoice(), charset[GlyphMapping(target_letter)]);
+    su->sayDotSequence(getTeacherVoice(), alphabet.dots(target_index));
 
     su->saySound(getTeacherVoice(), "please write");
     su->sayLetter(getTeacherVoice(), target_letter);
@@ -179,17 +192,15 @@ void Hangman::HM_new()
     {
       su->saySound(getTeacherVoice(), "DASH");
     }
-    int num_bytes_in_letter = numBytesInUTF8Letter(word);
     answer.clear();
 
     //We want answer's size to be same as word's.
     answer.resize(word.size());// filled with null characters.
 
-    //Fill answer with *s, but add these *s every num_bytes_in_letter intervals. To keep consistent with word's
-    for(size_t i = 0; i<word.size();)
+    //Fill answer with *s, one at the start of each of word's letters
+    for(Alphabet::LetterIterator letter(alphabet, word); !letter.done(); ++letter)
     {
-      answer.replace(i,1,"*");
-      i = i + numBytesInUTF8Letter(word.at(i));
+      answer.replace(letter.position(), 1, "*");
     }
     /*for(size_t i = 0; i<word_length*num_bytes_in_letter;i=i+num_bytes_in_letter)//FIXME:we assuming that every character in word will have the same number_of_bytes in UTF8.
     {
@@ -214,13 +225,13 @@ void Hangman::HM_attempt(std::string i)
   turncount = 0;
   if( mistake == 7 )
   { //after 7 mistakes students give one chance to guess the word
-    //int index = alphabeticIndex(alphabet, word, word_pos, word.at(word_pos));
-    int num_bytes_in_letter = numBytesInUTF8Letter(word.at(word_pos));
+    int num_bytes_in_letter = alphabet.letterBytes(word, word_pos);
     std::string correct_letter(word, word_pos, num_bytes_in_letter);
     std::cout << "		(DEBUG)Corr letter:" << correct_letter << " word.at(word_pos)" << correct_letter << std::endl;
+    guess.addLetter(i);
     if( i.compare(correct_letter) == 0 )
     { //letter is next in sequence
-      word_pos = word_pos + numBytesInUTF8Letter(word.at(word_pos)); //move to next character
+      word_pos = word_pos + num_bytes_in_letter; //move to next character
       if( word_pos == word.size() )
       { //are we done?
         su->saySound(getTeacherVoice(), "good");
@@ -233,6 +244,13 @@ void Hangman::HM_attempt(std::string i)
     else
     { //guess is incorrect
       su->saySound(getTeacherVoice(), "no");
+      //If the guess was heading for another of the words, spell that one too, so the mix-up can be explained
+      const Dictionary::Match* looks_like = guess.closest();
+      if( looks_like && words[looks_like->word] != guess.word() && words[looks_like->word] != word )
+      {
+        su->sayLetterSequence(getTeacherVoice(), words[looks_like->word]);
+        std::cout << "Your guess " << guess.word() << " looks like " << words[looks_like->word] << std::endl;
+      }
       su->saySound(getTeacherVoice(), "solution");
       su->sayLetterSequence(getTeacherVoice(), word);
       std::cout << "SORRY you have run out of guesses the correct word was " << word << std::endl;
@@ -244,11 +262,12 @@ void Hangman::HM_attempt(std::string i)
   }
   else
   {
-    for(; word_pos < word.size(); word_pos = word_pos + numBytesInUTF8Letter(word.at(word_pos)))
+    for(Alphabet::LetterIterator letter(alphabet, word); !letter.done(); ++letter)
     {
-      int index = alphabeticIndex(alphabet, word, word_pos, word.at(word_pos));
-      int num_bytes_in_letter = numBytesInUTF8Letter(word.at(word_pos));
-      std::string correct_letter(word, word_pos, num_bytes_in_letter);
+      word_pos = letter.position();
+      int index = letter.index();
+      int num_bytes_in_letter = letter.bytes();
+      std::string correct_letter = letter.letter();
       if( i.compare(correct_letter) == 0 )
       { //letter is next in sequence
         //std::cout<<"		(DEBUG)here1"<<std::endl;
@@ -294,10 +313,10 @@ void Hangman::HM_attempt(std::string i)
       return;
     }
     su->saySound(getTeacherVoice(), "current");
-    for(int s = 0; s < answer.size();)
+    //answer's letters sit where word's do
+    for(Alphabet::LetterIterator guessed(alphabet, word); !guessed.done(); ++guessed)
     {
-      int num_bytes_in_letter = numBytesInUTF8Letter(answer.at(s));
-      std::string letter(answer, s, num_bytes_in_letter);
+      std::string letter(answer, guessed.position(), guessed.bytes());
       std::cout<<"		(DEBUG)Extracted letter from answer is:"<<letter<<std::endl;
       if( !strcmp(letter.c_str(), "*") )
       {
@@ -307,7 +326,6 @@ void Hangman::HM_attempt(std::string i)
       {
         su->sayLetter(getTeacherVoice(), letter);
       }
-      s=s+num_bytes_in_letter;
     }
     if( mistake == 7 )
     {
@@ -350,43 +368,48 @@ void Hangman::HM_attempt(std::string i)
 //++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
 
 EnglishHangman::EnglishHangman(IOEventParser& my_iep) :
-      Hangman(my_iep, "", new EnglishSoundsUtil, createAlphabet(), createShortWords(), createMedWords(), createLongWords(), createxLongWords(), createxxLongWords(), false)
+      Hangman(my_iep, AppModes::mappingFile(AppModes::HANGMAN_ENGLISH), new EnglishSoundsUtil, createAlphabet(), createShortWords(), createMedWords(), createLongWords(), createxLongWords(), createxxLongWords(), false)
 {
 
 }
 
+const std::vector<std::string> EnglishHangman::createWords()
+{
+  return joinWords(createShortWords(), createMedWords(), createLongWords(), createxLongWords(), createxxLongWords());
+}
+
 const std::vector<std::string> EnglishHangman::createAlphabet() const
 {
   return boost::assign::list_of("A")("B")("C")("D")("E")("F")("G")("H")("I")("J")("K")("L")("M")("N")("O")("P")("Q")("R")("S")("T")("U")("V")("W")("X")("Y")("Z");
 }
 
 //3 letter words
-const std::vector<std::string> EnglishHangman::createShortWords() const
+const std::vector<std::string> EnglishHangman::createShortWords()
 {
   //XXX:Not used in the application code
   return boost::assign::list_of("CAT")("DOG")("HOW")("LET")("MOM")("NOT")("SET")("GET")("YES")("ZOO");
 }
 
 //4 letter words
-const std::vector<std::string> EnglishHangman::createMedWords() const
+const std::vector<std::string> EnglishHangman::createMedWords()
 {
   return boost::assign::list_of("NOTE")("LION")("QUIT")("REAL")("TIME")("VIEW")("EXAM")("YAWN")("FOUR")("BLUE")("TREE")("FROG")("NOSE")("FAST")("SLOW")("PLAY")("REST")("HOME")("PARK")("SICK")("SING")("BOOK")("JUMP")("STOP")("WALK");
 }
 
 //5 letter words
-const std::vector<std::string> EnglishHangman::createLongWords() const
+const std::vector<std::string> EnglishHangman::createLongWords()
 {
   return boost::assign::list_of("PIZZA")("APPLE")("BEACH")("INDIA")("SLATE")("MOUSE")("MONEY")("WATER")("GREAT")("GRADE")("GRAND")("STATE")("NIGHT")("DRESS")("CLOCK")("THING")("WATCH")("CLEAN")("CHECK")("SEVEN")("HOUSE")("STORY")("ABOUT")("SOUND")("ROUND");
 }
 
 //6 letter words
-const std::vector<std::string> EnglishHangman::createxLongWords() const
+const std::vector<std::string> EnglishHangman::createxLongWords()
 {
   return boost::assign::list_of("PLEASE")("GARDEN")("YELLOW")("ORANGE")("PURPLE")("FLOWER")("FRIEND")("MATHRU")("GROUND")("PLEASE")("FAMILY")("BORROW")("PUNISH")("ALWAYS")("ACROSS")("SQUARE")("PERSON")("INSIDE")("NUMBER")("INSECT");
 }
 
 //7 letter words
-const std::vector<std::string> EnglishHangman::createxxLongWords() const
+const std::vector<std::string> EnglishHangman::createxxLongWords()
 {
   return boost::assign::list_of("STUDENT")("TEACHER")("PRETEND")("JEALOUS")("HUNDRED")("WEATHER")("WHISPER")("MILLION")("CHICKEN")("OCTOPUS");
 }
@@ -394,46 +417,51 @@ const std::vector<std::string> EnglishHangman::createxxLongWords() const
 //++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
 
 ArabicHangman::ArabicHangman(IOEventParser& my_iep) :
-      Hangman(my_iep, "./language_mapping_files/arabic_mapping.txt", new ArabicSoundsUtil, createAlphabet(), createShortWords(), createMedWords(), createLongWords(), createxLongWords(), createxxLongWords(), false)
+      Hangman(my_iep, AppModes::mappingFile(AppModes::HANGMAN_ARABIC), new ArabicSoundsUtil, createAlphabet(), createShortWords(), createMedWords(), createLongWords(), createxLongWords(), createxxLongWords(), false)
 {
 
 }
 
+const std::vector<std::string> ArabicHangman::createWords()
+{
+  return joinWords(createShortWords(), createMedWords(), createLongWords(), createxLongWords(), createxxLongWords());
+}
+
 const std::vector<std::string> ArabicHangman::createAlphabet() const
 {
   return boost::assign::list_of("ا")("ب")("ت")("ث")("ج")("ح")("خ")("د")("ذ")("ر")("ز")("س")("ش")("ص")("ض")("ط")("ظ")("ع")("غ")("ف")("ق")("ك")("ل")("م")("ن")("ه")("و")("ي");
 }
 
 //3 letter words
-const std::vector<std::string> ArabicHangman::createShortWords() const
+const std::vector<std::string> ArabicHangman::createShortWords()
 {
   //XXX:Not used in the application code
   return boost::assign::list_of("");
 }
 
 //4 letter words
-const std::vector<std::string> ArabicHangman::createMedWords() const
+const std::vector<std::string> ArabicHangman::createMedWords()
 {
   //return boost::assign::list_of("ضصثق")("شسيب")("دجحخ");
   return boost::assign::list_of("ضفدع")("شجرة")("ضجيج")("سريع")("كتاب")("مريض")("عظيم")("سبعة");
 }
 
 //5 letter words
-const std::vector<std::string> ArabicHangman::createLongWords() const
+const std::vector<std::string> ArabicHangman::createLongWords()
 {
   //return boost::assign::list_of("طكمنت")("جحخهع");
   return boost::assign::list_of("فوشيا")("طعام")("داخل")("متكبر");
 }
 
 //6 letter words
-const std::vector<std::string> ArabicHangman::createxLongWords() const
+const std::vector<std::string> ArabicHangman::createxLongWords()
 {
   //return boost::assign::list_of("ةىركبت")("ضصهثشسي");
   return boost::assign::list_of("توفاحة")("موسيقى")("معلمتي")("الكحول");
 }
 
 //7 letter words
-const std::vector<std::string> ArabicHangman::createxxLongWords() const
+const std::vector<std::string> ArabicHangman::createxxLongWords()
 {
   //return boost::assign::list_of("منتالبي");
   return boost::assign::list_of("باذنجان");
@@ -442,44 +470,49 @@ const std::vector<std::string> ArabicHangman::createxxLongWords() const
 //++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
 
 FrenchHangman::FrenchHangman(IOEventParser& my_iep) :
-      Hangman(my_iep, "./language_mapping_files/french_mapping.txt", new FrenchSoundsUtil, createAlphabet(), createShortWords(), createMedWords(), createLongWords(), createxLongWords(), createxxLongWords(), false)
+      Hangman(my_iep, AppModes::mappingFile(AppModes::HANGMAN_FRENCH), new FrenchSoundsUtil, createAlphabet(), createShortWords(), createMedWords(), createLongWords(), createxLongWords(), createxxLongWords(), false)
 {
 
 }
 
+const std::vector<std::string> FrenchHangman::createWords()
+{
+  return joinWords(createShortWords(), createMedWords(), createLongWords(), createxLongWords(), createxxLongWords());
+}
+
 const std::vector<std::string> FrenchHangman::createAlphabet() const
 {
   return boost::assign::list_of("A")("B")("C")("D")("E")("F")("G")("H")("I")("J")("K")("L")("M")("N")("O")("P")("Q")("R")("S")("T")("U")("V")("W")("X")("Y")("Z")("Ç")("É")("À")("È")("Ù")("Â")("Ê")("Î")("Ô")("Û")("Ë")("Ï")("Ü")("œ");
 }
 
 //3 letter words
-const std::vector<std::string> FrenchHangman::createShortWords() const
+const std::vector<std::string> FrenchHangman::createShortWords()
 {
   //XXX:Not used in the application code
   return boost::assign::list_of("");
 }
 
 //4 letter words
-const std::vector<std::string> FrenchHangman::createMedWords() const
+const std::vector<std::string> FrenchHangman::createMedWords()
 {
   //return boost::assign::list_of("AœÜB");
   return boost::assign::list_of("FAUX")("BLEU")("CAFÉ");
 }
 
 //5 letter words
-const std::vector<std::string> FrenchHangman::createLongWords() const
+const std::vector<std::string> FrenchHangman::createLongWords()
 {
   return boost::assign::list_of("MERCI")("ROUGE")("HÔTEL");
 }
 
 //6 letter words
-const std::vector<std::string> FrenchHangman::createxLongWords() const
+const std::vector<std::string> FrenchHangman::createxLongWords()
 {
   return boost::assign::list_of("CHARGÉ")("PETITE")("SUCCÈS");
 }
 
 //7 letter words
-const std::vector<std::string> FrenchHangman::createxxLongWords() const
+const std::vector<std::string> FrenchHangman::createxxLongWords()
 {
   return boost::assign::list_of("ATTACHÉ")("BONJOUR")("HUÎTRES");
 }
@@ -487,44 +520,49 @@ const std::vector<std::string> FrenchHangman::createxxLongWords() const
 //TODO: Currently just using the French words. Need to implement with Swahili'ish/English words?
 
 KiswahiliHangman::KiswahiliHangman(IOEventParser& my_iep) :
-      Hangman(my_iep, "", new KiswahiliSoundsUtil, createAlphabet(), createShortWords(), createMedWords(), createLongWords(), createxLongWords(), createxxLongWords(), false)
+      Hangman(my_iep, AppModes::mappingFile(AppModes::HANGMAN_SWAHILI), new KiswahiliSoundsUtil, createAlphabet(), createShortWords(), createMedWords(), createLongWords(), createxLongWords(), createxxLongWords(), false)
 {
 
 }
 
+const std::vector<std::string> KiswahiliHangman::createWords()
+{
+  return joinWords(createShortWords(), createMedWords(), createLongWords(), createxLongWords(), createxxLongWords());
+}
+
 const std::vector<std::string> KiswahiliHangman::createAlphabet() const
 {
   return boost::assign::list_of("A")("B")("C")("D")("E")("F")("G")("H")("I")("J")("K")("L")("M")("N")("O")("P")("R")("S")("T")("U")("W")("Y")("Z");
 }
 
 //3 letter words
-const std::vector<std::string> KiswahiliHangman::createShortWords() const
+const std::vector<std::string> KiswahiliHangman::createShortWords()
 {
   //XXX:Not used in the application code
   return boost::assign::list_of("");
 }
 
 //4 letter words
-const std::vector<std::string> KiswahiliHangman::createMedWords() const
+const std::vector<std::string> KiswahiliHangman::createMedWords()
 {
   //return boost::assign::list_of("AœÜB");
   return boost::assign::list_of("FAUX")("BLEU")("CAFÉ");
 }
 
 //5 letter words
-const std::vector<std::string> KiswahiliHangman::createLongWords() const
+const std::vector<std::string> KiswahiliHangman::createLongWords()
 {
   return boost::assign::list_of("MERCI")("ROUGE")("HÔTEL");
 }
 
 //6 letter words
-const std::vector<std::string> KiswahiliHangman::createxLongWords() const
+const std::vector<std::string> KiswahiliHangman::createxLongWords()
 {
   return boost::assign::list_of("CHARGÉ")("PETITE")("SUCCÈS");
 }
 
 //7 letter words
-const std::vector<std::string> KiswahiliHangman::createxxLongWords() const
+const std::vector<std::string> KiswahiliHangman::createxxLongWords()
 {
   return boost::assign::list_of("ATTACHÉ")("BONJOUR")("HUÎTRES");
 }
@@ -532,43 +570,48 @@ const std::vector<std::string> KiswahiliHangman::createxxLongWords() const
 //++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
 
 English2Hangman::English2Hangman(IOEventParser& my_iep) :
-      Hangman(my_iep, "./language_mapping_files/english_mapping_nomirror.txt", new English2SoundsUtil, createAlphabet(), createShortWords(), createMedWords(), createLongWords(), createxLongWords(), createxxLongWords(), true)
+      Hangman(my_iep, AppModes::ENGLISH_NOMIRROR_MAPPING, new English2SoundsUtil, createAlphabet(), createShortWords(), createMedWords(), createLongWords(), createxLongWords(), createxxLongWords(), true)
 {
 
 }
 
+const std::vector<std::string> English2Hangman::createWords()
+{
+  return joinWords(createShortWords(), createMedWords(), createLongWords(), createxLongWords(), createxxLongWords());
+}
+
 const std::vector<std::string> English2Hangman::createAlphabet() const
 {
   return boost::assign::list_of("A")("B")("C")("D")("E")("F")("G")("H")("I")("J")("K")("L")("M")("N")("O")("P")("Q")("R")("S")("T")("U")("V")("W")("X")("Y")("Z");
 }
 
 //3 letter words
-const std::vector<std::string> English2Hangman::createShortWords() const
+const std::vector<std::string> English2Hangman::createShortWords()
 {
   //XXX:Not used in the application code
   return boost::assign::list_of("CAT")("DOG")("HOW")("LET")("MOM")("NOT")("SET")("GET")("YES")("ZOO");
 }
 
 //4 letter words
-const std::vector<std::string> English2Hangman::createMedWords() const
+const std::vector<std::string> English2Hangman::createMedWords()
 {
   return boost::assign::list_of("NOTE")("LION")("QUIT")("REAL")("TIME")("VIEW")("EXAM")("YAWN")("FOUR")("BLUE")("TREE")("FROG")("NOSE")("FAST")("SLOW")("PLAY")("REST")("HOME")("PARK")("SICK")("SING")("BOOK")("JUMP")("STOP")("WALK");
 }
 
 //5 letter words
-const std::vector<std::string> English2Hangman::createLongWords() const
+const std::vector<std::string> English2Hangman::createLongWords()
 {
   return boost::assign::list_of("PIZZA")("APPLE")("BEACH")("INDIA")("SLATE")("MOUSE")("MONEY")("WATER")("GREAT")("GRADE")("GRAND")("STATE")("NIGHT")("DRESS")("CLOCK")("THING")("WATCH")("CLEAN")("CHECK")("SEVEN")("HOUSE")("STORY")("ABOUT")("SOUND")("ROUND");
 }
 
 //6 letter words
-const std::vector<std::string> English2Hangman::createxLongWords() const
+const std::vector<std::string> English2Hangman::createxLongWords()
 {
   return boost::assign::list_of("PLEASE")("GARDEN")("YELLOW")("ORANGE")("PURPLE")("FLOWER")("FRIEND")("MATHRU")("GROUND")("PLEASE")("FAMILY")("BORROW")("PUNISH")("ALWAYS")("ACROSS")("SQUARE")("PERSON")("INSIDE")("NUMBER")("INSECT");
 }
 
 //7 letter words
-const std::vector<std::string> English2Hangman::createxxLongWords() const
+const std::vector<std::string> English2Hangman::createxxLongWords()
 {
   return boost::assign::list_of("STUDENT")("TEACHER")("PRETEND")("JEALOUS")("HUNDRED")("WEATHER")("WHISPER")("MILLION")("CHICKEN")("OCTOPUS");
 }
@@ -576,46 +619,51 @@ const std::vector<std::string> English2Hangman::createxxLongWords() const
 //++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
 
 Arabic2Hangman::Arabic2Hangman(IOEventParser& my_iep) :
-      Hangman(my_iep, "./language_mapping_files/arabic_mapping_nomirror.txt", new Arabic2SoundsUtil, createAlphabet(), createShortWords(), createMedWords(), createLongWords(), createxLongWords(), createxxLongWords(), true)
+      Hangman(my_iep, AppModes::ARABIC_NOMIRROR_MAPPING, new Arabic2SoundsUtil, createAlphabet(), createShortWords(), createMedWords(), createLongWords(), createxLongWords(), createxxLongWords(), true)
 {
 
 }
 
+const std::vector<std::string> Arabic2Hangman::createWords()
+{
+  return joinWords(createShortWords(), createMedWords(), createLongWords(), createxLongWords(), createxxLongWords());
+}
+
 const std::vector<std::string> Arabic2Hangman::createAlphabet() const
 {
   return boost::assign::list_of("ا")("ب")("ت")("ث")("ج")("ح")("خ")("د")("ذ")("ر")("ز")("س")("ش")("ص")("ض")("ط")("ظ")("ع")("غ")("ف")("ق")("ك")("ل")("م")("ن")("ه")("و")("ي");
 }
 
 //3 letter words
-const std::vector<std::string> Arabic2Hangman::createShortWords() const
+const std::vector<std::string> Arabic2Hangman::createShortWords()
 {
   //XXX:Not used in the application code
   return boost::assign::list_of("");
 }
 
 //4 letter words
-const std::vector<std::string> Arabic2Hangman::createMedWords() const
+const std::vector<std::string> Arabic2Hangman::createMedWords()
 {
   //return boost::assign::list_of("ضصثق")("شسيب")("دجحخ");
   return boost::assign::list_of("ضفدع")("شجرة")("ضجيج")("سريع")("كتاب")("مريض")("عظيم")("سبعة");
 }
 
 //5 letter words
-const std::vector<std::string> Arabic2Hangman::createLongWords() const
+const std::vector<std::string> Arabic2Hangman::createLongWords()
 {
   //return boost::assign::list_of("طكمنت")("جحخهع");
   return boost::assign::list_of("فوشيا")("طعام")("داخل")("متكبر");
 }
 
 //6 letter words
-const std::vector<std::string> Arabic2Hangman::createxLongWords() const
+const std::vector<std::string> Arabic2Hangman::createxLongWords()
 {
   //return boost::assign::list_of("ةىركبت")("ضصهثشسي");
   return boost::assign::list_of("توفاحة")("موسيقى")("معلمتي")("الكحول");
 }
 
 //7 letter words
-const std::vector<std::string> Arabic2Hangman::createxxLongWords() const
+const std::vector<std::string> Arabic2Hangman::createxxLongWords()
 {
   //return boost::assign::list_of("منتالبي");
   return boost::assign::list_of("باذنجان");
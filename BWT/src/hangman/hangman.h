@@ -11,8 +11,10 @@
 
 #include "common/utilities.h"
 #include "common/IBTApp.h"
+#include "common/Alphabet.h"
 #include "common/KnowledgeTracer.h"
 #include "common/language_utils.h"
+#include "Dictionary.h"
 
 class Hangman : public IBTApp
 {
@@ -24,6 +26,11 @@ public:
   {
   }
 
+protected:
+  //All the words of some word lists, leaving out empty ones
+  static const std::vector<std::string> joinWords(const std::vector<std::string>&, const std::vector<std::string>&,
+      const std::vector<std::string>&, const std::vector<std::string>&, const std::vector<std::string>&);
+
 private:
   void HM_new();
   void HM_attempt(std::string);
@@ -39,12 +46,14 @@ private:
   IOEventParser& iep; //So flushGlyph() can be called
   SoundsUtil* su;
 
-  const std::vector<std::string> alphabet;
+  const Alphabet alphabet;
   const std::vector<std::string> short_words;
   const std::vector<std::string> med_words;
   const std::vector<std::string> long_words;
   const std::vector<std::string> xlong_words;
   const std::vector<std::string> xxlong_words;
+  const Dictionary words; //all of the above, to match the last guess against
+  WordAssembler guess; //the student's last guess at the word, and the words it looks like
 
   std::vector<KnowledgeTracer> letter_skill;
 
@@ -68,16 +77,17 @@ class EnglishHangman : public Hangman
 {
 public:
   explicit EnglishHangman(IOEventParser&);
+  static const std::vector<std::string> createWords(); //all of the words below, for other apps to spell against
   ~EnglishHangman()
   {
   }
 private:
   const std::vector<std::string> createAlphabet() const;
-  const std::vector<std::string> createShortWords() const;
-  const std::vector<std::string> createMedWords() const;
-  const std::vector<std::string> createLongWords() const;
-  const std::vector<std::string> createxLongWords() const;
-  const std::vector<std::string> createxxLongWords() const;
+  static const std::vector<std::string> createShortWords();
+  static const std::vector<std::string> createMedWords();
+  static const std::vector<std::string> createLongWords();
+  static const std::vector<std::string> createxLongWords();
+  static const std::vector<std::string> createxxLongWords();
 };
 //++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
 
@@ -85,64 +95,68 @@ class ArabicHangman : public Hangman
 {
 public:
   explicit ArabicHangman(IOEventParser&);
+  static const std::vector<std::string> createWords(); //all of the words below, for other apps to spell against
   ~ArabicHangman()
   {
   }
 private:
   const std::vector<std::string> createAlphabet() const;
-  const std::vector<std::string> createShortWords() const;
-  const std::vector<std::string> createMedWords() const;
-  const std::vector<std::string> createLongWords() const;
-  const std::vector<std::string> createxLongWords() const;
-  const std::vector<std::string> createxxLongWords() const;};
+  static const std::vector<std::string> createShortWords();
+  static const std::vector<std::string> createMedWords();
+  static const std::vector<std::string> createLongWords();
+  static const std::vector<std::string> createxLongWords();
+  static const std::vector<std::string> createxxLongWords();};
 //++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
 
 class FrenchHangman : public Hangman
 {
 public:
   explicit FrenchHangman(IOEventParser&);
+  static const std::vector<std::string> createWords(); //all of the words below, for other apps to spell against
   ~FrenchHangman()
   {
   }
 private:
   const std::vector<std::string> createAlphabet() const;
-  const std::vector<std::string> createShortWords() const;
-  const std::vector<std::string> createMedWords() const;
-  const std::vector<std::string> createLongWords() const;
-  const std::vector<std::string> createxLongWords() const;
-  const std::vector<std::string> createxxLongWords() const;};
+  static const std::vector<std::string> createShortWords();
+  static const std::vector<std::string> createMedWords();
+  static const std::vector<std::string> createLongWords();
+  static const std::vector<std::string> createxLongWords();
+  static const std::vector<std::string> createxxLongWords();};
 //++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
 
 class KiswahiliHangman : public Hangman
 {
 public:
   explicit KiswahiliHangman(IOEventParser&);
+  static const std::vector<std::string> createWords(); //all of the words below, for other apps to spell against
   ~KiswahiliHangman()
   {
   }
 private:
   const std::vector<std::string> createAlphabet() const;
-  const std::vector<std::string> createShortWords() const;
-  const std::vector<std::string> createMedWords() const;
-  const std::vector<std::string> createLongWords() const;
-  const std::vector<std::string> createxLongWords() const;
-  const std::vector<std::string> createxxLongWords() const;};
+  static const std::vector<std::string> createShortWords();
+  static const std::vector<std::string> createMedWords();
+  static const std::vector<std::string> createLongWords();
+  static const std::vector<std::string> createxLongWords();
+  static const std::vector<std::string> createxxLongWords();};
   
 //++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
 class English2Hangman : public Hangman
 {
 public:
   explicit English2Hangman(IOEventParser&);
+  static const std::vector<std::string> createWords(); //all of the words below, for other apps to spell against
   ~English2Hangman()
   {
   }
 private:
   const std::vector<std::string> createAlphabet() const;
-  const std::vector<std::string> createShortWords() const;
-  const std::vector<std::string> createMedWords() const;
-  const std::vector<std::string> createLongWords() const;
-  const std::vector<std::string> createxLongWords() const;
-  const std::vector<std::string> createxxLongWords() const;
+  static const std::vector<std::string> createShortWords();
+  static const std::vector<std::string> createMedWords();
+  static const std::vector<std::string> createLongWords();
+  static const std::vector<std::string> createxLongWords();
+  static const std::vector<std::string> createxxLongWords();
 };
 //++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
 
@@ -150,16 +164,17 @@ class Arabic2Hangman : public Hangman
 {
 public:
   explicit Arabic2Hangman(IOEventParser&);
+  static const std::vector<std::string> createWords(); //all of the words below, for other apps to spell against
   ~Arabic2Hangman()
   {
   }
 private:
   const std::vector<std::string> createAlphabet() const;
-  const std::vector<std::string> createShortWords() const;
-  const std::vector<std::string> createMedWords() const;
-  const std::vector<std::string> createLongWords() const;
-  const std::vector<std::string> createxLongWords() const;
-  const std::vector<std::string> createxxLongWords() const;};
+  static const std::vector<std::string> createShortWords();
+  static const std::vector<std::string> createMedWords();
+  static const std::vector<std::string> createLongWords();
+  static const std::vector<std::string> createxLongWords();
+  static const std::vector<std::string> createxxLongWords();};
 //++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
   
 #endif /* HANGMAN_H_ */
@@ -7,6 +7,7 @@
 #include <assert.h>
 #include <boost/assign/list_of.hpp>
 #include "household.h"
+#include "common/app_modes.h"
 #include <string>
 
 #define MAX_CATS 3 // have short, medium, and long sounds... 
@@ -19,7 +20,7 @@
 static time_t last_event_time = time(0);
 
 Household::Household(IOEventParser& my_iep, const std::string& path_to_mapping_file, SoundsUtil* my_su, const std::vector<std::string> my_alph, const ForeignLanguage2EnglishMap sw, const ForeignLanguage2EnglishMap mw, const ForeignLanguage2EnglishMap lw, bool f) :
-  IBTApp(my_iep, path_to_mapping_file), iep(my_iep), su(my_su), alphabet(my_alph), short_sounds(sw), med_sounds(mw), long_sounds(lw),
+  IBTApp(my_iep, path_to_mapping_file), iep(my_iep), su(my_su), alphabet(my_alph, *IBTApp::getCurrentCharset()), short_sounds(sw), med_sounds(mw), long_sounds(lw),
       letter_skill(alphabet.size()), firsttime(true), turncount(0), word(""), target_letter(""), word_pos(0), word_length(0), nomirror(f), everyday_s ("./resources/Voice/everyday_sounds/", my_iep), last_word(""), three_down(false)
 {
   for(int i = 0; i < alphabet.size(); i++)
@@ -209,14 +210,12 @@ std::string Household::householdNameToSound(const std::string& object)
 void Household::AL_attempt(std::string i)
 {
 
-  static const Charset &charset = IBTApp::getCurrentCharset();
-
   ////
   if( target_letter.compare("\0") != 0 )
   { //if we were re-hashing a letter skill then one letter at a time
     if( target_letter.compare((std::string) i) == 0 )
     { //match!
-      int index = alphabeticIndex(alphabet, word, word_pos, target_letter);
+      int index = alphabet.indexOf(target_letter);
 
       letter_skill[index].observe(right);
       std::cout << target_letter << ": " << letter_skill[index].estimate() << std::endl;
@@ -229,7 +228,7 @@ void Household::AL_attempt(std::string i)
     }
     else
     {
-      int index = alphabeticIndex(alphabet, word, word_pos, target_letter);
+      int index = alphabet.indexOf(target_letter);
       letter_skill[index].observe(wrong);
       std::cout << target_letter << ": " << letter_skill[index].estimate() << std::endl;
       //std::cout << "    (DEBUG)Targetletter wrong" << std::endl;
@@ -242,7 +241,7 @@ void Household::AL_attempt(std::string i)
         su->saySound(getTeacherVoice(), "to write the letter");
         su->sayLetter(getTeacherVoice(), target_letter);
         su->saySound(getTeacherVoice(), "press");
-        su->sayDotSequence(getTeacherVoice(), charset[GlyphMapping(target_letter)]);//get the dots of the corresponding letter
+        su->sayDotSequence(getTeacherVoice(), alphabet.dots(index));//get the dots of the corresponding letter
         //std::cout << "    (DEBUG)Targetletter wrong, learning this letter" << std::endl;
       }
 
@@ -259,10 +258,10 @@ void Household::AL_attempt(std::string i)
 
   else
   { // need to spell entire name of object allowed three chances to guess before it tells you asnwer
-    int num_bytes_in_letter = numBytesInUTF8Letter(word.at(word_pos));
+    int num_bytes_in_letter = alphabet.letterBytes(word, word_pos);
     std::string correct_letter(word, word_pos, num_bytes_in_letter);
     //std::cout << "    (DEBUG)utf8 encoded size is:" << num_bytes_in_letter << "  word.size is:" << word.size() << "  word length is:" << word_length << " Correct letter is:"<<correct_letter<<" Target letter is:"<<target_letter<<" word.at(word_pos) is:"<<word.at(word_pos)<<std::endl;
-    int index = alphabeticIndex(alphabet, word, word_pos, word.at(word_pos));
+    int index = alphabet.indexOf(correct_letter);
     //std::cout << "    (DEBUG)First time,correct letter is" << correct_letter << " at index " << index << std::endl;
     if( i.compare(correct_letter) == 0 )
     { //letter is next in sequence
@@ -313,7 +312,7 @@ void Household::AL_attempt(std::string i)
           su->saySound(getTeacherVoice(), "to write the letter");
           su->sayLetter(getTeacherVoice(), correct_letter);
           su->saySound(getTeacherVoice(), "press");
-          su->sayDotSequence(getTeacherVoice(), charset[GlyphMapping(correct_letter)]);
+          su->sayDotSequence(getTeacherVoice(), alphabet.dots(index));
           su->saySound(getTeacherVoice(), "please write");
           su->sayLetter(getTeacherVoice(), correct_letter);
           target_letter = correct_letter;
@@ -329,7 +328,7 @@ void Household::AL_attempt(std::string i)
 //++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
 
 EnglishHousehold::EnglishHousehold(IOEventParser& my_iep) :
-  Household(my_iep, "", new EnglishSoundsUtil, createAlphabet(), createShortHouseholdWords(), createMedHouseholdWords(), createLongHouseholdWords(), false)
+  Household(my_iep, AppModes::mappingFile(AppModes::HOUSEHOLD_GAME_ENGLISH), new EnglishSoundsUtil, createAlphabet(), createShortHouseholdWords(), createMedHouseholdWords(), createLongHouseholdWords(), false)
 {
 
 }
@@ -3,6 +3,7 @@
 
 #include "common/utilities.h"
 #include "common/IBTApp.h"
+#include "common/Alphabet.h"
 #include "common/KnowledgeTracer.h"
 #include "common/language_utils.h"
 
@@ -39,7 +40,7 @@ private:
 
   const Voice everyday_s;
 
-  const std::vector<std::string> alphabet;
+  const Alphabet alphabet;
   const ForeignLanguage2EnglishMap short_sounds; //changed from short_animals
   const ForeignLanguage2EnglishMap med_sounds;
   const ForeignLanguage2EnglishMap long_sounds;
@@ -10,7 +10,7 @@
 #include "hangman_int2011.h"
 
 Int2011::Int2011(IOEventParser& my_iep, const std::string& path_to_mapping_file, SoundsUtil* my_su, const std::vector<std::string> my_alph, const std::vector<std::string> wordlist) : 
-  IBTApp(my_iep, path_to_mapping_file), iep(my_iep), su(my_su), alphabet(my_alph), int2011_words(wordlist), firsttime(true), turncount(0), mistake(0), correctcount(0), j(0), word(""), target_letter(""), word_pos(0), word_length(4), answer(""), button_zero_down(false)
+  IBTApp(my_iep, path_to_mapping_file), iep(my_iep), su(my_su), alphabet(my_alph, *IBTApp::getCurrentCharset()), int2011_words(wordlist), firsttime(true), turncount(0), mistake(0), correctcount(0), j(0), word(""), target_letter(""), word_pos(0), word_length(4), answer(""), button_zero_down(false)
 {
 
   for(size_t i = 0; i < int2011_words.size(); i++) {
@@ -72,7 +72,8 @@ void Int2011::processEvent(IOEvent& e) {
 }
 
 void Int2011::HM_new() {
-  static const Charset &charset = IBTApp::getCurrentCharset();
+  const CharsetSnapshot charset_snapshot = IBTApp::getCurrentCharset();
+  const Charset &charset = *charset_snapshot;
 
   turncount = 0;
   mistake = 0;
@@ -90,16 +91,14 @@ void Int2011::HM_new() {
   for(s = 0; s < word_length; s++) {
     su->saySound(getTeacherVoice(), "DASH");
   }
-  int num_bytes_in_letter = numBytesInUTF8Letter(word);
   answer.clear();
 
   //We want answer's size to be same as word's.
   answer.resize(word.size());// filled with null characters.
   
-  //Fill answer with *s, but add these *s every num_bytes_in_letter intervals. To keep consistent with word's
-  for(size_t i = 0; i<word.size();) {
-    answer.replace(i,1,"*");
-    i = i + numBytesInUTF8Letter(word.at(i));
+  //Fill answer with *s, one at the start of each of word's letters
+  for(Alphabet::LetterIterator letter(alphabet, word); !letter.done(); ++letter) {
+    answer.replace(letter.position(), 1, "*");
   }
   
   //answer = std::string(word_length, '*');//answer is originally all  *'s students need to guess what the *'s are
@@ -114,12 +113,11 @@ void Int2011::HM_attempt(std::string i) {
   turncount = 0;
   if( mistake == 7 ) { 
     //after 7 mistakes students give one chance to guess the word
-    //int index = alphabeticIndex(alphabet, word, word_pos, word.at(word_pos));
-    int num_bytes_in_letter = numBytesInUTF8Letter(word.at(word_pos));
+    int num_bytes_in_letter = alphabet.letterBytes(word, word_pos);
     std::string correct_letter(word, word_pos, num_bytes_in_letter);
     std::cout << "		(DEBUG)Corr letter:" << correct_letter << " word.at(word_pos)" << correct_letter << std::endl;
     if( i.compare(correct_letter) == 0 ) { //letter is next in sequence
-      word_pos = word_pos + numBytesInUTF8Letter(word.at(word_pos)); //move to next character
+      word_pos = word_pos + num_bytes_in_letter; //move to next character
       if( word_pos == word.size() ) { //are we done?
         su->saySound(getTeacherVoice(), "good");
 	su->saySound(getTeacherVoice(), "well done you guessed it");
@@ -137,10 +135,10 @@ void Int2011::HM_attempt(std::string i) {
     }
     // mistake guess method ends here
   } else {
-    for(; word_pos < word.size(); word_pos = word_pos + numBytesInUTF8Letter(word.at(word_pos))) {
-      int index = alphabeticIndex(alphabet, word, word_pos, word.at(word_pos));
-      int num_bytes_in_letter = numBytesInUTF8Letter(word.at(word_pos));
-      std::string correct_letter(word, word_pos, num_bytes_in_letter);
+    for(Alphabet::LetterIterator letter(alphabet, word); !letter.done(); ++letter) {
+      word_pos = letter.position();
+      int num_bytes_in_letter = letter.bytes();
+      std::string correct_letter = letter.letter();
       if( i.compare(correct_letter) == 0 ) { //letter is next in sequence
         if( answer.at(word_pos) != '*' ) {
           su->saySound(getTeacherVoice(), "same letter");
@@ -176,16 +174,15 @@ void Int2011::HM_attempt(std::string i) {
       return;
     }
     su->saySound(getTeacherVoice(), "current");
-    for(int s = 0; s < answer.size();) {
-      int num_bytes_in_letter = numBytesInUTF8Letter(answer.at(s));
-      std::string letter(answer, s, num_bytes_in_letter);
+    //answer's letters sit where word's do
+    for(Alphabet::LetterIterator guessed(alphabet, word); !guessed.done(); ++guessed) {
+      std::string letter(answer, guessed.position(), guessed.bytes());
       std::cout<<"		(DEBUG)Extracted letter from answer is:"<<letter<<std::endl;
       if( !strcmp(letter.c_str(), "*") ) {
         su->saySound(getTeacherVoice(), "DASH");
       } else {
         su->sayLetter(getTeacherVoice(), letter);
       }
-      s=s+num_bytes_in_letter;
     }
     if( mistake == 7 ) {
       su->saySound(getTeacherVoice(), "7 mistakes");
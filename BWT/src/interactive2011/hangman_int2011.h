@@ -8,6 +8,7 @@
 
 #include "common/utilities.h"
 #include "common/IBTApp.h"
+#include "common/Alphabet.h"
 #include "common/language_utils.h"
 
 class Int2011 : public IBTApp, public boost::noncopyable
@@ -29,7 +30,7 @@ private:
     right, wrong
   };
 
-  const std::vector<std::string> alphabet;
+  const Alphabet alphabet;
   const std::vector<std::string> int2011_words;
 
   bool firsttime;
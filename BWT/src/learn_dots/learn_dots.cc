@@ -6,6 +6,7 @@
  */
 
 #include "learn_dots.h"
+#include "common/app_modes.h"
 
 const int LearnDots::sequence[][6] = { { 1, 2, 3, 4, 5, 6 }, { 1, 3, 4, 6, 2, 5 }, { 1, 4, 2, 5, 3, 6 }, { 1, 5, 4, 2, 6, 3 }, { 1, 6, 4, 3, 5, 2 } };
 
@@ -91,37 +92,37 @@ void LearnDots::LD_new()
 }
 //++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
 EnglishLearnDots::EnglishLearnDots(IOEventParser& my_iep) :
-  LearnDots(my_iep, "", new EnglishSoundsUtil, false)
+  LearnDots(my_iep, AppModes::mappingFile(AppModes::LEARN_DOTS_ENGLISH), new EnglishSoundsUtil, false)
 {
 
 }
 //++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
 ArabicLearnDots::ArabicLearnDots(IOEventParser& my_iep) :
-  LearnDots(my_iep, "./language_mapping_files/arabic_mapping.txt", new ArabicSoundsUtil, false)
+  LearnDots(my_iep, AppModes::mappingFile(AppModes::LEARN_DOTS_ARABIC), new ArabicSoundsUtil, false)
 {
 
 }
 //++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
 FrenchLearnDots::FrenchLearnDots(IOEventParser& my_iep) :
-  LearnDots(my_iep, "./language_mapping_files/french_mapping.txt", new FrenchSoundsUtil, false)
+  LearnDots(my_iep, AppModes::mappingFile(AppModes::LEARN_DOTS_FRENCH), new FrenchSoundsUtil, false)
 {
 
 }
 //++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
 KiswahiliLearnDots::KiswahiliLearnDots(IOEventParser& my_iep) :
-  LearnDots(my_iep, "", new KiswahiliSoundsUtil, false)
+  LearnDots(my_iep, AppModes::mappingFile(AppModes::LEARN_DOTS_SWAHILI), new KiswahiliSoundsUtil, false)
 {
 
 }
 //++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
 English2LearnDots::English2LearnDots(IOEventParser& my_iep) :
-  LearnDots(my_iep, "./language_mapping_files/english_mapping_nomirror.txt", new English2SoundsUtil, true)
+  LearnDots(my_iep, AppModes::ENGLISH_NOMIRROR_MAPPING, new English2SoundsUtil, true)
 {
 
 }
 //++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
 Arabic2LearnDots::Arabic2LearnDots(IOEventParser& my_iep) :
-  LearnDots(my_iep, "./language_mapping_files/arabic_mapping_nomirror.txt", new Arabic2SoundsUtil, true)
+  LearnDots(my_iep, AppModes::ARABIC_NOMIRROR_MAPPING, new Arabic2SoundsUtil, true)
 {
 
 }
@@ -9,7 +9,7 @@
 
 #include <boost/assign/list_of.hpp>
 #include "learn_letters.h"
-#include "common/multicharacter.h"
+#include "common/app_modes.h"
 
 static bool is_multicell; // is the character a multi-cell braille character?
 
@@ -21,8 +21,9 @@ int total_multicells = 0; // how many cells there are in total (usually 2)
 LearnLetters::LearnLetters(IOEventParser& my_iep, const std::string& path_to_mapping_file, SoundsUtil* my_su, const std::vector<std::string> my_alph, const std::vector<
     std::string> g0, const std::vector<std::string> g1, const std::vector<std::string> g2, const std::vector<std::string> g3, const std::vector<
     std::string> g4, bool f) :
-  IBTApp(my_iep, path_to_mapping_file), su(my_su), alphabet(my_alph), group0(g0), group1(g1), group2(g2), group3(g3), group4(g4), target_group(0),
-      target_index(0), target_sequence(0), current_sequence(0), letter_skill(alphabet.size()), nomirror(f), multicell(), cell_position(0)
+  IBTApp(my_iep, path_to_mapping_file), su(my_su), alphabet(my_alph, *IBTApp::getCurrentCharset()), group0(g0), group1(g1), group2(g2), group3(g3), group4(g4), target_group(0),
+      target_index(0), target_sequence(0), current_sequence(0), letter_skill(alphabet.size()), nomirror(f),
+      cell_rules(TranslationTable::load(*IBTApp::getCurrentCharset(), TranslationTable::rulesFilename(path_to_mapping_file))), cell_position(0)
 {
   printf("in learn letters\n");
   if( group0.size() + group1.size() + group2.size() + group3.size() + group4.size() != alphabet.size() )
@@ -33,9 +34,6 @@ LearnLetters::LearnLetters(IOEventParser& my_iep, const std::string& path_to_map
 
   su->saySound(getTeacherVoice(), "learn letters");
 
-  //initialize multicell support
-  multicell->initializeMultiCell();
-
   //initilaize the 
   for(unsigned int i = 0; i < alphabet.size(); i++)
   {
@@ -85,9 +83,16 @@ float LearnLetters::group_skill(int g)
   return gs;
 }
 
+//The cells to write the target letter in, from the mapping file and any cell rules that go with it
+const std::vector<unsigned char>& LearnLetters::targetCells() const
+{
+  return cell_rules.cellsFor(GlyphMapping(alphabet[target_index]));
+}
+
 void LearnLetters::LL_new()
 {
-  static const Charset &charset = IBTApp::getCurrentCharset();
+  const CharsetSnapshot charset_snapshot = IBTApp::getCurrentCharset();
+  const Charset &charset = *charset_snapshot;
 
   //choose a new sequence target:
   std::vector<int> choices;
@@ -104,7 +109,7 @@ void LearnLetters::LL_new()
     target_index = target_group * 5 + i;//XXX: *5 because we have 5 groups
     if( letter_skill[target_index].estimate() < .1 )
     {
-      target_sequence = charset[GlyphMapping((std::string) alphabet[target_index])];
+      target_sequence = alphabet.dots(target_index);
       //printf("target sequnce is %d\n", target_sequence);
       std::cout << alphabet[target_index] << std::endl;
       teaching_letter = true;
@@ -133,13 +138,13 @@ void LearnLetters::LL_new()
     }
     random_shuffle(choices.begin(), choices.end());
     target_index = *choices.begin();
-    target_sequence = charset[GlyphMapping(alphabet[target_index])];
+    target_sequence = alphabet.dots(target_index);
   }
 
   /* check if it's multicell */
-  is_multicell = multicell->isMultiCell(alphabet[target_index]);
+  is_multicell = cell_rules.isMultiCell(GlyphMapping(alphabet[target_index]));
   if (is_multicell) {
-      total_multicells = multicell->numCells(alphabet[target_index]); // so we only have to get it once
+      total_multicells = targetCells().size(); // so we only have to get it once
   }
 
   if( teaching_letter )
@@ -156,7 +161,7 @@ void LearnLetters::LL_new()
     su->saySound(getTeacherVoice(), "please write");
     if (is_multicell){
      
-      target_sequence = multicell->getPatterns(alphabet[target_index])[cell_position];
+      target_sequence = targetCells()[cell_position];
     }
    
   }
@@ -171,7 +176,7 @@ void LearnLetters::LL_new()
       
       //su->saySound(getTeacherVoice(), "multicell_character");
       su->saySound(getTeacherVoice(), "cell1");
-      target_sequence = multicell->getPatterns(alphabet[target_index])[cell_position];  //will have to check if it's the end
+      target_sequence = targetCells()[cell_position];  //will have to check if it's the end
     }
     su->saySound(getTeacherVoice(), "press");
     su->sayDotSequence(getTeacherVoice(), target_sequence);
@@ -179,7 +184,7 @@ void LearnLetters::LL_new()
       
       su->saySound(getTeacherVoice(), "cell2");
       su->saySound(getTeacherVoice(), "press");
-      int target2 = multicell->getPatterns(alphabet[target_index])[cell_position + 1];
+      int target2 = targetCells()[cell_position + 1];
       su->sayDotSequence(getTeacherVoice(),target2);
     }
    
@@ -196,7 +201,8 @@ void LearnLetters::LL_attempt(int i)
   
   printf("target is %d\n", target_sequence);
 	std::cout << "LN_attempt" << std::endl;
-  static const Charset &charset = IBTApp::getCurrentCharset();
+  const CharsetSnapshot charset_snapshot = IBTApp::getCurrentCharset();
+  const Charset &charset = *charset_snapshot;
 
   if( my_dot_mask(i) & target_sequence )
   { //dot is in sequence
@@ -214,7 +220,7 @@ void LearnLetters::LL_attempt(int i)
         printf("SHOULD BE MOVING ON NOW\n");
         su->saySound(getTeacherVoice(), "good_next_cell");
         cell_position++;
-        target_sequence = multicell->getPatterns(alphabet[target_index])[cell_position];
+        target_sequence = targetCells()[cell_position];
         
         
         current_sequence = 0; // reset
@@ -268,7 +274,7 @@ int LearnLetters::getGroupSize(int g)
 
 //++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
 EnglishLearnLetters::EnglishLearnLetters(IOEventParser& my_iep) :
-      LearnLetters(my_iep, "", new EnglishSoundsUtil, createAlphabet(), createGroup0Letters(), createGroup1Letters(), createGroup2Letters(), createGroup3Letters(), createGroup4Letters(), false)
+      LearnLetters(my_iep, AppModes::mappingFile(AppModes::LEARN_LETTERS_ENGLISH), new EnglishSoundsUtil, createAlphabet(), createGroup0Letters(), createGroup1Letters(), createGroup2Letters(), createGroup3Letters(), createGroup4Letters(), false)
 {
 
 }
@@ -303,7 +309,7 @@ const std::vector<std::string> EnglishLearnLetters::createGroup4Letters() const
 }
 //++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
 ArabicLearnLetters::ArabicLearnLetters(IOEventParser& my_iep) :
-      LearnLetters(my_iep, "./language_mapping_files/arabic_mapping.txt", new ArabicSoundsUtil, createAlphabet(), createGroup0Letters(), createGroup1Letters(), createGroup2Letters(), createGroup3Letters(), createGroup4Letters(), false)
+      LearnLetters(my_iep, AppModes::mappingFile(AppModes::LEARN_LETTERS_ARABIC), new ArabicSoundsUtil, createAlphabet(), createGroup0Letters(), createGroup1Letters(), createGroup2Letters(), createGroup3Letters(), createGroup4Letters(), false)
 {
 
 }
@@ -339,7 +345,7 @@ const std::vector<std::string> ArabicLearnLetters::createGroup4Letters() const
 }
 //++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
 FrenchLearnLetters::FrenchLearnLetters(IOEventParser& my_iep) :
-      LearnLetters(my_iep, "./language_mapping_files/french_mapping.txt", new FrenchSoundsUtil, createAlphabet(), createGroup0Letters(), createGroup1Letters(), createGroup2Letters(), createGroup3Letters(), createGroup4Letters(), false)
+      LearnLetters(my_iep, AppModes::mappingFile(AppModes::LEARN_LETTERS_FRENCH), new FrenchSoundsUtil, createAlphabet(), createGroup0Letters(), createGroup1Letters(), createGroup2Letters(), createGroup3Letters(), createGroup4Letters(), false)
 {
 
 }
@@ -375,7 +381,7 @@ const std::vector<std::string> FrenchLearnLetters::createGroup4Letters() const
 }
 //++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
 KiswahiliLearnLetters::KiswahiliLearnLetters(IOEventParser& my_iep) :
-      LearnLetters(my_iep, "", new KiswahiliSoundsUtil, createAlphabet(), createGroup0Letters(), createGroup1Letters(), createGroup2Letters(), createGroup3Letters(), createGroup4Letters(), false)
+      LearnLetters(my_iep, AppModes::mappingFile(AppModes::LEARN_LETTERS_SWAHILI), new KiswahiliSoundsUtil, createAlphabet(), createGroup0Letters(), createGroup1Letters(), createGroup2Letters(), createGroup3Letters(), createGroup4Letters(), false)
 {
 
 }
@@ -411,7 +417,7 @@ const std::vector<std::string> KiswahiliLearnLetters::createGroup4Letters() cons
 
 //++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
 English2LearnLetters::English2LearnLetters(IOEventParser& my_iep) :
-      LearnLetters(my_iep, "./language_mapping_files/english_mapping_nomirror.txt", new English2SoundsUtil, createAlphabet(), createGroup0Letters(), createGroup1Letters(), createGroup2Letters(), createGroup3Letters(), createGroup4Letters(), true)
+      LearnLetters(my_iep, AppModes::ENGLISH_NOMIRROR_MAPPING, new English2SoundsUtil, createAlphabet(), createGroup0Letters(), createGroup1Letters(), createGroup2Letters(), createGroup3Letters(), createGroup4Letters(), true)
 {
 
 }
@@ -447,7 +453,7 @@ const std::vector<std::string> English2LearnLetters::createGroup4Letters() const
 
 //+++++++++++++++++++++++++++++++mir+++++++++++++++++++++++++++++++++++++
 Arabic2LearnLetters::Arabic2LearnLetters(IOEventParser& my_iep) :
-      LearnLetters(my_iep, "./language_mapping_files/arabic_mapping_nomirror.txt", new Arabic2SoundsUtil, createAlphabet(), createGroup0Letters(), createGroup1Letters(), createGroup2Letters(), createGroup3Letters(), createGroup4Letters(), true)
+      LearnLetters(my_iep, AppModes::ARABIC_NOMIRROR_MAPPING, new Arabic2SoundsUtil, createAlphabet(), createGroup0Letters(), createGroup1Letters(), createGroup2Letters(), createGroup3Letters(), createGroup4Letters(), true)
 {
 
 }
@@ -484,7 +490,7 @@ const std::vector<std::string> Arabic2LearnLetters::createGroup4Letters() const
 //++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
 
 Hindi2LearnLetters::Hindi2LearnLetters(IOEventParser& my_iep) :
-      LearnLetters(my_iep, "./language_mapping_files/devanagari_mapping.txt", new Hindi2SoundsUtil, createAlphabet(), createGroup0Letters(), createGroup1Letters(), createGroup2Letters(), createGroup3Letters(), createGroup4Letters(), true)
+      LearnLetters(my_iep, AppModes::mappingFile(AppModes::LEARN_LETTERS_HINDI), new Hindi2SoundsUtil, createAlphabet(), createGroup0Letters(), createGroup1Letters(), createGroup2Letters(), createGroup3Letters(), createGroup4Letters(), true)
 {
 
 }
@@ -579,7 +585,7 @@ const std::vector<std::string> Hindi2LearnLetters::createGroup4Letters() const
 //++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
 
 KannadaLearnLetters::KannadaLearnLetters (IOEventParser& my_iep) :
-      LearnLetters(my_iep, "./language_mapping_files/kannada_mapping.txt", new KannadaSoundsUtil, createAlphabet(), createGroup0Letters(), createGroup1Letters(), createGroup2Letters(), createGroup3Letters(), createGroup4Letters(), true)
+      LearnLetters(my_iep, AppModes::KANNADA_MAPPING, new KannadaSoundsUtil, createAlphabet(), createGroup0Letters(), createGroup1Letters(), createGroup2Letters(), createGroup3Letters(), createGroup4Letters(), true)
 {
   printf("constructed\n");
 }
@@ -10,9 +10,10 @@
 
 #include "common/utilities.h"
 #include "common/IBTApp.h"
+#include "common/Alphabet.h"
 #include "common/KnowledgeTracer.h"
 #include "common/language_utils.h"
-#include "common/multicharacter.h"
+#include "Translator.h"
 
 class LearnLetters : public IBTApp
 {
@@ -27,19 +28,20 @@ private:
   void LL_attempt(int);
   void LL_new();
   float group_skill(int);
+  const std::vector<unsigned char>& targetCells() const;
   int getGroupSize(int);
   bool nomirror;
 
 private:
   SoundsUtil* su;
-  multi* multicell; 
+  TranslationTable cell_rules; // how to write each letter, multi-cell ones included
   enum observation
   {
     right, wrong
   };
   int cell_position; // for multi-cell characters
   //IOEventParser& iep; //So flushGlyph() can be called
-  const std::vector<std::string> alphabet;
+  const Alphabet alphabet;
   const std::vector<std::string> group0;
   const std::vector<std::string> group1;
   const std::vector<std::string> group2;
@@ -5,6 +5,7 @@
  *      Author: imran
  */
 #include "learn_numbers.h"
+#include "common/app_modes.h"
 #include "Dots.h"
 
 LearnNumbers::LearnNumbers(IOEventParser& my_iep, const std::string& path_to_mapping_file, SoundsUtil* my_su, bool f) :
@@ -35,7 +36,7 @@ void LearnNumbers::LN_new()
   //generate a random number between 0 to 9
   int n = (int) (10.0 * rand() / (RAND_MAX+1.0)); //better alternative than rand()%10
   current_sequence = '\0';
-  target_sequence = convertToDotSequence(IBTApp::getCurrentCharset(), n);
+  target_sequence = convertToDotSequence(*IBTApp::getCurrentCharset(), n);
   std::cout<<"Chosen number is:"<<n<<std::endl;
 
   //
@@ -69,7 +70,8 @@ void LearnNumbers::playWriteTheNumberSounds(const DotSequence& d) const
 {
   std::cout << "playWriteTheNumberSounds" << std::endl;
   
-  static const Charset& charset = IBTApp::getCurrentCharset();
+  const CharsetSnapshot charset_snapshot = IBTApp::getCurrentCharset();
+  const Charset &charset = *charset_snapshot;
   int current_number = atoi(((std::string) charset[d]).c_str()); //mapping the target_sequence to it's original number
 
   su->saySound(math_s, "to_write_number");
@@ -80,41 +82,41 @@ void LearnNumbers::playWriteTheNumberSounds(const DotSequence& d) const
 
 //++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
 EnglishLearnNumbers::EnglishLearnNumbers(IOEventParser& my_iep) :
-  LearnNumbers(my_iep, "./language_mapping_files/number_mapping.txt", new EnglishSoundsUtil, false)
+  LearnNumbers(my_iep, AppModes::mappingFile(AppModes::LEARN_NUMBERS_ENGLISH), new EnglishSoundsUtil, false)
 {
 
 }
 
 //++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
 ArabicLearnNumbers::ArabicLearnNumbers(IOEventParser& my_iep) :
-  LearnNumbers(my_iep, "./language_mapping_files/number_mapping.txt", new ArabicSoundsUtil, false)
+  LearnNumbers(my_iep, AppModes::mappingFile(AppModes::LEARN_NUMBERS_ARABIC), new ArabicSoundsUtil, false)
 {
 
 }
 
 //++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
 FrenchLearnNumbers::FrenchLearnNumbers(IOEventParser& my_iep) :
-  LearnNumbers(my_iep, "./language_mapping_files/number_mapping.txt", new FrenchSoundsUtil, false)
+  LearnNumbers(my_iep, AppModes::mappingFile(AppModes::LEARN_NUMBERS_FRENCH), new FrenchSoundsUtil, false)
 {
 
 }
 //++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
 KiswahiliLearnNumbers::KiswahiliLearnNumbers(IOEventParser& my_iep) :
-  LearnNumbers(my_iep, "./language_mapping_files/number_mapping.txt", new KiswahiliSoundsUtil, false)
+  LearnNumbers(my_iep, AppModes::mappingFile(AppModes::LEARN_NUMBERS_SWAHILI), new KiswahiliSoundsUtil, false)
 {
 
 }
 
 //++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
 Arabic2LearnNumbers::Arabic2LearnNumbers(IOEventParser& my_iep) :
-  LearnNumbers(my_iep, "./language_mapping_files/number_mapping_unmirrored.txt", new Arabic2SoundsUtil, true)
+  LearnNumbers(my_iep, AppModes::NUMBER_UNMIRRORED_MAPPING, new Arabic2SoundsUtil, true)
 {
 
 }
 
 //++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
 English2LearnNumbers::English2LearnNumbers(IOEventParser& my_iep) :
-  LearnNumbers(my_iep, "./language_mapping_files/number_mapping_unmirrored.txt", new English2SoundsUtil, true)
+  LearnNumbers(my_iep, AppModes::NUMBER_UNMIRRORED_MAPPING, new English2SoundsUtil, true)
 {
 
 }
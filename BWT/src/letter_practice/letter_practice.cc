@@ -6,11 +6,12 @@
  */
 #include <boost/assign/list_of.hpp>
 #include "letter_practice.h"
+#include "common/app_modes.h"
 
 LetterPractice::LetterPractice(IOEventParser& my_iep, const std::string& path_to_mapping_file, SoundsUtil* my_su, const std::vector<std::string> my_alph, const std::vector<
     std::string> sw, const std::vector<std::string> mw, const std::vector<std::string> lw, bool f) :
-  IBTApp(my_iep, path_to_mapping_file), su(my_su), iep(my_iep), alphabet(my_alph), short_words(sw), med_words(mw), long_words(lw),
-      letter_skill(alphabet.size()), word(""), target_letter("\0"), word_pos(0), word_length(0), firsttime(true), nomirror(f)
+  IBTApp(my_iep, path_to_mapping_file), su(my_su), iep(my_iep), alphabet(my_alph, *IBTApp::getCurrentCharset()), short_words(sw), med_words(mw), long_words(lw),
+      letter_skill(alphabet.size()), word(""), target_letter("\0"), word_pos(0), word_length(0), firsttime(true), nomirror(f), written_dots(INVALID_DOTS)
 {
   su->saySound(getTeacherVoice(), "letter practice");
 
@@ -45,6 +46,7 @@ void LetterPractice::processEvent(IOEvent& e)
   if( e.type == IOEvent::CELL_LETTER || e.type == IOEvent::BUTTON_LETTER )
   {
     printEvent(e);
+    written_dots = DotsMirror::mir(e.dots); //the decoder mirrors the dots to look the letter up
     //Upon entering this mode, we dont want any pending LETTER events to interfere. So we skip the first LETTER event.
     if( firsttime )//Check if this is the first letter event, if so, we skip it
     {
@@ -62,13 +64,11 @@ void LetterPractice::processEvent(IOEvent& e)
 
 void LetterPractice::PL_attempt(std::string i)
 {
-  static const Charset &charset = IBTApp::getCurrentCharset();
-
   if( target_letter.compare("\0") != 0 )
   { //if we were re-hashing a letter skill
     if( target_letter.compare((std::string) i) == 0 )
     { //match!
-      int index = std::distance(alphabet.begin(), std::find(alphabet.begin(), alphabet.end(), target_letter));//finding the index of the target_letter
+      int index = alphabet.indexOf(target_letter);
       //std::cout << "		(DEBUG)1alphabet at index is:" << alphabet.at(index) << std::endl;
       letter_skill[index].observe(right);
       std::cout << target_letter << ": " << letter_skill[index].estimate() << std::endl;
@@ -78,11 +78,12 @@ void LetterPractice::PL_attempt(std::string i)
     }
     else
     {
-      int index = std::distance(alphabet.begin(), std::find(alphabet.begin(), alphabet.end(), target_letter));//finding the index of the target_letter
+      int index = alphabet.indexOf(target_letter);
       //std::cout << "    (DEBUG)2alphabet at index is:" << alphabet.at(index) << std::endl;
       letter_skill[index].observe(wrong);
       std::cout << target_letter << ": " << letter_skill[index].estimate() << std::endl;
       su->saySound(getTeacherVoice(), "no");
+      sayDifference(index);
 
       bool teaching_letter = (letter_skill[index].estimate() < .1);
 
@@ -92,7 +93,7 @@ void LetterPractice::PL_attempt(std::string i)
         su->saySound(getTeacherVoice(), "to write the letter");
         su->sayLetter(getTeacherVoice(), target_letter);
         su->saySound(getTeacherVoice(), "press");
-        su->sayDotSequence(getTeacherVoice(), charset[GlyphMapping(target_letter)]);
+        su->sayDotSequence(getTeacherVoice(), alphabet.dots(index));
       }
 
       su->saySound(getTeacherVoice(), "please write");
@@ -102,9 +103,9 @@ void LetterPractice::PL_attempt(std::string i)
   }
   else
   { //if we were testing a sequence
-    int num_bytes_in_letter = numBytesInUTF8Letter(word.at(word_pos));
+    int num_bytes_in_letter = alphabet.letterBytes(word, word_pos);
     std::string correct_letter(word, word_pos, num_bytes_in_letter);
-    int index = std::distance(alphabet.begin(), std::find(alphabet.begin(), alphabet.end(), correct_letter));
+    int index = alphabet.indexOf(correct_letter);
     if( 0 )
     {
       std::cout << "    (DEBUG)utf8 encoded size is:" << num_bytes_in_letter << "  word.size is:" << word.size() << "  word length is:"
@@ -130,6 +131,7 @@ void LetterPractice::PL_attempt(std::string i)
     else
     { //letter is incorrect
       su->saySound(getTeacherVoice(), "no");
+      sayDifference(index);
       letter_skill[index].observe(wrong);
       LS_length_skill[word_length].observe(wrong);
       std::cout << correct_letter << ": " << letter_skill[index].estimate() << std::endl;
@@ -138,7 +140,7 @@ void LetterPractice::PL_attempt(std::string i)
         su->saySound(getTeacherVoice(), "to write the letter");
         su->sayLetter(getTeacherVoice(), correct_letter);
         su->saySound(getTeacherVoice(), "press");
-        su->sayDotSequence(getTeacherVoice(), charset[GlyphMapping(correct_letter)]);
+        su->sayDotSequence(getTeacherVoice(), alphabet.dots(index));
         target_letter = correct_letter;
       }
       return;
@@ -146,10 +148,43 @@ void LetterPractice::PL_attempt(std::string i)
   }
 }
 
-void LetterPractice::PL_new()
+//Say the letter just written and which dots it differs by from the letter at alphabetic index index, e.g. "K,
+//dot 3" for a K written instead of an M. If what was written isn't a letter, the charset's nearest letter to it
+//stands in for it when working out the dots, but isn't named.
+void LetterPractice::sayDifference(size_t index)
 {
-  static const Charset &charset = IBTApp::getCurrentCharset();
+  const unsigned char target_dots = alphabet.dots(index);
+  if( target_dots == INVALID_DOTS || written_dots == INVALID_DOTS )
+    return;
+
+  const CharsetSnapshot charset_snapshot = IBTApp::getCurrentCharset();
+  const Charset &charset = *charset_snapshot;
+
+  unsigned char written = written_dots;
+  const bool wrote_letter = !charset[written].isEmpty();
+  if( !wrote_letter )
+  {
+    const Charset::Nearest &nearest = charset.nearest(written);
+    if( nearest.count == 0 )
+      return;
+    written = nearest.dots[0];
+  }
+
+  //Writing the whole letter mirrored is one slip, not several dots wrong
+  const unsigned char mirrored = DotsMirror::mir(written);
+  const bool was_mirrored = Charset::MIRROR_COST + Charset::dotDistance(mirrored, target_dots)
+      < Charset::dotDistance(written, target_dots);
+  const unsigned char differing = (was_mirrored ? mirrored : written) ^ target_dots;
+  std::cout << (wrote_letter ? "You wrote " : "You wrote no letter; the nearest is ") << (std::string) charset[written]
+      << (was_mirrored ? " (mirrored)" : "") << ", which differs by dots " << dot_string(differing) << std::endl;
+  if( wrote_letter )
+    su->sayLetter(getTeacherVoice(), (std::string) charset[written]);
+  if( differing != 0 )
+    su->sayDotSequence(getTeacherVoice(), differing);
+}
 
+void LetterPractice::PL_new()
+{
   //check if we've lost any letter skills
   std::vector<int> low_letters;
   for(unsigned int i = 0; i < alphabet.size(); i++)
@@ -165,12 +200,13 @@ void LetterPractice::PL_new()
   {
     //choose a letter skill to train
     random_shuffle(low_letters.begin(), low_letters.end());
-    target_letter = alphabet.at(low_letters.front());
+    const int target_index = low_letters.front();
+    target_letter = alphabet.at(target_index);
     //std::cout << "		(DEBUG)Bad at letter:" << target_letter << std::endl;
     su->saySound(getTeacherVoice(), "to write the letter");
     su->sayLetter(getTeacherVoice(), target_letter);
     su->saySound(getTeacherVoice(), "press");
-    su->sayDotSequence(getTeacherVoice(), charset[GlyphMapping(target_letter)]);
+    su->sayDotSequence(getTeacherVoice(), alphabet.dots(target_index));
 
     su->saySound(getTeacherVoice(), "please write");
     su->sayLetter(getTeacherVoice(), target_letter);
@@ -241,7 +277,7 @@ void LetterPractice::PL_new()
 //++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
 
 EnglishLetterPractice::EnglishLetterPractice(IOEventParser& my_iep) :
-  LetterPractice(my_iep, "", new EnglishSoundsUtil, createAlphabet(), createShortWords(), createMedWords(), createLongWords(), false)
+  LetterPractice(my_iep, AppModes::mappingFile(AppModes::LETTER_PRACTICE_ENGLISH), new EnglishSoundsUtil, createAlphabet(), createShortWords(), createMedWords(), createLongWords(), false)
 {
 
 }
@@ -268,7 +304,7 @@ const std::vector<std::string> EnglishLetterPractice::createLongWords() const
 //++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
 
 ArabicLetterPractice::ArabicLetterPractice(IOEventParser& my_iep) :
-  LetterPractice(my_iep, "./language_mapping_files/arabic_mapping.txt", new ArabicSoundsUtil, createAlphabet(), createShortWords(), createMedWords(), createLongWords(), false)
+  LetterPractice(my_iep, AppModes::mappingFile(AppModes::LETTER_PRACTICE_ARABIC), new ArabicSoundsUtil, createAlphabet(), createShortWords(), createMedWords(), createLongWords(), false)
 {
 
 }
@@ -301,7 +337,7 @@ const std::vector<std::string> ArabicLetterPractice::createLongWords() const
 //++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
 
 FrenchLetterPractice::FrenchLetterPractice(IOEventParser& my_iep) :
-  LetterPractice(my_iep, "./language_mapping_files/french_mapping.txt", new FrenchSoundsUtil, createAlphabet(), createShortWords(), createMedWords(), createLongWords(), false)
+  LetterPractice(my_iep, AppModes::mappingFile(AppModes::LETTER_PRACTICE_FRENCH), new FrenchSoundsUtil, createAlphabet(), createShortWords(), createMedWords(), createLongWords(), false)
 {
 
 }
@@ -328,7 +364,7 @@ const std::vector<std::string> FrenchLetterPractice::createLongWords() const
 //++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
 
 KiswahiliLetterPractice::KiswahiliLetterPractice(IOEventParser& my_iep) :
-  LetterPractice(my_iep, "", new KiswahiliSoundsUtil, createAlphabet(), createShortWords(), createMedWords(), createLongWords(), false)
+  LetterPractice(my_iep, AppModes::mappingFile(AppModes::LETTER_PRACTICE_SWAHILI), new KiswahiliSoundsUtil, createAlphabet(), createShortWords(), createMedWords(), createLongWords(), false)
 {
 
 }
@@ -356,7 +392,7 @@ const std::vector<std::string> KiswahiliLetterPractice::createLongWords() const
 //++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
 
 English2LetterPractice::English2LetterPractice(IOEventParser& my_iep) :
-  LetterPractice(my_iep, "./language_mapping_files/english_mapping_nomirror.txt", new English2SoundsUtil, createAlphabet(), createShortWords(), createMedWords(), createLongWords(), true)
+  LetterPractice(my_iep, AppModes::ENGLISH_NOMIRROR_MAPPING, new English2SoundsUtil, createAlphabet(), createShortWords(), createMedWords(), createLongWords(), true)
 {
 
 }
@@ -383,7 +419,7 @@ const std::vector<std::string> English2LetterPractice::createLongWords() const
 //++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
 
 Arabic2LetterPractice::Arabic2LetterPractice(IOEventParser& my_iep) :
-  LetterPractice(my_iep, "./language_mapping_files/arabic_mapping_nomirror.txt", new Arabic2SoundsUtil, createAlphabet(), createShortWords(), createMedWords(), createLongWords(), true)
+  LetterPractice(my_iep, AppModes::ARABIC_NOMIRROR_MAPPING, new Arabic2SoundsUtil, createAlphabet(), createShortWords(), createMedWords(), createLongWords(), true)
 {
 
 }
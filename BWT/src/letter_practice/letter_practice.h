@@ -10,9 +10,9 @@
 
 #include "common/utilities.h"
 #include "common/IBTApp.h"
+#include "common/Alphabet.h"
 #include "common/KnowledgeTracer.h"
 #include "common/language_utils.h"
-#include "common/multicharacter.h"
 
 class LetterPractice : public IBTApp
 {
@@ -26,6 +26,7 @@ public:
 private:
   void PL_attempt(std::string);
   void PL_new();
+  void sayDifference(size_t index);
   bool nomirror;
 
 private:
@@ -36,7 +37,7 @@ private:
   SoundsUtil* su;
   IOEventParser& iep; //So flushGlyph() can be called
 
-  const std::vector<std::string> alphabet;
+  const Alphabet alphabet;
   const std::vector<std::string> short_words;
   const std::vector<std::string> med_words;
   const std::vector<std::string> long_words;
@@ -48,6 +49,7 @@ private:
   int word_pos;
   int word_length;
   bool firsttime;
+  unsigned char written_dots; //dots of the last letter written, as the charset has them
 };
 //++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
 class EnglishLetterPractice : public LetterPractice
@@ -6,9 +6,11 @@
  */
 
 #include "letter_scaffold.h"
+#include "common/app_modes.h"
+#include "hangman/hangman.h"
 
-LetterScaffold::LetterScaffold(IOEventParser& my_iep, const std::string& path_to_mapping_file, SoundsUtil* my_su, bool f) :
-  IBTApp(my_iep, path_to_mapping_file), su(my_su), iep(my_iep), firsttime(true), nomirror(f)
+LetterScaffold::LetterScaffold(IOEventParser& my_iep, const std::string& path_to_mapping_file, SoundsUtil* my_su, const std::vector<std::string> my_words, bool f) :
+  IBTApp(my_iep, path_to_mapping_file), su(my_su), iep(my_iep), firsttime(true), nomirror(f), words(my_words), speller(words, 1, 3)
 {
   su->saySound(getTeacherVoice(), "free spelling");
 }
@@ -25,13 +27,19 @@ void LetterScaffold::processEvent(IOEvent& e)
   if( isDown(e) && dot > 0 )
     su->sayNumber(getStudentVoice(), dot, nomirror);
 
-  //Whenever the user hits Button0 we immediately want the LETTER event to be generated so that he doesnt have to wait for the timeout
+  //Whenever the user hits Button0 we immediately want the LETTER event to be generated so that he doesnt have to wait for the timeout.
+  //It also ends the word, once that letter has come.
   if( e.type == IOEvent::BUTTON && e.button == 0 )
   {
+    speller.push(e);
     iep.flushGlyph();
     return; //required? hmm..
   }
 
+  //The speller needs to know when a glyph is underway, for Button0 to end the word after its letter
+  if( e.type == IOEvent::CELL_START || e.type == IOEvent::BUTTON_START )
+    speller.push(e);
+
   if( e.type == IOEvent::BUTTON_LETTER || e.type == IOEvent::CELL_LETTER )
   {
     printEvent(e);
@@ -40,47 +48,74 @@ void LetterScaffold::processEvent(IOEvent& e)
     {
       std::cout << "    (DEBUG)Skipping first letter event" << std::endl;
       firsttime = false;
+      speller.reset(); //its glyph is done with too
       return;//skip
     }
     else
     {
       su->sayLetter(getTeacherVoice(), (std::string) e.letter);
+      sayWordHints(e);
     }
   }
 }
+
+//Add a letter to the word being written. Once the letters spell a word, say so and end it, so the next letter
+//starts a new word even in the same cell; until then, show the words they look like.
+void LetterScaffold::sayWordHints(IOEvent& e)
+{
+  speller.push(e);
+  const Dictionary::Match* closest = speller.closest();
+  if( !closest )
+    return;
+
+  if( closest->distance == 0 && words[closest->word] == speller.word() )
+  {
+    su->saySound(getTeacherVoice(), "good");
+    std::cout << "You spelled " << speller.word() << std::endl;
+    speller.endWord();
+    return;
+  }
+
+  std::cout << speller.word() << " looks like:";
+  for(size_t i = 0; i < speller.matches().size(); i++)
+    std::cout << " " << words[speller.matches()[i].word];
+  for(size_t i = 0; i < speller.completions().size(); i++)
+    std::cout << " " << words[speller.completions()[i].word] << "...";
+  std::cout << std::endl;
+}
 //++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
 EnglishLetterScaffold::EnglishLetterScaffold(IOEventParser& my_iep) :
-  LetterScaffold(my_iep, "", new EnglishSoundsUtil, false)
+  LetterScaffold(my_iep, AppModes::mappingFile(AppModes::FREE_SPELLING_ENGLISH), new EnglishSoundsUtil, EnglishHangman::createWords(), false)
 {
 
 }
 //++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
 ArabicLetterScaffold::ArabicLetterScaffold(IOEventParser& my_iep) :
-  LetterScaffold(my_iep, "./language_mapping_files/arabic_mapping.txt", new ArabicSoundsUtil, false)
+  LetterScaffold(my_iep, AppModes::mappingFile(AppModes::FREE_SPELLING_ARABIC), new ArabicSoundsUtil, ArabicHangman::createWords(), false)
 {
 
 }
 //++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
 FrenchLetterScaffold::FrenchLetterScaffold(IOEventParser& my_iep) :
-  LetterScaffold(my_iep, "./language_mapping_files/french_mapping.txt", new FrenchSoundsUtil, false)
+  LetterScaffold(my_iep, AppModes::mappingFile(AppModes::FREE_SPELLING_FRENCH), new FrenchSoundsUtil, FrenchHangman::createWords(), false)
 {
 
 }
 //++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
 KiswahiliLetterScaffold::KiswahiliLetterScaffold(IOEventParser& my_iep) :
-  LetterScaffold(my_iep, "", new KiswahiliSoundsUtil, false)
+  LetterScaffold(my_iep, AppModes::mappingFile(AppModes::FREE_SPELLING_SWAHILI), new KiswahiliSoundsUtil, KiswahiliHangman::createWords(), false)
 {
 
 }
 //++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
 English2LetterScaffold::English2LetterScaffold(IOEventParser& my_iep) :
-  LetterScaffold(my_iep, "./language_mapping_files/english_mapping_nomirror.txt", new English2SoundsUtil, true)
+  LetterScaffold(my_iep, AppModes::ENGLISH_NOMIRROR_MAPPING, new English2SoundsUtil, English2Hangman::createWords(), true)
 {
 
 }
 //++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
 Arabic2LetterScaffold::Arabic2LetterScaffold(IOEventParser& my_iep) :
-  LetterScaffold(my_iep, "./language_mapping_files/arabic_mapping_nomirror.txt", new Arabic2SoundsUtil, true)
+  LetterScaffold(my_iep, AppModes::ARABIC_NOMIRROR_MAPPING, new Arabic2SoundsUtil, Arabic2Hangman::createWords(), true)
 {
 
 }
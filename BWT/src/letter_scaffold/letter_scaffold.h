@@ -12,19 +12,24 @@
 #include "common/IBTApp.h"
 #include "common/KnowledgeTracer.h"
 #include "common/language_utils.h"
+#include "Dictionary.h"
 
 class LetterScaffold : public IBTApp
 {
 public:
-  explicit LetterScaffold(IOEventParser&, const std::string&, SoundsUtil*, bool);
+  explicit LetterScaffold(IOEventParser&, const std::string&, SoundsUtil*, const std::vector<std::string>, bool);
   virtual ~LetterScaffold();
   void processEvent(IOEvent& e);
 
 private:
+  void sayWordHints(IOEvent& e);
+
   SoundsUtil* su;
   IOEventParser& iep; //So flushGlyph() can be called
   bool firsttime;
   bool nomirror;
+  const Dictionary words; //the language's words, to match what's written against
+  WordAssembler speller; //the word the student is writing, and the words it looks like
 };
 //++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
 class EnglishLetterScaffold : public LetterScaffold
@@ -1,6 +1,8 @@
 #include <iostream>
 #include <unistd.h>
 #include <ctime> //g++ 4.3.2
+#include <cctype>
+#include <sstream>
 #include "common/IBTApp.h"
 #include "common/language_utils.h"
 #include "common/utilities.h"
@@ -10,6 +12,18 @@
 
 int launch_bt(int argc, char **argv);
 
+// Where to keep the debouncer's noise profile for the board on io_port
+static std::string noiseProfileFilename(const std::string &io_port,
+                                        const unsigned int &version)
+{
+  std::ostringstream name;
+  name << "./config/debounce_";
+  for(std::string::const_iterator c = io_port.begin(); c != io_port.end(); ++c)
+    name << (std::isalnum((unsigned char) *c) ? *c : '_');
+  name << "_v" << version << ".profile";
+  return name.str();
+}
+
 //This hack has something to do with SDL on Windows. Freddie might know the details
 #ifdef BT_WINDOWS
 #ifdef main
@@ -57,6 +71,9 @@ int main(int argc, char **argv)
 
 int launch_bt(int argc, char **argv)
 {
+  // The debouncer and the parser keep threads of their own: the apps that
+  // handle the parser's events block (speaking, sleeping), and the stylus
+  // events must not pile up behind them.
   IOEventParser event_parser;
   Voice teacher_voice("./resources/Voice/teacher/", event_parser);
   SoundsUtil* eng_su = new EnglishSoundsUtil;
@@ -68,9 +85,13 @@ int launch_bt(int argc, char **argv)
   // turn off stylus input debouncing. If they turn off the
   // debouncind, the BaseIOEvents are passed directly to the
   // IOEventParser. This is a TSS mod!
+  // Each hole is held back only as long as its own noise warrants: from
+  // 30 ms for clean holes up to the old fixed 300 ms for worn ones.
   ShortStylusSuppressor debouncer(0.3);
-  
-  if( (argc > 1) && !strcmp(argv[1], "--nodebounce") )
+  debouncer.setAdaptiveThreshold(TimeInterval(0, 30), TimeInterval(0, 300));
+
+  const bool debouncing = !( (argc > 1) && !strcmp(argv[1], "--nodebounce") );
+  if( !debouncing )
   {
     std::cout << "[ DEBOUNCING DISABLED ]" << std::endl;
     bt.setBaseIOEventHandler(event_parser);
@@ -110,9 +131,34 @@ int launch_bt(int argc, char **argv)
   unsigned int version;
   bt.detect(io_port, version);
   std::cout << "  found a version " << version << " tutor on " << io_port << std::endl;
+
+  // Pick up what the debouncer learned about this board last time. The
+  // Tutor has no serial number, so boards are told apart by port and ROM.
+  const std::string noise_profile = noiseProfileFilename(io_port, version);
+  if( debouncing )
+  {
+    try { debouncer.loadNoiseProfile(noise_profile); }
+    catch (const BTException &e)
+    { std::cout << "  no debouncing profile yet (" << e.why << ")" << std::endl; }
+  }
+
   eng_su->saySound(teacher_voice, "connected"); // TODO put something more intelligent here
   eng_su->saySound(teacher_voice, "welcome_menu"); // announce that back in main menu
-  bt.join();
 
-  return 0;
+  if( !debouncing )
+  {
+    bt.join();
+    return 0;
+  }
+
+  // bt.join() never returns, and the program is only ever stopped with
+  // Ctrl-C, so there's no shutdown to save the profile at. Instead this
+  // thread wakes up once a minute and saves what's been learned so far.
+  for(;;)
+  {
+    TimeInterval(60).sleep();
+    try { debouncer.saveNoiseProfile(noise_profile); }
+    catch (const BTException &e)
+    { std::cerr << "Couldn't save debouncing profile: " << e.why << std::endl; }
+  }
 }
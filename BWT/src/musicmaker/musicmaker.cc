@@ -26,7 +26,7 @@
 struct FunctorTimerTaskMM {
   const MusicMaker& mm;
   unsigned int turn; //the turn at which this thread was invoked
-  int &tempo;
+  int tempo; //seconds per beat
   boost::mutex &tone_matrix_mutex;
 
   // constructor
@@ -36,14 +36,18 @@ struct FunctorTimerTaskMM {
   // main loop of thread
   inline void operator()()
   {
+    // beats are paced by deadline so the time spent playing notes doesn't
+    // make the beat drift
+    PeriodicTicker beat(TimeInterval(tempo, 0));
     while(mm.loop){
-      BT_sleep(tempo);
+      beat.wait();
       //sleep(7); //Good for testing the concurrency
       
       // grab the mutex for the tone matrix array
       boost::mutex::scoped_lock lock_m(tone_matrix_mutex);
       
       tempo = mm.playNote(turn++);
+      beat.setPeriod(TimeInterval(tempo, 0));
       if(turn == 32)
         turn = 0;
     }
@@ -6,6 +6,7 @@
  */
 
 #include "number_scaffold.h"
+#include "common/app_modes.h"
 
 NumberScaffold::NumberScaffold(IOEventParser& my_iep, const std::string& path_to_mapping_file, SoundsUtil* my_su, bool f) :
   IBTApp(my_iep, path_to_mapping_file), su(my_su), iep(my_iep), firsttime(true),math_s("./resources/Voice/math_sounds/", my_iep), nomirror(f)
@@ -50,37 +51,37 @@ void NumberScaffold::processEvent(IOEvent& e)
 }
 //++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
 EnglishNumberScaffold::EnglishNumberScaffold(IOEventParser& my_iep) :
-  NumberScaffold(my_iep, "", new EnglishSoundsUtil,false)
+  NumberScaffold(my_iep, AppModes::mappingFile(AppModes::FREE_NUMBERS_ENGLISH), new EnglishSoundsUtil,false)
 {
 
 }
 //++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
 ArabicNumberScaffold::ArabicNumberScaffold(IOEventParser& my_iep) :
-  NumberScaffold(my_iep, "", new ArabicSoundsUtil,false)
+  NumberScaffold(my_iep, AppModes::mappingFile(AppModes::FREE_NUMBERS_ARABIC), new ArabicSoundsUtil,false)
 {
 
 }
 //++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
 FrenchNumberScaffold::FrenchNumberScaffold(IOEventParser& my_iep) :
-  NumberScaffold(my_iep, "", new FrenchSoundsUtil,false)
+  NumberScaffold(my_iep, AppModes::mappingFile(AppModes::FREE_NUMBERS_FRENCH), new FrenchSoundsUtil,false)
 {
 
 }
 //++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
 KiswahiliNumberScaffold::KiswahiliNumberScaffold(IOEventParser& my_iep) :
-  NumberScaffold(my_iep, "", new KiswahiliSoundsUtil, false)
+  NumberScaffold(my_iep, AppModes::mappingFile(AppModes::FREE_NUMBERS_SWAHILI), new KiswahiliSoundsUtil, false)
 {
 
 }
 //++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
 English2NumberScaffold::English2NumberScaffold(IOEventParser& my_iep) :
-  NumberScaffold(my_iep, "./language_mapping_files/english_mapping_nomirror.txt", new English2SoundsUtil, true)
+  NumberScaffold(my_iep, AppModes::ENGLISH_NOMIRROR_MAPPING, new English2SoundsUtil, true)
 {
 
 }
 //++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
 Arabic2NumberScaffold::Arabic2NumberScaffold(IOEventParser& my_iep) :
-  NumberScaffold(my_iep, "./language_mapping_files/arabic_mapping_nomirror.txt", new Arabic2SoundsUtil, true)
+  NumberScaffold(my_iep, AppModes::ARABIC_NOMIRROR_MAPPING, new Arabic2SoundsUtil, true)
 {
 
 }